@@ -51,6 +51,12 @@ namespace AssetProcessor
         static const char* FIND_PRODUCTS_BY_PLATFORM = "FindProductsByPlatform";
         static const char* FIND_ALL_SOURCES = "FindAllSources";
         static const char* DELETE_FINGERPRINTS_BY_SOURCE = "DeleteFingerprintsBySource";
+        static const char* FIND_ALL_FILE_HASHES = "FindAllFileHashes";
+        static const char* INSERT_FILE_HASH = "InsertFileHash";
+        static const char* DELETE_FILE_HASH = "DeleteFileHash";
+        static const char* FIND_ALL_DIRECTORY_SNAPSHOTS = "FindAllDirectorySnapshots";
+        static const char* INSERT_DIRECTORY_SNAPSHOT = "InsertDirectorySnapshot";
+        static const char* DELETE_DIRECTORY_SNAPSHOT = "DeleteDirectorySnapshot";
         
     }
 
@@ -145,6 +151,14 @@ namespace AssetProcessor
         }
 
 
+        // the file hash cache and directory snapshots are not part of the versioned schema.  they can be created at any time
+        // without losing data, so make sure they exist for databases which predate them.
+        if (!dropAllTables)
+        {
+            m_databaseConnection->ExecuteOneOffStatement("CreateFileHashesTable");
+            m_databaseConnection->ExecuteOneOffStatement("CreateDirectorySnapshotsTable");
+        }
+
         if (dropAllTables)
         {
             // drop all tables by destroying the entire database.
@@ -384,6 +398,61 @@ namespace AssetProcessor
             "WHERE JobLog.JobID = :jobLogPK; ");
         
 
+        // -----------------------------------------------------------------------------------------------------------------------------
+        //                   File hash table
+        // -----------------------------------------------------------------------------------------------------------------------------
+        // caches the content hash of a source file for a given (size, mod time, file id) so that it does not have to be read again.
+        // FileHashCache already folds the case of the file name where the file system is case insensitive.
+        m_databaseConnection->AddStatement("CreateFileHashesTable",
+            "CREATE TABLE IF NOT EXISTS FileHashes(                         "
+            "    FileName                 TEXT PRIMARY KEY,                 "
+            "    Size                     INTEGER,                          "
+            "    ModTime                  INTEGER,                          "
+            "    FileId                   INTEGER,                          "
+            "    Hash                     INTEGER                           "
+            ");");
+
+        m_createStatements.push_back("CreateFileHashesTable");
+
+        m_databaseConnection->AddStatement(FIND_ALL_FILE_HASHES,
+            "SELECT FileName, Size, ModTime, FileId, Hash FROM FileHashes;");
+
+        // unlike the fingerprints table, the file name is the primary key here, so insert or replace does exactly what we want.
+        m_databaseConnection->AddStatement(INSERT_FILE_HASH,
+            "INSERT OR REPLACE INTO FileHashes (FileName, Size, ModTime, FileId, Hash) VALUES "
+            "(:fileName, :size, :modTime, :fileId, :hash);");
+
+        m_databaseConnection->AddStatement(DELETE_FILE_HASH,
+            "DELETE FROM FileHashes WHERE "
+            "FileName = :fileName;");
+
+        // -----------------------------------------------------------------------------------------------------------------------------
+        //                   Directory snapshot table
+        // -----------------------------------------------------------------------------------------------------------------------------
+        // the listing of each directory seen by the asset scanner, keyed by its modification time.
+        // Entries is a newline separated list of names, with folders marked by a trailing slash.
+        // like the file hash table, the name is compared exactly: the scanner keys directories by the path it listed,
+        // and on case sensitive file systems two directories may differ only in case.
+        m_databaseConnection->AddStatement("CreateDirectorySnapshotsTable",
+            "CREATE TABLE IF NOT EXISTS DirectorySnapshots(                 "
+            "    DirectoryName            TEXT PRIMARY KEY,                 "
+            "    ModTime                  INTEGER,                          "
+            "    Entries                  TEXT                              "
+            ");");
+
+        m_createStatements.push_back("CreateDirectorySnapshotsTable");
+
+        m_databaseConnection->AddStatement(FIND_ALL_DIRECTORY_SNAPSHOTS,
+            "SELECT DirectoryName, ModTime, Entries FROM DirectorySnapshots;");
+
+        m_databaseConnection->AddStatement(INSERT_DIRECTORY_SNAPSHOT,
+            "INSERT OR REPLACE INTO DirectorySnapshots (DirectoryName, ModTime, Entries) VALUES "
+            "(:directoryName, :modTime, :entries);");
+
+        m_databaseConnection->AddStatement(DELETE_DIRECTORY_SNAPSHOT,
+            "DELETE FROM DirectorySnapshots WHERE "
+            "DirectoryName = :directoryName;");
+
         // --------------------------- COMPLEX QUERIES --------------------------------
         // get FingerprintPK by product name
         m_databaseConnection->AddStatement(FIND_SOURCES_BY_PRODUCTNAME,
@@ -1393,6 +1462,280 @@ namespace AssetProcessor
         AZ_Warning(ConsoleChannel, result != Statement::SqlError, "Error occurred while stepping %s", FIND_PRODUCTS_BY_PLATFORM);
     }
 
+    void DatabaseConnection::EnumerateFileHashes(FileHashHandler handler) const
+    {
+        AZ_Error(ConsoleChannel, m_databaseConnection, "Fatal: attempt to work on a database connection that doesn't exist");
+        AZ_Error(ConsoleChannel, m_databaseConnection->IsOpen(), "Fatal: attempt to work on a database connection that isn't open");
+
+        if ((!m_databaseConnection) || (!m_databaseConnection->IsOpen()))
+        {
+            return;
+        }
+
+        StatementAutoFinalizer autoFinal(*m_databaseConnection, FIND_ALL_FILE_HASHES);
+        Statement* statement = autoFinal.Get();
+        if (!statement)
+        {
+            AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", FIND_ALL_FILE_HASHES);
+            return;
+        }
+
+        Statement::SqlStatus result = statement->Step();
+        while (result == Statement::SqlOK)
+        {
+            AssetUtilities::FileHashEntry entry;
+            QString fileName = QString::fromUtf8(statement->GetColumnText(0).c_str());
+            entry.m_size = static_cast<AZ::u64>(statement->GetColumnInt64(1));
+            entry.m_modTime = statement->GetColumnInt64(2);
+            entry.m_fileId = static_cast<AZ::u64>(statement->GetColumnInt64(3));
+            entry.m_hash = static_cast<AZ::u64>(statement->GetColumnInt64(4));
+            handler(fileName, entry);
+            result = statement->Step();
+        }
+
+        AZ_Warning(ConsoleChannel, result != Statement::SqlError, "Error occurred while stepping %s", FIND_ALL_FILE_HASHES);
+    }
+
+    void DatabaseConnection::UpdateFileHashes(const AZStd::vector<AssetUtilities::FileHashRecord>& changedEntries, const QStringList& removedFileNames)
+    {
+        AZ_Error(ConsoleChannel, m_databaseConnection, "Fatal: attempt to work on a database connection that doesn't exist");
+        AZ_Error(ConsoleChannel, m_databaseConnection->IsOpen(), "Fatal: attempt to work on a database connection that isn't open");
+
+        if ((!m_databaseConnection) || (!m_databaseConnection->IsOpen()))
+        {
+            return;
+        }
+
+        if ((changedEntries.empty()) && (removedFileNames.isEmpty()))
+        {
+            return;
+        }
+
+        // there can be tens of thousands of these after a fresh scan, so do them all in one transaction.
+        ScopedTransaction transaction(m_databaseConnection);
+
+        if (!changedEntries.empty())
+        {
+            StatementAutoFinalizer autoFinal(*m_databaseConnection, INSERT_FILE_HASH);
+            Statement* statement = autoFinal.Get();
+            if (!statement)
+            {
+                AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", INSERT_FILE_HASH);
+                return;
+            }
+
+            int fileNameVar = statement->GetNamedParamIdx(":fileName");
+            int sizeVar = statement->GetNamedParamIdx(":size");
+            int modTimeVar = statement->GetNamedParamIdx(":modTime");
+            int fileIdVar = statement->GetNamedParamIdx(":fileId");
+            int hashVar = statement->GetNamedParamIdx(":hash");
+
+            if ((!fileNameVar) || (!sizeVar) || (!modTimeVar) || (!fileIdVar) || (!hashVar))
+            {
+                AZ_WarningOnce(ConsoleChannel, false, "Could not find the column for fileName %i or size %i or modTime %i or fileId %i or hash %i in %s", fileNameVar, sizeVar, modTimeVar, fileIdVar, hashVar, INSERT_FILE_HASH);
+                return;
+            }
+
+            AZStd::string utf8Encoded;
+
+            for (const AssetUtilities::FileHashRecord& record : changedEntries)
+            {
+                // convert to char * (must persist for lifetime of statement)
+                utf8Encoded = record.first.toUtf8().constData();
+                statement->BindValueText(fileNameVar, utf8Encoded.c_str());
+                statement->BindValueInt64(sizeVar, static_cast<AZ::s64>(record.second.m_size));
+                statement->BindValueInt64(modTimeVar, record.second.m_modTime);
+                statement->BindValueInt64(fileIdVar, static_cast<AZ::s64>(record.second.m_fileId));
+                statement->BindValueInt64(hashVar, static_cast<AZ::s64>(record.second.m_hash));
+
+                if (statement->Step() == Statement::SqlError)
+                {
+                    AZ_Warning(ConsoleChannel, false, "Failed to execute %s for %s", INSERT_FILE_HASH, utf8Encoded.c_str());
+                    return;
+                }
+                statement->Reset();
+            }
+        }
+
+        if (!removedFileNames.isEmpty())
+        {
+            StatementAutoFinalizer autoFinal(*m_databaseConnection, DELETE_FILE_HASH);
+            Statement* statement = autoFinal.Get();
+            if (!statement)
+            {
+                AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", DELETE_FILE_HASH);
+                return;
+            }
+
+            int fileNameVar = statement->GetNamedParamIdx(":fileName");
+            if (!fileNameVar)
+            {
+                AZ_WarningOnce(ConsoleChannel, false, "Could not find the column for :fileName for %s", DELETE_FILE_HASH);
+                return;
+            }
+
+            AZStd::string utf8Encoded;
+
+            for (const QString& fileName : removedFileNames)
+            {
+                utf8Encoded = fileName.toUtf8().constData();
+                statement->BindValueText(fileNameVar, utf8Encoded.c_str());
+
+                if (statement->Step() == Statement::SqlError)
+                {
+                    AZ_Warning(ConsoleChannel, false, "Failed to execute %s for %s", DELETE_FILE_HASH, utf8Encoded.c_str());
+                    return;
+                }
+                statement->Reset();
+            }
+        }
+
+        transaction.Commit();
+    }
+
+    void DatabaseConnection::EnumerateDirectorySnapshots(DirectorySnapshotHandler handler) const
+    {
+        AZ_Error(ConsoleChannel, m_databaseConnection, "Fatal: attempt to work on a database connection that doesn't exist");
+        AZ_Error(ConsoleChannel, m_databaseConnection->IsOpen(), "Fatal: attempt to work on a database connection that isn't open");
+
+        if ((!m_databaseConnection) || (!m_databaseConnection->IsOpen()))
+        {
+            return;
+        }
+
+        StatementAutoFinalizer autoFinal(*m_databaseConnection, FIND_ALL_DIRECTORY_SNAPSHOTS);
+        Statement* statement = autoFinal.Get();
+        if (!statement)
+        {
+            AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", FIND_ALL_DIRECTORY_SNAPSHOTS);
+            return;
+        }
+
+        Statement::SqlStatus result = statement->Step();
+        while (result == Statement::SqlOK)
+        {
+            DirectorySnapshot snapshot;
+            QString directoryName = QString::fromUtf8(statement->GetColumnText(0).c_str());
+            snapshot.m_modTime = statement->GetColumnInt64(1);
+            QStringList entries = QString::fromUtf8(statement->GetColumnText(2).c_str()).split('\n', QString::SkipEmptyParts);
+            for (const QString& entry : entries)
+            {
+                if (entry.endsWith('/'))
+                {
+                    snapshot.m_folders.push_back(entry.left(entry.length() - 1));
+                }
+                else
+                {
+                    snapshot.m_files.push_back(entry);
+                }
+            }
+            handler(directoryName, snapshot);
+            result = statement->Step();
+        }
+
+        AZ_Warning(ConsoleChannel, result != Statement::SqlError, "Error occurred while stepping %s", FIND_ALL_DIRECTORY_SNAPSHOTS);
+    }
+
+    void DatabaseConnection::UpdateDirectorySnapshots(const AZStd::vector<AZStd::pair<QString, DirectorySnapshot> >& changedSnapshots, const QStringList& removedDirectoryNames)
+    {
+        AZ_Error(ConsoleChannel, m_databaseConnection, "Fatal: attempt to work on a database connection that doesn't exist");
+        AZ_Error(ConsoleChannel, m_databaseConnection->IsOpen(), "Fatal: attempt to work on a database connection that isn't open");
+
+        if ((!m_databaseConnection) || (!m_databaseConnection->IsOpen()))
+        {
+            return;
+        }
+
+        if ((changedSnapshots.empty()) && (removedDirectoryNames.isEmpty()))
+        {
+            return;
+        }
+
+        ScopedTransaction transaction(m_databaseConnection);
+
+        if (!changedSnapshots.empty())
+        {
+            StatementAutoFinalizer autoFinal(*m_databaseConnection, INSERT_DIRECTORY_SNAPSHOT);
+            Statement* statement = autoFinal.Get();
+            if (!statement)
+            {
+                AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", INSERT_DIRECTORY_SNAPSHOT);
+                return;
+            }
+
+            int directoryNameVar = statement->GetNamedParamIdx(":directoryName");
+            int modTimeVar = statement->GetNamedParamIdx(":modTime");
+            int entriesVar = statement->GetNamedParamIdx(":entries");
+
+            if ((!directoryNameVar) || (!modTimeVar) || (!entriesVar))
+            {
+                AZ_WarningOnce(ConsoleChannel, false, "Could not find the column for directoryName %i or modTime %i or entries %i in %s", directoryNameVar, modTimeVar, entriesVar, INSERT_DIRECTORY_SNAPSHOT);
+                return;
+            }
+
+            AZStd::string directoryNameStr;
+            AZStd::string entriesStr;
+
+            for (const auto& changed : changedSnapshots)
+            {
+                QStringList entries = changed.second.m_files;
+                for (const QString& folder : changed.second.m_folders)
+                {
+                    entries.push_back(folder + '/');
+                }
+
+                // convert to char * (must persist for lifetime of statement)
+                directoryNameStr = changed.first.toUtf8().constData();
+                entriesStr = entries.join('\n').toUtf8().constData();
+                statement->BindValueText(directoryNameVar, directoryNameStr.c_str());
+                statement->BindValueInt64(modTimeVar, changed.second.m_modTime);
+                statement->BindValueText(entriesVar, entriesStr.c_str());
+
+                if (statement->Step() == Statement::SqlError)
+                {
+                    AZ_Warning(ConsoleChannel, false, "Failed to execute %s for %s", INSERT_DIRECTORY_SNAPSHOT, directoryNameStr.c_str());
+                    return;
+                }
+                statement->Reset();
+            }
+        }
+
+        if (!removedDirectoryNames.isEmpty())
+        {
+            StatementAutoFinalizer autoFinal(*m_databaseConnection, DELETE_DIRECTORY_SNAPSHOT);
+            Statement* statement = autoFinal.Get();
+            if (!statement)
+            {
+                AZ_Error(ConsoleChannel, false, "Unable to find SQL statement: %s", DELETE_DIRECTORY_SNAPSHOT);
+                return;
+            }
+
+            int directoryNameVar = statement->GetNamedParamIdx(":directoryName");
+            if (!directoryNameVar)
+            {
+                AZ_WarningOnce(ConsoleChannel, false, "Could not find the column for :directoryName for %s", DELETE_DIRECTORY_SNAPSHOT);
+                return;
+            }
+
+            AZStd::string utf8Encoded;
+
+            for (const QString& directoryName : removedDirectoryNames)
+            {
+                utf8Encoded = directoryName.toUtf8().constData();
+                statement->BindValueText(directoryNameVar, utf8Encoded.c_str());
+
+                if (statement->Step() == Statement::SqlError)
+                {
+                    AZ_Warning(ConsoleChannel, false, "Failed to execute %s for %s", DELETE_DIRECTORY_SNAPSHOT, utf8Encoded.c_str());
+                    return;
+                }
+                statement->Reset();
+            }
+        }
+
+        transaction.Commit();
+    }
+
     void DatabaseConnection::VacuumAndAnalyze()
     {
         if (m_databaseConnection)
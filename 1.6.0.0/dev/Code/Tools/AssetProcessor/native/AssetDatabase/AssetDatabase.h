@@ -22,6 +22,7 @@
 #include <QtCore/QString>
 
 #include "native/AssetManager/AssetData.h"
+#include "native/utilities/FileHashCache.h"
 #include "AzToolsFramework/API/EditorAssetSystemAPI.h"
 
 class QStringList;
@@ -86,6 +87,18 @@ namespace AssetProcessor
         using PlatformProductHandler = AZStd::function<void(const QString&)>;
         void EnumeratePlatformProducts(const QString& platform, PlatformProductHandler handler) const;
 
+        //! The file hash table persists AssetUtilities::FileHashCache between runs.
+        using FileHashHandler = AZStd::function<void(const QString& fileName, const AssetUtilities::FileHashEntry& entry)>;
+        void EnumerateFileHashes(FileHashHandler handler) const;
+        //! Write changed entries and delete removed ones, in a single transaction.
+        void UpdateFileHashes(const AZStd::vector<AssetUtilities::FileHashRecord>& changedEntries, const QStringList& removedFileNames);
+
+        //! The directory snapshot table lets the asset scanner reuse directory listings from the previous run.
+        using DirectorySnapshotHandler = AZStd::function<void(const QString& directoryName, const DirectorySnapshot& snapshot)>;
+        void EnumerateDirectorySnapshots(DirectorySnapshotHandler handler) const;
+        //! Write changed snapshots and delete removed ones, in a single transaction.
+        void UpdateDirectorySnapshots(const AZStd::vector<AZStd::pair<QString, DirectorySnapshot> >& changedSnapshots, const QStringList& removedDirectoryNames);
+
         //! Vacuum And Analyze is a housekeeping operation.  It should be used periodically when a lot of data has changed
         //! and you are not currently doing any other work.  It recovers wasted space in the DB and it also analyzes the performance
         //! of queries that have been previously made and collects statistics in the stats table.  SQLITE uses these statistics
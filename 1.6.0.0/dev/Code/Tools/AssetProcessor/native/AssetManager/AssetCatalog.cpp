@@ -99,6 +99,14 @@ namespace AssetProcessor
 
     void AssetCatalog::SaveRegistry_Impl()
     {
+        int saveVersion = 0;
+        {
+            // requests made after this point get a save of their own, this one may already be past the changes they expect
+            QMutexLocker locker(&m_savingRegistryMutex);
+            saveVersion = m_currentRegistrySaveVersion;
+            m_currentlySavingCatalog = false;
+        }
+
         // note that its safe not to save the catalog if the catalog is not dirty
         // because the engine will be accepting updates as long as the update has a higher or equal
         // number to the saveId, not just equal.
@@ -141,11 +149,7 @@ namespace AssetProcessor
             }
         }
 
-        {
-            QMutexLocker locker(&m_savingRegistryMutex);
-            m_currentlySavingCatalog = false;
-            Q_EMIT Saved(m_currentRegistrySaveVersion);
-        }
+        Q_EMIT Saved(saveVersion);
     }
 
     int AssetCatalog::SaveRegistry()
@@ -13,6 +13,7 @@
 #define ASSETPROCESSOR_ASSETDATA_H
 
 #include <QString>
+#include <QStringList>
 #include <QSet>
 
 namespace AssetProcessor
@@ -36,6 +37,17 @@ namespace AssetProcessor
     //This global function is required, if we want to use DatabaseEntry as a key in a QHash
     uint qHash(const DatabaseEntry& key, uint seed = 0);
 
+    //! This struct records the listing of a single directory as seen by the asset scanner, so that the next scan
+    //! can reuse it instead of listing the directory again if the directory's modification time has not changed.
+    //! Note that a directory's modification time only changes when entries are added, removed or renamed,
+    //! so this can only stand in for the listing, never for the files themselves.
+    struct DirectorySnapshot
+    {
+        qint64 m_modTime = 0; // milliseconds since epoch
+        QStringList m_files; // names only, not paths
+        QStringList m_folders; // names only, not paths
+    };
+
     //! this is the interface which we use to speak to the legacy database tables.
     // its known as the legacy database interface because the forthcoming tables will completely replace these
     // but this layer exits for compatibility with the previous version and allows us to upgrade in place.
@@ -28,6 +28,7 @@
 #include "native/AssetManager/assetProcessorManager.h"
 #include "native/utilities/PlatformConfiguration.h"
 #include "native/utilities/AssetUtils.h"
+#include "native/utilities/FileHashCache.h"
 #include "native/utilities/assetUtilEBusHelper.h"
 #include "native/AssetManager/AssetProcessingStateData.h"
 #include "native/AssetDatabase/AssetDatabase.h"
@@ -97,6 +98,18 @@ namespace AssetProcessor
             m_stateData->OpenDatabase();
         }
         delete legacyData;
+
+        if (m_platformConfig->UseContentHashFingerprints())
+        {
+            // warm up the hash cache so that files which have not changed since the last run are not read again.
+            AssetUtilities::SetContentHashFingerprinting(true);
+            AssetUtilities::FileHashCache& hashCache = AssetUtilities::GetFileHashCache();
+            m_stateData->EnumerateFileHashes([&hashCache](const QString& fileName, const AssetUtilities::FileHashEntry& entry)
+                {
+                    hashCache.Load(fileName, entry);
+                });
+            AZ_TracePrintf(AssetProcessor::ConsoleChannel, "Content hash fingerprinting enabled, %i file hashes loaded.\n", hashCache.Size());
+        }
         
         m_highestJobId = m_stateData->GetHighestJobID();
         if (m_highestJobId < 0)
@@ -525,6 +538,7 @@ namespace AssetProcessor
     {
         m_quitRequested = true;
         m_filesToExamine.clear();
+        FlushFileHashes();
         Q_EMIT ReadyToQuit(this);
     }
 
@@ -1748,6 +1762,7 @@ namespace AssetProcessor
                 if (examineFile.m_isDelete && !QFile::exists(examineFile.m_fileName))
                 {
                     AZ_TracePrintf(AssetProcessor::DebugChannel, "Input was deleted and no overrider was found.\n");
+                    AssetUtilities::GetFileHashCache().Invalidate(examineFile.m_fileName);
                     const AssetProcessor::ScanFolderInfo* scanFolderInfo = m_platformConfig->GetScanFolderForFile(normalizedPath);
                     QString sourceFile(relativePathToFile);
                     if (!scanFolderInfo->OutputPrefix().isEmpty())
@@ -1785,6 +1800,8 @@ namespace AssetProcessor
                 m_hasProcessedCriticalAssets = true;
             }
 
+            FlushFileHashes();
+
             if (!m_quitRequested && m_AssetProcessorIsBusy)
             {
                 m_AssetProcessorIsBusy = false;
@@ -1793,6 +1810,21 @@ namespace AssetProcessor
         }
     }
 
+    void AssetProcessorManager::FlushFileHashes()
+    {
+        if ((!m_stateData) || (!AssetUtilities::IsContentHashFingerprinting()))
+        {
+            return;
+        }
+
+        AZStd::vector<AssetUtilities::FileHashRecord> changedEntries;
+        QStringList removedFileNames;
+        AssetUtilities::FileHashCache& hashCache = AssetUtilities::GetFileHashCache();
+        hashCache.TakeDirtyEntries(changedEntries);
+        hashCache.TakeRemovedEntries(removedFileNames);
+        m_stateData->UpdateFileHashes(changedEntries, removedFileNames);
+    }
+
     // ----------------------------------------------------
     // ------------- File change Queue --------------------
     // ----------------------------------------------------
@@ -213,6 +213,9 @@ namespace AssetProcessor
         bool Recv(unsigned int connId, QByteArray payload, R& request);
 
         void AssessFileInternal(QString filePath, bool isDelete);
+
+        //! write any content hashes computed since the last flush to the database
+        void FlushFileHashes();
         void CheckAsset(const FileEntry& source);
         void CheckMissingJobs(const AZStd::vector<JobDetails>& jobsThisTime);
         void CheckDeletedFileInCache(QString normalizedPath);
@@ -54,6 +54,17 @@ void AssetScanner::StopScan()
     QMetaObject::invokeMethod(&m_assetScannerWorker, "StopScan", Qt::DirectConnection);
 }
 
+void AssetScanner::SetSnapshotDatabase(AZStd::shared_ptr<DatabaseConnection> database)
+{
+    // the worker thread is not running a scan yet, so it is safe to hand this over directly.
+    m_assetScannerWorker.SetSnapshotDatabase(database);
+}
+
+int AssetScanner::GetReusedListingCount() const
+{
+    return m_assetScannerWorker.GetReusedListingCount();
+}
+
 
 AssetProcessor::AssetScanningStatus AssetScanner::status() const
 {
@@ -38,6 +38,13 @@ namespace AssetProcessor
         void StartScan();//Should be called to start a scan
         void StopScan();//Should be called to stop a scan
 
+        //! Record directory listings in the given database so that unchanged folders are not listed again on the next run.
+        //! Should be called before StartScan.
+        void SetSnapshotDatabase(AZStd::shared_ptr<DatabaseConnection> database);
+
+        //! Number of directory listings reused by the last scan, only valid once it has reported Completed.
+        int GetReusedListingCount() const;
+
         Q_INVOKABLE AssetProcessor::AssetScanningStatus status() const;
 
 Q_SIGNALS:
@@ -11,20 +11,369 @@
 */
 #include "native/AssetManager/assetScannerWorker.h"
 #include "native/AssetManager/assetScanner.h"
+#include "native/AssetDatabase/AssetDatabase.h"
 #include "native/utilities/AssetUtils.h"
 #include "native/utilities/PlatformConfiguration.h"
+#include <AzCore/std/containers/vector.h>
+#include <QAtomicInt>
+#include <QDateTime>
 #include <QDir>
+#include <QDirIterator>
 #include <QFileInfo>
-#include <QFileInfoList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
 
 using namespace AssetProcessor;
 
+namespace
+{
+    // a directory modified this recently before the scan started could be modified again without its
+    // modification time changing (timestamp granularity), so its listing is not recorded.
+    const qint64 s_minimumDirectoryAgeForSnapshotMs = 2000;
+
+    // found files are handed over to the worker thread to be emitted in batches of about this size.
+    const int s_fileBatchSize = 256;
+
+    struct DirectoryTask
+    {
+        QString m_path;
+        bool m_recurse = true;
+    };
+
+    typedef AZStd::pair<QString, DirectorySnapshot> DirectorySnapshotRecord;
+
+    /** Walks a set of directory trees with a number of lanes (threads).  Each lane has its own queue of directories,
+     * which it works on depth first.  A lane which runs out of work steals the oldest (closest to the root, so usually
+     * the largest) directory from another lane's queue.  Files are handed to the calling thread in batches as they are
+     * found, so that it can forward them while the walk continues.
+     */
+    class ParallelDirectoryWalker
+    {
+    public:
+        ParallelDirectoryWalker(const PlatformConfiguration* config, const QHash<QString, DirectorySnapshot>& previousSnapshots, volatile bool& doScan, int laneCount)
+            : m_platformConfiguration(config)
+            , m_previousSnapshots(previousSnapshots)
+            , m_doScan(doScan)
+            , m_lanes(new Lane[laneCount])
+            , m_laneCount(laneCount)
+            , m_activeLanes(laneCount)
+            , m_scanStartTime(QDateTime::currentMSecsSinceEpoch())
+        {
+            for (int idx = 0; idx < m_platformConfiguration->MetaDataFileTypesCount(); idx++)
+            {
+                m_metaFileSuffixes.push_back("." + m_platformConfiguration->GetMetaDataFileTypeAt(idx).first);
+            }
+        }
+
+        int LaneCount() const
+        {
+            return m_laneCount;
+        }
+
+        void AddRoot(const QString& path, bool recurse)
+        {
+            DirectoryTask task;
+            task.m_path = QDir(path).absolutePath();
+            task.m_recurse = recurse;
+            PushTask(m_nextRootLane, task);
+            m_nextRootLane = (m_nextRootLane + 1) % m_laneCount;
+        }
+
+        //! Blocks until files are available or the walk is over.  returns false once the walk is over and all files were taken.
+        bool WaitForFiles(QStringList& files)
+        {
+            QMutexLocker locker(&m_stateMutex);
+            while ((m_foundFiles.isEmpty()) && (m_activeLanes > 0))
+            {
+                m_filesAvailable.wait(&m_stateMutex);
+            }
+
+            if (m_foundFiles.isEmpty())
+            {
+                return false;
+            }
+
+            files.swap(m_foundFiles);
+            m_foundFiles.clear();
+            return true;
+        }
+
+        void RunLane(int laneIndex)
+        {
+            LaneResults results;
+            QStringList foundFiles;
+
+            while (true)
+            {
+                // read before looking for work, so that a task pushed after we found nothing is not missed below.
+                int workGeneration = m_workGeneration.load();
+
+                DirectoryTask task;
+                if (PopTask(laneIndex, task))
+                {
+                    ScanDirectory(laneIndex, task, foundFiles, results);
+                    // any subfolders were queued before this, so pending only reaches zero when there is truly no more work.
+                    if (!m_pendingTasks.deref())
+                    {
+                        QMutexLocker locker(&m_stateMutex);
+                        m_workAvailable.wakeAll();
+                    }
+                    continue;
+                }
+
+                if ((m_pendingTasks.load() == 0) || (!m_doScan))
+                {
+                    break;
+                }
+
+                // sleep until another lane queues a directory or the last pending one is done.
+                QMutexLocker locker(&m_stateMutex);
+                while ((m_workGeneration.load() == workGeneration) && (m_pendingTasks.load() != 0))
+                {
+                    m_workAvailable.wait(&m_stateMutex);
+                }
+            }
+
+            QMutexLocker locker(&m_stateMutex);
+            m_foundFiles.append(foundFiles);
+            m_changedSnapshots.insert(m_changedSnapshots.end(), results.m_changedSnapshots.begin(), results.m_changedSnapshots.end());
+            m_visitedDirectories.unite(results.m_visitedDirectories);
+            m_reusedListings += results.m_reusedListings;
+            --m_activeLanes;
+            m_filesAvailable.wakeAll();
+        }
+
+        // the following are only valid once the walk is over.
+        AZStd::vector<DirectorySnapshotRecord> m_changedSnapshots;
+        QSet<QString> m_visitedDirectories;
+        int m_reusedListings = 0;
+
+    private:
+        struct Lane
+        {
+            QMutex m_mutex;
+            std::deque<DirectoryTask> m_tasks;
+        };
+
+        struct LaneResults
+        {
+            AZStd::vector<DirectorySnapshotRecord> m_changedSnapshots;
+            QSet<QString> m_visitedDirectories;
+            int m_reusedListings = 0;
+        };
+
+        void PushTask(int laneIndex, const DirectoryTask& task)
+        {
+            m_pendingTasks.ref();
+            {
+                QMutexLocker locker(&m_lanes[laneIndex].m_mutex);
+                m_lanes[laneIndex].m_tasks.push_back(task);
+            }
+
+            // idle lanes check the generation under the state mutex before they sleep, so bumping it under the same mutex can't be missed.
+            QMutexLocker locker(&m_stateMutex);
+            m_workGeneration.ref();
+            m_workAvailable.wakeOne();
+        }
+
+        bool PopTask(int laneIndex, DirectoryTask& task)
+        {
+            {
+                // our own work, newest first, so that each lane goes depth first through its subtree.
+                Lane& lane = m_lanes[laneIndex];
+                QMutexLocker locker(&lane.m_mutex);
+                if (!lane.m_tasks.empty())
+                {
+                    task = lane.m_tasks.back();
+                    lane.m_tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for (int offset = 1; offset < m_laneCount; ++offset)
+            {
+                Lane& victim = m_lanes[(laneIndex + offset) % m_laneCount];
+                QMutexLocker locker(&victim.m_mutex);
+                if (!victim.m_tasks.empty())
+                {
+                    task = victim.m_tasks.front();
+                    victim.m_tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool IsMetaFile(const QString& absPath) const
+        {
+            for (const QString& suffix : m_metaFileSuffixes)
+            {
+                if (absPath.endsWith(suffix, Qt::CaseInsensitive))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void ScanDirectory(int laneIndex, const DirectoryTask& task, QStringList& foundFiles, LaneResults& results)
+        {
+            if (!m_doScan) // scan was cancelled!
+            {
+                return;
+            }
+
+            // the modification time must be read before the listing, so that a change during the listing
+            // makes the recorded time stale rather than the recorded listing.
+            qint64 modTime = QFileInfo(task.m_path).lastModified().toMSecsSinceEpoch();
+
+            DirectorySnapshot freshListing;
+            const DirectorySnapshot* listing = &freshListing;
+
+            auto previous = m_previousSnapshots.constFind(task.m_path);
+            if ((previous != m_previousSnapshots.constEnd()) && (previous.value().m_modTime == modTime))
+            {
+                listing = &previous.value();
+                ++results.m_reusedListings;
+            }
+            else
+            {
+                freshListing.m_modTime = modTime;
+                QDirIterator entries(task.m_path, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Files);
+                while (entries.hasNext())
+                {
+                    entries.next();
+                    if (entries.fileInfo().isDir())
+                    {
+                        freshListing.m_folders.push_back(entries.fileName());
+                    }
+                    else
+                    {
+                        freshListing.m_files.push_back(entries.fileName());
+                    }
+                }
+
+                if (m_scanStartTime - modTime >= s_minimumDirectoryAgeForSnapshotMs)
+                {
+                    results.m_changedSnapshots.push_back(DirectorySnapshotRecord(task.m_path, freshListing));
+                }
+            }
+            results.m_visitedDirectories.insert(task.m_path);
+
+            QString prefix = task.m_path.endsWith('/') ? task.m_path : task.m_path + '/';
+
+            //Only scan sub folders if recurseSubFolders flag is set
+            if (task.m_recurse)
+            {
+                for (const QString& folder : listing->m_folders)
+                {
+                    QString absPath = prefix + folder;
+
+                    // Filtering out excluded folders
+                    if (m_platformConfiguration->IsFileExcluded(absPath))
+                    {
+                        continue;
+                    }
+
+                    DirectoryTask subTask;
+                    subTask.m_path = absPath;
+                    subTask.m_recurse = true;
+                    PushTask(laneIndex, subTask);
+                }
+            }
+
+            for (const QString& file : listing->m_files)
+            {
+                QString absPath = prefix + file;
+
+                // Filtering out excluded files
+                if (m_platformConfiguration->IsFileExcluded(absPath))
+                {
+                    continue;
+                }
+
+                // Filtering out metadata files as well, there is no need to send both the source file and the metadafiles
+                // to the apm for analysis, just sending the source file should be enough
+                if (IsMetaFile(absPath))
+                {
+                    continue;
+                }
+
+                foundFiles.push_back(absPath);
+            }
+
+            if (foundFiles.size() >= s_fileBatchSize)
+            {
+                QMutexLocker locker(&m_stateMutex);
+                m_foundFiles.append(foundFiles);
+                m_filesAvailable.wakeAll();
+                foundFiles.clear();
+            }
+        }
+
+        const PlatformConfiguration* m_platformConfiguration;
+        const QHash<QString, DirectorySnapshot>& m_previousSnapshots;
+        volatile bool& m_doScan;
+        QStringList m_metaFileSuffixes;
+
+        std::unique_ptr<Lane[]> m_lanes;
+        int m_laneCount;
+        int m_nextRootLane = 0;
+        QAtomicInt m_pendingTasks;
+        QAtomicInt m_workGeneration; // bumped whenever a directory is queued
+
+        QMutex m_stateMutex; // guards everything below, as well as the results
+        QWaitCondition m_workAvailable;
+        QWaitCondition m_filesAvailable;
+        QStringList m_foundFiles;
+        int m_activeLanes;
+
+        qint64 m_scanStartTime;
+    };
+
+    class DirectoryWalkerLane
+        : public QRunnable
+    {
+    public:
+        DirectoryWalkerLane(ParallelDirectoryWalker& walker, int laneIndex)
+            : m_walker(walker)
+            , m_laneIndex(laneIndex)
+        {
+        }
+
+        void run() override
+        {
+            m_walker.RunLane(m_laneIndex);
+        }
+
+    private:
+        ParallelDirectoryWalker& m_walker;
+        int m_laneIndex;
+    };
+}
+
 AssetScannerWorker::AssetScannerWorker(PlatformConfiguration* config, QObject* parent)
     : QObject(parent)
     , m_platformConfiguration(config)
 {
 }
 
+void AssetScannerWorker::SetSnapshotDatabase(AZStd::shared_ptr<DatabaseConnection> database)
+{
+    m_snapshotDatabase = database;
+    m_snapshotsLoaded = false;
+}
+
+int AssetScannerWorker::GetReusedListingCount() const
+{
+    return m_reusedListings;
+}
+
 void AssetScannerWorker::StartScan()
 {
     // this must be called from the thread operating it and not the main thread.
@@ -32,29 +381,22 @@ void AssetScannerWorker::StartScan()
 
     m_fileList.clear();
     m_doScan = true;
+    m_reusedListings = 0;
 
     Q_EMIT ScanningStateChanged(AssetProcessor::AssetScanningStatus::Started);
     Q_EMIT ScanningStateChanged(AssetProcessor::AssetScanningStatus::InProgress);
 
-    for (int idx = 0; idx < m_platformConfiguration->GetScanFolderCount(); idx++)
-    {
-        ScanFolderInfo scanFolderInfo = m_platformConfiguration->GetScanFolderAt(idx);
-        ScanForSourceFiles(scanFolderInfo);
-    }
-    // we want not to emit any signals until we're finished scanning
-    // so that we don't interleave directory tree walking (IO access to the file table)
-    // with file access (IO access to file data) caused by sending signals to other classes.
+    // files are emitted in batches while the tree is still being walked, so that the
+    // AssetProcessorManager can start its analysis before the last folder is listed.
+    ScanForSourceFiles();
+
+    m_fileList.clear();
 
     if (!m_doScan)
     {
-        m_fileList.clear();
         Q_EMIT ScanningStateChanged(AssetProcessor::AssetScanningStatus::Stopped);
         return;
     }
-    else
-    {
-        EmitFiles();
-    }
 
     Q_EMIT ScanningStateChanged(AssetProcessor::AssetScanningStatus::Completed);
 }
@@ -67,86 +409,103 @@ void AssetScannerWorker::StopScan()
     m_doScan = false;
 }
 
-void AssetScannerWorker::ScanForSourceFiles(ScanFolderInfo scanFolderInfo)
+void AssetScannerWorker::LoadDirectorySnapshots()
 {
-    if (!m_doScan)
+    if ((m_snapshotsLoaded) || (!m_snapshotDatabase))
     {
         return;
     }
 
-    QDir dir(scanFolderInfo.ScanPath());
+    m_snapshotsLoaded = true;
+    m_directorySnapshots.clear();
+    m_snapshotDatabase->EnumerateDirectorySnapshots([this](const QString& directoryName, const DirectorySnapshot& snapshot)
+        {
+            m_directorySnapshots.insert(directoryName, snapshot);
+        });
+}
 
-    QFileInfoList entries;
+void AssetScannerWorker::ScanForSourceFiles()
+{
+    LoadDirectorySnapshots();
 
-    //Only scan sub folders if recurseSubFolders flag is set
-    if (!scanFolderInfo.RecurseSubFolders())
+    ParallelDirectoryWalker walker(m_platformConfiguration, m_directorySnapshots, m_doScan, qMax(2, QThread::idealThreadCount()));
+    for (int idx = 0; idx < m_platformConfiguration->GetScanFolderCount(); idx++)
     {
-        entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files);
+        const ScanFolderInfo& scanFolderInfo = m_platformConfiguration->GetScanFolderAt(idx);
+        walker.AddRoot(scanFolderInfo.ScanPath(), scanFolderInfo.RecurseSubFolders());
     }
-    else
+
+    QThreadPool lanePool;
+    lanePool.setMaxThreadCount(walker.LaneCount());
+    for (int laneIndex = 0; laneIndex < walker.LaneCount(); ++laneIndex)
     {
-        entries = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Files);
+        lanePool.start(new DirectoryWalkerLane(walker, laneIndex));
     }
 
-    for (const QFileInfo& entry : entries)
+    QStringList files;
+    while (walker.WaitForFiles(files))
     {
-        if (!m_doScan) // scan was cancelled!
-        {
-            return;
-        }
-
-        QString absPath = entry.absoluteFilePath();
+        EmitFiles(files);
+        files.clear();
+    }
+    lanePool.waitForDone();
 
-        // Filtering out excluded files
-        if (m_platformConfiguration->IsFileExcluded(absPath))
-        {
-            continue;
-        }
+    if (!m_doScan)
+    {
+        // an incomplete walk can't tell us which directories are gone, so don't record anything.
+        return;
+    }
 
-        if (entry.isDir())
+    // anything we did not visit this time no longer exists (or is no longer scanned)
+    QStringList removedDirectories;
+    for (auto iter = m_directorySnapshots.begin(); iter != m_directorySnapshots.end(); )
+    {
+        if (!walker.m_visitedDirectories.contains(iter.key()))
         {
-            //Entry is a directory
-            ScanForSourceFiles(absPath);
+            removedDirectories.push_back(iter.key());
+            iter = m_directorySnapshots.erase(iter);
         }
         else
         {
-            // Filtering out metadata files as well, there is no need to send both the source file and the metadafiles 
-            // to the apm for analysis, just sending the source file should be enough
-            bool isMetaFile = false;
-            for (int idx = 0; idx < m_platformConfiguration->MetaDataFileTypesCount(); idx++)
-            {
-                QPair<QString, QString> metaInfo = m_platformConfiguration->GetMetaDataFileTypeAt(idx);
-                if (absPath.endsWith("." + metaInfo.first, Qt::CaseInsensitive))
-                {
-                    // its a meta file
-                    isMetaFile = true;
-                    break;
-                }
-            }
+            ++iter;
+        }
+    }
 
-            if (isMetaFile)
-            {
-                continue;
-            }
+    for (const DirectorySnapshotRecord& changed : walker.m_changedSnapshots)
+    {
+        m_directorySnapshots[changed.first] = changed.second;
+    }
 
-            //Entry is a file
-            m_fileList.insert(absPath);
-        }
+    m_reusedListings = walker.m_reusedListings;
+
+    AZ_TracePrintf(AssetProcessor::ConsoleChannel, "Scanned %i folders (%i unchanged listings reused) and found %i files.\n",
+        walker.m_visitedDirectories.size(), walker.m_reusedListings, m_fileList.size());
+
+    if (m_snapshotDatabase)
+    {
+        m_snapshotDatabase->UpdateDirectorySnapshots(walker.m_changedSnapshots, removedDirectories);
     }
 }
 
-void AssetScannerWorker::EmitFiles()
+void AssetScannerWorker::EmitFiles(const QStringList& files)
 {
-    //Loop over all source asset files and send them up the chain:
-    for (const QString& fileEntries : m_fileList)
+    //Loop over the batch of source asset files and send them up the chain:
+    for (const QString& fileEntry : files)
     {
         if (!m_doScan)
         {
             break;
         }
-        Q_EMIT FileOfInterestFound(fileEntries);
+
+        // scan folders can overlap, only report each file once.
+        if (m_fileList.contains(fileEntry))
+        {
+            continue;
+        }
+        m_fileList.insert(fileEntry);
+
+        Q_EMIT FileOfInterestFound(fileEntry);
     }
-    m_fileList.clear();
 }
 
 
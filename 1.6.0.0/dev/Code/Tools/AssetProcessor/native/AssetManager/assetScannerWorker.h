@@ -13,18 +13,24 @@
 #define ASSETSCANNERWORKER_H
 #include "native/assetprocessor.h"
 #include "assetScanFolderInfo.h"
+#include "native/AssetManager/AssetData.h"
+#include <AzCore/std/smart_ptr/shared_ptr.h>
 #include <QString>
 #include <QSet>
+#include <QHash>
 #include <QObject>
 
 namespace AssetProcessor
 {
     class PlatformConfiguration;
+    class DatabaseConnection;
 
     /** This Class is actually responsible for scanning the game folder
      * and finding file of interest files.
      * Its created on the main thread and then moved to the worker thread
      * so it should contain no QObject-based classes at construction time (it can make them later)
+     * The directory tree is walked by a pool of threads, and files are emitted in batches from the
+     * worker thread while the walk is still in progress.
      */
     class AssetScannerWorker
         : public QObject
@@ -33,6 +39,13 @@ namespace AssetProcessor
     public:
         explicit AssetScannerWorker(PlatformConfiguration* config, QObject* parent = 0);
 
+        //! Persist directory listings in the given database, so that directories which have not changed
+        //! since the previous run do not need to be listed again.  Must be called before the scan starts.
+        void SetSnapshotDatabase(AZStd::shared_ptr<DatabaseConnection> database);
+
+        //! How many directory listings the last completed scan took from the snapshots instead of listing the directory.
+        int GetReusedListingCount() const;
+
 Q_SIGNALS:
         void ScanningStateChanged(AssetProcessor::AssetScanningStatus status);
         void FileOfInterestFound(QString filepath);
@@ -42,13 +55,20 @@ Q_SIGNALS:
         void StopScan();
 
     protected:
-        void ScanForSourceFiles(ScanFolderInfo scanFolderInfo);
-        void EmitFiles();
+        void ScanForSourceFiles();
+        void EmitFiles(const QStringList& files);
 
     private:
+        void LoadDirectorySnapshots();
+
         volatile bool m_doScan = true;
         QSet<QString> m_fileList; // note:  neither QSet nor QString are qobject-derived
         PlatformConfiguration* m_platformConfiguration;
+
+        AZStd::shared_ptr<DatabaseConnection> m_snapshotDatabase;
+        bool m_snapshotsLoaded = false;
+        QHash<QString, DirectorySnapshot> m_directorySnapshots; // only touched by the worker thread outside of a scan
+        int m_reusedListings = 0;
     };
 } // end namespace AssetProcessor
 
@@ -28,6 +28,8 @@
 
 #include <AzFramework/Asset/AssetProcessorMessages.h>
 #include <AzCore/Serialization/Utils.h>
+#include <AzCore/IO/SystemFile.h> // for AZ_MAX_PATH_LEN
+#include <AzCore/std/algorithm.h>
 #include <AzCore/std/functional.h>
 #include <AzFramework/IO/LocalFileIO.h>
 #include <AzFramework/IO/FileOperations.h>
@@ -70,6 +72,7 @@ FileServer::FileServer(QObject* parent)
     m_bytesSent = 0;
     m_bytesReceived = 0;
     m_numOpenFiles = 0;
+    m_numReadAheadHits = 0;
 }
 
 FileServer::~FileServer()
@@ -230,6 +233,7 @@ void FileServer::ConnectionRemoved(unsigned int connId)
     }
 #endif
     m_fileIOs.remove(connId);
+    m_readAheadStates.remove(connId);
 }
 
 void FileServer::UpdateMetrics()
@@ -262,6 +266,7 @@ void FileServer::UpdateMetrics()
         Q_EMIT BytesSentChanged();
         Q_EMIT BytesReceivedChanged();
         Q_EMIT NumOpenFilesChanged();
+        Q_EMIT NumReadAheadHitsChanged();
 
         //update connections metrics
         Q_EMIT UpdateConnectionMetrics();
@@ -278,11 +283,17 @@ inline void FileServer::Send(unsigned int connId, unsigned int serial, const R&
     EBUS_EVENT_ID_RESULT(bytesSent, connId, AssetProcessor::ConnectionBus, Send, serial, response);
     m_bytesSent += bytesSent;
     AddBytesSent(connId, bytesSent, m_realtimeMetrics);
+    if (m_requestTimer.isValid())
+    {
+        AddRequestTime(connId, m_requestTimer.nsecsElapsed() / 1000, m_realtimeMetrics);
+        m_requestTimer.invalidate();
+    }
 }
 
 template <class R>
 inline bool FileServer::Recv(unsigned int connId, QByteArray payload, R& request)
 {
+    m_requestTimer.start();
     bool readFromStream = AZ::Utils::LoadObjectFromBufferInPlace(payload.data(), payload.size(), request);
     AZ_Assert(readFromStream, "FileServer::Recv: Could not deserialize from stream");
     if (readFromStream)
@@ -360,6 +371,12 @@ void FileServer::ProcessCloseRequest(unsigned int connId, unsigned int, unsigned
     auto fileIO = m_fileIOs[connId];
     RecordFileOp(fileIO.get(), "CLOSE", fileHandle, nullptr);
 
+    auto readAheadStates = m_readAheadStates.find(connId);
+    if (readAheadStates != m_readAheadStates.end())
+    {
+        readAheadStates.value().remove(fileHandle);
+    }
+
     AZ::IO::Result res = fileIO->Close(fileHandle);
     if (res)
     {
@@ -403,8 +420,12 @@ void FileServer::ProcessReadRequest(unsigned int connId, unsigned int, unsigned
     AZStd::string moreInfo = AZStd::string::format("%llu bytes", size);
     RecordFileOp(fileIO.get(), "READ", fileHandle, moreInfo.c_str());
 
-    AZ::IO::Result res = fileIO->Read(fileHandle, response.m_data.data(), response.m_data.size(), failOnFewerRead, &bytesRead);
-    response.m_resultCode = static_cast<uint32_t>(res.GetResultCode());
+    response.m_resultCode = ReadWithReadAhead(connId, fileIO.get(), fileHandle, reinterpret_cast<char*>(response.m_data.data()), response.m_data.size(), bytesRead);
+    if ((failOnFewerRead) && (bytesRead < size) && (response.m_resultCode == static_cast<uint32_t>(ResultCode::Success)))
+    {
+        // reads are gathered from the read ahead and the file, so the short read is only known once both are done
+        response.m_resultCode = static_cast<uint32_t>(ResultCode::Error);
+    }
     m_bytesRead += bytesRead;
 
     //if the read resulted in any size other than requested resize to the read size
@@ -423,6 +444,7 @@ void FileServer::ProcessReadRequest(unsigned int connId, unsigned int, unsigned
         Q_EMIT NumReadRequestsChanged();
         Q_EMIT BytesReceivedChanged();
         Q_EMIT BytesReadChanged();
+        Q_EMIT NumReadAheadHitsChanged();
     }
 }
 
@@ -445,9 +467,8 @@ void FileServer::ProcessWriteRequest(unsigned int connId, unsigned int, unsigned
     AZStd::string moreInfo = AZStd::string::format("%llu bytes", request.m_data.size());
     RecordFileOp(fileIO.get(), "WRITE", fileHandle, moreInfo.c_str());
 
-    AZ::IO::Result res = fileIO->Write(fileHandle, request.m_data.data(), static_cast<uint64_t>(request.m_data.size()), &bytesWritten);
-    uint32_t resultCode = static_cast<uint32_t>(res.GetResultCode());
-    if (res)
+    uint32_t resultCode = WriteWithReadAhead(connId, fileIO.get(), fileHandle, request.m_data.data(), request.m_data.size(), bytesWritten);
+    if (resultCode == static_cast<uint32_t>(ResultCode::Success))
     {
         m_bytesWritten += bytesWritten;
         AddBytesWritten(connId, bytesWritten, m_realtimeMetrics);
@@ -488,9 +509,7 @@ void FileServer::ProcessTellRequest(unsigned int connId, unsigned int, unsigned
     AZStd::string moreInfo = AZStd::string::format("offset: %llu", offset);
     RecordFileOp(fileIO.get(), "TELL", fileHandle, moreInfo.c_str());
 
-    AZ::IO::Result res = fileIO->Tell(fileHandle, offset);
-
-    uint32_t resultCode = static_cast<uint32_t>(res.GetResultCode());
+    uint32_t resultCode = TellWithReadAhead(connId, fileIO.get(), fileHandle, offset);
     FileTellResponse response(resultCode, offset);
 
     Send(connId, serial, response);
@@ -524,9 +543,7 @@ void FileServer::ProcessSeekRequest(unsigned int connId, unsigned int, unsigned
     AZStd::string moreInfo = AZStd::string::format("offset: %llu, mode: %d", offset, seekType);
     RecordFileOp(fileIO.get(), "SEEK", fileHandle, moreInfo.c_str());
 
-    AZ::IO::Result res = fileIO->Seek(fileHandle, offset, seekType);
-
-    uint32_t resultCode = static_cast<uint32_t>(res.GetResultCode());
+    uint32_t resultCode = SeekWithReadAhead(connId, fileIO.get(), fileHandle, offset, request.m_seekMode);
     FileSeekResponse response(resultCode);
     Send(connId, serial, response);
     AddSeekRequest(connId, m_realtimeMetrics);
@@ -717,8 +734,12 @@ void FileServer::ProcessFlushRequest(unsigned int connId, unsigned int, unsigned
     auto fileIO = m_fileIOs[connId];
     RecordFileOp(fileIO.get(), "FLUSH", fileHandle, nullptr);
 
-    AZ::IO::Result res = fileIO->Flush(fileHandle);
-    uint32_t resultCode = static_cast<uint32_t>(res.GetResultCode());
+    uint32_t resultCode = DiscardReadAhead(connId, fileIO.get(), fileHandle);
+    if (resultCode == static_cast<uint32_t>(ResultCode::Success))
+    {
+        AZ::IO::Result res = fileIO->Flush(fileHandle);
+        resultCode = static_cast<uint32_t>(res.GetResultCode());
+    }
     if (serial != 0)
     {
         FileFlushResponse response(resultCode);
@@ -937,6 +958,212 @@ void FileServer::ProcessFindFileNamesRequest(unsigned int connId, unsigned int,
     }
 }
 
+FileServer::ReadAheadState* FileServer::FindReadAheadState(unsigned int connId, AZ::IO::HandleType fileHandle)
+{
+    auto connectionStates = m_readAheadStates.find(connId);
+    if (connectionStates == m_readAheadStates.end())
+    {
+        return nullptr;
+    }
+    auto state = connectionStates.value().find(fileHandle);
+    if (state == connectionStates.value().end())
+    {
+        return nullptr;
+    }
+    return &state.value();
+}
+
+AZ::u64 FileServer::GetReadAheadBytes(unsigned int connId) const
+{
+    AZ::u64 bufferedBytes = 0;
+    auto connectionStates = m_readAheadStates.find(connId);
+    if (connectionStates != m_readAheadStates.end())
+    {
+        for (const ReadAheadState& state : connectionStates.value())
+        {
+            bufferedBytes += state.m_buffer.size();
+        }
+    }
+    return bufferedBytes;
+}
+
+AZ::u32 FileServer::ReadWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, char* output, AZ::u64 size, AZ::u64& bytesRead)
+{
+    ReadAheadState& state = m_readAheadStates[connId][fileHandle];
+    bytesRead = 0;
+
+    // serve what we can from the buffer, the file itself is positioned at its end
+    AZ::u64 bufferEnd = state.m_bufferOffset + state.m_buffer.size();
+    if (state.m_position < bufferEnd)
+    {
+        AZ::u64 available = AZStd::min<AZ::u64>(size, bufferEnd - state.m_position);
+        memcpy(output, state.m_buffer.constData() + (state.m_position - state.m_bufferOffset), available);
+        state.m_position += available;
+        bytesRead = available;
+        m_numReadAheadHits++;
+        AddBytesReadAhead(connId, available, m_realtimeMetrics);
+        if (state.m_position == bufferEnd)
+        {
+            // used up, the file is back at the client's position so there is nothing left worth holding on to
+            state.m_buffer.clear();
+        }
+    }
+
+    ++state.m_sequentialReads;
+    AZ::u64 remaining = size - bytesRead;
+    if (remaining == 0)
+    {
+        return static_cast<AZ::u32>(ResultCode::Success);
+    }
+
+    // the buffer was used up above, so the file position is the client's position again
+    if ((state.m_sequentialReads < s_readAheadMinSequentialReads) || (remaining >= s_readAheadSize)
+        || (GetReadAheadBytes(connId) + s_readAheadSize > s_readAheadMaxBytesPerConnection))
+    {
+        // random access, a read large enough that buffering it would only add a copy,
+        // or a client with so many partly read files that it has used up its share of memory
+        AZ::u64 directBytesRead = 0;
+        AZ::IO::Result res = fileIO->Read(fileHandle, output + bytesRead, remaining, false, &directBytesRead);
+        bytesRead += directBytesRead;
+        return static_cast<AZ::u32>(res.GetResultCode());
+    }
+
+    AZ::u64 fileOffset = 0;
+    AZ::IO::Result res = fileIO->Tell(fileHandle, fileOffset);
+    if (res)
+    {
+        AZ::u64 bufferedBytes = 0;
+        state.m_buffer.resize(static_cast<int>(s_readAheadSize));
+        res = fileIO->Read(fileHandle, state.m_buffer.data(), s_readAheadSize, false, &bufferedBytes);
+        state.m_buffer.resize(res ? static_cast<int>(bufferedBytes) : 0);
+    }
+    if (!res)
+    {
+        state.m_buffer.clear();
+        return static_cast<AZ::u32>(res.GetResultCode());
+    }
+
+    state.m_bufferOffset = fileOffset;
+    AZ::u64 available = AZStd::min<AZ::u64>(remaining, state.m_buffer.size());
+    memcpy(output + bytesRead, state.m_buffer.constData(), available);
+    state.m_position = fileOffset + available;
+    bytesRead += available;
+    if (available == static_cast<AZ::u64>(state.m_buffer.size()))
+    {
+        // the end of the file was inside this read
+        state.m_buffer.clear();
+    }
+    return static_cast<AZ::u32>(ResultCode::Success);
+}
+
+AZ::u32 FileServer::SeekWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, AZ::s64 offset, AZ::u32 seekMode)
+{
+    AZ::IO::SeekType seekType = static_cast<AZ::IO::SeekType>(seekMode);
+    ReadAheadState* state = FindReadAheadState(connId, fileHandle);
+    if ((!state) || (state->m_buffer.isEmpty()))
+    {
+        if (state)
+        {
+            state->m_sequentialReads = 0;
+        }
+        AZ::IO::Result res = fileIO->Seek(fileHandle, offset, seekType);
+        return static_cast<AZ::u32>(res.GetResultCode());
+    }
+
+    if (seekType != AZ::IO::SeekType::SeekFromEnd)
+    {
+        // seeks that stay inside the buffer only move the client's position, so skipping a few bytes keeps streaming
+        AZ::s64 target = (seekType == AZ::IO::SeekType::SeekFromCurrent) ? static_cast<AZ::s64>(state->m_position) + offset : offset;
+        AZ::s64 bufferEnd = static_cast<AZ::s64>(state->m_bufferOffset + state->m_buffer.size());
+        if ((target >= static_cast<AZ::s64>(state->m_bufferOffset)) && (target <= bufferEnd))
+        {
+            state->m_position = static_cast<AZ::u64>(target);
+            return static_cast<AZ::u32>(ResultCode::Success);
+        }
+
+        // the file is not where the client thinks it is, so relative seeks have to become absolute ones
+        offset = target;
+        seekType = AZ::IO::SeekType::SeekFromStart;
+    }
+
+    state->m_buffer.clear();
+    state->m_sequentialReads = 0;
+    AZ::IO::Result res = fileIO->Seek(fileHandle, offset, seekType);
+    return static_cast<AZ::u32>(res.GetResultCode());
+}
+
+AZ::u32 FileServer::TellWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, AZ::u64& offset)
+{
+    ReadAheadState* state = FindReadAheadState(connId, fileHandle);
+    if ((state) && (!state->m_buffer.isEmpty()))
+    {
+        offset = state->m_position;
+        return static_cast<AZ::u32>(ResultCode::Success);
+    }
+
+    AZ::IO::Result res = fileIO->Tell(fileHandle, offset);
+    return static_cast<AZ::u32>(res.GetResultCode());
+}
+
+AZ::u32 FileServer::DiscardReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle)
+{
+    ReadAheadState* state = FindReadAheadState(connId, fileHandle);
+    if (!state)
+    {
+        return static_cast<AZ::u32>(ResultCode::Success);
+    }
+
+    bool moved = state->m_position < state->m_bufferOffset + state->m_buffer.size();
+    state->m_buffer.clear();
+    state->m_sequentialReads = 0;
+    if (moved)
+    {
+        AZ::IO::Result res = fileIO->Seek(fileHandle, static_cast<AZ::s64>(state->m_position), AZ::IO::SeekType::SeekFromStart);
+        return static_cast<AZ::u32>(res.GetResultCode());
+    }
+    return static_cast<AZ::u32>(ResultCode::Success);
+}
+
+AZ::u32 FileServer::WriteWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, const void* data, AZ::u64 size, AZ::u64& bytesWritten)
+{
+    bytesWritten = 0;
+    AZ::u32 resultCode = DiscardReadAhead(connId, fileIO, fileHandle);
+    if (resultCode != static_cast<AZ::u32>(ResultCode::Success))
+    {
+        return resultCode;
+    }
+
+    // other handles of this client may have read ahead of the bytes being written
+    auto connectionStates = m_readAheadStates.find(connId);
+    if (connectionStates != m_readAheadStates.end())
+    {
+        char writtenFile[AZ_MAX_PATH_LEN];
+        bool haveWrittenFile = fileIO->GetFilename(fileHandle, writtenFile, sizeof(writtenFile));
+        for (auto state = connectionStates.value().begin(); state != connectionStates.value().end(); ++state)
+        {
+            if ((state.key() == fileHandle) || (state.value().m_buffer.isEmpty()))
+            {
+                continue;
+            }
+
+            // without a name to compare, assume the worst. case is ignored, as it is by the Windows and OS X file systems.
+            char bufferedFile[AZ_MAX_PATH_LEN];
+            if ((haveWrittenFile) && (fileIO->GetFilename(state.key(), bufferedFile, sizeof(bufferedFile)))
+                && (QString::compare(QDir::cleanPath(writtenFile), QDir::cleanPath(bufferedFile), Qt::CaseInsensitive) != 0))
+            {
+                continue;
+            }
+
+            // there is no request to report a failure on, the handle's next read would start where its buffer ended
+            AZ::u32 discarded = DiscardReadAhead(connId, fileIO, state.key());
+            AZ_Warning("FileServer", discarded == static_cast<AZ::u32>(ResultCode::Success), "Failed to move file handle %u back after its read ahead went stale", state.key());
+        }
+    }
+
+    AZ::IO::Result res = fileIO->Write(fileHandle, data, size, &bytesWritten);
+    return static_cast<AZ::u32>(res.GetResultCode());
+}
+
 void FileServer::RecordFileOp(AZ::IO::FileIOBase* fileIO, const char* op, const AZ::IO::HandleType& fileHandle, const char* moreInfo)
 {
     (void)fileIO;
@@ -16,6 +16,7 @@
 #include <QDir>
 #include <QString>
 #include <QHash>
+#include <QElapsedTimer>
 
 #include <memory>
 
@@ -69,6 +70,7 @@ class FileServer
     Q_PROPERTY(qint64 bytesSent MEMBER m_bytesSent NOTIFY BytesSentChanged)
     Q_PROPERTY(qint64 bytesReceived MEMBER m_bytesReceived NOTIFY BytesReceivedChanged)
     Q_PROPERTY(qint64 numOpenFiles MEMBER m_numOpenFiles NOTIFY NumOpenFilesChanged)
+    Q_PROPERTY(qint64 numReadAheadHits MEMBER m_numReadAheadHits NOTIFY NumReadAheadHitsChanged)
 
 Q_SIGNALS:
     void RootFolderChanged();
@@ -100,6 +102,7 @@ Q_SIGNALS:
     void BytesSentChanged();
     void BytesReceivedChanged();
     void NumOpenFilesChanged();
+    void NumReadAheadHitsChanged();
 
     //per connection metrics
     void AddBytesReceived(unsigned int connId, qint64 add, bool update);
@@ -126,6 +129,8 @@ Q_SIGNALS:
     void AddCopyRequest(unsigned int connId, bool update);
     void AddRenameRequest(unsigned int connId, bool update);
     void AddFindFileNamesRequest(unsigned int connId, bool update);
+    void AddBytesReadAhead(unsigned int connId, qint64 add, bool update);
+    void AddRequestTime(unsigned int connId, qint64 microseconds, bool update);
 
     void UpdateBytesReceived(unsigned int connId);
     void UpdateBytesSent(unsigned int connId);
@@ -202,7 +207,36 @@ protected:
     //! So we only create a cache folder for VFS-based runs.
     void EnsureCacheFolderExists(int connId);
 
+    //! Reads are served from a per handle read ahead buffer once a handle has been read sequentially a few times,
+    //! so a file streamed in small reads costs one disk read per s_readAheadSize bytes. The client still makes one
+    //! round trip per read, saving those needs read ahead in its RemoteFileIO.
+    //! While the buffer holds data the file itself is positioned at the end of it, anything that depends on the
+    //! file position has to go through these.  They return AZ::IO::ResultCode values, as the responses carry them.
+    AZ::u32 ReadWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, char* output, AZ::u64 size, AZ::u64& bytesRead);
+    AZ::u32 SeekWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, AZ::s64 offset, AZ::u32 seekMode);
+    AZ::u32 TellWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, AZ::u64& offset);
+    //! Moves the file back to where the client expects it and drops the read ahead data
+    AZ::u32 DiscardReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle);
+    //! Also drops what other handles of the connection have read ahead of the same file
+    AZ::u32 WriteWithReadAhead(unsigned int connId, AZ::IO::FileIOBase* fileIO, AZ::IO::HandleType fileHandle, const void* data, AZ::u64 size, AZ::u64& bytesWritten);
+    //! Bytes currently held in the read ahead buffers of a connection
+    AZ::u64 GetReadAheadBytes(unsigned int connId) const;
+
+    static const AZ::u64 s_readAheadSize = 256 * 1024;
+    static const int s_readAheadMinSequentialReads = 2;
+    // buffers are freed once read, this only bounds clients which keep many files partly read
+    static const AZ::u64 s_readAheadMaxBytesPerConnection = 8 * s_readAheadSize;
+
 private:
+    struct ReadAheadState
+    {
+        QByteArray m_buffer;
+        AZ::u64 m_bufferOffset = 0; // file offset of the first byte in m_buffer
+        AZ::u64 m_position = 0; // the client's file offset, only meaningful while m_buffer holds data
+        int m_sequentialReads = 0; // reads since the handle was last moved or written
+    };
+    ReadAheadState* FindReadAheadState(unsigned int connId, AZ::IO::HandleType fileHandle);
+
     //metrics
     qint64 m_numOpenRequests;
     qint64 m_numCloseRequests;
@@ -229,6 +263,10 @@ private:
     qint64 m_bytesSent;
     qint64 m_bytesReceived;
     qint64 m_numOpenFiles;
+    qint64 m_numReadAheadHits;
+
+    // started when a request is received and read when its response is sent, requests are handled one at a time
+    QElapsedTimer m_requestTimer;
 
     //root
     QString m_displayRoot;
@@ -237,6 +275,8 @@ private:
 
     // maps connection ID -> LocalFileIO
     QHash<unsigned int, std::shared_ptr<AZ::IO::FileIOBase> > m_fileIOs;
+    // maps connection ID -> file handle -> read ahead
+    QHash<unsigned int, QHash<AZ::IO::HandleType, ReadAheadState> > m_readAheadStates;
 
 #if defined(AZ_PLATFORM_WINDOWS)
     QHash<unsigned int, HANDLE> m_locks;
@@ -13,6 +13,36 @@
 
 #if defined(_WIN32)
 #include <Windows.h>
+#elif defined(AZ_PLATFORM_LINUX)
+// note: the AssetProcessor targets in the wscript only build for win and darwin, so nothing compiles this backend yet.
+// it has not been built or run, enable and test it together with a linux AssetProcessor target.
+#include <AzCore/Debug/Trace.h>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace
+{
+    // changes are collected until nothing new has arrived for this long...
+    const qint64 s_debounceMs = 10;
+    // ...but a batch is never held back longer than this, so a steady stream of changes still gets through quickly.
+    const qint64 s_maxBatchLatencyMs = 50;
+    // how often folders which could not be watched (because the watch limit was reached) are polled for changes instead.
+    const qint64 s_pollIntervalMs = 1000;
+
+    const uint32_t s_watchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+    bool IsSameOrSubPath(const QString& path, const QString& folder)
+    {
+        return (path == folder) || ((path.startsWith(folder)) && (path.length() > folder.length()) && (path.at(folder.length()) == QChar('/')));
+    }
+}
 #endif
 
 //////////////////////////////////////////////////////////////////////////////
@@ -24,6 +54,8 @@ FolderRootWatch::FolderRootWatch(const QString rootFolder)
 #if defined(_WIN32)
     m_directoryHandle = nullptr;
     m_ioHandle = nullptr;
+#elif defined(AZ_PLATFORM_LINUX)
+    m_inotifyHandle = -1;
 #endif
 }
 
@@ -47,6 +79,31 @@ bool FolderRootWatch::Start()
             return true;
         }
     }
+#elif defined(AZ_PLATFORM_LINUX)
+    QString rootFolder = QDir::cleanPath(m_root);
+    if (!QFileInfo(rootFolder).isDir())
+    {
+        return false;
+    }
+
+    m_inotifyHandle = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyHandle < 0)
+    {
+        // too many inotify instances are in use on this machine, but we can still poll.
+        AZ_Warning("FileWatcher", false, "Unable to create an inotify instance (%s), %s will be polled for changes instead.\n", strerror(errno), rootFolder.toUtf8().constData());
+        m_unwatchedFolders.push_back(rootFolder);
+    }
+    else
+    {
+        AddWatchesRecursively(rootFolder);
+    }
+
+    // take the baseline that polled folders will be compared against.
+    PollUnwatchedFolders(false);
+
+    m_shutdownThreadSignal = false;
+    m_thread = std::thread(std::bind(&FolderRootWatch::WatchFolderLoop, this));
+    return true;
 #endif
     return false;
 }
@@ -67,6 +124,18 @@ void FolderRootWatch::Stop()
 #if defined(_WIN32)
     CloseHandle(m_directoryHandle);
     m_directoryHandle = nullptr;
+#elif defined(AZ_PLATFORM_LINUX)
+    // the watch thread wakes up at least every s_pollIntervalMs to check the shutdown signal, so it is safe to close this after joining.
+    if (m_inotifyHandle >= 0)
+    {
+        ::close(m_inotifyHandle);
+        m_inotifyHandle = -1;
+    }
+    m_watchedFolders.clear();
+    m_unwatchedFolders.clear();
+    m_pollSnapshot.clear();
+    m_pendingChanges.clear();
+    m_pendingChangeIndex.clear();
 #endif
 }
 
@@ -137,9 +206,288 @@ void FolderRootWatch::WatchFolderLoop()
             }
         }
     }
+#elif defined(AZ_PLATFORM_LINUX)
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lastEventTime = 0;
+    qint64 batchStartTime = 0;
+    qint64 nextPollTime = s_pollIntervalMs;
+
+    while (!m_shutdownThreadSignal)
+    {
+        // sleep until there is something to read, the current burst is over, or it is time to poll.
+        qint64 now = timer.elapsed();
+        qint64 timeout = m_unwatchedFolders.isEmpty() ? s_pollIntervalMs : qMax<qint64>(0, nextPollTime - now);
+        if (!m_pendingChanges.isEmpty())
+        {
+            timeout = qMin(timeout, qMax<qint64>(0, qMin(lastEventTime + s_debounceMs, batchStartTime + s_maxBatchLatencyMs) - now));
+        }
+
+        struct pollfd pollHandle;
+        pollHandle.fd = m_inotifyHandle;
+        pollHandle.events = POLLIN;
+        pollHandle.revents = 0;
+        int ready = ::poll(&pollHandle, m_inotifyHandle >= 0 ? 1 : 0, static_cast<int>(timeout));
+
+        if (m_shutdownThreadSignal)
+        {
+            break;
+        }
+
+        if ((ready > 0) && (pollHandle.revents & POLLIN))
+        {
+            bool wasEmpty = m_pendingChanges.isEmpty();
+            ProcessInotifyEvents();
+            lastEventTime = timer.elapsed();
+            if ((wasEmpty) && (!m_pendingChanges.isEmpty()))
+            {
+                batchStartTime = lastEventTime;
+            }
+        }
+
+        now = timer.elapsed();
+        if ((!m_unwatchedFolders.isEmpty()) && (now >= nextPollTime))
+        {
+            if (m_pendingChanges.isEmpty())
+            {
+                batchStartTime = now;
+            }
+            PollUnwatchedFolders(true);
+            nextPollTime = now + s_pollIntervalMs;
+        }
+
+        if ((!m_pendingChanges.isEmpty()) && ((now - lastEventTime >= s_debounceMs) || (now - batchStartTime >= s_maxBatchLatencyMs)))
+        {
+            FlushPendingChanges();
+        }
+    }
 #endif
 }
 
+#if defined(AZ_PLATFORM_LINUX)
+void FolderRootWatch::AddWatchesRecursively(const QString& folder)
+{
+    int watchHandle = ::inotify_add_watch(m_inotifyHandle, folder.toUtf8().constData(), s_watchMask);
+    if (watchHandle < 0)
+    {
+        if (errno == ENOSPC)
+        {
+            // fs.inotify.max_user_watches has been reached.  Rather than miss changes, poll this part of the tree.
+            AZ_Warning("FileWatcher", !m_unwatchedFolders.isEmpty(), "The inotify watch limit has been reached, parts of %s will be polled for changes instead.  "
+                "Raise fs.inotify.max_user_watches for faster change detection.\n", m_root.toUtf8().constData());
+            m_unwatchedFolders.push_back(folder);
+        }
+        // otherwise its not a folder any more, or it was already removed.
+        return;
+    }
+
+    m_watchedFolders[watchHandle] = folder;
+
+    QDirIterator subFolders(folder, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (subFolders.hasNext())
+    {
+        AddWatchesRecursively(subFolders.next());
+    }
+}
+
+void FolderRootWatch::RemoveWatchesUnder(const QString& folder)
+{
+    for (auto watchIter = m_watchedFolders.begin(); watchIter != m_watchedFolders.end(); )
+    {
+        if (IsSameOrSubPath(watchIter.value(), folder))
+        {
+            ::inotify_rm_watch(m_inotifyHandle, watchIter.key());
+            watchIter = m_watchedFolders.erase(watchIter);
+        }
+        else
+        {
+            ++watchIter;
+        }
+    }
+
+    for (auto unwatchedIter = m_unwatchedFolders.begin(); unwatchedIter != m_unwatchedFolders.end(); )
+    {
+        if (IsSameOrSubPath(*unwatchedIter, folder))
+        {
+            unwatchedIter = m_unwatchedFolders.erase(unwatchedIter);
+        }
+        else
+        {
+            ++unwatchedIter;
+        }
+    }
+
+    for (auto snapshotIter = m_pollSnapshot.begin(); snapshotIter != m_pollSnapshot.end(); )
+    {
+        if (IsSameOrSubPath(snapshotIter.key(), folder))
+        {
+            snapshotIter = m_pollSnapshot.erase(snapshotIter);
+        }
+        else
+        {
+            ++snapshotIter;
+        }
+    }
+}
+
+void FolderRootWatch::ProcessInotifyEvents()
+{
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    while (true)
+    {
+        ssize_t bytesRead = ::read(m_inotifyHandle, buffer, sizeof(buffer));
+        if (bytesRead <= 0)
+        {
+            // EAGAIN, we've drained everything that is available.
+            return;
+        }
+
+        for (char* cursor = buffer; cursor < buffer + bytesRead; )
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // the kernel dropped events, so we don't know what changed.  Rebuild the watches (folders may have been
+                // created that we never heard about) and report the root as added, which makes the AssetProcessorManager
+                // rescan it.  That rescan compares fingerprints, so only files which really changed get processed.
+                AZ_TracePrintf("FileWatcher", "inotify event queue overflowed, rescanning %s.\n", m_root.toUtf8().constData());
+                QString rootFolder = QDir::cleanPath(m_root);
+                RemoveWatchesUnder(rootFolder);
+                AddWatchesRecursively(rootFolder);
+                PollUnwatchedFolders(false);
+                AddPendingChange(rootFolder, FileAction::FileAction_Added);
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // the folder was removed, or we removed the watch ourselves.
+                m_watchedFolders.remove(event->wd);
+                continue;
+            }
+
+            auto watchIter = m_watchedFolders.find(event->wd);
+            if ((watchIter == m_watchedFolders.end()) || (event->len == 0))
+            {
+                continue;
+            }
+
+            QString folder = watchIter.value();
+            QString path = folder + QChar('/') + QString::fromUtf8(event->name);
+            bool isFolder = (event->mask & IN_ISDIR) != 0;
+
+            FileAction action = FileAction::FileAction_None;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                action = FileAction::FileAction_Added;
+                if (isFolder)
+                {
+                    // note that anything created inside of it before the watch is added is found by whoever handles the folder
+                    // being added, the same as when a folder is moved in.
+                    AddWatchesRecursively(path);
+                }
+            }
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                action = FileAction::FileAction_Removed;
+                if (isFolder)
+                {
+                    RemoveWatchesUnder(path);
+                }
+            }
+            else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+            {
+                action = FileAction::FileAction_Modified;
+            }
+
+            if (action != FileAction::FileAction_None)
+            {
+                AddPendingChange(path, action);
+
+                if (action != FileAction::FileAction_Modified)
+                {
+                    // ReadDirectoryChangesW reports the containing folder as modified when its entries change, do the same.
+                    AddPendingChange(folder, FileAction::FileAction_Modified);
+                }
+            }
+        }
+    }
+}
+
+void FolderRootWatch::AddPendingChange(const QString& path, FileAction action)
+{
+    // bursts (a save writes a file many times, a sync touches it twice) collapse into one change, but a file
+    // which is added and then removed is still reported in that order.
+    auto pendingIter = m_pendingChangeIndex.find(path);
+    if ((pendingIter != m_pendingChangeIndex.end()) && (m_pendingChanges[pendingIter.value()].m_action == action))
+    {
+        return;
+    }
+
+    FileChangeInfo info;
+    info.m_filePath = QDir::toNativeSeparators(path);
+    info.m_action = action;
+    m_pendingChangeIndex[path] = m_pendingChanges.size();
+    m_pendingChanges.push_back(info);
+}
+
+void FolderRootWatch::FlushPendingChanges()
+{
+    for (const FileChangeInfo& info : m_pendingChanges)
+    {
+        bool invoked = QMetaObject::invokeMethod(m_fileWatcher, "AnyFileChange", Qt::QueuedConnection, Q_ARG(FileChangeInfo, info));
+        Q_ASSERT(invoked);
+    }
+    m_pendingChanges.clear();
+    m_pendingChangeIndex.clear();
+}
+
+void FolderRootWatch::PollUnwatchedFolders(bool reportChanges)
+{
+    // an incremental scan of the folders we could not watch: compare what is there now with what was there last time.
+    QHash<QString, QPair<qint64, qint64> > currentSnapshot;
+    for (const QString& folder : m_unwatchedFolders)
+    {
+        QDirIterator entries(folder, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+        while (entries.hasNext())
+        {
+            entries.next();
+            QFileInfo info = entries.fileInfo();
+            currentSnapshot.insert(info.absoluteFilePath(), qMakePair(info.lastModified().toMSecsSinceEpoch(), info.isDir() ? 0 : info.size()));
+        }
+    }
+
+    if (reportChanges)
+    {
+        for (auto currentIter = currentSnapshot.begin(); currentIter != currentSnapshot.end(); ++currentIter)
+        {
+            auto previousIter = m_pollSnapshot.find(currentIter.key());
+            if (previousIter == m_pollSnapshot.end())
+            {
+                AddPendingChange(currentIter.key(), FileAction::FileAction_Added);
+            }
+            else if (previousIter.value() != currentIter.value())
+            {
+                AddPendingChange(currentIter.key(), FileAction::FileAction_Modified);
+            }
+        }
+
+        for (auto previousIter = m_pollSnapshot.begin(); previousIter != m_pollSnapshot.end(); ++previousIter)
+        {
+            if (!currentSnapshot.contains(previousIter.key()))
+            {
+                AddPendingChange(previousIter.key(), FileAction::FileAction_Removed);
+            }
+        }
+    }
+
+    m_pollSnapshot.swap(currentSnapshot);
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 /// FileWatcher
 FileWatcher::FileWatcher()
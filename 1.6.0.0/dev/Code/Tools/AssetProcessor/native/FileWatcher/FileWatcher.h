@@ -18,6 +18,9 @@
 #include <QMap>
 #include <QVector>
 #include <QString>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
 
 #include <thread>
 
@@ -50,6 +53,15 @@ public Q_SLOTS:
 private:
     void WatchFolderLoop();
 
+#if defined(AZ_PLATFORM_LINUX)
+    void AddWatchesRecursively(const QString& folder);
+    void RemoveWatchesUnder(const QString& folder);
+    void ProcessInotifyEvents();
+    void AddPendingChange(const QString& path, FileAction action);
+    void FlushPendingChanges();
+    void PollUnwatchedFolders(bool reportChanges);
+#endif
+
 private:
     std::thread m_thread;
     QString m_root;
@@ -60,6 +72,13 @@ private:
 #if defined(_WIN32)
     HANDLE m_directoryHandle;
     HANDLE m_ioHandle;
+#elif defined(AZ_PLATFORM_LINUX)
+    int m_inotifyHandle;
+    QHash<int, QString> m_watchedFolders; // inotify watch descriptor to folder path
+    QStringList m_unwatchedFolders; // folders we could not get a watch for, which are polled instead
+    QHash<QString, QPair<qint64, qint64> > m_pollSnapshot; // path to (modification time, size) for everything under m_unwatchedFolders
+    QVector<FileChangeInfo> m_pendingChanges; // changes waiting for the burst they are part of to end
+    QHash<QString, int> m_pendingChangeIndex; // path to the index of its latest change in m_pendingChanges
 #endif
 };
 
@@ -54,6 +54,10 @@ Connection::Connection(AssetProcessor::PlatformConfiguration* config, bool inPro
     m_bytesSent = 0;
     m_bytesReceived = 0;
     m_numOpenFiles = 0;
+    m_bytesReadAhead = 0;
+    m_numTimedRequests = 0;
+    m_requestTime = 0;
+    m_maxRequestTime = 0;
 
     //connection
     m_identifier = "";//empty
@@ -153,6 +157,11 @@ QString Connection::Elapsed() const
     return m_elapsedDisplay;
 }
 
+qint64 Connection::AverageRequestTime() const
+{
+    return m_numTimedRequests ? m_requestTime / m_numTimedRequests : 0;
+}
+
 void Connection::SetIpAddress(QString ipAddress)
 {
     if (Status() == Connected)
@@ -680,6 +689,26 @@ void Connection::AddFindFileNamesRequest(bool update)
     }
 }
 
+void Connection::AddBytesReadAhead(qint64 add, bool update)
+{
+    m_bytesReadAhead += add;
+    if (update)
+    {
+        Q_EMIT BytesReadAheadChanged();
+    }
+}
+
+void Connection::AddRequestTime(qint64 microseconds, bool update)
+{
+    m_numTimedRequests++;
+    m_requestTime += microseconds;
+    m_maxRequestTime = qMax(m_maxRequestTime, microseconds);
+    if (update)
+    {
+        Q_EMIT RequestTimeChanged();
+    }
+}
+
 void Connection::UpdateBytesReceived()
 {
     Q_EMIT BytesReceivedChanged();
@@ -805,6 +834,16 @@ void Connection::UpdateFindFileNamesRequest()
     Q_EMIT NumFindFileNamesRequestsChanged();
 }
 
+void Connection::UpdateBytesReadAhead()
+{
+    Q_EMIT BytesReadAheadChanged();
+}
+
+void Connection::UpdateRequestTime()
+{
+    Q_EMIT RequestTimeChanged();
+}
+
 void Connection::UpdateMetrics()
 {
     UpdateBytesReceived();
@@ -832,6 +871,8 @@ void Connection::UpdateMetrics()
     UpdateCopyRequest();
     UpdateRenameRequest();
     UpdateFindFileNamesRequest();
+    UpdateBytesReadAhead();
+    UpdateRequestTime();
 }
 
 size_t Connection::Send(unsigned int serial, const AzFramework::AssetSystem::BaseAssetProcessorMessage& message)
@@ -74,6 +74,9 @@ class Connection
     Q_PROPERTY(qint64 bytesSent MEMBER m_bytesSent NOTIFY BytesSentChanged)
     Q_PROPERTY(qint64 bytesReceived MEMBER m_bytesReceived NOTIFY BytesReceivedChanged)
     Q_PROPERTY(qint64 numOpenFiles MEMBER m_numOpenFiles NOTIFY NumOpenFilesChanged)
+    Q_PROPERTY(qint64 bytesReadAhead MEMBER m_bytesReadAhead NOTIFY BytesReadAheadChanged)
+    Q_PROPERTY(qint64 averageRequestTime READ AverageRequestTime NOTIFY RequestTimeChanged)
+    Q_PROPERTY(qint64 maxRequestTime MEMBER m_maxRequestTime NOTIFY RequestTimeChanged)
 
 public:
     explicit Connection(AssetProcessor::PlatformConfiguration* platformConfig = nullptr, bool inProxyMode = false, qintptr socketDescriptor = -1, QString proxyInfo = QString(), int defaultProxyPort = -1, QObject* parent = 0);
@@ -96,6 +99,8 @@ public:
     bool AutoConnect() const;
     QString DisplayName() const;
     QString Elapsed() const;
+    //! Microseconds the file server takes from receiving a request to sending its response
+    qint64 AverageRequestTime() const;
 
     bool InitiatedConnection() const;
 
@@ -130,6 +135,8 @@ public:
     void AddCopyRequest(bool update);
     void AddRenameRequest(bool update);
     void AddFindFileNamesRequest(bool update);
+    void AddBytesReadAhead(qint64 add, bool update);
+    void AddRequestTime(qint64 microseconds, bool update);
 
     void UpdateBytesReceived();
     void UpdateBytesSent();
@@ -156,6 +163,8 @@ public:
     void UpdateCopyRequest();
     void UpdateRenameRequest();
     void UpdateFindFileNamesRequest();
+    void UpdateBytesReadAhead();
+    void UpdateRequestTime();
 
     void UpdateMetrics();
 
@@ -214,6 +223,8 @@ Q_SIGNALS:
     void BytesSentChanged();
     void BytesReceivedChanged();
     void NumOpenFilesChanged();
+    void BytesReadAheadChanged();
+    void RequestTimeChanged();
 
 public Q_SLOTS:
     void SetIdentifier(QString Identifier);
@@ -281,6 +292,10 @@ private:
     qint64 m_bytesSent;
     qint64 m_bytesReceived;
     qint64 m_numOpenFiles;
+    qint64 m_bytesReadAhead; // bytes the file server answered from its read ahead instead of the disk
+    qint64 m_numTimedRequests;
+    qint64 m_requestTime; // total, in microseconds
+    qint64 m_maxRequestTime;
     Q_DISABLE_COPY(Connection)
 };
 
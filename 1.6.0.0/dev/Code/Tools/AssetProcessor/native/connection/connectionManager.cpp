@@ -664,6 +664,24 @@ void ConnectionManager::AddFindFileNamesRequest(unsigned int connId, bool update
     }
 }
 
+void ConnectionManager::AddBytesReadAhead(unsigned int connId, qint64 add, bool update)
+{
+    auto iter = m_connectionMap.find(connId);
+    if (iter != m_connectionMap.end())
+    {
+        iter.value()->AddBytesReadAhead(add, update);
+    }
+}
+
+void ConnectionManager::AddRequestTime(unsigned int connId, qint64 microseconds, bool update)
+{
+    auto iter = m_connectionMap.find(connId);
+    if (iter != m_connectionMap.end())
+    {
+        iter.value()->AddRequestTime(microseconds, update);
+    }
+}
+
 void ConnectionManager::UpdateBytesReceived(unsigned int connId)
 {
     auto iter = m_connectionMap.find(connId);
@@ -137,6 +137,8 @@ public Q_SLOTS:
     void AddCopyRequest(unsigned int connId, bool update);
     void AddRenameRequest(unsigned int connId, bool update);
     void AddFindFileNamesRequest(unsigned int connId, bool update);
+    void AddBytesReadAhead(unsigned int connId, qint64 add, bool update);
+    void AddRequestTime(unsigned int connId, qint64 microseconds, bool update);
 
     void UpdateBytesReceived(unsigned int connId);
     void UpdateBytesSent(unsigned int connId);
@@ -0,0 +1,347 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include <native/resourcecompiler/RCJobQueue.h>
+#include "rcjoblistmodel.h"
+#include "rcjob.h"
+#include "native/assetprocessor.h"
+
+namespace AssetProcessor
+{
+    RCJobQueue::RCJobQueue(QObject* parent)
+        : QObject(parent)
+    {
+    }
+
+    void RCJobQueue::AttachToModel(RCJobListModel* target)
+    {
+        if (m_sourceModel)
+        {
+            BusDisconnect();
+            disconnect(m_sourceModel, nullptr, this, nullptr);
+            m_heap.clear();
+            m_heapIndex.clear();
+            m_jobsByElement.clear();
+        }
+
+        m_sourceModel = target;
+
+        if (target)
+        {
+            BusConnect();
+            connect(target, &RCJobListModel::JobQueued, this, &RCJobQueue::OnJobQueued);
+            connect(target, &RCJobListModel::JobDequeued, this, &RCJobQueue::OnJobDequeued);
+
+            for (int jobIndex = 0; jobIndex < target->itemCount(); ++jobIndex)
+            {
+                RCJob* job = target->getItem(jobIndex);
+                if (job->GetState() == RCJob::pending)
+                {
+                    Push(job);
+                }
+            }
+        }
+    }
+
+    RCJob* RCJobQueue::GetNextPendingJob()
+    {
+        // jobs leave the queue when the model tells us they were started, this only guards against a job whose
+        // state was changed behind the model's back.
+        while (!m_heap.isEmpty())
+        {
+            RCJob* job = m_heap.front().m_job;
+            if (job->GetState() == RCJob::pending)
+            {
+                return job;
+            }
+            Remove(job);
+        }
+        // there are no jobs to do.
+        return nullptr;
+    }
+
+    int RCJobQueue::GetPendingJobCount() const
+    {
+        return m_heap.size();
+    }
+
+    bool RCJobQueue::IsBefore(const QueueEntry& left, const QueueEntry& right)
+    {
+        // first thing to check is in platform.
+        if (left.m_platformConnected != right.m_platformConnected)
+        {
+            return left.m_platformConnected;
+        }
+
+        // critical jobs take priority
+        if (left.m_critical != right.m_critical)
+        {
+            return left.m_critical;
+        }
+
+        // sync compile jobs take priority, the higher the serial the more recent the request and the sooner we want to do it
+        if (left.m_syncRequest != right.m_syncRequest)
+        {
+            return left.m_syncRequest > right.m_syncRequest;
+        }
+
+        if (left.m_asyncRequest != right.m_asyncRequest)
+        {
+            return left.m_asyncRequest > right.m_asyncRequest;
+        }
+
+        // arbitrarily, lets have PC get done first since pc-format assets are what the editor uses.
+        if (left.m_pcPlatform != right.m_pcPlatform)
+        {
+            return left.m_pcPlatform;
+        }
+
+        // a heap needs a strict order, so jobs without a priority (any negative value) all rank below jobs with one
+        int priorityLeft = left.m_priority < 0 ? -1 : left.m_priority;
+        int priorityRight = right.m_priority < 0 ? -1 : right.m_priority;
+        if (priorityLeft != priorityRight)
+        {
+            return priorityLeft > priorityRight;
+        }
+
+        // if we get all the way down here it means we're dealing with two assets which are not
+        // in any compile groups, not a priority platform, not a priority type, priority platform, etc.
+        // we can arrange these any way we want, but must pick at least a stable order.
+        if (left.m_jobID != right.m_jobID)
+        {
+            return left.m_jobID < right.m_jobID;
+        }
+        return left.m_job < right.m_job;
+    }
+
+    qint64 RCJobQueue::GetLatestRequest(const QHash<AssetProcessor::QueueElementID, QVector<qint64> >& requests, const AssetProcessor::QueueElementID& target) const
+    {
+        auto found = requests.find(target);
+        if ((found == requests.end()) || (found.value().isEmpty()))
+        {
+            return 0;
+        }
+        return found.value().back();
+    }
+
+    void RCJobQueue::RefreshRequests(const AssetProcessor::QueueElementID& target)
+    {
+        qint64 syncRequest = GetLatestRequest(m_activeSyncCompileRequests, target);
+        qint64 asyncRequest = GetLatestRequest(m_activeAsyncCompileRequests, target);
+
+        for (auto found = m_jobsByElement.find(target); (found != m_jobsByElement.end()) && (found.key() == target); ++found)
+        {
+            int heapIndex = m_heapIndex.value(found.value(), -1);
+            if (heapIndex < 0)
+            {
+                continue;
+            }
+            QueueEntry& entry = m_heap[heapIndex];
+            if ((entry.m_syncRequest != syncRequest) || (entry.m_asyncRequest != asyncRequest))
+            {
+                entry.m_syncRequest = syncRequest;
+                entry.m_asyncRequest = asyncRequest;
+                Update(heapIndex);
+            }
+        }
+    }
+
+    void RCJobQueue::Push(RCJob* job)
+    {
+        if (m_heapIndex.contains(job))
+        {
+            return;
+        }
+
+        const QueueElementID& elementID = job->GetElementID();
+        QString platform = job->GetPlatform();
+
+        QueueEntry entry;
+        entry.m_job = job;
+        entry.m_jobID = job->jobID();
+        entry.m_syncRequest = GetLatestRequest(m_activeSyncCompileRequests, elementID);
+        entry.m_asyncRequest = GetLatestRequest(m_activeAsyncCompileRequests, elementID);
+        entry.m_priority = job->GetPriority();
+        entry.m_platformConnected = m_currentlyConnectedPlatforms.contains(platform);
+        entry.m_critical = job->IsCritical();
+        entry.m_pcPlatform = (platform == "pc");
+
+        m_jobsByElement.insert(elementID, job);
+        m_heap.push_back(entry);
+        m_heapIndex.insert(job, m_heap.size() - 1);
+        SiftUp(m_heap.size() - 1);
+    }
+
+    void RCJobQueue::Remove(RCJob* job)
+    {
+        auto found = m_heapIndex.find(job);
+        if (found == m_heapIndex.end())
+        {
+            return;
+        }
+        int heapIndex = found.value();
+        m_heapIndex.erase(found);
+        m_jobsByElement.remove(job->GetElementID(), job);
+
+        QueueEntry last = m_heap.back();
+        m_heap.pop_back();
+        if (heapIndex < m_heap.size())
+        {
+            Place(heapIndex, last);
+            Update(heapIndex);
+        }
+    }
+
+    void RCJobQueue::Update(int heapIndex)
+    {
+        if ((heapIndex > 0) && (IsBefore(m_heap[heapIndex], m_heap[(heapIndex - 1) / 2])))
+        {
+            SiftUp(heapIndex);
+        }
+        else
+        {
+            SiftDown(heapIndex);
+        }
+    }
+
+    void RCJobQueue::SiftUp(int heapIndex)
+    {
+        QueueEntry entry = m_heap[heapIndex];
+        while (heapIndex > 0)
+        {
+            int parentIndex = (heapIndex - 1) / 2;
+            if (!IsBefore(entry, m_heap[parentIndex]))
+            {
+                break;
+            }
+            Place(heapIndex, m_heap[parentIndex]);
+            heapIndex = parentIndex;
+        }
+        Place(heapIndex, entry);
+    }
+
+    void RCJobQueue::SiftDown(int heapIndex)
+    {
+        QueueEntry entry = m_heap[heapIndex];
+        int heapSize = m_heap.size();
+        for (;; )
+        {
+            int childIndex = heapIndex * 2 + 1;
+            if (childIndex >= heapSize)
+            {
+                break;
+            }
+            if ((childIndex + 1 < heapSize) && (IsBefore(m_heap[childIndex + 1], m_heap[childIndex])))
+            {
+                ++childIndex;
+            }
+            if (!IsBefore(m_heap[childIndex], entry))
+            {
+                break;
+            }
+            Place(heapIndex, m_heap[childIndex]);
+            heapIndex = childIndex;
+        }
+        Place(heapIndex, entry);
+    }
+
+    void RCJobQueue::Place(int heapIndex, const QueueEntry& entry)
+    {
+        m_heap[heapIndex] = entry;
+        m_heapIndex[entry.m_job] = heapIndex;
+    }
+
+    void RCJobQueue::AddCompileRequest(const AssetProcessor::QueueElementID& target, bool sync)
+    {
+        if (sync)
+        {
+            m_activeSyncCompileRequests[target].push_back(++m_lastRequestSerial);
+        }
+        else
+        {
+            m_activeAsyncCompileRequests[target].push_back(++m_lastRequestSerial);
+        }
+        RefreshRequests(target);
+    }
+
+    void RCJobQueue::RemoveCompileRequest(const AssetProcessor::QueueElementID& target, bool sync)
+    {
+        // removing a compile request is currently done pretty much only when a compile request completes, in which case
+        // the job has already left the queue and there is nothing to reorder.
+        QHash<QueueElementID, QVector<qint64> >& requests = sync ? m_activeSyncCompileRequests : m_activeAsyncCompileRequests;
+        auto found = requests.find(target);
+        if (found == requests.end())
+        {
+            return;
+        }
+
+        found.value().pop_back();
+        if (found.value().isEmpty())
+        {
+            requests.erase(found);
+        }
+        RefreshRequests(target);
+    }
+
+    void RCJobQueue::OnJobQueued(AssetProcessor::RCJob* job)
+    {
+        Push(job);
+    }
+
+    void RCJobQueue::OnJobDequeued(AssetProcessor::RCJob* job)
+    {
+        Remove(job);
+    }
+
+    void RCJobQueue::AssetProcessorPlatformConnected(const AZStd::string platform)
+    {
+        QMetaObject::invokeMethod(this, "ProcessPlatformChangeMessage", Qt::QueuedConnection, Q_ARG(QString, QString::fromUtf8(platform.c_str())), Q_ARG(bool, true));
+    }
+
+    void RCJobQueue::AssetProcessorPlatformDisconnected(const AZStd::string platform)
+    {
+        QMetaObject::invokeMethod(this, "ProcessPlatformChangeMessage", Qt::QueuedConnection, Q_ARG(QString, QString::fromUtf8(platform.c_str())), Q_ARG(bool, false));
+    }
+
+    void RCJobQueue::ProcessPlatformChangeMessage(QString platformName, bool connected)
+    {
+        AZ_TracePrintf(AssetProcessor::DebugChannel, "RCJobQueue: Platform %s has %s.", platformName.toUtf8().data(), connected ? "connected" : "disconnected");
+        if (connected)
+        {
+            m_currentlyConnectedPlatforms.insert(platformName);
+        }
+        else
+        {
+            m_currentlyConnectedPlatforms.remove(platformName);
+        }
+
+        // a platform change can move any number of jobs, so rather than sifting each one the heap is rebuilt in O(n).
+        bool changed = false;
+        for (QueueEntry& entry : m_heap)
+        {
+            if (entry.m_job->GetPlatform() == platformName)
+            {
+                changed = changed || (entry.m_platformConnected != connected);
+                entry.m_platformConnected = connected;
+            }
+        }
+
+        if (changed)
+        {
+            for (int heapIndex = m_heap.size() / 2 - 1; heapIndex >= 0; --heapIndex)
+            {
+                SiftDown(heapIndex);
+            }
+        }
+    }
+} // end namespace AssetProcessor
+
+#include <native/resourcecompiler/RCJobQueue.moc>
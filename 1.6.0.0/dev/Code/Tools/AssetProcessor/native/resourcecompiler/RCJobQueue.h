@@ -0,0 +1,112 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef ASSETPROCESSOR_RCJOBQUEUE_H
+#define ASSETPROCESSOR_RCJOBQUEUE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <AzCore/base.h>
+
+#include "RCCommon.h"
+#include "native/utilities/AssetUtilEBusHelper.h"
+
+namespace AssetProcessor
+{
+    class RCJobListModel;
+    class RCJob;
+
+    //! The RCJobQueue decides which pending job the RC Controller should start next.
+    //! It watches the raw RC job list and keeps every pending job in an indexed binary heap, so adding a job,
+    //! escalating it and taking the best one are O(log n) no matter how many jobs are queued.  The order is
+    //!  * Jobs for currently connected platforms before jobs for unconnected platforms
+    //!  * Critical (currently Copy) jobs
+    //!  * Jobs in Sync Compile Requests (with most recent requests first)
+    //!  * Jobs in Async Compile Lists (with most recent requests first)
+    //!  * PC jobs, since pc-format assets are what the editor uses
+    //!  * Jobs with a higher priority.  Jobs without a priority (negative) come after those which have one.
+    //!  * Older jobs (lower job id)
+    class RCJobQueue
+        : public QObject
+        , protected AssetProcessorPlatformBus::Handler
+    {
+        Q_OBJECT
+    public:
+        explicit RCJobQueue(QObject* parent = 0);
+
+        void AttachToModel(RCJobListModel* target);
+
+        //! Returns the job that should be started next without removing it, it leaves the queue once it is started.
+        RCJob* GetNextPendingJob();
+        int GetPendingJobCount() const;
+
+        void AddCompileRequest(const AssetProcessor::QueueElementID& target, bool sync);
+        void RemoveCompileRequest(const AssetProcessor::QueueElementID& target, bool sync);
+
+    protected:
+        // The sort key of a job is cached here so that comparing two jobs does not touch the job or any lookup table
+        struct QueueEntry
+        {
+            RCJob* m_job = nullptr;
+            AZ::s64 m_jobID = 0;
+            qint64 m_syncRequest = 0; // serial of the most recent sync compile request for the job, 0 for none
+            qint64 m_asyncRequest = 0;
+            int m_priority = -1;
+            bool m_platformConnected = false;
+            bool m_critical = false;
+            bool m_pcPlatform = false;
+        };
+
+        //! Does left come before right in the queue
+        static bool IsBefore(const QueueEntry& left, const QueueEntry& right);
+
+        qint64 GetLatestRequest(const QHash<AssetProcessor::QueueElementID, QVector<qint64> >& requests, const AssetProcessor::QueueElementID& target) const;
+        void RefreshRequests(const AssetProcessor::QueueElementID& target);
+
+        void Push(RCJob* job);
+        void Remove(RCJob* job);
+        void Update(int heapIndex);
+        void SiftUp(int heapIndex);
+        void SiftDown(int heapIndex);
+        void Place(int heapIndex, const QueueEntry& entry);
+
+        // ---------------------------------------------------------
+        // AssetProcessorPlatformBus::Handler
+        void AssetProcessorPlatformConnected(const AZStd::string platform) override;
+        void AssetProcessorPlatformDisconnected(const AZStd::string platform) override;
+        // -----------
+
+        QVector<QueueEntry> m_heap;
+        QHash<RCJob*, int> m_heapIndex; // position of each queued job within m_heap
+        QMultiHash<AssetProcessor::QueueElementID, RCJob*> m_jobsByElement; // queued jobs, so a compile request can find what it escalates
+
+        // every request gets a serial that is higher than all before it, so the most recent request is the largest.
+        // they contain duplicates, on purpose, so that removing a request restores the one made before it.
+        QHash<AssetProcessor::QueueElementID, QVector<qint64> > m_activeSyncCompileRequests;
+        QHash<AssetProcessor::QueueElementID, QVector<qint64> > m_activeAsyncCompileRequests;
+        qint64 m_lastRequestSerial = 0;
+
+        QSet<QString> m_currentlyConnectedPlatforms;
+
+        RCJobListModel* m_sourceModel = nullptr;
+
+    private Q_SLOTS:
+        void OnJobQueued(AssetProcessor::RCJob* job);
+        void OnJobDequeued(AssetProcessor::RCJob* job);
+        void ProcessPlatformChangeMessage(QString platformName, bool connected);
+    };
+} // namespace AssetProcessor
+
+#endif //ASSETPROCESSOR_RCJOBQUEUE_H
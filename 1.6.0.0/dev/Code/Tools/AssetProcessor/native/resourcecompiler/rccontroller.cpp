@@ -44,13 +44,13 @@ namespace AssetProcessor
 
         m_maxJobs = cfg_maxJobs ? qMax<unsigned int>(cfg_minJobs, qMin<unsigned int>(cfg_maxJobs, maxJobs)) : maxJobs;
 
-        m_RCQueueSortModel.AttachToModel(&m_RCJobListModel);
+        m_RCJobQueue.AttachToModel(&m_RCJobListModel);
     }
 
     RCController::~RCController()
     {
         AssetProcessorPlatformBus::Handler::BusDisconnect();
-        m_RCQueueSortModel.AttachToModel(nullptr);
+        m_RCJobQueue.AttachToModel(nullptr);
     }
 
     RCJobListModel* RCController::getQueueModel()
@@ -148,7 +148,7 @@ namespace AssetProcessor
 
     bool RCController::IsIdle()
     {
-        return ((!m_RCQueueSortModel.GetNextPendingJob()) && (m_RCJobListModel.jobsInFlight() == 0));
+        return ((!m_RCJobQueue.GetNextPendingJob()) && (m_RCJobListModel.jobsInFlight() == 0));
     }
 
     void RCController::jobSubmitted(JobDetails details)
@@ -196,12 +196,12 @@ namespace AssetProcessor
         if (!m_dispatchingJobs)
         {
             m_dispatchingJobs = true;
-            RCJob* rcJob = m_RCQueueSortModel.GetNextPendingJob();
+            RCJob* rcJob = m_RCJobQueue.GetNextPendingJob();
 
             while (m_RCJobListModel.jobsInFlight() < m_maxJobs && rcJob && !m_shuttingDown)
             {
                 startJob(rcJob);
-                rcJob = m_RCQueueSortModel.GetNextPendingJob();
+                rcJob = m_RCJobQueue.GetNextPendingJob();
             }
             m_dispatchingJobs = false;
         }
@@ -226,7 +226,7 @@ namespace AssetProcessor
         {
             for (const auto element : results)
             {
-                m_RCQueueSortModel.AddCompileRequest(element, true);
+                m_RCJobQueue.AddCompileRequest(element, true);
             }
             m_activeCompileGroups.push_back(AssetCompileGroup());
             m_activeCompileGroups.back().m_groupMembers.swap(results);
@@ -251,7 +251,7 @@ namespace AssetProcessor
             if (it != compileGroup.m_groupMembers.end())
             {
                 // this compile group contains the expected group!
-                m_RCQueueSortModel.RemoveCompileRequest(queuedElement, true);
+                m_RCJobQueue.RemoveCompileRequest(queuedElement, true);
                 compileGroup.m_groupMembers.erase(it);
                 if ((compileGroup.m_groupMembers.isEmpty()) || (state != RCJob::completed))
                 {
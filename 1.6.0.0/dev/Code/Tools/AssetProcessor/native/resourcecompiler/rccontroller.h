@@ -22,7 +22,7 @@
 #include "native/utilities/assetUtilEBusHelper.h"
 
 #include "rcjoblistmodel.h"
-#include "RCQueueSortModel.h"
+#include "RCJobQueue.h"
 
 #include <AzFramework/Asset/AssetProcessorMessages.h>
 #include <AzToolsFramework/API/EditorAssetSystemAPI.h>
@@ -101,7 +101,7 @@ namespace AssetProcessor
         QMap<QString, int> m_jobsCountPerPlatform;// This stores the count of jobs per platform in the RC Queue
         QMap<QString, int> m_pendingCriticalJobsPerPlatform;// This stores the count of pending critical jobs per platform in the RC Queue
         AssetProcessor::RCJobListModel m_RCJobListModel;
-        AssetProcessor::RCQueueSortModel m_RCQueueSortModel;
+        AssetProcessor::RCJobQueue m_RCJobQueue;
 
         //! An Asset Compile Group is a set of assets that we're tracking the compilation of
         //! It consists of a whole bunch of assets and is considered to be "complete" when either one of the assets in the group fails
@@ -30,6 +30,9 @@ namespace AssetProcessor
         // Test model behaviour from creation in debug
         new ModelTest(this, this);
 #endif
+        m_publishTimer.setSingleShot(true);
+        m_publishTimer.setInterval(s_rowPublishIntervalMs);
+        connect(&m_publishTimer, &QTimer::timeout, this, &RCJobListModel::PublishPendingRows);
     }
 
     int RCJobListModel::rowCount(const QModelIndex& parent) const
@@ -38,7 +41,7 @@ namespace AssetProcessor
         {
             return 0;
         }
-        return itemCount();
+        return m_publishedRowCount;
     }
 
     QModelIndex RCJobListModel::parent(const QModelIndex& index) const
@@ -162,22 +165,53 @@ namespace AssetProcessor
 
     void RCJobListModel::addNewJob(RCJob* rcJob)
     {
-        int posForInsert = m_jobs.size();
-        beginInsertRows(QModelIndex(), posForInsert, posForInsert);
-
+        // the row is published to views later, along with every other job that arrives before then
         m_jobs.push_back(rcJob);
+        if (!m_publishTimer.isActive())
+        {
+            m_publishTimer.start();
+        }
 
-        bool isPending = false;
         if (rcJob->GetState() == RCJob::pending)
         {
             m_jobsInQueueLookup.insert(rcJob->GetElementID(), rcJob);
-            isPending = true;
+            Q_EMIT JobQueued(rcJob);
+            EraseFailedJobs(rcJob->GetElementID());
         }
-        endInsertRows();
+    }
 
-        if (isPending)
+    void RCJobListModel::PublishPendingRows()
+    {
+        m_publishTimer.stop();
+        if (m_publishedRowCount < m_jobs.size())
         {
-            EraseFailedJobs(rcJob->GetElementID());
+            beginInsertRows(QModelIndex(), m_publishedRowCount, m_jobs.size() - 1);
+            m_publishedRowCount = m_jobs.size();
+            endInsertRows();
+        }
+    }
+
+    void RCJobListModel::RemoveJobAt(int jobIndex)
+    {
+        if (jobIndex < m_publishedRowCount)
+        {
+            beginRemoveRows(QModelIndex(), jobIndex, jobIndex);
+            m_jobs.removeAt(jobIndex);
+            --m_publishedRowCount;
+            endRemoveRows();
+        }
+        else
+        {
+            m_jobs.removeAt(jobIndex);
+        }
+    }
+
+    void RCJobListModel::JobDataChanged(int jobIndex)
+    {
+        // unpublished rows will be read in full once they are inserted
+        if (jobIndex < m_publishedRowCount)
+        {
+            Q_EMIT dataChanged(index(jobIndex, 0, QModelIndex()), index(jobIndex, 0, QModelIndex()));
         }
     }
 
@@ -201,10 +235,8 @@ namespace AssetProcessor
                 RCJob* jobAtIndex = m_jobs.at(jobIndex);
                 if (jobsToRemove.contains(jobAtIndex))
                 {
-                    beginRemoveRows(QModelIndex(), jobIndex, jobIndex);
+                    RemoveJobAt(jobIndex);
                     jobAtIndex->deleteLater();
-                    m_jobs.removeAt(jobIndex);
-                    endRemoveRows();
                 }
             }
         }
@@ -216,9 +248,9 @@ namespace AssetProcessor
         rcJob->setTimeLaunched(QDateTime::currentDateTime());
 
         m_jobsInFlight.insert(rcJob);
+        Q_EMIT JobDequeued(rcJob);
 
-        int jobIndex = m_jobs.lastIndexOf(rcJob);
-        Q_EMIT dataChanged(index(jobIndex, 0, QModelIndex()), index(jobIndex, 0, QModelIndex()));
+        JobDataChanged(m_jobs.lastIndexOf(rcJob));
     }
 
     void RCJobListModel::markAsStarted(RCJob* rcJob)
@@ -233,6 +265,7 @@ namespace AssetProcessor
     void RCJobListModel::markAsCompleted(RCJob* rcJob)
     {
         rcJob->setTimeCompleted(QDateTime::currentDateTime());
+        Q_EMIT JobDequeued(rcJob);
 
         auto foundInQueue = m_jobsInQueueLookup.find(rcJob->GetElementID());
         while ((foundInQueue != m_jobsInQueueLookup.end()) && (foundInQueue.value() == rcJob))
@@ -246,9 +279,7 @@ namespace AssetProcessor
         // If the job completed, remove it from the list and delete it
         if (rcJob->GetState() == RCJob::completed)
         {
-            beginRemoveRows(QModelIndex(), jobIndex, jobIndex);
-            m_jobs.removeAt(jobIndex);
-            endRemoveRows();
+            RemoveJobAt(jobIndex);
 
             EraseFailedJobs(rcJob->GetElementID());
             rcJob->deleteLater();
@@ -256,7 +287,7 @@ namespace AssetProcessor
         else
         {
             m_jobsFailedLookup.insert(rcJob->GetElementID(), rcJob);
-            Q_EMIT dataChanged(index(jobIndex, 0, QModelIndex()), index(jobIndex, 0, QModelIndex()));
+            JobDataChanged(jobIndex);
         }
     }
 
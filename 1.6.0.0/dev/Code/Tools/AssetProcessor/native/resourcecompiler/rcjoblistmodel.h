@@ -18,6 +18,7 @@
 #include <QObject>
 #include <QQueue>
 #include <QMultiMap>
+#include <QTimer>
 
 #include "rcjob.h"
 
@@ -31,6 +32,9 @@ namespace AssetProcessor
 {
     /**
      * The RCJobListModel class contains lists of RC jobs
+     * It is only a view of the jobs, the order in which they are processed is decided by the RCJobQueue.
+     * New jobs are published to attached views in batches, at most once per s_rowPublishIntervalMs, since jobs
+     * arrive in the tens of thousands after a fresh clone and inserting rows one at a time stalls the UI.
      */
     class RCJobListModel
         : public QAbstractItemModel
@@ -87,9 +91,25 @@ namespace AssetProcessor
 
         void EraseFailedJobs(const QueueElementID& target);
 
+        //! Makes every job added so far visible to views immediately rather than on the next publish
+        void PublishPendingRows();
+
+    Q_SIGNALS:
+        //! A pending job was added, or a job stopped being pending.  Emitted immediately, unlike the row changes.
+        void JobQueued(AssetProcessor::RCJob* rcJob);
+        void JobDequeued(AssetProcessor::RCJob* rcJob);
+
     private:
+        static const int s_rowPublishIntervalMs = 250;
+
+        void RemoveJobAt(int jobIndex);
+        void JobDataChanged(int jobIndex);
+
 
         QVector<RCJob*> m_jobs;
+        // views see m_jobs[0, m_publishedRowCount), jobs after that were added since the last publish
+        int m_publishedRowCount = 0;
+        QTimer m_publishTimer;
         QSet<RCJob*> m_jobsInFlight;
 
         // profiler showed much of our time was spent in IsInQueue.
@@ -19,6 +19,7 @@
 #include <QDir>
 #include <QDebug>
 #include <QSet>
+#include <QHash>
 #include <AzToolsFramework/API/AssetDatabaseBus.h>
 #include "native/AssetDatabase/AssetDatabase.h"
 
@@ -682,6 +683,47 @@ void AssetProcessingStateDataUnitTest::TestClearData(AssetProcessor::LegacyDatab
     stateData->GetSourceFileNames(allFiles);
 }
 
+void AssetProcessingStateDataUnitTest::DirectorySnapshotTest(AssetProcessor::DatabaseConnection* connection)
+{
+    using namespace AssetProcessor;
+
+    DirectorySnapshot lowerSnapshot;
+    lowerSnapshot.m_modTime = 100;
+    lowerSnapshot.m_files.push_back("file.txt");
+    lowerSnapshot.m_folders.push_back("sub");
+
+    DirectorySnapshot upperSnapshot;
+    upperSnapshot.m_modTime = 200;
+    upperSnapshot.m_files.push_back("FILE.txt");
+
+    AZStd::vector<AZStd::pair<QString, DirectorySnapshot> > changed;
+    changed.push_back(AZStd::make_pair(QString("c:/snapshots/dir"), lowerSnapshot));
+    changed.push_back(AZStd::make_pair(QString("c:/snapshots/DIR"), upperSnapshot));
+    connection->UpdateDirectorySnapshots(changed, QStringList());
+
+    // directory names are compared exactly, names differing only in case must not replace each other
+    QHash<QString, DirectorySnapshot> found;
+    connection->EnumerateDirectorySnapshots([&found](const QString& directoryName, const DirectorySnapshot& snapshot)
+        {
+            found.insert(directoryName, snapshot);
+        });
+    UNIT_TEST_EXPECT_TRUE(found.size() == 2);
+    UNIT_TEST_EXPECT_TRUE(found.contains("c:/snapshots/dir") && found["c:/snapshots/dir"].m_modTime == 100);
+    UNIT_TEST_EXPECT_TRUE(found["c:/snapshots/dir"].m_files == lowerSnapshot.m_files);
+    UNIT_TEST_EXPECT_TRUE(found["c:/snapshots/dir"].m_folders == lowerSnapshot.m_folders);
+    UNIT_TEST_EXPECT_TRUE(found.contains("c:/snapshots/DIR") && found["c:/snapshots/DIR"].m_modTime == 200);
+
+    // removing one spelling leaves the other
+    connection->UpdateDirectorySnapshots(AZStd::vector<AZStd::pair<QString, DirectorySnapshot> >(), QStringList() << "c:/snapshots/DIR");
+    found.clear();
+    connection->EnumerateDirectorySnapshots([&found](const QString& directoryName, const DirectorySnapshot& snapshot)
+        {
+            found.insert(directoryName, snapshot);
+        });
+    UNIT_TEST_EXPECT_TRUE(found.size() == 1);
+    UNIT_TEST_EXPECT_TRUE(found.contains("c:/snapshots/dir"));
+}
+
 void AssetProcessingStateDataUnitTest::AssetProcessingStateDataTest()
 {
     using namespace AssetProcessingStateDataUnitTestInternal;
@@ -840,6 +882,12 @@ void AssetProcessingStateDataUnitTest::AssetProcessingStateDataTest()
         {
             return;
         }
+
+        DirectorySnapshotTest(&connection);
+        if (testsFailed)
+        {
+            return;
+        }
     }
 
     Q_EMIT UnitTestPassed();
@@ -17,6 +17,7 @@
 namespace AssetProcessor
 {
     class LegacyDatabaseInterface;
+    class DatabaseConnection;
 }
 
 class AssetProcessingStateDataUnitTest
@@ -32,6 +33,7 @@ public:
     void AdvancedDataTest(AssetProcessor::LegacyDatabaseInterface* stateData);
     void TestReloadedData(AssetProcessor::LegacyDatabaseInterface* stateData);
     void TestClearData(AssetProcessor::LegacyDatabaseInterface* stateData);
+    void DirectorySnapshotTest(AssetProcessor::DatabaseConnection* connection);
     virtual void StartTest() override;
 
 
@@ -25,6 +25,7 @@
 #include <QList>
 #include <QCoreApplication>
 #include <QTime>
+#include <QThread>
 
 
 using namespace UnitTestUtils;
@@ -57,6 +58,9 @@ void AssetScannerUnitTest::StartTest()
         UNIT_TEST_EXPECT_TRUE(CreateDummyFile(expect));
     }
 
+    // directories modified within the last two seconds are not snapshotted (timestamp granularity), so let them age.
+    QThread::msleep(2100);
+
     // but we're going to not watch subfolder3 recursively, so... remove these files:
     expectedFiles.remove(tempPath.absoluteFilePath("subfolder3/aaa/basefile.txt"));
     expectedFiles.remove(tempPath.absoluteFilePath("subfolder3/aaa/bbb/basefile.txt"));
@@ -113,6 +117,36 @@ void AssetScannerUnitTest::StartTest()
         UNIT_TEST_EXPECT_TRUE(expectedFiles.find(search) != expectedFiles.end());
     }
 
+    // a second scan (which is allowed to reuse directory listings from the first) must find exactly the same files,
+    // and files added since then must show up too.
+    UNIT_TEST_EXPECT_TRUE(CreateDummyFile(tempPath.absoluteFilePath("subfolder2/aaa/bbb/newfile.txt")));
+    expectedFiles << tempPath.absoluteFilePath("subfolder2/aaa/bbb/newfile.txt");
+
+    actuallyFound.clear();
+    doneScan = false;
+    scanner.StartScan();
+    nowTime.start();
+    while (!doneScan)
+    {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+
+        if (nowTime.elapsed() > 10000)
+        {
+            break;
+        }
+    }
+
+    UNIT_TEST_EXPECT_TRUE(doneScan);
+    UNIT_TEST_EXPECT_TRUE(actuallyFound.count() == expectedFiles.count());
+
+    for (const QString& search : actuallyFound)
+    {
+        UNIT_TEST_EXPECT_TRUE(expectedFiles.find(search) != expectedFiles.end());
+    }
+
+    // only subfolder2/aaa/bbb changed, every other directory must have reused its listing from the first scan.
+    UNIT_TEST_EXPECT_TRUE(scanner.GetReusedListingCount() > 0);
+
     Q_EMIT UnitTestPassed();
 }
 
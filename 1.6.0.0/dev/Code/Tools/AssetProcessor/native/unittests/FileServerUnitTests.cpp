@@ -0,0 +1,200 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#if defined(UNIT_TEST)
+#include "FileServerUnitTests.h"
+
+#include "native/FileServer/fileServer.h"
+#include <AzFramework/IO/LocalFileIO.h>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace
+{
+    //! Internal class to unit test the read ahead of FileServer, the requests only add (de)serialization around it
+    class ReadAheadFileServer
+        : public FileServer
+    {
+    public:
+        using FileServer::ReadWithReadAhead;
+        using FileServer::SeekWithReadAhead;
+        using FileServer::TellWithReadAhead;
+        using FileServer::WriteWithReadAhead;
+        using FileServer::GetReadAheadBytes;
+        using FileServer::s_readAheadSize;
+        using FileServer::s_readAheadMaxBytesPerConnection;
+    };
+
+    const AZ::u32 s_success = static_cast<AZ::u32>(AZ::IO::ResultCode::Success);
+
+    // not a multiple of the read ahead size, so the last buffer is a short one
+    const int s_fileSize = 1024 * 1024 + 123;
+
+    bool ReadMatches(ReadAheadFileServer& server, unsigned int connId, AZ::IO::FileIOBase& fileIO, AZ::IO::HandleType fileHandle, const QByteArray& contents, int offset, int size)
+    {
+        QByteArray data(size, 0);
+        AZ::u64 bytesRead = 0;
+        if (server.ReadWithReadAhead(connId, &fileIO, fileHandle, data.data(), size, bytesRead) != s_success)
+        {
+            return false;
+        }
+        data.resize(static_cast<int>(bytesRead));
+        return data == contents.mid(offset, size);
+    }
+
+    bool Seek(ReadAheadFileServer& server, unsigned int connId, AZ::IO::FileIOBase& fileIO, AZ::IO::HandleType fileHandle, AZ::s64 offset, AZ::IO::SeekType seekType)
+    {
+        return server.SeekWithReadAhead(connId, &fileIO, fileHandle, offset, static_cast<AZ::u32>(seekType)) == s_success;
+    }
+
+    bool TellIs(ReadAheadFileServer& server, unsigned int connId, AZ::IO::FileIOBase& fileIO, AZ::IO::HandleType fileHandle, AZ::u64 expectedOffset)
+    {
+        AZ::u64 offset = 0;
+        return (server.TellWithReadAhead(connId, &fileIO, fileHandle, offset) == s_success) && (offset == expectedOffset);
+    }
+
+    bool Write(ReadAheadFileServer& server, unsigned int connId, AZ::IO::FileIOBase& fileIO, AZ::IO::HandleType fileHandle, const QByteArray& data)
+    {
+        AZ::u64 bytesWritten = 0;
+        return (server.WriteWithReadAhead(connId, &fileIO, fileHandle, data.constData(), data.size(), bytesWritten) == s_success)
+               && (bytesWritten == static_cast<AZ::u64>(data.size()));
+    }
+}
+
+REGISTER_UNIT_TEST(FileServerUnitTests)
+
+void FileServerUnitTests::StartTest()
+{
+    QTemporaryDir tempDir;
+    QString fileName = QDir(tempDir.path()).filePath("readahead.bin");
+
+    // bytes from the wrong offset don't match, even a whole buffer away
+    QByteArray contents(s_fileSize, 0);
+    for (int i = 0; i < s_fileSize; ++i)
+    {
+        contents[i] = static_cast<char>((i % 251) ^ ((i / 251) & 0xff));
+    }
+    QFile file(fileName);
+    UNIT_TEST_EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+    UNIT_TEST_EXPECT_TRUE(file.write(contents) == s_fileSize);
+    file.close();
+
+    ReadAheadFileServer server;
+    AZ::IO::LocalFileIO fileIO;
+    const unsigned int connId = 1;
+    const AZ::u64 readAheadSize = ReadAheadFileServer::s_readAheadSize;
+
+    AZ::IO::HandleType readHandle = AZ::IO::InvalidHandle;
+    UNIT_TEST_EXPECT_TRUE(fileIO.Open(fileName.toUtf8().constData(), AZ::IO::OpenMode::ModeRead | AZ::IO::OpenMode::ModeBinary, readHandle));
+
+    // the first read goes to the file, the second one of a sequence fills the buffer
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 0, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 16, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == readAheadSize);
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 32, 16));
+
+    // tell reports where the client is, not where the file is
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 48));
+
+    // seeks inside the buffer keep it, forwards and backwards
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, 100, AZ::IO::SeekType::SeekFromCurrent));
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 148));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 148, 16));
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, 20, AZ::IO::SeekType::SeekFromStart));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 20, 8));
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 28));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == readAheadSize);
+
+    // seeks outside of it drop it, relative ones still count from the client's position
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, 300000, AZ::IO::SeekType::SeekFromCurrent));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 300028));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 300028, 16));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 300044, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == readAheadSize);
+
+    // a buffer is freed as soon as it has been read
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 300060, static_cast<int>(readAheadSize) - 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 300044 + readAheadSize));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 300044 + static_cast<int>(readAheadSize), 16));
+
+    // seeks from the end and reads past it
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, -16, AZ::IO::SeekType::SeekFromEnd));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, s_fileSize - 16, 16));
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, s_fileSize));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, s_fileSize, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+
+    // writes through another handle of the same client drop what was read ahead of them
+    AZ::IO::HandleType writeHandle = AZ::IO::InvalidHandle;
+    UNIT_TEST_EXPECT_TRUE(fileIO.Open(fileName.toUtf8().constData(), AZ::IO::OpenMode::ModeRead | AZ::IO::OpenMode::ModeUpdate | AZ::IO::OpenMode::ModeBinary, writeHandle));
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, 0, AZ::IO::SeekType::SeekFromStart));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 0, 16));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 16, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == readAheadSize);
+
+    QByteArray otherHandleData("WRITTEN");
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, writeHandle, 40, AZ::IO::SeekType::SeekFromStart));
+    UNIT_TEST_EXPECT_TRUE(Write(server, connId, fileIO, writeHandle, otherHandleData));
+    UNIT_TEST_EXPECT_TRUE(fileIO.Flush(writeHandle));
+    contents.replace(40, otherHandleData.size(), otherHandleData);
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, readHandle, 32));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 32, 32));
+
+    // a handle which reads and then writes writes where the client is, not where its buffer ends
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, writeHandle, 0, AZ::IO::SeekType::SeekFromStart));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, writeHandle, contents, 0, 16));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, writeHandle, contents, 16, 16));
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == readAheadSize);
+
+    QByteArray sameHandleData("SAME");
+    UNIT_TEST_EXPECT_TRUE(Write(server, connId, fileIO, writeHandle, sameHandleData));
+    UNIT_TEST_EXPECT_TRUE(fileIO.Flush(writeHandle));
+    contents.replace(32, sameHandleData.size(), sameHandleData);
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(connId) == 0);
+    UNIT_TEST_EXPECT_TRUE(TellIs(server, connId, fileIO, writeHandle, 36));
+    UNIT_TEST_EXPECT_TRUE(Seek(server, connId, fileIO, readHandle, 0, AZ::IO::SeekType::SeekFromStart));
+    UNIT_TEST_EXPECT_TRUE(ReadMatches(server, connId, fileIO, readHandle, contents, 0, 64));
+
+    UNIT_TEST_EXPECT_TRUE(fileIO.Close(writeHandle));
+    UNIT_TEST_EXPECT_TRUE(fileIO.Close(readHandle));
+
+    // a client keeping many files partly read only gets so much memory, the other files are read directly
+    const unsigned int busyConnId = 2;
+    const int numHandles = 12;
+    AZ::IO::HandleType handles[numHandles];
+    for (int i = 0; i < numHandles; ++i)
+    {
+        handles[i] = AZ::IO::InvalidHandle;
+        UNIT_TEST_EXPECT_TRUE(fileIO.Open(fileName.toUtf8().constData(), AZ::IO::OpenMode::ModeRead | AZ::IO::OpenMode::ModeBinary, handles[i]));
+        UNIT_TEST_EXPECT_TRUE(ReadMatches(server, busyConnId, fileIO, handles[i], contents, 0, 16));
+        UNIT_TEST_EXPECT_TRUE(ReadMatches(server, busyConnId, fileIO, handles[i], contents, 16, 16));
+    }
+    UNIT_TEST_EXPECT_TRUE(server.GetReadAheadBytes(busyConnId) == ReadAheadFileServer::s_readAheadMaxBytesPerConnection);
+    for (int i = 0; i < numHandles; ++i)
+    {
+        UNIT_TEST_EXPECT_TRUE(ReadMatches(server, busyConnId, fileIO, handles[i], contents, 32, 16));
+        UNIT_TEST_EXPECT_TRUE(TellIs(server, busyConnId, fileIO, handles[i], 48));
+        UNIT_TEST_EXPECT_TRUE(fileIO.Close(handles[i]));
+    }
+
+    Q_EMIT UnitTestPassed();
+}
+
+#include <native/unittests/FileServerUnitTests.moc>
+
+#endif // UNIT_TEST
@@ -22,6 +22,7 @@
 #include <QFile>
 #include <QSet>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QString>
 
 using namespace AssetProcessor;
@@ -304,10 +305,61 @@ void FileWatcherUnitTestRunner::StartTest()
         QObject::disconnect(connectionModified);
     }
 
+    { // test that a burst of writes to the same file is delivered promptly, and coalesced rather than flooding the main thread
+        QString burstFileName = QDir(tempDir.path()).absoluteFilePath("burst.tif");
+        UNIT_TEST_EXPECT_TRUE(UnitTestUtils::CreateDummyFile(burstFileName, "start"));
+
+        // let the add settle before counting modifications.
+        QThread::msleep(200);
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+
+        const int numWrites = 100;
+        int modifiedCount = 0;
+        auto connection = QObject::connect(&folderWatch, &FolderWatchCallbackEx::fileModified, [&](QString filename)
+        {
+            if (QDir::toNativeSeparators(filename).toLower() == QDir::toNativeSeparators(burstFileName).toLower())
+            {
+                ++modifiedCount;
+            }
+        });
+
+        for (int writeIndex = 0; writeIndex < numWrites; ++writeIndex)
+        {
+            QFile burstFile(burstFileName);
+            UNIT_TEST_EXPECT_TRUE(burstFile.open(QFile::WriteOnly | QFile::Append));
+            burstFile.write("0");
+            burstFile.close();
+        }
+
+        // measured from the end of the burst, so the time spent writing does not count against the notification latency.
+        QElapsedTimer latencyTimer;
+        latencyTimer.start();
+
+        unsigned int tries = 0;
+        while (modifiedCount == 0 && tries++ < 100)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+            QThread::msleep(1);
+        }
+        qint64 latency = latencyTimer.elapsed();
+
+        // collect any stragglers
+        QThread::msleep(200);
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+
+        UNIT_TEST_EXPECT_TRUE(modifiedCount > 0);
+        // the latency goal for a change to reach the main thread is 100ms.
+        UNIT_TEST_EXPECT_TRUE(latency < 100);
+#if defined(AZ_PLATFORM_LINUX)
+        // each write produces several raw notifications, the linux backend folds them together.
+        UNIT_TEST_EXPECT_TRUE(modifiedCount < numWrites);
+#endif
+        QObject::disconnect(connection);
+    }
 
     Q_EMIT UnitTestPassed();
 }
 
-#if defined(AZ_PLATFORM_WINDOWS)
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_LINUX)
 REGISTER_UNIT_TEST(FileWatcherUnitTestRunner)
 #endif
@@ -131,6 +131,8 @@ void RCcontrollerUnitTests::RunRCControllerTests()
     });
 
     RCJobListModel* rcJobListModel = m_rcController.getQueueModel();
+    // rows are published to views on a timer, don't wait for it
+    rcJobListModel->PublishPendingRows();
     int returnedCount = rcJobListModel->rowCount(QModelIndex());
     int expectedCount = 5; // finished ones should be removed, so it shouldn't show up
 
@@ -441,6 +443,52 @@ void RCcontrollerUnitTests::RunRCControllerTests()
     UNIT_TEST_EXPECT_TRUE(gotJobsInQueueCall);
     UNIT_TEST_EXPECT_TRUE(jobsInQueueCount = priorJobs + 1);
 
+    /// --- TEST ------------- the job queue hands out pending jobs in order, and compile requests escalate them
+    {
+        RCJobListModel queueTestModel;
+        RCJobQueue queueTest;
+        queueTest.AttachToModel(&queueTestModel);
+
+        QList<RCJob*> queueTestJobs;
+        for (int jobIndex = 0; jobIndex < 4; ++jobIndex)
+        {
+            RCJob* job = new RCJob(&queueTestModel);
+            AssetProcessor::JobDetails jobDetails;
+            jobDetails.m_jobEntry.m_relativePathToFile = QString("queuetest/file%1.txt").arg(jobIndex);
+            jobDetails.m_jobEntry.m_platform = "pc";
+            jobDetails.m_jobEntry.m_jobKey = "Queue Stuff";
+            jobDetails.m_jobEntry.m_jobId = 100 + jobIndex;
+            jobDetails.m_priority = (jobIndex == 1) ? 5 : -1;
+            jobDetails.m_critical = (jobIndex == 3);
+            job->Init(jobDetails);
+            queueTestModel.addNewJob(job);
+            queueTestJobs.push_back(job);
+        }
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetPendingJobCount() == 4);
+
+        // critical first, then priority, then the oldest
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[3]);
+        queueTestModel.markAsProcessing(queueTestJobs[3]);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[1]);
+
+        // the most recent sync compile request wins over priority
+        queueTest.AddCompileRequest(queueTestJobs[0]->GetElementID(), true);
+        queueTest.AddCompileRequest(queueTestJobs[2]->GetElementID(), true);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[2]);
+        queueTest.RemoveCompileRequest(queueTestJobs[2]->GetElementID(), true);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[0]);
+        queueTest.RemoveCompileRequest(queueTestJobs[0]->GetElementID(), true);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[1]);
+
+        queueTestModel.markAsProcessing(queueTestJobs[1]);
+        queueTestModel.markAsProcessing(queueTestJobs[0]);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == queueTestJobs[2]);
+        queueTestModel.markAsProcessing(queueTestJobs[2]);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetNextPendingJob() == nullptr);
+        UNIT_TEST_EXPECT_TRUE(queueTest.GetPendingJobCount() == 0);
+
+        queueTest.AttachToModel(nullptr);
+    }
 
     ////--------------- RCJob Test with critical locking TRUE
     QTemporaryDir dir;
@@ -13,6 +13,7 @@
 
 #include "native/utilities/AssetUtils.h"
 #include "native/utilities/ByteArrayStream.h"
+#include "native/utilities/FileHashCache.h"
 #include <AzCore/std/parallel/thread.h>
 #include "native/assetprocessor.h"
 
@@ -364,6 +365,75 @@ void UtilitiesUnitTests::StartTest()
 
     }
 
+    // content hashing and the file hash cache
+    {
+        // known XXH64 results
+        UNIT_TEST_EXPECT_TRUE(ComputeContentHash("", 0) == 0xEF46DB3751D8E999ULL);
+        UNIT_TEST_EXPECT_TRUE(ComputeContentHash("a", 1) == 0xD24EC4F1A98C6E5BULL);
+        UNIT_TEST_EXPECT_TRUE(ComputeContentHash("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+        QTemporaryDir tempDir;
+        QDir tempPath(tempDir.path());
+        QString firstFile = tempPath.absoluteFilePath("first.txt");
+        QString secondFile = tempPath.absoluteFilePath("second.txt");
+        QString differentFile = tempPath.absoluteFilePath("different.txt");
+        UNIT_TEST_EXPECT_TRUE(UnitTestUtils::CreateDummyFile(firstFile, "same contents"));
+        UNIT_TEST_EXPECT_TRUE(UnitTestUtils::CreateDummyFile(secondFile, "same contents"));
+        UNIT_TEST_EXPECT_TRUE(UnitTestUtils::CreateDummyFile(differentFile, "other contents"));
+
+        AZ::u64 firstHash = 0;
+        AZ::u64 secondHash = 0;
+        AZ::u64 differentHash = 0;
+        UNIT_TEST_EXPECT_TRUE(ComputeFileContentHash(firstFile, firstHash));
+        UNIT_TEST_EXPECT_TRUE(ComputeFileContentHash(secondFile, secondHash));
+        UNIT_TEST_EXPECT_TRUE(ComputeFileContentHash(differentFile, differentHash));
+        UNIT_TEST_EXPECT_TRUE(firstHash == secondHash);
+        UNIT_TEST_EXPECT_FALSE(firstHash == differentHash);
+        UNIT_TEST_EXPECT_FALSE(ComputeFileContentHash(tempPath.absoluteFilePath("doesnotexist.txt"), firstHash));
+
+        // in content hash mode the fingerprint only depends on the contents and the extra info
+        bool wasContentHashing = IsContentHashFingerprinting();
+        SetContentHashFingerprinting(true);
+        GetFileHashCache().Clear();
+        UNIT_TEST_EXPECT_TRUE(GenerateBaseFingerprint(firstFile, "extra") == GenerateBaseFingerprint(secondFile, "extra"));
+        UNIT_TEST_EXPECT_FALSE(GenerateBaseFingerprint(firstFile, "extra") == GenerateBaseFingerprint(differentFile, "extra"));
+        UNIT_TEST_EXPECT_FALSE(GenerateBaseFingerprint(firstFile, "extra") == GenerateBaseFingerprint(firstFile, "other extra"));
+        UNIT_TEST_EXPECT_TRUE(GenerateBaseFingerprint(tempPath.absoluteFilePath("doesnotexist.txt")) == 0);
+
+        // an entry whose stat matches the file is trusted without reading the file
+        FileHashEntry cachedEntry;
+        UNIT_TEST_EXPECT_TRUE(StatFileForHash(firstFile, cachedEntry));
+        cachedEntry.m_hash = 12345;
+        GetFileHashCache().Load(firstFile, cachedEntry);
+        AZ::u64 cachedHash = 0;
+        UNIT_TEST_EXPECT_TRUE(GetFileHashCache().GetHash(firstFile, cachedHash));
+        UNIT_TEST_EXPECT_TRUE(cachedHash == 12345);
+
+        // but not once the stat differs
+        cachedEntry.m_size += 1;
+        GetFileHashCache().Load(firstFile, cachedEntry);
+        UNIT_TEST_EXPECT_TRUE(GetFileHashCache().GetHash(firstFile, cachedHash));
+        UNIT_TEST_EXPECT_TRUE(cachedHash == secondHash);
+
+        // invalidated entries are reported so they can be removed from the database
+        GetFileHashCache().Invalidate(firstFile);
+        QStringList removedEntries;
+        GetFileHashCache().TakeRemovedEntries(removedEntries);
+        UNIT_TEST_EXPECT_TRUE(removedEntries.size() == 1);
+
+        // names differing only in case are the same file only on case insensitive file systems
+        GetFileHashCache().Clear();
+        GetFileHashCache().Load(tempPath.absoluteFilePath("casetest/file.txt"), cachedEntry);
+        GetFileHashCache().Load(tempPath.absoluteFilePath("casetest/FILE.txt"), cachedEntry);
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_APPLE)
+        UNIT_TEST_EXPECT_TRUE(GetFileHashCache().Size() == 1);
+#else
+        UNIT_TEST_EXPECT_TRUE(GetFileHashCache().Size() == 2);
+#endif
+
+        GetFileHashCache().Clear();
+        SetContentHashFingerprinting(wasContentHashing);
+    }
 
     Q_EMIT UnitTestPassed();
 }
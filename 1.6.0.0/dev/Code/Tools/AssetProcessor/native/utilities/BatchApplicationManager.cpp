@@ -21,6 +21,7 @@
 #include "native/AssetManager/assetScanFolderInfo.h"
 #include "native/resourcecompiler/rccontroller.h"
 #include "native/AssetManager/assetScanner.h"
+#include "native/AssetDatabase/AssetDatabase.h"
 #include <AzFramework/Asset/AssetProcessorMessages.h>
 #include <AzToolsFramework/API/EditorAssetSystemAPI.h>
 
@@ -167,6 +168,14 @@ void BatchApplicationManager::DestroyRCController()
 void BatchApplicationManager::InitAssetScanner()
 {
     m_assetScanner = new AssetProcessor::AssetScanner(m_platformConfiguration);
+    if (m_assetProcessorManager->GetDatabaseConnection())
+    {
+        // the scanner writes its snapshots from its own thread, while the AssetProcessorManager keeps using its connection
+        // on the main thread, so the scanner gets a connection of its own to the same database.
+        AZStd::shared_ptr<AssetProcessor::DatabaseConnection> snapshotDatabase(aznew AssetProcessor::DatabaseConnection());
+        snapshotDatabase->OpenDatabase();
+        m_assetScanner->SetSnapshotDatabase(snapshotDatabase);
+    }
     QObject::connect(m_assetScanner, SIGNAL(AssetScanningStatusChanged(AssetProcessor::AssetScanningStatus)), m_assetProcessorManager, SLOT(OnAssetScannerStatusChange(AssetProcessor::AssetScanningStatus)));
     QObject::connect(m_assetScanner, SIGNAL(FileOfInterestFound(QString)), m_assetProcessorManager, SLOT(AssessModifiedFile(QString)));
 }
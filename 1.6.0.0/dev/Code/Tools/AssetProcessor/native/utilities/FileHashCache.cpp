@@ -0,0 +1,391 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "native/utilities/FileHashCache.h"
+#include "native/utilities/assetUtils.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <string.h> // for memcpy
+
+#if defined(AZ_PLATFORM_WINDOWS)
+#   include <windows.h>
+#else
+#   include <sys/stat.h>
+#endif
+
+namespace AssetUtilsInternal
+{
+    // XXH64, see https://github.com/Cyan4973/xxHash.  Implemented here so that we do not take on a new dependency.
+    // it runs at memory bandwidth, which is what makes hashing every source file on a fresh clone affordable.
+    static const AZ::u64 s_prime1 = 11400714785074694791ULL;
+    static const AZ::u64 s_prime2 = 14029467366897019727ULL;
+    static const AZ::u64 s_prime3 = 1609587929392839161ULL;
+    static const AZ::u64 s_prime4 = 9650029242287828579ULL;
+    static const AZ::u64 s_prime5 = 2870177450012600261ULL;
+
+    // files are streamed in chunks of this size when they cannot be memory mapped
+    static const qint64 s_hashStreamChunkSize = 256 * 1024;
+
+    // a file modified less than this long ago might be modified again without its timestamp changing
+    // (timestamp granularity), so its hash is returned but not cached.
+    static const qint64 s_minimumFileAgeForCachingMs = 2000;
+
+    inline AZ::u64 RotateLeft(AZ::u64 value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline AZ::u64 Read64(const unsigned char* data)
+    {
+        AZ::u64 value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline AZ::u32 Read32(const unsigned char* data)
+    {
+        AZ::u32 value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline AZ::u64 Round(AZ::u64 accumulator, AZ::u64 input)
+    {
+        accumulator += input * s_prime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * s_prime1;
+    }
+
+    inline AZ::u64 MergeRound(AZ::u64 accumulator, AZ::u64 value)
+    {
+        accumulator ^= Round(0, value);
+        return accumulator * s_prime1 + s_prime4;
+    }
+
+    class ContentHasher
+    {
+    public:
+        explicit ContentHasher(AZ::u64 seed)
+            : m_seed(seed)
+        {
+            m_lanes[0] = seed + s_prime1 + s_prime2;
+            m_lanes[1] = seed + s_prime2;
+            m_lanes[2] = seed;
+            m_lanes[3] = seed - s_prime1;
+        }
+
+        void Update(const unsigned char* data, AZ::u64 dataSize)
+        {
+            m_totalSize += dataSize;
+
+            if (m_bufferedSize + dataSize < sizeof(m_buffer))
+            {
+                memcpy(m_buffer + m_bufferedSize, data, static_cast<size_t>(dataSize));
+                m_bufferedSize += static_cast<unsigned int>(dataSize);
+                return;
+            }
+
+            const unsigned char* end = data + dataSize;
+
+            if (m_bufferedSize)
+            {
+                unsigned int fill = sizeof(m_buffer) - m_bufferedSize;
+                memcpy(m_buffer + m_bufferedSize, data, fill);
+                ConsumeStripe(m_buffer);
+                data += fill;
+                m_bufferedSize = 0;
+            }
+
+            while (data + sizeof(m_buffer) <= end)
+            {
+                ConsumeStripe(data);
+                data += sizeof(m_buffer);
+            }
+
+            if (data < end)
+            {
+                m_bufferedSize = static_cast<unsigned int>(end - data);
+                memcpy(m_buffer, data, m_bufferedSize);
+            }
+        }
+
+        AZ::u64 Finish() const
+        {
+            AZ::u64 hash;
+            if (m_totalSize >= sizeof(m_buffer))
+            {
+                hash = RotateLeft(m_lanes[0], 1) + RotateLeft(m_lanes[1], 7) + RotateLeft(m_lanes[2], 12) + RotateLeft(m_lanes[3], 18);
+                hash = MergeRound(hash, m_lanes[0]);
+                hash = MergeRound(hash, m_lanes[1]);
+                hash = MergeRound(hash, m_lanes[2]);
+                hash = MergeRound(hash, m_lanes[3]);
+            }
+            else
+            {
+                hash = m_seed + s_prime5;
+            }
+
+            hash += m_totalSize;
+
+            const unsigned char* data = m_buffer;
+            const unsigned char* end = m_buffer + m_bufferedSize;
+            while (data + 8 <= end)
+            {
+                hash ^= Round(0, Read64(data));
+                hash = RotateLeft(hash, 27) * s_prime1 + s_prime4;
+                data += 8;
+            }
+
+            if (data + 4 <= end)
+            {
+                hash ^= static_cast<AZ::u64>(Read32(data)) * s_prime1;
+                hash = RotateLeft(hash, 23) * s_prime2 + s_prime3;
+                data += 4;
+            }
+
+            while (data < end)
+            {
+                hash ^= (*data) * s_prime5;
+                hash = RotateLeft(hash, 11) * s_prime1;
+                ++data;
+            }
+
+            hash ^= hash >> 33;
+            hash *= s_prime2;
+            hash ^= hash >> 29;
+            hash *= s_prime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+    private:
+        void ConsumeStripe(const unsigned char* data)
+        {
+            m_lanes[0] = Round(m_lanes[0], Read64(data));
+            m_lanes[1] = Round(m_lanes[1], Read64(data + 8));
+            m_lanes[2] = Round(m_lanes[2], Read64(data + 16));
+            m_lanes[3] = Round(m_lanes[3], Read64(data + 24));
+        }
+
+        AZ::u64 m_seed;
+        AZ::u64 m_lanes[4];
+        AZ::u64 m_totalSize = 0;
+        unsigned char m_buffer[32];
+        unsigned int m_bufferedSize = 0;
+    };
+}
+
+namespace AssetUtilities
+{
+    AZ::u64 ComputeContentHash(const void* data, AZ::u64 dataSize, AZ::u64 seed /*= 0*/)
+    {
+        AssetUtilsInternal::ContentHasher hasher(seed);
+        hasher.Update(reinterpret_cast<const unsigned char*>(data), dataSize);
+        return hasher.Finish();
+    }
+
+    bool ComputeFileContentHash(const QString& fullPathToFile, AZ::u64& hash)
+    {
+        QFile file(fullPathToFile);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            return false;
+        }
+
+        AssetUtilsInternal::ContentHasher hasher(0);
+        qint64 fileSize = file.size();
+
+        if (fileSize > 0)
+        {
+            uchar* mapped = file.map(0, fileSize);
+            if (mapped)
+            {
+                hasher.Update(mapped, static_cast<AZ::u64>(fileSize));
+                file.unmap(mapped);
+            }
+            else
+            {
+                // mapping can fail for very large files or on some network shares, so fall back to streaming
+                QByteArray chunk;
+                chunk.resize(static_cast<int>(AssetUtilsInternal::s_hashStreamChunkSize));
+                qint64 bytesRead = 0;
+                while ((bytesRead = file.read(chunk.data(), AssetUtilsInternal::s_hashStreamChunkSize)) > 0)
+                {
+                    hasher.Update(reinterpret_cast<const unsigned char*>(chunk.constData()), static_cast<AZ::u64>(bytesRead));
+                }
+
+                if (bytesRead < 0)
+                {
+                    return false;
+                }
+            }
+        }
+
+        hash = hasher.Finish();
+        return true;
+    }
+
+    bool StatFileForHash(const QString& fullPathToFile, FileHashEntry& entry)
+    {
+        QFileInfo fileInfo(fullPathToFile);
+        if (!fileInfo.exists())
+        {
+            return false;
+        }
+
+        entry.m_size = static_cast<AZ::u64>(fileInfo.size());
+        entry.m_modTime = fileInfo.lastModified().toMSecsSinceEpoch();
+        entry.m_fileId = 0;
+
+#if defined(AZ_PLATFORM_WINDOWS)
+        // opening with no access rights only reads metadata, and does not interfere with anyone else writing the file.
+        HANDLE fileHandle = ::CreateFileW(reinterpret_cast<const wchar_t*>(fullPathToFile.utf16()), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (fileHandle != INVALID_HANDLE_VALUE)
+        {
+            BY_HANDLE_FILE_INFORMATION info;
+            if (::GetFileInformationByHandle(fileHandle, &info))
+            {
+                entry.m_fileId = (static_cast<AZ::u64>(info.nFileIndexHigh) << 32) | static_cast<AZ::u64>(info.nFileIndexLow);
+            }
+            ::CloseHandle(fileHandle);
+        }
+#else
+        struct stat statResult;
+        if (::stat(fullPathToFile.toUtf8().constData(), &statResult) == 0)
+        {
+            entry.m_fileId = static_cast<AZ::u64>(statResult.st_ino);
+        }
+#endif
+        return true;
+    }
+
+    QString FileHashCache::MakeKey(const QString& fullPathToFile)
+    {
+        // only fold case where the file system does, otherwise two distinct files would share an entry.
+#if defined(AZ_PLATFORM_WINDOWS) || defined(AZ_PLATFORM_APPLE)
+        return NormalizeFilePath(fullPathToFile).toLower();
+#else
+        return NormalizeFilePath(fullPathToFile);
+#endif
+    }
+
+    bool FileHashCache::GetHash(const QString& fullPathToFile, AZ::u64& hash)
+    {
+        FileHashEntry current;
+        if (!StatFileForHash(fullPathToFile, current))
+        {
+            return false;
+        }
+
+        QString key = MakeKey(fullPathToFile);
+        {
+            QMutexLocker locker(&m_mutex);
+            auto found = m_entries.find(key);
+            if ((found != m_entries.end()) && (found.value().MatchesStat(current)))
+            {
+                hash = found.value().m_hash;
+                return true;
+            }
+        }
+
+        // do the actual reading outside of the lock so that many threads can hash different files at once.
+        if (!ComputeFileContentHash(fullPathToFile, current.m_hash))
+        {
+            return false;
+        }
+        hash = current.m_hash;
+
+        // if the file changed while we were reading it, or it is too young to trust its timestamp, don't remember the result.
+        FileHashEntry after;
+        if ((!StatFileForHash(fullPathToFile, after)) || (!after.MatchesStat(current)))
+        {
+            return true;
+        }
+
+        if (QDateTime::currentMSecsSinceEpoch() - current.m_modTime < AssetUtilsInternal::s_minimumFileAgeForCachingMs)
+        {
+            return true;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_entries[key] = current;
+        m_dirty.insert(key);
+        m_removed.remove(key);
+        return true;
+    }
+
+    void FileHashCache::Load(const QString& fullPathToFile, const FileHashEntry& entry)
+    {
+        QString key = MakeKey(fullPathToFile);
+        QMutexLocker locker(&m_mutex);
+        m_entries[key] = entry;
+    }
+
+    void FileHashCache::Invalidate(const QString& fullPathToFile)
+    {
+        QString key = MakeKey(fullPathToFile);
+        QMutexLocker locker(&m_mutex);
+        if (m_entries.remove(key))
+        {
+            m_dirty.remove(key);
+            m_removed.insert(key);
+        }
+    }
+
+    void FileHashCache::TakeDirtyEntries(AZStd::vector<FileHashRecord>& entries)
+    {
+        QMutexLocker locker(&m_mutex);
+        entries.reserve(entries.size() + m_dirty.size());
+        for (const QString& key : m_dirty)
+        {
+            auto found = m_entries.find(key);
+            if (found != m_entries.end())
+            {
+                entries.push_back(FileHashRecord(key, found.value()));
+            }
+        }
+        m_dirty.clear();
+    }
+
+    void FileHashCache::TakeRemovedEntries(QStringList& fileNames)
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString& key : m_removed)
+        {
+            fileNames.push_back(key);
+        }
+        m_removed.clear();
+    }
+
+    void FileHashCache::Clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_entries.clear();
+        m_dirty.clear();
+        m_removed.clear();
+    }
+
+    int FileHashCache::Size() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_entries.size();
+    }
+
+    FileHashCache& GetFileHashCache()
+    {
+        static FileHashCache s_fileHashCache;
+        return s_fileHashCache;
+    }
+} // namespace AssetUtilities
@@ -0,0 +1,93 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef ASSETPROCESSOR_FILEHASHCACHE_H
+#define ASSETPROCESSOR_FILEHASHCACHE_H
+
+#include <AzCore/base.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/utils.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace AssetUtilities
+{
+    //! The identity of a file on disk at a given moment.  If any of these change, the cached content hash is stale.
+    struct FileHashEntry
+    {
+        AZ::u64 m_size = 0;
+        AZ::s64 m_modTime = 0; // milliseconds since epoch
+        AZ::u64 m_fileId = 0; // inode on posix, file index on windows, 0 if unknown
+        AZ::u64 m_hash = 0;
+
+        bool MatchesStat(const FileHashEntry& other) const
+        {
+            return (m_size == other.m_size) && (m_modTime == other.m_modTime) && (m_fileId == other.m_fileId);
+        }
+    };
+
+    typedef AZStd::pair<QString, FileHashEntry> FileHashRecord;
+
+    //! Compute a 64 bit hash (XXH64) of the contents of the given file.
+    //! The file is memory mapped if possible, and otherwise streamed in fixed size chunks.
+    //! returns false if the file could not be read.
+    bool ComputeFileContentHash(const QString& fullPathToFile, AZ::u64& hash);
+
+    //! Compute a 64 bit hash (XXH64) of a block of memory.
+    AZ::u64 ComputeContentHash(const void* data, AZ::u64 dataSize, AZ::u64 seed = 0);
+
+    //! Fill out the stat portion (size, modification time, file id) of an entry.  returns false if the file does not exist.
+    bool StatFileForHash(const QString& fullPathToFile, FileHashEntry& entry);
+
+    //! FileHashCache maps (path, size, mtime, file id) to the hash of the contents of that file so that
+    //! unchanged files only ever have to be read once.  It is safe to use from any thread.
+    //! It has no knowledge of the database; whoever owns the database is expected to Load() it at startup
+    //! and periodically persist the entries returned from TakeDirtyEntries() / TakeRemovedEntries().
+    class FileHashCache
+    {
+    public:
+        //! Retrieve the hash of the file, hashing it only if it is unknown or its stat has changed.
+        //! returns false if the file does not exist or could not be read.
+        bool GetHash(const QString& fullPathToFile, AZ::u64& hash);
+
+        //! Add an entry that is already known to be persisted (does not mark it dirty).
+        void Load(const QString& fullPathToFile, const FileHashEntry& entry);
+
+        //! Forget about a file, for example because it was deleted.
+        void Invalidate(const QString& fullPathToFile);
+
+        //! Remove and return all entries which have been hashed since the last call.
+        void TakeDirtyEntries(AZStd::vector<FileHashRecord>& entries);
+
+        //! Remove and return all file names invalidated since the last call.
+        void TakeRemovedEntries(QStringList& fileNames);
+
+        void Clear();
+        int Size() const;
+
+    private:
+        static QString MakeKey(const QString& fullPathToFile);
+
+        mutable QMutex m_mutex;
+        QHash<QString, FileHashEntry> m_entries;
+        QSet<QString> m_dirty;
+        QSet<QString> m_removed;
+    };
+
+    //! The single cache used by GenerateBaseFingerprint when content hash fingerprinting is enabled.
+    FileHashCache& GetFileHashCache();
+} // namespace AssetUtilities
+
+#endif // ASSETPROCESSOR_FILEHASHCACHE_H
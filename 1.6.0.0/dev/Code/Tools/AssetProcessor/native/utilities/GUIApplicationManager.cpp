@@ -602,6 +602,8 @@ void GUIApplicationManager::InitConnectionManager()
     QObject::connect(m_fileServer, SIGNAL(AddCopyRequest(unsigned int, bool)), m_connectionManager, SLOT(AddCopyRequest(unsigned int, bool)));
     QObject::connect(m_fileServer, SIGNAL(AddRenameRequest(unsigned int, bool)), m_connectionManager, SLOT(AddRenameRequest(unsigned int, bool)));
     QObject::connect(m_fileServer, SIGNAL(AddFindFileNamesRequest(unsigned int, bool)), m_connectionManager, SLOT(AddFindFileNamesRequest(unsigned int, bool)));
+    QObject::connect(m_fileServer, SIGNAL(AddBytesReadAhead(unsigned int, qint64, bool)), m_connectionManager, SLOT(AddBytesReadAhead(unsigned int, qint64, bool)));
+    QObject::connect(m_fileServer, SIGNAL(AddRequestTime(unsigned int, qint64, bool)), m_connectionManager, SLOT(AddRequestTime(unsigned int, qint64, bool)));
     QObject::connect(m_fileServer, SIGNAL(UpdateConnectionMetrics()), m_connectionManager, SLOT(UpdateConnectionMetrics()));
 
     m_connectionManager->ReadProxyServerInformation();
@@ -145,6 +145,10 @@ void PlatformConfiguration::ReadRecognizersFromConfigFile(QString iniPath)
         m_maxJobs = loader.value("maxJobs", m_maxJobs).toInt();
         loader.endGroup();
 
+        loader.beginGroup("Fingerprinting");
+        m_contentHashFingerprints = (loader.value("contentHash", m_contentHashFingerprints ? 1 : 0).toInt() == 1);
+        loader.endGroup();
+
         // Read in scan folders and RC flags per asset/platform
         QStringList groups = loader.childGroups();
         for (QString group : groups)
@@ -528,6 +532,11 @@ int PlatformConfiguration::GetMaxJobs() const
     return m_maxJobs;
 }
 
+bool PlatformConfiguration::UseContentHashFingerprints() const
+{
+    return m_contentHashFingerprints;
+}
+
 
 bool PlatformConfiguration::ReadRecognizerFromConfig(AssetRecognizer& target, QSettings& loader)
 {
@@ -123,6 +123,9 @@ namespace AssetProcessor
         int GetMinJobs() const;
         int GetMaxJobs() const;
 
+        //! Whether source fingerprints should hash file contents rather than use modification times
+        bool UseContentHashFingerprints() const;
+
         //! Return how many scan folders there are
         int GetScanFolderCount() const;
 
@@ -199,6 +202,7 @@ namespace AssetProcessor
 
         int m_minJobs = 1;
         int m_maxJobs = 3;
+        bool m_contentHashFingerprints = false;
 
         bool ReadRecognizerFromConfig(AssetRecognizer& target, QSettings& loader); // assumes the group is already selected
     };
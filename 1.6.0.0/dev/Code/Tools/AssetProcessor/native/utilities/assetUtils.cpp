@@ -10,6 +10,7 @@
 *
 */
 #include "AssetUtils.h"
+#include "native/utilities/FileHashCache.h"
 
 #include "native/utilities/PlatformConfiguration.h"
 #include "native/AssetManager/assetScanner.h"
@@ -91,6 +92,9 @@ namespace AssetUtilsInternal
     };
     AZ_THREAD_LOCAL bool AssertAbsorber::s_onAbsorbThread = false;
 
+    // set once at startup from the platform configuration, before any jobs are running.
+    static bool s_contentHashFingerprinting = false;
+
     bool FileCopyMoveWithTimeout(QString sourceFile, QString outputFile, bool isCopy, unsigned int waitTimeInSeconds)
     {
         if (waitTimeInSeconds < 0)
@@ -888,6 +892,16 @@ namespace AssetUtilities
         return fingerprint;
     }
 
+    void SetContentHashFingerprinting(bool enable)
+    {
+        AssetUtilsInternal::s_contentHashFingerprinting = enable;
+    }
+
+    bool IsContentHashFingerprinting()
+    {
+        return AssetUtilsInternal::s_contentHashFingerprinting;
+    }
+
     unsigned int GenerateBaseFingerprint(QString fullPathToFile, QString extraInfo /*= QString()*/)
     {
         QFileInfo fi(fullPathToFile);
@@ -896,9 +910,23 @@ namespace AssetUtilities
             return 0;
         }
         unsigned int fingerprint = 0;
-        QDateTime mod = fi.lastModified();
 
         fingerprint = AssetUtilities::ComputeCRC32(extraInfo.toStdString().data(), extraInfo.toStdString().length(), static_cast<unsigned int>(extraInfo.size()));
+
+        if (IsContentHashFingerprinting())
+        {
+            AZ::u64 contentHash = 0;
+            if (GetFileHashCache().GetHash(fullPathToFile, contentHash))
+            {
+                fingerprint = AssetUtilities::ComputeCRC32(&contentHash, sizeof(contentHash), fingerprint);
+                return fingerprint;
+            }
+            // if the file cannot be read right now (for example, its locked), fall through to the timestamp
+            // so that the fingerprint still changes and the job is retried once it can be read.
+            AZ_TracePrintf(AssetProcessor::DebugChannel, "Unable to hash %s, using its timestamp instead.\n", fullPathToFile.toUtf8().constData());
+        }
+
+        QDateTime mod = fi.lastModified();
         qint64 highreztimer = mod.toMSecsSinceEpoch();
         AZ_TracePrintf(AssetProcessor::DebugChannel, "ms since epoch: %llu", highreztimer);
         fingerprint = AssetUtilities::ComputeCRC32(&highreztimer, sizeof(highreztimer), fingerprint);
@@ -185,6 +185,12 @@ namespace AssetUtilities
     // Generates a fingerprint for a file without querying the existence of metadata files.  Helper function for GenerateFingerprint.
     unsigned int GenerateBaseFingerprint(QString fullPathToFile, QString extraInfo = QString());
 
+    //! When enabled, fingerprints are based on a hash of the file contents instead of its modification time,
+    //! so that touching a file (or switching branches, or a fresh clone) does not cause it to be reprocessed.
+    //! Hashes are cached in AssetUtilities::GetFileHashCache() by (path, size, mtime, file id).
+    void SetContentHashFingerprinting(bool enable);
+    bool IsContentHashFingerprinting();
+
     //! This class represents a matching pattern that is based on AssetBuilderSDK::AssetBuilderPattern::PatternType, which can either be a regex
     //! pattern or a wildcar (glob) pattern
     class FilePatternMatcher
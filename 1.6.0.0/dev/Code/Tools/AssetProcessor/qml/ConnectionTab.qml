@@ -826,6 +826,56 @@ Item {
              font.pointSize: 8
          }
 
+         Text {
+             id: bytesReadAheadLabel
+             width: 112
+             height: 20
+             text: qsTr("Read Ahead Bytes:")
+             anchors.top: renameRequestsLabel.bottom
+             anchors.topMargin: 9
+             anchors.left: renameRequestsLabel.left
+             font.family: "Helvetica"
+             font.pointSize: 8
+         }
+
+         Text {
+             id: bytesReadAhead
+             width: 91
+             height: 20
+             text: conn.bytesReadAhead
+             anchors.verticalCenter: bytesReadAheadLabel.verticalCenter
+             horizontalAlignment: Text.AlignLeft
+             anchors.left: bytesReadAheadLabel.right
+             anchors.leftMargin: -1
+             font.family: "Helvetica"
+             font.pointSize: 8
+         }
+
+         Text {
+             id: requestTimeLabel
+             width: 117
+             height: 20
+             text: qsTr("Request Avg/Max (us):")
+             anchors.top: findFilesRequestsLabel.bottom
+             anchors.topMargin: 9
+             anchors.left: findFilesRequestsLabel.left
+             font.family: "Helvetica"
+             font.pointSize: 8
+         }
+
+         Text {
+             id: requestTime
+             width: 123
+             height: 20
+             text: conn.averageRequestTime + " / " + conn.maxRequestTime
+             anchors.verticalCenter: requestTimeLabel.verticalCenter
+             anchors.left: requestTimeLabel.right
+             anchors.leftMargin: 0
+             horizontalAlignment: Text.AlignLeft
+             font.family: "Helvetica"
+             font.pointSize: 8
+         }
+
 
          Text {
              id: openFilesLabel
@@ -760,6 +760,31 @@ ColumnLayout {
             font.pointSize: 8
         }
 
+        Text {
+            id: readAheadHitsLabel
+            width: 97
+            height: 20
+            text: qsTr("Read Ahead Hits:")
+            anchors.left: openFilesLabel.left
+            anchors.top: openFilesLabel.bottom
+            anchors.topMargin: 6
+            font.family: "Helvetica"
+            font.pointSize: 8
+        }
+
+        Text {
+            id: readAheadHits
+            width: 123
+            height: 20
+            text: fileServer.numReadAheadHits
+            anchors.verticalCenter: readAheadHitsLabel.verticalCenter
+            anchors.left: readAheadHitsLabel.right
+            anchors.leftMargin: 0
+            horizontalAlignment: Text.AlignLeft
+            font.family: "Helvetica"
+            font.pointSize: 8
+        }
+
         Text {
             id: openFileRequestsLabel
             width: 121
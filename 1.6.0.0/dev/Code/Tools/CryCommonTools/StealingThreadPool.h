@@ -110,6 +110,43 @@ namespace ThreadUtils {
         bool m_submited;
         friend class StealingThreadPool;
     };
+
+
+    // JobGroupWaiter lets a thread which is not a worker of the pool block until
+    // a JobGroup is done, without waiting for unrelated jobs like WaitAllJobs() does.
+    // Usage: pool.CreateJobGroup(&JobGroupWaiter::Signal, &waiter), Add(), Submit(), waiter.Wait()
+    class JobGroupWaiter
+    {
+    public:
+        JobGroupWaiter()
+            : m_finished(false)
+        {
+        }
+
+        static void Signal(JobGroupWaiter* waiter)
+        {
+            AutoLock lock(waiter->m_lock);
+            waiter->m_finished = true;
+            waiter->m_finishedCV.WakeAll();
+        }
+
+        void Wait()
+        {
+            AutoLock lock(m_lock);
+            while (!m_finished)
+            {
+                m_finishedCV.Sleep(m_lock);
+            }
+        }
+
+    private:
+        JobGroupWaiter(const JobGroupWaiter&);
+        JobGroupWaiter& operator=(const JobGroupWaiter&);
+
+        CriticalSection m_lock;
+        ConditionVariable m_finishedCV;
+        bool m_finished;
+    };
 }
 
 #endif // CRYINCLUDE_CRYCOMMONTOOLS_STEALINGTHREADPOOL_H
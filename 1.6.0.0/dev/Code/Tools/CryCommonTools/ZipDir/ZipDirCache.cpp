@@ -144,7 +144,7 @@ ZipDir::ErrorEnum ZipDir::Cache::ReadFile (FileEntry* pFileEntry, void* pCompres
         else
         {
             unsigned long nSizeUncompressed = pFileEntry->desc.lSizeUncompressed;
-            if (Z_OK != ZipRawUncompress(pUncompressed, &nSizeUncompressed, pBuffer, pFileEntry->desc.lSizeCompressed))
+            if (Z_OK != ZipRawUncompressMethod(pFileEntry->nMethod, pUncompressed, &nSizeUncompressed, pBuffer, pFileEntry->desc.lSizeCompressed))
             {
                 return ZD_ERROR_CORRUPTED_DATA;
             }
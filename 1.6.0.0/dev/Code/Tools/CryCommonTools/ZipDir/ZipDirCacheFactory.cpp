@@ -703,7 +703,7 @@ void ZipDir::CacheFactory::Validate(const FileEntry& fileEntry)
     int nError = Z_OK;
     if (fileEntry.nMethod)
     {
-        nError = ZipRawUncompress (pUncompressed, &nDestSize, pCompressed, fileEntry.desc.lSizeCompressed);
+        nError = ZipRawUncompressMethod (fileEntry.nMethod, pUncompressed, &nDestSize, pCompressed, fileEntry.desc.lSizeCompressed);
     }
     else
     {
@@ -26,6 +26,7 @@
 #include "ThreadUtils.h"
 
 #include <zlib.h>  // declaration of Z_OK for ZipRawDecompress
+#include <map>
 
 using namespace ZipFile;
 
@@ -44,6 +45,7 @@ class PackFilePool;
 struct PackFileBatch
 {
     PackFilePool* pool;
+    const ZipDir::EncryptionKey* encryptionKey;
 
     int zipMaxSize;
     int sourceMinSize;
@@ -53,6 +55,7 @@ struct PackFileBatch
 
     PackFileBatch()
         : pool(0)
+        , encryptionKey(0)
         , sourceMinSize(0)
         , sourceMaxSize(0)
         , zipMaxSize(0)
@@ -71,15 +74,27 @@ struct PackFileJob
     const char* relativePathSrc;
     const char* realFilename;
 
+    // usually the ones of the batch, unless a compression policy picked others for this file
+    int compressionMethod;
+    int compressionLevel;
+
     unsigned int existingCRC;
 
+    // CRC of the uncompressed data, calculated by the worker so the writing thread doesn't have to
+    unsigned int uncompressedCRC;
+    bool hasUncompressedCRC;
+
     void* compressedData;
     unsigned long compressedSize;
     unsigned long compressedSizePreviously;
+    unsigned long compressedCapacity;
+    bool compressedPooled;
+    bool compressedEncrypted;
 
     void* uncompressedData;
     unsigned long uncompressedSize;
     unsigned long uncompressedSizePreviously;
+    bool uncompressedMapped;
 
     __int64 modTime;
     ZipDir::ErrorEnum zdError;
@@ -91,13 +106,21 @@ struct PackFileJob
         , batch(0)
         , realFilename(0)
         , relativePathSrc(0)
+        , compressionMethod(0)
+        , compressionLevel(0)
         , existingCRC(0)
+        , uncompressedCRC(0)
+        , hasUncompressedCRC(false)
         , compressedData(0)
         , compressedSize(0)
         , compressedSizePreviously(0)
+        , compressedCapacity(0)
+        , compressedPooled(false)
+        , compressedEncrypted(false)
         , uncompressedData(0)
         , uncompressedSize(0)
         , uncompressedSizePreviously(0)
+        , uncompressedMapped(false)
         , modTime(0)
         , zdError(ZipDir::ZD_ERROR_NOT_IMPLEMENTED)
         , status(PACKFILE_FAILED)
@@ -116,6 +139,28 @@ struct PackFileJob
         uncompressedSize = 0;
     }
 
+    // Drops the source data once it has been compressed, only the size and CRC are needed to store the file.
+    void ReleaseMappedData()
+    {
+        if (uncompressedMapped && uncompressedData && uncompressedData != compressedData)
+        {
+            UnmapViewOfFile(uncompressedData);
+            uncompressedData = 0;
+            uncompressedMapped = false;
+        }
+    }
+
+    // memory held by this job while it waits to be written
+    size_t GetResidentSize() const
+    {
+        size_t size = uncompressedData ? uncompressedSize : 0;
+        if (compressedData && compressedData != uncompressedData)
+        {
+            size += compressedSize;
+        }
+        return size;
+    }
+
     ~PackFileJob()
     {
         if (compressedData && compressedData != uncompressedData)
@@ -126,7 +171,14 @@ struct PackFileJob
 
         if (uncompressedData)
         {
-            free(uncompressedData);
+            if (uncompressedMapped)
+            {
+                UnmapViewOfFile(uncompressedData);
+            }
+            else
+            {
+                free(uncompressedData);
+            }
             uncompressedData = 0;
         }
     }
@@ -137,6 +189,9 @@ struct PackFileJob
 
 static void PackFileFromDisc(PackFileJob* job);
 
+// Compresses files on worker threads while the main thread writes them in submission order.
+// Workers block on m_memoryAvailable once the finished-but-unwritten files exceed the memory limit,
+// the main thread blocks on m_fileReady until the file it has to write next is done.
 class PackFilePool
 {
 public:
@@ -146,12 +201,17 @@ public:
         , m_awaitedFile(0)
         , m_memoryLimit(memoryLimit)
         , m_allocatedMemory(0)
+        , m_pooledMemory(0)
     {
         m_files.reserve(numFiles);
     }
 
     ~PackFilePool()
     {
+        for (Buffers::iterator it = m_freeBuffers.begin(); it != m_freeBuffers.end(); ++it)
+        {
+            free(it->second);
+        }
     }
 
     void Submit(int key, const PackFileJob& job)
@@ -167,25 +227,21 @@ public:
 
     PackFileJob* WaitForFile(int index)
     {
-        while (true)
+        ThreadUtils::AutoLock lock(m_filesLock);
+
+        m_awaitedFile = index;
+        // workers held back by the memory limit may be allowed to continue now
+        m_memoryAvailable.WakeAll();
+
+        if (size_t(index) >= m_files.size())
         {
-            {
-                ThreadUtils::AutoLock lock(m_filesLock);
-                m_awaitedFile = index;
-                if (size_t(index) >= m_files.size())
-                {
-                    return 0;
-                }
-                if (m_files[index])
-                {
-                    return m_files[index];
-                }
-            }
-            Sleep(0);
+            return 0;
         }
-
-        assert(0);
-        return 0;
+        while (!m_files[index])
+        {
+            m_fileReady.Sleep(m_filesLock);
+        }
+        return m_files[index];
     }
 
     void Start(int numThreads)
@@ -207,59 +263,93 @@ public:
 
     void SkipPendingFiles()
     {
+        ThreadUtils::AutoLock lock(m_filesLock);
         m_skip = true;
+        m_memoryAvailable.WakeAll();
     }
 
     void ReleaseFile(int index)
     {
-        assert(m_files[index] != 0);
-        if (m_files[index])
+        ThreadUtils::AutoLock lock(m_filesLock);
+
+        PackFileJob* job = m_files[index];
+        assert(job != 0);
+        if (job)
         {
             if (m_memoryLimit != 0)
             {
-                ThreadUtils::AutoLock lock(m_filesLock);
+                m_allocatedMemory -= job->GetResidentSize();
+                m_memoryAvailable.WakeAll();
+            }
 
-                m_allocatedMemory -= m_files[index]->uncompressedSize;
-                m_allocatedMemory -= m_files[index]->compressedSize;
+            if (job->compressedPooled && job->compressedData)
+            {
+                RecycleBuffer(job->compressedData, job->compressedCapacity);
+                job->compressedData = 0;
+                job->compressedPooled = false;
             }
 
-            delete m_files[index];
+            delete job;
             m_files[index] = 0;
         }
     }
 
+    // Returns a buffer of at least 'size' bytes for compressed data. Buffers come back through
+    // ReleaseFile, so for a long run of files the pool settles at roughly one buffer per file in flight.
+    void* AcquireBuffer(size_t size, unsigned long& capacity)
+    {
+        {
+            ThreadUtils::AutoLock lock(m_filesLock);
+            Buffers::iterator it = m_freeBuffers.lower_bound(size);
+            // don't waste a huge buffer on a tiny file
+            if (it != m_freeBuffers.end() && it->first <= size * 4)
+            {
+                void* buffer = it->second;
+                capacity = (unsigned long)it->first;
+                m_pooledMemory -= it->first;
+                m_freeBuffers.erase(it);
+                return buffer;
+            }
+        }
+
+        capacity = (unsigned long)size;
+        return malloc(size);
+    }
+
 private:
+    typedef std::multimap<size_t, void*> Buffers;
+
+    // called with m_filesLock held
+    void RecycleBuffer(void* buffer, size_t capacity)
+    {
+        const size_t maxPooledMemory = m_memoryLimit ? m_memoryLimit / 4 : size_t(64 * 1024 * 1024);
+        if (m_pooledMemory + capacity > maxPooledMemory)
+        {
+            free(buffer);
+            return;
+        }
+
+        m_pooledMemory += capacity;
+        m_freeBuffers.insert(Buffers::value_type(capacity, buffer));
+    }
 
     // called from non-main thread
     static void ProcessFile(PackFileJob* job)
     {
         PackFilePool* self = job->batch->pool;
 
-        if (!self->m_skip)
+        if (self->m_memoryLimit != 0)
         {
-            if (self->m_memoryLimit != 0)
+            ThreadUtils::AutoLock lock(self->m_filesLock);
+            // the file the main thread waits for, and the one after it, are never held back
+            while (!self->m_skip && self->m_allocatedMemory > self->m_memoryLimit && job->index > self->m_awaitedFile + 1)
             {
-                while (true)
-                {
-                    size_t allocatedMemory = 0;
-                    int awaitedFile = 0;
-                    {
-                        ThreadUtils::AutoLock lock(self->m_filesLock);
-                        allocatedMemory = self->m_allocatedMemory;
-                        awaitedFile = self->m_awaitedFile;
-                    }
-
-                    if (allocatedMemory > self->m_memoryLimit && job->index > awaitedFile + 1)
-                    {
-                        Sleep(10); // give time to main thread to write data to file
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
+                self->m_memoryAvailable.Sleep(self->m_filesLock);
             }
+        }
 
+        if (!self->m_skip)
+        {
             PackFileFromDisc(job);
         }
 
@@ -278,18 +368,27 @@ private:
 
         if (m_memoryLimit != 0)
         {
-            m_allocatedMemory += job->uncompressedSize;
-            m_allocatedMemory += job->compressedSize;
+            m_allocatedMemory += job->GetResidentSize();
+        }
+
+        if (job->index == m_awaitedFile)
+        {
+            m_fileReady.WakeAll();
         }
     }
 
     size_t m_memoryLimit;
 
     ThreadUtils::CriticalSection m_filesLock;
+    ThreadUtils::ConditionVariable m_fileReady;
+    ThreadUtils::ConditionVariable m_memoryAvailable;
     std::vector<PackFileJob*> m_files;
     int m_awaitedFile;
     size_t m_allocatedMemory;
-    bool m_skip;
+    volatile bool m_skip;
+
+    Buffers m_freeBuffers;
+    size_t m_pooledMemory;
 
     ThreadUtils::SimpleThreadPool m_pool;
 };
@@ -437,10 +536,12 @@ char* ZipDir::CacheRW::AllocPath(const char* pPath)
 
 static void PackFileFromMemory(PackFileJob* job)
 {
+    job->uncompressedCRC = (unsigned int)crc32(0, (unsigned char*)job->uncompressedData, job->uncompressedSize);
+    job->hasUncompressedCRC = true;
+
     if (job->existingCRC != 0)
     {
-        unsigned int crcCode = (unsigned int)crc32(0, (unsigned char*)job->uncompressedData, job->uncompressedSize);
-        if (crcCode == job->existingCRC)
+        if (job->uncompressedCRC == job->existingCRC)
         {
             job->compressedData = 0;
             job->compressedSize = 0;
@@ -451,21 +552,40 @@ static void PackFileFromMemory(PackFileJob* job)
         }
     }
 
-    switch (job->batch->compressionMethod)
+    switch (job->compressionMethod)
     {
     case METHOD_DEFLATE_AND_ENCRYPT:
     case METHOD_DEFLATE:
+    case METHOD_LZ4:
     {
-        // allocate memory for compression. Min is nSize * 1.001 + 12
         if (job->uncompressedSize > 0)
         {
-            job->compressedSize = job->uncompressedSize + (job->uncompressedSize >> 3) + 32;
-            job->compressedData = malloc(job->compressedSize);
-            int error = ZipDir::ZipRawCompress(job->uncompressedData, &job->compressedSize, job->compressedData, job->uncompressedSize, job->batch->compressionLevel);
+            const size_t bufferSize = ZipDir::ZipRawCompressBound(job->compressionMethod, job->uncompressedSize);
+            if (job->batch->pool)
+            {
+                job->compressedData = job->batch->pool->AcquireBuffer(bufferSize, job->compressedCapacity);
+                job->compressedPooled = true;
+            }
+            else
+            {
+                job->compressedData = malloc(bufferSize);
+                job->compressedCapacity = (unsigned long)bufferSize;
+            }
+            job->compressedSize = job->compressedCapacity;
+            int error = job->compressionMethod == METHOD_LZ4
+                ? ZipDir::ZipRawCompressLZ4(job->uncompressedData, &job->compressedSize, job->compressedData, job->uncompressedSize, job->compressionLevel)
+                : ZipDir::ZipRawCompress(job->uncompressedData, &job->compressedSize, job->compressedData, job->uncompressedSize, job->compressionLevel);
             if (error == Z_OK)
             {
                 job->status = PACKFILE_COMPRESSED;
                 job->zdError = ZipDir::ZD_ERROR_SUCCESS;
+
+                // the buffer is ours, so encrypt it here instead of copying it while writing
+                if (job->compressionMethod == METHOD_DEFLATE_AND_ENCRYPT && job->batch->encryptionKey)
+                {
+                    ZipDir::Encrypt((char*)job->compressedData, job->compressedSize, *job->batch->encryptionKey);
+                    job->compressedEncrypted = true;
+                }
             }
             else
             {
@@ -609,8 +729,18 @@ void ZipDir::CacheRW::StorePackedFile(PackFileJob* job)
         return;
     }
 
-    pFileEntry->OnNewFileData(job->uncompressedData, job->uncompressedSize,
-        job->compressedSize, job->batch->compressionMethod, false);
+    if (job->hasUncompressedCRC)
+    {
+        // the source data may already be released, the worker calculated the CRC for us
+        pFileEntry->OnNewFileData(NULL, job->uncompressedSize,
+            job->compressedSize, job->compressionMethod, false);
+        pFileEntry->desc.lCRC32 = job->uncompressedCRC;
+    }
+    else
+    {
+        pFileEntry->OnNewFileData(job->uncompressedData, job->uncompressedSize,
+            job->compressedSize, job->compressionMethod, false);
+    }
     pFileEntry->SetFromFileTimeNTFS(job->modTime);
 
     // since we changed the time, we'll have to update CDR
@@ -671,17 +801,19 @@ void ZipDir::CacheRW::StorePackedFile(PackFileJob* job)
 
     // now we have the fresh local header and data offset
 
+    // the data usually follows the local header directly, seeking anyway would flush the header
+    // out of the stdio buffer as a separate tiny write
 #ifdef WIN32
-    if (_fseeki64 (m_pFile, (__int64)pFileEntry->nFileDataOffset, SEEK_SET) != 0)
+    if (_ftelli64(m_pFile) != (__int64)pFileEntry->nFileDataOffset && _fseeki64 (m_pFile, (__int64)pFileEntry->nFileDataOffset, SEEK_SET) != 0)
 #else
-    if (fseek (m_pFile, pFileEntry->nFileDataOffset, SEEK_SET) != 0)
+    if (ftell(m_pFile) != (long)pFileEntry->nFileDataOffset && fseek (m_pFile, pFileEntry->nFileDataOffset, SEEK_SET) != 0)
 #endif
     {
         job->zdError = ZD_ERROR_IO_FAILED;
         return;
     }
 
-    const bool encrypt = pFileEntry->nMethod == METHOD_DEFLATE_AND_ENCRYPT;
+    const bool encrypt = pFileEntry->nMethod == METHOD_DEFLATE_AND_ENCRYPT && !job->compressedEncrypted;
 
     if (!WriteCompressedData((char*)job->compressedData, job->compressedSize, encrypt, m_pFile))
     {
@@ -709,17 +841,21 @@ ZipDir::ErrorEnum ZipDir::CacheRW::UpdateFile (const char* szRelativePathSrc, vo
     PackFileBatch batch;
     batch.compressionMethod = nCompressionMethod;
     batch.compressionLevel = nCompressionLevel;
+    batch.encryptionKey = &m_encryptionKey;
 
     PackFileJob job;
     job.relativePathSrc = szRelativePathSrc;
+    job.compressionMethod = nCompressionMethod;
+    job.compressionLevel = nCompressionLevel;
     job.modTime = modTime;
     job.uncompressedData = pUncompressed;
     job.uncompressedSize = nSize;
     job.batch = &batch;
 
     // crc will be used to check if this file need to be updated at all
+    // an entry stored with another method is re-encoded even if its data didn't change
     ZipDir::FileEntry* entry = FindFile(szRelativePath);
-    if (entry)
+    if (entry && entry->nMethod == job.compressionMethod)
     {
         job.existingCRC = entry->desc.lCRC32;
     }
@@ -781,48 +917,66 @@ static void PackFileFromDisc(PackFileJob* job)
     lt.LowPart = ft.dwLowDateTime;
     job->modTime = lt.QuadPart;
 
-    FILE* f = fopen(job->realFilename, "rb");
-    if (!f)
+    HANDLE hFile = CreateFileA(job->realFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
     {
         job->status = PACKFILE_FAILED;
         job->zdError = ZipDir::ZD_ERROR_FILE_NOT_FOUND;
         return;
     }
 
-    fseek(f, 0, SEEK_END);
-    size_t fileSize = (size_t)ftell(f);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size))
+    {
+        CloseHandle(hFile);
+
+        job->status = PACKFILE_FAILED;
+        job->zdError = ZipDir::ZD_ERROR_IO_FAILED;
+        return;
+    }
+    const size_t fileSize = (size_t)size.QuadPart;
 
     if (fileSize < job->batch->sourceMinSize || (job->batch->sourceMaxSize > 0 && fileSize > job->batch->sourceMaxSize))
     {
-        fclose(f);
+        CloseHandle(hFile);
 
         job->status = PACKFILE_SKIPPED;
         job->zdError = ZipDir::ZD_ERROR_SUCCESS;
         return;
     }
 
-    job->uncompressedData = malloc(fileSize);
-
-    fseek(f, 0, SEEK_SET);
-    if (fread(job->uncompressedData, 1, fileSize, f) != fileSize)
+    // map the file instead of reading it into a heap copy, empty files can't be mapped
+    if (fileSize > 0)
     {
-        free(job->uncompressedData);
-        job->uncompressedData = 0;
-        fclose(f);
+        HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        void* view = hMapping ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (hMapping)
+        {
+            // the view keeps the mapping alive
+            CloseHandle(hMapping);
+        }
+        if (!view)
+        {
+            CloseHandle(hFile);
 
-        job->status = PACKFILE_FAILED;
-        job->zdError = ZipDir::ZD_ERROR_IO_FAILED;
-        return;
+            job->status = PACKFILE_FAILED;
+            job->zdError = ZipDir::ZD_ERROR_IO_FAILED;
+            return;
+        }
+        job->uncompressedData = view;
+        job->uncompressedMapped = true;
     }
-    fclose(f);
+    CloseHandle(hFile);
     job->uncompressedSize = fileSize;
 
     PackFileFromMemory(job);
+
+    job->ReleaseMappedData();
 }
 
 bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char** filenamesInZip, size_t fileCount,
     int compressionLevel, bool encryptContent, size_t zipMaxSize, int sourceMinSize, int sourceMaxSize,
-    int numExtraThreads, ZipDir::IReporter* reporter, ZipDir::ISplitter* splitter)
+    int numExtraThreads, ZipDir::IReporter* reporter, ZipDir::ISplitter* splitter, const ZipDir::ICompressionPolicy* compressionPolicy)
 {
     int compressionMethod = METHOD_DEFLATE;
     if (encryptContent)
@@ -842,6 +996,7 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
     batch.compressionLevel = compressionLevel;
     batch.compressionMethod = compressionMethod;
     batch.pool = 0;
+    batch.encryptionKey = &m_encryptionKey;
     batch.sourceMinSize = sourceMinSize;
     batch.sourceMaxSize = sourceMaxSize;
     batch.zipMaxSize = zipMaxSize;
@@ -859,6 +1014,13 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
             job.relativePathSrc = filenameInZip;
             job.realFilename = realFilename;
             job.batch = &batch;
+            job.compressionMethod = compressionMethod;
+            job.compressionLevel = compressionLevel;
+            // encrypted content is always deflated, the encryption is tied to its method id
+            if (compressionPolicy && !encryptContent)
+            {
+                compressionPolicy->GetCompression(filenameInZip, job.compressionMethod, job.compressionLevel);
+            }
 
             {
                 // crc will be used to check if this file need to be updated at all
@@ -873,12 +1035,15 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
                     lt.HighPart = ft.dwHighDateTime;
                     lt.LowPart = ft.dwLowDateTime;
                     job.modTime = lt.QuadPart;
-                    job.existingCRC = entry->desc.lCRC32;
                     job.compressedSizePreviously = entry->desc.lSizeCompressed;
                     job.uncompressedSizePreviously = entry->desc.lSizeUncompressed;
 
+                    // an entry stored with another method (the compression policy changed) is re-encoded even if its data didn't change
+                    const bool sameMethod = entry->nMethod == job.compressionMethod;
+                    job.existingCRC = sameMethod ? entry->desc.lCRC32 : 0;
+
                     // Check if file with the same name, timestamp and size already exists in pak.
-                    if (entry->CompareFileTimeNTFS(job.modTime) && fileSize == entry->desc.lSizeUncompressed)
+                    if (sameMethod && entry->CompareFileTimeNTFS(job.modTime) && fileSize == entry->desc.lSizeUncompressed)
                     {
                         if (reporter)
                         {
@@ -976,6 +1141,13 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
             job.relativePathSrc = filenameInZip;
             job.realFilename = realFilename;
             job.batch = &batch;
+            job.compressionMethod = compressionMethod;
+            job.compressionLevel = compressionLevel;
+            // encrypted content is always deflated, the encryption is tied to its method id
+            if (compressionPolicy && !encryptContent)
+            {
+                compressionPolicy->GetCompression(filenameInZip, job.compressionMethod, job.compressionLevel);
+            }
 
             {
                 // crc will be used to check if this file need to be updated at all
@@ -988,12 +1160,15 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
                     lt.HighPart = ft.dwHighDateTime;
                     lt.LowPart = ft.dwLowDateTime;
                     job.modTime = lt.QuadPart;
-                    job.existingCRC = entry->desc.lCRC32;
                     job.compressedSizePreviously = entry->desc.lSizeCompressed;
                     job.uncompressedSizePreviously = entry->desc.lSizeUncompressed;
 
+                    // an entry stored with another method (the compression policy changed) is re-encoded even if its data didn't change
+                    const bool sameMethod = entry->nMethod == job.compressionMethod;
+                    job.existingCRC = sameMethod ? entry->desc.lCRC32 : 0;
+
                     // Check if file with the same name, timestamp and size already exists in pak.
-                    if (entry->CompareFileTimeNTFS(job.modTime) && fileSize == entry->desc.lSizeUncompressed)
+                    if (sameMethod && entry->CompareFileTimeNTFS(job.modTime) && fileSize == entry->desc.lSizeUncompressed)
                     {
                         if (reporter)
                         {
@@ -1102,10 +1277,11 @@ bool ZipDir::CacheRW::UpdateMultipleFiles(const char** realFilenames, const char
                 {
                     reporter->ReportFailed(job->realFilename, ""); // TODO reason
                 }
-                continue;
+                break;
             }
             ;
 
+            // hands the memory and the compression buffer back to the workers
             pool.ReleaseFile(i);
         }
     }
@@ -1494,7 +1670,7 @@ ZipDir::ErrorEnum ZipDir::CacheRW::ReadFile (FileEntry* pFileEntry, void* pCompr
             unsigned long nSizeUncompressed = pFileEntry->desc.lSizeUncompressed;
             if (nSizeUncompressed > 0)
             {
-                if (Z_OK != ZipRawUncompress(pUncompressed, &nSizeUncompressed, pBuffer, pFileEntry->desc.lSizeCompressed))
+                if (Z_OK != ZipRawUncompressMethod(pFileEntry->nMethod, pUncompressed, &nSizeUncompressed, pBuffer, pFileEntry->desc.lSizeCompressed))
                 {
                     return ZD_ERROR_CORRUPTED_DATA;
                 }
@@ -62,6 +62,15 @@ namespace ZipDir
         virtual void SetLastFile(size_t total, size_t add, size_t sub, int offset) = 0;
     };
 
+    struct ICompressionPolicy
+    {
+        // Arguments:
+        //   filenameInZip - the name of the file inside of the pak
+        //   method        - in: the method of the batch, out: METHOD_STORE, METHOD_DEFLATE or METHOD_LZ4
+        //   level         - in: the level of the batch, out: zlib level for deflate, 0 (fast) or HC level for LZ4
+        virtual void GetCompression(const char* filenameInZip, int& method, int& level) const = 0;
+    };
+
     struct IEncryptPredicate
     {
         virtual bool Match(const char* filename) = 0;
@@ -112,7 +121,8 @@ namespace ZipDir
         // Adds or updates a bunch of files. Creates directories if needed. Multithreaded when numExtraThreads > 0
         bool UpdateMultipleFiles(const char** realFilenames, const char** filenamesInZip, size_t fileCount,
             int compressionLevel, bool encryptContent, size_t zipMaxSize, int sourceMinSize, int sourceMaxSize,
-            int numExtraThreads, ZipDir::IReporter* reporter, ZipDir::ISplitter* splitter = NULL);
+            int numExtraThreads, ZipDir::IReporter* reporter, ZipDir::ISplitter* splitter = NULL,
+            const ZipDir::ICompressionPolicy* compressionPolicy = NULL);
 
         //   Adds a new file to the zip or update an existing one if it is not compressed - just stored  - start a big file
         ErrorEnum StartContinuousFileUpdate(const char* szRelativePath, unsigned nSize);
@@ -14,6 +14,8 @@
 #include "StdAfx.h"
 #include "smartptr.h"
 #include <zlib.h>
+#include <lz4.h>
+#include <lz4hc.h>
 #include "ZipFileFormat.h"
 #include "ZipDirStructures.h"
 #include <time.h>
@@ -116,6 +118,58 @@ int ZipDir::ZipRawCompress (const void* pUncompressed, unsigned long* pDestSize,
     return err;
 }
 
+int ZipDir::ZipRawUncompressLZ4 (void* pUncompressed, unsigned long* pDestSize, const void* pCompressed, unsigned long nSrcSize)
+{
+    // the uncompressed size is known from the directory, so anything other than an exact fit is corrupted data
+    const int nDecoded = LZ4_decompress_safe((const char*)pCompressed, (char*)pUncompressed, (int)nSrcSize, (int)*pDestSize);
+    if (nDecoded < 0 || (unsigned long)nDecoded != *pDestSize)
+    {
+        return Z_DATA_ERROR;
+    }
+    return Z_OK;
+}
+
+int ZipDir::ZipRawCompressLZ4 (const void* pUncompressed, unsigned long* pDestSize, void* pCompressed, unsigned long nSrcSize, int nLevel)
+{
+    const int nCompressed = nLevel > 0
+        ? LZ4_compressHC2_limitedOutput((const char*)pUncompressed, (char*)pCompressed, (int)nSrcSize, (int)*pDestSize, nLevel)
+        : LZ4_compress_limitedOutput((const char*)pUncompressed, (char*)pCompressed, (int)nSrcSize, (int)*pDestSize);
+    if (nCompressed <= 0 && nSrcSize > 0)
+    {
+        return Z_BUF_ERROR;
+    }
+    *pDestSize = (unsigned long)nCompressed;
+    return Z_OK;
+}
+
+unsigned long ZipDir::ZipRawCompressBound (unsigned nMethod, unsigned long nSrcSize)
+{
+    switch (nMethod)
+    {
+    case METHOD_STORE:
+        return nSrcSize;
+    case METHOD_LZ4:
+        return (unsigned long)LZ4_compressBound((int)nSrcSize);
+    default:
+        // Min is nSize * 1.001 + 12
+        return nSrcSize + (nSrcSize >> 3) + 32;
+    }
+}
+
+int ZipDir::ZipRawUncompressMethod (unsigned nMethod, void* pUncompressed, unsigned long* pDestSize, const void* pCompressed, unsigned long nSrcSize)
+{
+    switch (nMethod)
+    {
+    case METHOD_DEFLATE:
+    case METHOD_DEFLATE_AND_ENCRYPT:
+        return ZipRawUncompress(pUncompressed, pDestSize, pCompressed, nSrcSize);
+    case METHOD_LZ4:
+        return ZipRawUncompressLZ4(pUncompressed, pDestSize, pCompressed, nSrcSize);
+    default:
+        return Z_DATA_ERROR;
+    }
+}
+
 // finds the subdirectory entry by the name, using the names from the name pool
 // assumes: all directories are sorted in alphabetical order.
 // case-sensitive (must be lower-case if case-insensitive search in Win32 is performed)
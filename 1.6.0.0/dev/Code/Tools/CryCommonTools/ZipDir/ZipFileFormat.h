@@ -52,7 +52,8 @@ namespace ZipFile
         METHOD_DEFLATE  = 8, // The file is Deflated
         METHOD_DEFLATE64 = 9, // Enhanced Deflating using Deflate64(tm)
         METHOD_IMPLODE_PKWARE = 10, // PKWARE Date Compression Library Imploding
-        METHOD_DEFLATE_AND_ENCRYPT = 11 // Deflate + Custom encryption
+        METHOD_DEFLATE_AND_ENCRYPT = 11, // Deflate + Custom encryption
+        METHOD_LZ4 = 100 // Raw LZ4 block (written by both the fast and the HC compressor), not a PKWARE method
     };
 
     // version numbers
@@ -200,6 +200,22 @@ namespace ZipDir
     // returns one of the Z_* errors (Z_OK upon success), and the size in *pDestSize. the pCompressed buffer must be at least nSrcSize*1.001+12 size
     extern int ZipRawCompress (const void* pUncompressed, unsigned long* pDestSize, void* pCompressed, unsigned long nSrcSize, int nLevel);
 
+    // Uncompresses a raw LZ4 block (method METHOD_LZ4) into exactly *pDestSize bytes
+    // returns one of the Z_* errors (Z_OK upon success)
+    extern int ZipRawUncompressLZ4 (void* pUncompressed, unsigned long* pDestSize, const void* pCompressed, unsigned long nSrcSize);
+
+    // compresses the raw data into a raw LZ4 block. nLevel 0 uses the fast compressor, 1..16 the HC compressor at that level.
+    // returns one of the Z_* errors (Z_OK upon success), and the size in *pDestSize. the pCompressed buffer should be
+    // at least ZipRawCompressBound() bytes
+    extern int ZipRawCompressLZ4 (const void* pUncompressed, unsigned long* pDestSize, void* pCompressed, unsigned long nSrcSize, int nLevel);
+
+    // size of the buffer needed to compress nSrcSize bytes with the given method
+    extern unsigned long ZipRawCompressBound (unsigned nMethod, unsigned long nSrcSize);
+
+    // Uncompresses data stored with any of the supported compression methods (except METHOD_STORE)
+    // returns one of the Z_* errors (Z_OK upon success)
+    extern int ZipRawUncompressMethod (unsigned nMethod, void* pUncompressed, unsigned long* pDestSize, const void* pCompressed, unsigned long nSrcSize);
+
     //////////////////////////////////////////////////////////////////////////
     struct SExtraZipFileData
     {
@@ -0,0 +1,181 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+
+#include "CrySimpleBenchmark.hpp"
+#include "CrySimpleSock.hpp"
+#include "CrySimpleJob.hpp"
+
+#include <Core/StdTypes.hpp>
+#include <Core/Error.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // requests are stored as a 64 bit little endian size followed by the request, the way they arrive on the wire
+    std::mutex g_RecordMutex;
+
+    double Percentile(const std::vector<double>& rSorted, double Fraction)
+    {
+        if (rSorted.empty())
+        {
+            return 0.0;
+        }
+        const size_t Idx = std::min(rSorted.size() - 1, static_cast<size_t>(Fraction * static_cast<double>(rSorted.size())));
+        return rSorted[Idx];
+    }
+}
+
+CCrySimpleBenchmark::CCrySimpleBenchmark(const std::string& rRequestFile, const std::string& rHost, uint16_t Port, uint32_t Connections, uint32_t Repeat)
+    : m_RequestFile(rRequestFile)
+    , m_Host(rHost)
+    , m_Port(Port)
+    , m_Connections(std::max<uint32_t>(Connections, 1))
+    , m_Repeat(std::max<uint32_t>(Repeat, 1))
+{
+}
+
+void CCrySimpleBenchmark::RecordRequest(const std::string& rRequestFile, const std::vector<uint8_t>& rRequest)
+{
+    if (rRequest.empty())
+    {
+        return;
+    }
+
+    uint8_t Header[8];
+    uint64_t Size = rRequest.size();
+    for (int a = 0; a < 8; a++)
+    {
+        Header[a] = static_cast<uint8_t>(Size >> (a * 8));
+    }
+
+    std::lock_guard<std::mutex> Lock(g_RecordMutex);
+    FILE* f = fopen(rRequestFile.c_str(), "ab");
+    if (!f)
+    {
+        return;
+    }
+    fwrite(Header, 1, sizeof(Header), f);
+    fwrite(&rRequest[0], 1, rRequest.size(), f);
+    fclose(f);
+}
+
+bool CCrySimpleBenchmark::LoadRequests()
+{
+    FILE* f = fopen(m_RequestFile.c_str(), "rb");
+    if (!f)
+    {
+        printf("Benchmark: unable to open request file %s\n", m_RequestFile.c_str());
+        return false;
+    }
+
+    uint8_t Header[8];
+    while (fread(Header, 1, sizeof(Header), f) == sizeof(Header))
+    {
+        uint64_t Size = 0;
+        for (int a = 0; a < 8; a++)
+        {
+            Size |= static_cast<uint64_t>(Header[a]) << (a * 8);
+        }
+
+        std::vector<uint8_t> Request(static_cast<size_t>(Size));
+        if (!Size || fread(&Request[0], 1, Request.size(), f) != Request.size())
+        {
+            printf("Benchmark: request file %s is truncated\n", m_RequestFile.c_str());
+            break;
+        }
+        m_Requests.push_back(std::move(Request));
+    }
+    fclose(f);
+
+    printf("Benchmark: loaded %d compile requests from %s\n", static_cast<int>(m_Requests.size()), m_RequestFile.c_str());
+    return !m_Requests.empty();
+}
+
+bool CCrySimpleBenchmark::Run()
+{
+    if (!LoadRequests())
+    {
+        return false;
+    }
+
+    const size_t Total = m_Requests.size() * m_Repeat;
+    std::atomic<size_t> NextRequest(0);
+    std::atomic<size_t> Failed(0);
+    std::vector<std::vector<double> > Latencies(m_Connections);
+
+    printf("Benchmark: sending %d requests to %s:%d over %d connections\n", static_cast<int>(Total), m_Host.c_str(), m_Port, m_Connections);
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> Clients;
+    for (uint32_t a = 0; a < m_Connections; a++)
+    {
+        Clients.emplace_back([this, a, Total, &NextRequest, &Failed, &Latencies]()
+            {
+                std::vector<double>& rLatencies = Latencies[a];
+                for (size_t Idx = NextRequest++; Idx < Total; Idx = NextRequest++)
+                {
+                    const std::vector<uint8_t>& Vec = m_Requests[Idx % m_Requests.size()];
+
+                    const auto RequestStart = std::chrono::steady_clock::now();
+                    bool Succeeded = false;
+                    CrySimple_SECURE_START
+                    CCrySimpleSock Sock(m_Host, m_Port);
+                    if (Sock.Valid())
+                    {
+                        Sock.Forward(Vec);
+                        std::vector<uint8_t> Response;
+                        uint8_t State = ECSJS_NONE;
+                        Succeeded = Sock.RecvResponse(Response, State) && State == ECSJS_DONE;
+                    }
+                    CrySimple_SECURE_END
+                    const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - RequestStart;
+
+                    if (Succeeded)
+                    {
+                        rLatencies.push_back(Elapsed.count());
+                    }
+                    else
+                    {
+                        Failed++;
+                    }
+                }
+            });
+    }
+    for (std::thread& rClient : Clients)
+    {
+        rClient.join();
+    }
+
+    const std::chrono::duration<double> Duration = std::chrono::steady_clock::now() - Start;
+
+    std::vector<double> Sorted;
+    for (const std::vector<double>& rLatencies : Latencies)
+    {
+        Sorted.insert(Sorted.end(), rLatencies.begin(), rLatencies.end());
+    }
+    std::sort(Sorted.begin(), Sorted.end());
+
+    const double Seconds = std::max(Duration.count(), 1e-6);
+    printf("Benchmark: %d compiled, %d failed in %.2fs\n", static_cast<int>(Sorted.size()), static_cast<int>(Failed.load()), Seconds);
+    printf("Benchmark: %.1f compiles/sec, latency p50 %.2fms p99 %.2fms max %.2fms\n",
+        static_cast<double>(Sorted.size()) / Seconds, Percentile(Sorted, 0.5), Percentile(Sorted, 0.99), Sorted.empty() ? 0.0 : Sorted.back());
+
+    return !Sorted.empty();
+}
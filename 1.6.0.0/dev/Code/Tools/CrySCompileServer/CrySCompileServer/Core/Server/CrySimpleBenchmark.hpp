@@ -0,0 +1,47 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+
+#ifndef __CRYSIMPLEBENCHMARK__
+#define __CRYSIMPLEBENCHMARK__
+
+#include <Core/Common.h>
+#include <string>
+#include <vector>
+
+// Load generator for the compile server, started with "-benchmark <RequestFile> [host] [connections] [repeat]".
+// A server running with DumpRequests=<RequestFile> appends every Compile request it receives to that file; the
+// benchmark replays them, each on its own connection, the same way the engine sends them.  Run the server under test
+// with Caching=0 so that repeated requests are compiled again instead of being answered from the cache.
+class CCrySimpleBenchmark
+{
+public:
+    CCrySimpleBenchmark(const std::string& rRequestFile, const std::string& rHost, uint16_t Port, uint32_t Connections, uint32_t Repeat);
+
+    // returns false if the request file could not be loaded or no request succeeded
+    bool                    Run();
+
+    // appends a compile request to the request file, thread safe
+    static void             RecordRequest(const std::string& rRequestFile, const std::vector<uint8_t>& rRequest);
+
+private:
+    bool                    LoadRequests();
+
+    std::string             m_RequestFile;
+    std::string             m_Host;
+    uint16_t                m_Port;
+    uint32_t                m_Connections;
+    uint32_t                m_Repeat;
+    std::vector<std::vector<uint8_t> > m_Requests;
+};
+
+#endif
@@ -36,8 +36,29 @@ struct SFileEntryHeader
     uint32_t flags;     // Flags
     uint8_t  hash[16];  // Hash code for the data.
 };
+
+// Cache.idx lets the server start without reading every compiled shader in Cache.dat back into memory.
+// It covers the first cacheFileSize bytes of Cache.dat, anything appended after that is scanned as before.
+struct SIndexFileHeader
+{
+    char     signature[4];
+    uint32_t version;
+    uint64_t cacheFileSize; // Size of Cache.dat when the index was written.
+    uint32_t entryCount;
+};
+
+struct SIndexFileEntry
+{
+    uint8_t  hash[16];      // Hash code of the request.
+    uint8_t  dataHash[16];  // Hash code of the compiled data.
+    uint64_t dataOffset;    // Offset of the compiled data in Cache.dat.
+    uint32_t dataSize;
+};
 #pragma pack(pop)
 
+#define INDEX_FILE_VERSION 1
+#define CACHE_NOT_ON_DISK (~0ull)
+
 
 CCrySimpleCache& CCrySimpleCache::Instance()
 {
@@ -45,12 +66,40 @@ CCrySimpleCache& CCrySimpleCache::Instance()
     return g_Cache;
 }
 
+CCrySimpleCache::CCrySimpleCache()
+    : m_CachingEnabled(false)
+    , m_Hit(0)
+    , m_Miss(0)
+    , m_EntryCount(0)
+    , m_MemoryBudget(0)
+    , m_CacheFileSize(0)
+{
+    for (int a = 0; a < NUM_SHARDS; a++)
+    {
+        m_Shards[a].m_ResidentBytes = 0;
+    }
+}
+
 void CCrySimpleCache::Init()
 {
-    CCrySimpleMutexAutoLock Lock(m_Mutex);
     m_CachingEnabled    =   false;
     m_Hit       =   0;
     m_Miss  =   0;
+    Clear();
+}
+
+void CCrySimpleCache::Clear()
+{
+    for (int a = 0; a < NUM_SHARDS; a++)
+    {
+        SShard& rShard = m_Shards[a];
+        CCrySimpleMutexAutoLock Lock(rShard.m_Mutex);
+        rShard.m_Entries.clear();
+        rShard.m_Blobs.clear();
+        rShard.m_LRU.clear();
+        rShard.m_ResidentBytes = 0;
+    }
+    m_EntryCount = 0;
 }
 
 std::string CCrySimpleCache::CreateFileName(const tdHash& rHash) const
@@ -65,6 +114,61 @@ std::string CCrySimpleCache::CreateFileName(const tdHash& rHash) const
     return SEnviropment::Instance().m_Cache + Tmp + "/" + Name;
 }
 
+std::string CCrySimpleCache::CreateIndexFileName(const std::string& rCacheFileName) const
+{
+    size_t Extension = rCacheFileName.rfind('.');
+    return (Extension == std::string::npos ? rCacheFileName : rCacheFileName.substr(0, Extension)) + ".idx";
+}
+
+uint64_t CCrySimpleCache::ResidentBytes() const
+{
+    uint64_t Bytes = 0;
+    for (int a = 0; a < NUM_SHARDS; a++)
+    {
+        Bytes += m_Shards[a].m_ResidentBytes;
+    }
+    return Bytes;
+}
+
+// must be called with the shard locked
+void CCrySimpleCache::Evict(SShard& rShard)
+{
+    if (!m_MemoryBudget)
+    {
+        return;
+    }
+
+    // only blobs which are already in the cache file are in the LRU list, the rest are still waiting to be saved.
+    const uint64_t ShardBudget = m_MemoryBudget / NUM_SHARDS;
+    while (rShard.m_ResidentBytes > ShardBudget && !rShard.m_LRU.empty())
+    {
+        tdBlobs::iterator it = rShard.m_Blobs.find(rShard.m_LRU.back());
+        rShard.m_LRU.pop_back();
+        if (it != rShard.m_Blobs.end() && it->second.m_Resident)
+        {
+            SCacheBlob& rBlob = it->second;
+            rShard.m_ResidentBytes -= rBlob.m_Data.size();
+            tdDataVector().swap(rBlob.m_Data);
+            rBlob.m_Resident = false;
+        }
+    }
+}
+
+bool CCrySimpleCache::ReadFromCacheFile(uint64_t Offset, uint32_t Size, tdDataVector& rData)
+{
+    CCrySimpleMutexAutoLock LockDisk(m_DiskMutex);
+
+    AZ::IO::SystemFile cacheFile;
+    if (!cacheFile.Open(m_CacheFileName.c_str(), AZ::IO::SystemFile::SF_OPEN_READ_ONLY))
+    {
+        return false;
+    }
+
+    rData.resize(Size);
+    cacheFile.Seek(Offset, AZ::IO::SystemFile::SF_SEEK_BEGIN);
+    return cacheFile.Read(Size, rData.data()) == Size;
+}
+
 
 bool CCrySimpleCache::Find(const tdHash& rHash, tdDataVector& rData)
 {
@@ -73,28 +177,70 @@ bool CCrySimpleCache::Find(const tdHash& rHash, tdDataVector& rData)
         return false;
     }
 
-    CCrySimpleMutexAutoLock Lock(m_Mutex);
-    tdEntries::iterator it = m_Entries.find(rHash);
-    if (it != m_Entries.end())
+    tdHash DataHash;
     {
-        tdData::iterator dataIt = m_Data.find(it->second);
-        if (dataIt == m_Data.end())
+        SShard& rShard = Shard(rHash);
+        CCrySimpleMutexAutoLock Lock(rShard.m_Mutex);
+        tdEntries::iterator it = rShard.m_Entries.find(rHash);
+        if (it == rShard.m_Entries.end())
         {
-            m_Miss++;
+            InterlockedIncrement(&m_Miss);
             return false;
         }
-        m_Hit++;
-        rData = dataIt->second;
-        return true;
+        DataHash = it->second;
+    }
 
-        //if (CSTLHelper::Uncompress( it->second,rData ))
-        //return true;
+    SShard& rDataShard = Shard(DataHash);
+    uint64_t FileOffset;
+    uint32_t Size;
+    {
+        CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+        tdBlobs::iterator it = rDataShard.m_Blobs.find(DataHash);
+        if (it == rDataShard.m_Blobs.end())
+        {
+            InterlockedIncrement(&m_Miss);
+            return false;
+        }
 
-        //      const std::string FileName=CreateFileName(rHash);
-        //      CSTLHelper::FromFile(FileName,rData);
+        SCacheBlob& rBlob = it->second;
+        if (rBlob.m_Resident)
+        {
+            if (rBlob.m_FileOffset != CACHE_NOT_ON_DISK)
+            {
+                rDataShard.m_LRU.splice(rDataShard.m_LRU.begin(), rDataShard.m_LRU, rBlob.m_LRU);
+            }
+            InterlockedIncrement(&m_Hit);
+            rData = rBlob.m_Data;
+            return true;
+        }
+        FileOffset  =   rBlob.m_FileOffset;
+        Size                =   rBlob.m_Size;
     }
-    m_Miss++;
-    return false;
+
+    // it was evicted (or never loaded), read it back without holding up the rest of the shard.
+    if (!ReadFromCacheFile(FileOffset, Size, rData) || !(CSTLHelper::Hash(rData) == DataHash))
+    {
+        printf("Warning: Cache entry %s could not be read back from the cache file\n", CSTLHelper::Hash2String(DataHash).c_str());
+        InterlockedIncrement(&m_Miss);
+        return false;
+    }
+
+    {
+        CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+        tdBlobs::iterator it = rDataShard.m_Blobs.find(DataHash);
+        if (it != rDataShard.m_Blobs.end() && !it->second.m_Resident)
+        {
+            SCacheBlob& rBlob = it->second;
+            rBlob.m_Data        =   rData;
+            rBlob.m_Resident    =   true;
+            rDataShard.m_ResidentBytes += rBlob.m_Data.size();
+            rDataShard.m_LRU.push_front(DataHash);
+            rBlob.m_LRU         =   rDataShard.m_LRU.begin();
+            Evict(rDataShard);
+        }
+    }
+    InterlockedIncrement(&m_Hit);
+    return true;
 }
 
 void CCrySimpleCache::Add(const tdHash& rHash, const tdDataVector& rData)
@@ -113,41 +259,202 @@ void CCrySimpleCache::Add(const tdHash& rHash, const tdDataVector& rData)
         const uint8_t* pData    =   &rData[0];
 
         tdHash DataHash =   CSTLHelper::Hash(rData);
+
         {
-            CCrySimpleMutexAutoLock Lock(m_Mutex);
-            m_Entries[rHash]  =   DataHash;
-            if (m_Data.find(DataHash) == m_Data.end())
+            SShard& rShard = Shard(rHash);
+            CCrySimpleMutexAutoLock Lock(rShard.m_Mutex);
+            std::pair<tdEntries::iterator, bool> Inserted = rShard.m_Entries.insert(std::make_pair(rHash, DataHash));
+            if (Inserted.second)
             {
-                m_Data[DataHash]    =   rData;
+                InterlockedIncrement(&m_EntryCount);
             }
             else
             {
-                hdr.flags |= EFEHF_REFERENCE;
-                hdr.dataSize    =   sizeof(tdHash);
-                pData   =   reinterpret_cast<const uint8_t*>(&DataHash);
+                Inserted.first->second = DataHash;
             }
         }
 
+        SShard& rDataShard = Shard(DataHash);
+        CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+        SPendingCacheEntry PendingCacheEntry;
+        PendingCacheEntry.m_DataHash    =   DataHash;
+        PendingCacheEntry.m_HasData     =   rDataShard.m_Blobs.find(DataHash) == rDataShard.m_Blobs.end();
+        if (PendingCacheEntry.m_HasData)
+        {
+            SCacheBlob& rBlob = rDataShard.m_Blobs[DataHash];
+            rBlob.m_Data            =   rData;
+            rBlob.m_FileOffset  =   CACHE_NOT_ON_DISK;
+            rBlob.m_Size            =   (uint32_t)rData.size();
+            rBlob.m_Resident    =   true;
+            rDataShard.m_ResidentBytes += rData.size();
+        }
+        else
+        {
+            hdr.flags |= EFEHF_REFERENCE;
+            hdr.dataSize    =   sizeof(tdHash);
+            pData   =   reinterpret_cast<const uint8_t*>(&DataHash);
+        }
 
+        tdDataVector* pBuffer = new tdDataVector(sizeof(hdr) + hdr.dataSize);
+        memcpy(&(*pBuffer)[0], &hdr, sizeof(hdr));
+        memcpy(&(*pBuffer)[sizeof(hdr)], pData, hdr.dataSize);
+        PendingCacheEntry.m_pBuffer = pBuffer;
 
-        tdDataVector buf;
-        buf.resize(sizeof(hdr) + hdr.dataSize);
-        memcpy(&buf[0], &hdr, sizeof(hdr));
-        memcpy(&buf[sizeof(hdr)], pData, hdr.dataSize);
-
-        tdDataVector* pPendingCacheEntry = new tdDataVector(buf);
         {
+            // queued while the data shard is still locked so that the data is always saved before anything referencing it
             CCrySimpleMutexAutoLock LockFile(m_FileMutex);
-            m_PendingCacheEntries.push_back(pPendingCacheEntry);
+            m_PendingCacheEntries.push_back(PendingCacheEntry);
             if (m_PendingCacheEntries.size() > 10000)
             {
                 printf("Warning: Too many pending entries not saved to disk!!!");
             }
-            //CSTLHelper::AppendToFile( SEnviropment::Instance().m_Cache+"Cache.dat",buf );
         }
     }
 }
 
+void CCrySimpleCache::AddLoadedEntry(const tdHash& rHash, const tdHash& rDataHash, uint64_t DataOffset, uint32_t DataSize)
+{
+    {
+        SShard& rShard = Shard(rHash);
+        CCrySimpleMutexAutoLock Lock(rShard.m_Mutex);
+        if (rShard.m_Entries.insert(std::make_pair(rHash, rDataHash)).second)
+        {
+            m_EntryCount++;
+        }
+        else
+        {
+            rShard.m_Entries[rHash] = rDataHash;
+        }
+    }
+
+    SShard& rDataShard = Shard(rDataHash);
+    CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+    if (rDataShard.m_Blobs.find(rDataHash) == rDataShard.m_Blobs.end())
+    {
+        // loaded entries start out on disk only, they are read in the first time they are asked for.
+        SCacheBlob& rBlob = rDataShard.m_Blobs[rDataHash];
+        rBlob.m_FileOffset  =   DataOffset;
+        rBlob.m_Size            =   DataSize;
+        rBlob.m_Resident    =   false;
+    }
+}
+
+uint64_t CCrySimpleCache::LoadIndexFile(const std::string& rCacheFileName, uint64_t CacheFileSize)
+{
+    const std::string IndexFileName = CreateIndexFileName(rCacheFileName);
+
+    tdDataVector Index;
+    if (!AZ::IO::SystemFile::Exists(IndexFileName.c_str()) || !CSTLHelper::FromFile(IndexFileName, Index) || Index.size() < sizeof(SIndexFileHeader))
+    {
+        return 0;
+    }
+
+    SIndexFileHeader hdr;
+    memcpy(&hdr, &Index[0], sizeof(hdr));
+    if (memcmp(hdr.signature, "SIDX", 4) != 0 || hdr.version != INDEX_FILE_VERSION || hdr.cacheFileSize > CacheFileSize ||
+        Index.size() != sizeof(hdr) + static_cast<uint64_t>(hdr.entryCount) * sizeof(SIndexFileEntry))
+    {
+        printf("Ignoring out of date cache index %s\n", IndexFileName.c_str());
+        return 0;
+    }
+
+    const SIndexFileEntry* pEntries = reinterpret_cast<const SIndexFileEntry*>(&Index[sizeof(hdr)]);
+
+    // make sure the index was made for this cache file by checking the entry it points furthest into
+    uint32_t Last = 0;
+    for (uint32_t a = 0; a < hdr.entryCount; a++)
+    {
+        if (pEntries[a].dataOffset > pEntries[Last].dataOffset)
+        {
+            Last = a;
+        }
+    }
+    if (hdr.entryCount)
+    {
+        SFileEntryHeader entryHdr;
+        AZ::IO::SystemFile cacheFile;
+        bool bValid = pEntries[Last].dataOffset >= sizeof(entryHdr) && pEntries[Last].dataOffset + pEntries[Last].dataSize <= hdr.cacheFileSize &&
+            cacheFile.Open(rCacheFileName.c_str(), AZ::IO::SystemFile::SF_OPEN_READ_ONLY);
+        if (bValid)
+        {
+            cacheFile.Seek(pEntries[Last].dataOffset - sizeof(entryHdr), AZ::IO::SystemFile::SF_SEEK_BEGIN);
+            bValid = cacheFile.Read(sizeof(entryHdr), &entryHdr) == sizeof(entryHdr) && memcmp(entryHdr.signature, "SHDR", 4) == 0 &&
+                entryHdr.dataSize == pEntries[Last].dataSize && (entryHdr.flags & EFEHF_REFERENCE) == 0;
+        }
+        if (!bValid)
+        {
+            printf("Ignoring cache index %s, it does not match the cache file\n", IndexFileName.c_str());
+            return 0;
+        }
+    }
+
+    for (uint32_t a = 0; a < hdr.entryCount; a++)
+    {
+        tdHash Hash, DataHash;
+        memcpy(&Hash, pEntries[a].hash, sizeof(Hash));
+        memcpy(&DataHash, pEntries[a].dataHash, sizeof(DataHash));
+        AddLoadedEntry(Hash, DataHash, pEntries[a].dataOffset, pEntries[a].dataSize);
+    }
+
+    printf("%d shaders loaded from cache index\n", hdr.entryCount);
+    return hdr.cacheFileSize;
+}
+
+void CCrySimpleCache::SaveIndexFile(const std::string& rCacheFileName, uint64_t CacheFileSize)
+{
+    std::vector<SIndexFileEntry> Entries;
+    Entries.reserve(m_EntryCount);
+    for (int a = 0; a < NUM_SHARDS; a++)
+    {
+        SShard& rShard = m_Shards[a];
+        CCrySimpleMutexAutoLock Lock(rShard.m_Mutex);
+        for (tdEntries::const_iterator it = rShard.m_Entries.begin(); it != rShard.m_Entries.end(); ++it)
+        {
+            SIndexFileEntry Entry;
+            memcpy(Entry.hash, &it->first, sizeof(Entry.hash));
+            memcpy(Entry.dataHash, &it->second, sizeof(Entry.dataHash));
+            Entries.push_back(Entry);
+        }
+    }
+
+    // the data hashes are sharded separately, look the offsets up afterwards.
+    for (size_t a = 0; a < Entries.size(); a++)
+    {
+        tdHash DataHash;
+        memcpy(&DataHash, Entries[a].dataHash, sizeof(DataHash));
+        SShard& rDataShard = Shard(DataHash);
+        CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+        tdBlobs::const_iterator it = rDataShard.m_Blobs.find(DataHash);
+        if (it == rDataShard.m_Blobs.end() || it->second.m_FileOffset == CACHE_NOT_ON_DISK)
+        {
+            return;
+        }
+        Entries[a].dataOffset   =   it->second.m_FileOffset;
+        Entries[a].dataSize     =   it->second.m_Size;
+    }
+
+    SIndexFileHeader hdr;
+    memcpy(hdr.signature, "SIDX", 4);
+    hdr.version             =   INDEX_FILE_VERSION;
+    hdr.cacheFileSize   =   CacheFileSize;
+    hdr.entryCount      =   static_cast<uint32_t>(Entries.size());
+
+    tdDataVector Index(sizeof(hdr) + Entries.size() * sizeof(SIndexFileEntry));
+    memcpy(&Index[0], &hdr, sizeof(hdr));
+    if (!Entries.empty())
+    {
+        memcpy(&Index[sizeof(hdr)], &Entries[0], Entries.size() * sizeof(SIndexFileEntry));
+    }
+
+    const std::string IndexFileName = CreateIndexFileName(rCacheFileName);
+    const std::string TempFileName = IndexFileName + ".tmp";
+    if (CSTLHelper::ToFile(TempFileName, Index))
+    {
+        AZ::IO::SystemFile::Delete(IndexFileName.c_str());
+        AZ::IO::SystemFile::Rename(TempFileName.c_str(), IndexFileName.c_str());
+    }
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
@@ -156,6 +463,8 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
 
     printf("Loading shader cache from %s\n", filename.c_str());
 
+    Clear();
+
     tdDataVector rData;
 
     tdHash hash;
@@ -178,6 +487,15 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
 
     AZ::IO::SystemFile::SizeType fileSize = cacheFile.Length();
 
+    // everything the index knows about is only read in when it is first asked for, only scan what was appended since.
+    nFilePos = LoadIndexFile(filename, fileSize);
+    num = static_cast<uint32_t>(m_EntryCount);
+    if (nFilePos > 0)
+    {
+        cacheFile.Seek(nFilePos, AZ::IO::SystemFile::SF_SEEK_BEGIN);
+    }
+    const uint32_t numIndexed = num;
+
     uint64_t SizeAdded = 0;
     uint64_t SizeAddedCount = 0;
     uint64_t SizeSaved = 0;
@@ -226,32 +544,29 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
                 break;
             }
 
-            bool bSkip = false;
-
             tdHash DataHash =   *reinterpret_cast<tdHash*>(&rData[0]);
-            tdData::iterator it = m_Data.find(DataHash);
-            if (it == m_Data.end())
+            SShard& rDataShard = Shard(DataHash);
+            tdBlobs::iterator it = rDataShard.m_Blobs.find(DataHash);
+            if (it == rDataShard.m_Blobs.end())
             {
                 // Too big entry, probably invalid.
-                bSkip = true; // don't abort reading whole file just yet - skip only this entry
+                // don't abort reading whole file just yet - skip only this entry
                 printf("\nSkipping Invalid cache entry %d\n at file position: %I64u, data-hash references to not existing data ", num, nFilePos, hdr.dataSize);
             }
-
-            if (!bSkip)
+            else
             {
-                m_Entries[hash] =   DataHash;
-                SizeSaved += it->second.size();
+                AddLoadedEntry(hash, DataHash, it->second.m_FileOffset, it->second.m_Size);
+                SizeSaved += it->second.m_Size;
                 SizeSavedCount++;
             }
         }
         else
         {
             tdHash DataHash =   CSTLHelper::Hash(rData);
-            m_Entries[hash] =   DataHash;
-            if (m_Data.find(DataHash) == m_Data.end())
+            SShard& rDataShard = Shard(DataHash);
+            if (rDataShard.m_Blobs.find(DataHash) == rDataShard.m_Blobs.end())
             {
                 SizeAdded += rData.size();
-                m_Data[DataHash]    =   rData;
                 SizeAddedCount++;
             }
             else
@@ -259,6 +574,7 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
                 SizeSaved += rData.size();
                 SizeSavedCount++;
             }
+            AddLoadedEntry(hash, DataHash, nFilePos + sizeof(SFileEntryHeader), hdr.dataSize);
         }
 
         if (num % 1000 == 0)
@@ -277,6 +593,18 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
         nFilePos += hdr.dataSize + sizeof(SFileEntryHeader);
     }
 
+    if (!bLoadedOK)
+    {
+        // the caller restores the backup (which the offsets we have don't point into), start again from nothing.
+        Clear();
+        return false;
+    }
+
+    if (num != numIndexed)
+    {
+        SaveIndexFile(filename, nFilePos);
+    }
+
     printf("\n%d shaders loaded from cache\n", num);
 
     return bLoadedOK;
@@ -284,6 +612,12 @@ bool CCrySimpleCache::LoadCacheFile(const std::string& filename)
 
 void CCrySimpleCache::Finalize()
 {
+    m_MemoryBudget  =   static_cast<uint64_t>(SEnviropment::Instance().m_CacheMemoryBudget) * 1024 * 1024;
+    m_CacheFileName =   SEnviropment::Instance().m_Cache + "Cache.dat";
+
+    AZ::IO::SystemFile cacheFile;
+    m_CacheFileSize =   cacheFile.Open(m_CacheFileName.c_str(), AZ::IO::SystemFile::SF_OPEN_READ_ONLY) ? cacheFile.Length() : 0;
+
     m_CachingEnabled    =   true;
     printf("\n caching enabled\n");
 }
@@ -295,23 +629,51 @@ void CCrySimpleCache::ThreadFunc_SavePendingCacheEntries()
     bool bListEmpty = false;
     do
     {
-        tdDataVector* pPendingCacheEntry = 0;
+        SPendingCacheEntry PendingCacheEntry;
+        PendingCacheEntry.m_pBuffer = 0;
 
         {
             CCrySimpleMutexAutoLock LockFile(m_FileMutex);
             if (!m_PendingCacheEntries.empty())
             {
-                pPendingCacheEntry = m_PendingCacheEntries.front();
+                PendingCacheEntry = m_PendingCacheEntries.front();
                 m_PendingCacheEntries.pop_front();
             }
-            //CSTLHelper::AppendToFile( SEnviropment::Instance().m_Cache+"Cache.dat",buf );
             bListEmpty = m_PendingCacheEntries.empty();
         }
 
-        if (pPendingCacheEntry)
+        if (PendingCacheEntry.m_pBuffer)
         {
-            CSTLHelper::AppendToFile(SEnviropment::Instance().m_Cache + "Cache.dat", *pPendingCacheEntry);
-            delete pPendingCacheEntry;
+            uint64_t DataOffset;
+            bool bWritten;
+            {
+                CCrySimpleMutexAutoLock LockDisk(m_DiskMutex);
+                DataOffset = m_CacheFileSize + sizeof(SFileEntryHeader);
+                bWritten = CSTLHelper::AppendToFile(m_CacheFileName, *PendingCacheEntry.m_pBuffer);
+                if (bWritten)
+                {
+                    m_CacheFileSize += PendingCacheEntry.m_pBuffer->size();
+                }
+            }
+            delete PendingCacheEntry.m_pBuffer;
+
+            if (bWritten && PendingCacheEntry.m_HasData)
+            {
+                // now that it can be read back it is allowed to be evicted.
+                SShard& rDataShard = Shard(PendingCacheEntry.m_DataHash);
+                CCrySimpleMutexAutoLock Lock(rDataShard.m_Mutex);
+                tdBlobs::iterator it = rDataShard.m_Blobs.find(PendingCacheEntry.m_DataHash);
+                if (it != rDataShard.m_Blobs.end() && it->second.m_FileOffset == CACHE_NOT_ON_DISK)
+                {
+                    it->second.m_FileOffset = DataOffset;
+                    if (it->second.m_Resident)
+                    {
+                        rDataShard.m_LRU.push_front(PendingCacheEntry.m_DataHash);
+                        it->second.m_LRU = rDataShard.m_LRU.begin();
+                    }
+                    Evict(rDataShard);
+                }
+            }
         }
     } while (!bListEmpty);
 }
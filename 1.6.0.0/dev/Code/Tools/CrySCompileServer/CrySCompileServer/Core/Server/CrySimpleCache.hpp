@@ -18,9 +18,10 @@
 
 #include <Core/STLHelper.hpp>
 
-#include <map>
-#include <vector>
 #include <list>
+#include <unordered_map>
+#include <vector>
+#include <string.h>
 
 /*class CCrySimpleCacheEntry
 {
@@ -30,23 +31,82 @@ protected:
 private:
 };*/
 
-typedef std::map<tdHash, tdHash>             tdEntries;
-typedef std::map<tdHash, tdDataVector> tdData;
+struct SCacheHashHasher
+{
+    size_t operator()(const tdHash& rHash) const
+    {
+        // the hashes are md5, any part of them is as good a hash as any other.
+        size_t Value;
+        memcpy(&Value, rHash.hash, sizeof(Value));
+        return Value;
+    }
+};
+
+// One compiled shader.  Blobs which have been written to the cache file can be dropped from memory when their
+// shard is over its memory budget, and are read back from the cache file the next time they are asked for.
+struct SCacheBlob
+{
+    tdDataVector                                m_Data;             // empty unless resident
+    uint64_t                                        m_FileOffset;   // where the data is in the cache file, CACHE_NOT_ON_DISK until it has been saved
+    uint32_t                                        m_Size;
+    bool                                                m_Resident;
+    std::list<tdHash>::iterator m_LRU;          // only valid when resident and saved
+};
+
+struct SPendingCacheEntry
+{
+    tdHash                                          m_DataHash;
+    bool                                                m_HasData;      // false for entries which only reference data saved before
+    tdDataVector*                               m_pBuffer;
+};
+
+typedef std::unordered_map<tdHash, tdHash, SCacheHashHasher>      tdEntries;
+typedef std::unordered_map<tdHash, SCacheBlob, SCacheHashHasher> tdBlobs;
 
 class CCrySimpleCache
 {
+    enum
+    {
+        NUM_SHARDS = 16
+    };
+
+    // request hashes and data hashes are spread over the shards independently, a shard lock is never held
+    // while taking another one.
+    struct SShard
+    {
+        CCrySimpleMutex                         m_Mutex;
+        tdEntries                                       m_Entries;          // request hash -> data hash
+        tdBlobs                                         m_Blobs;            // data hash -> compiled data
+        std::list<tdHash>                       m_LRU;                  // resident, saved blobs, most recently used first
+        uint64_t                                        m_ResidentBytes;
+    };
+
     volatile bool                               m_CachingEnabled;
-    int                                                 m_Hit;
-    int                                                 m_Miss;
-    tdEntries                                       m_Entries;
-    tdData                                          m_Data;
-    CCrySimpleMutex                         m_Mutex;
+    volatile AtomicCountType        m_Hit;
+    volatile AtomicCountType        m_Miss;
+    volatile AtomicCountType        m_EntryCount;
+    uint64_t                                        m_MemoryBudget;
+    SShard                                          m_Shards[NUM_SHARDS];
     CCrySimpleMutex                         m_FileMutex;
+    CCrySimpleMutex                         m_DiskMutex;
+    std::string                                 m_CacheFileName;
+    uint64_t                                        m_CacheFileSize;
 
-    std::list<tdDataVector*>        m_PendingCacheEntries;
+    std::list<SPendingCacheEntry>   m_PendingCacheEntries;
     std::string                                 CreateFileName(const tdHash& rHash) const;
+    std::string                                 CreateIndexFileName(const std::string& rCacheFileName) const;
+
+    SShard&                                         Shard(const tdHash& rHash){return m_Shards[rHash.hash[0] % NUM_SHARDS]; }
+    void                                                Evict(SShard& rShard);
+    void                                                Clear();
+    bool                                                ReadFromCacheFile(uint64_t Offset, uint32_t Size, tdDataVector& rData);
+    void                                                AddLoadedEntry(const tdHash& rHash, const tdHash& rDataHash, uint64_t DataOffset, uint32_t DataSize);
+    uint64_t                                        LoadIndexFile(const std::string& rCacheFileName, uint64_t CacheFileSize);
+    void                                                SaveIndexFile(const std::string& rCacheFileName, uint64_t CacheFileSize);
 
 public:
+    CCrySimpleCache();
+
     void                                                Init();
     bool                                                Find(const tdHash& rHash, tdDataVector& rData);
     void                                                Add(const tdHash& rHash, const tdDataVector& rData);
@@ -59,10 +119,12 @@ public:
     static CCrySimpleCache&         Instance();
 
 
-    std::list<tdDataVector*>&       PendingCacheEntries(){return m_PendingCacheEntries; }
+    std::list<SPendingCacheEntry>&  PendingCacheEntries(){return m_PendingCacheEntries; }
     int                                                 Hit() const{return m_Hit; }
     int                                                 Miss() const{return m_Miss; }
-    int                                                 EntryCount() const{return static_cast<int>(m_Entries.size()); }
+    int                                                 EntryCount() const{return m_EntryCount; }
+    uint64_t                                        ResidentBytes() const;
+    uint64_t                                        MemoryBudget() const{return m_MemoryBudget; }
 };
 
 #endif
@@ -145,6 +145,7 @@ protected:
         Ret += CreateInfoText("port", SEnviropment::Instance().m_port);
         Ret += CreateInfoText("MailInterval", SEnviropment::Instance().m_MailInterval);
         Ret += CreateInfoText("Caching", SEnviropment::Instance().m_Caching ? "Enabled" : "Disabled");
+        Ret += CreateInfoText("CacheMemoryBudget", static_cast<int>(SEnviropment::Instance().m_CacheMemoryBudget));
         Ret += CreateInfoText("FallbackServer", SEnviropment::Instance().m_FallbackServer == "" ? "None" : SEnviropment::Instance().m_FallbackServer);
         Ret += CreateInfoText("FallbackTreshold", static_cast<int>(SEnviropment::Instance().m_FallbackTreshold));
         Ret += CreateInfoText("DumpShaders", static_cast<int>(SEnviropment::Instance().m_DumpShaders));
@@ -155,6 +156,20 @@ protected:
                 CCrySimpleCache::Instance().Hit() + CCrySimpleCache::Instance().Miss(),
                 CCrySimpleCache::Instance().Hit() * 100 / AZStd::GetMax(1, (CCrySimpleCache::Instance().Hit() + CCrySimpleCache::Instance().Miss())));
         Ret += CreateInfoText("Pending Entries", static_cast<int>(CCrySimpleCache::Instance().PendingCacheEntries().size()));
+        Ret += CreateInfoText("Misses", CCrySimpleCache::Instance().Miss());
+        if (CCrySimpleCache::Instance().MemoryBudget())
+        {
+            const int ResidentMB = static_cast<int>(CCrySimpleCache::Instance().ResidentBytes() / (1024 * 1024));
+            const int BudgetMB = static_cast<int>(CCrySimpleCache::Instance().MemoryBudget() / (1024 * 1024));
+            Ret += CreateBar("Memory (MB)", ResidentMB, BudgetMB, ResidentMB * 100 / AZStd::GetMax(1, BudgetMB));
+        }
+        else
+        {
+            Ret += CreateInfoText("Memory (MB)", static_cast<int>(CCrySimpleCache::Instance().ResidentBytes() / (1024 * 1024)));
+        }
+        Ret += CreateInfoText("Compiling", static_cast<int>(CCrySimpleJobCompile::GlobalInFlightCompiles()));
+        Ret += CreateInfoText("Active", static_cast<int>(CCrySimpleJobCompile::GlobalActiveCompiles()));
+        Ret += CreateInfoText("Coalesced", static_cast<int>(CCrySimpleJobCompile::GlobalCoalescedTasks()));
 
 
 
@@ -19,6 +19,13 @@
 
 class TiXmlElement;
 
+enum EProtocolVersion
+{
+    EPV_V001,
+    EPV_V002,
+    EPV_V0021,
+};
+
 enum ECrySimpleJobState
 {
     ECSJS_NONE,
@@ -34,11 +34,18 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #define MAX_COMPILER_WAIT_TIME (60 * 1000)
 
 volatile AtomicCountType CCrySimpleJobCompile::m_GlobalCompileTasks         = 0;
 volatile AtomicCountType CCrySimpleJobCompile::m_GlobalCompileTasksMax      = 0;
+volatile AtomicCountType CCrySimpleJobCompile::m_GlobalCoalescedTasks       = 0;
+volatile AtomicCountType CCrySimpleJobCompile::m_GlobalInFlightCompiles     = 0;
+volatile AtomicCountType CCrySimpleJobCompile::m_GlobalActiveCompiles       = 0;
 volatile int32_t CCrySimpleJobCompile::m_RemoteServerID                 = 0;
 volatile int64_t CCrySimpleJobCompile::m_GlobalCompileTime  =   0;
 
@@ -65,6 +72,75 @@ struct STimer
 
 STimer g_Timer;
 
+// A request which is currently being compiled.  Identical requests which arrive while it is running wait for its
+// result instead of launching the compiler again (a full shader cache build asks for the same permutation from many
+// clients at once).
+struct SInFlightCompile
+{
+    SInFlightCompile()
+        : m_Finished(false)
+        , m_Succeeded(false)
+    {
+    }
+
+    bool                                            m_Finished;
+    bool                                            m_Succeeded;
+    tdDataVector                            m_Result;
+    std::condition_variable     m_Done;
+};
+
+typedef std::map<tdHash, std::shared_ptr<SInFlightCompile> > tdInFlightCompiles;
+
+static std::mutex g_InFlightMutex;
+static tdInFlightCompiles g_InFlightCompiles;
+
+// Removes the entry when the compiling job is done, whichever way it leaves Execute (compile errors are thrown),
+// and wakes everyone waiting on it.  If Publish was never called the waiters are told it failed.
+class CInFlightCompileGuard
+{
+    tdHash                                                      m_Hash;
+    std::shared_ptr<SInFlightCompile>   m_pInFlight;
+public:
+    CInFlightCompileGuard(const tdHash& rHash, const std::shared_ptr<SInFlightCompile>& pInFlight)
+        : m_Hash(rHash)
+        , m_pInFlight(pInFlight)
+    {
+    }
+
+    ~CInFlightCompileGuard()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(g_InFlightMutex);
+            m_pInFlight->m_Finished = true;
+            g_InFlightCompiles.erase(m_Hash);
+        }
+        m_pInFlight->m_Done.notify_all();
+        InterlockedDecrement(&CCrySimpleJobCompile::m_GlobalInFlightCompiles);
+    }
+
+    void Publish(const tdDataVector& rResult)
+    {
+        std::lock_guard<std::mutex> Lock(g_InFlightMutex);
+        m_pInFlight->m_Result = rResult;
+        m_pInFlight->m_Succeeded = true;
+    }
+};
+
+// Counts the job as active work for the fallback threshold while it compiles, however it leaves Execute.
+class CActiveCompileGuard
+{
+public:
+    CActiveCompileGuard()
+    {
+        InterlockedIncrement(&CCrySimpleJobCompile::m_GlobalActiveCompiles);
+    }
+
+    ~CActiveCompileGuard()
+    {
+        InterlockedDecrement(&CCrySimpleJobCompile::m_GlobalActiveCompiles);
+    }
+};
+
 CCrySimpleJobCompile::CCrySimpleJobCompile(uint32_t requestIP, EProtocolVersion Version, std::vector<uint8_t>* pRVec)
     : CCrySimpleJobCache(requestIP)
     , m_Version(Version)
@@ -96,7 +172,35 @@ bool CCrySimpleJobCompile::Execute(const TiXmlElement* pElement)
         return true;
     }
 
-    if (!SEnviropment::Instance().m_FallbackServer.empty() && m_GlobalCompileTasks > SEnviropment::Instance().m_FallbackTreshold)
+    std::shared_ptr<SInFlightCompile> pInFlight;
+    {
+        std::unique_lock<std::mutex> Lock(g_InFlightMutex);
+        tdInFlightCompiles::iterator it = g_InFlightCompiles.find(HashID());
+        if (it != g_InFlightCompiles.end())
+        {
+            std::shared_ptr<SInFlightCompile> pFirst = it->second;
+            InterlockedIncrement(&m_GlobalCoalescedTasks);
+            pFirst->m_Done.wait(Lock, [&pFirst]() { return pFirst->m_Finished; });
+            if (pFirst->m_Succeeded)
+            {
+                rVec = pFirst->m_Result;
+                State(ECSJS_DONE);
+                return true;
+            }
+            // the first request failed, compile this one as well so that it reports its own error.
+        }
+        else
+        {
+            pInFlight = std::make_shared<SInFlightCompile>();
+            g_InFlightCompiles[HashID()] = pInFlight;
+            InterlockedIncrement(&m_GlobalInFlightCompiles);
+        }
+    }
+    std::unique_ptr<CInFlightCompileGuard> pInFlightGuard(pInFlight ? new CInFlightCompileGuard(HashID(), pInFlight) : nullptr);
+
+    // only jobs which actually compile count towards the fallback threshold, not cache hits or coalesced waiters
+    CActiveCompileGuard ActiveGuard;
+    if (!SEnviropment::Instance().m_FallbackServer.empty() && m_GlobalActiveCompiles > SEnviropment::Instance().m_FallbackTreshold)
     {
         tdEntryVec ServerVec;
         CSTLHelper::Tokenize(ServerVec, SEnviropment::Instance().m_FallbackServer, ";");
@@ -158,6 +262,11 @@ bool CCrySimpleJobCompile::Execute(const TiXmlElement* pElement)
         CCrySimpleCache::Instance().Add(HashID(), rVec);
     }
 
+    if (pInFlightGuard && State() == ECSJS_DONE)
+    {
+        pInFlightGuard->Publish(rVec);
+    }
+
     return true;
 }
 
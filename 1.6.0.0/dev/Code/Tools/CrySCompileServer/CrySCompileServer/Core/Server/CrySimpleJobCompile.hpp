@@ -22,8 +22,14 @@
 class CCrySimpleJobCompile
     :   public  CCrySimpleJobCache
 {
+    friend class CInFlightCompileGuard;
+    friend class CActiveCompileGuard;
+
     static volatile AtomicCountType             m_GlobalCompileTasks;
     static volatile AtomicCountType             m_GlobalCompileTasksMax;
+    static volatile AtomicCountType             m_GlobalCoalescedTasks;
+    static volatile AtomicCountType             m_GlobalInFlightCompiles;
+    static volatile AtomicCountType             m_GlobalActiveCompiles;
     static volatile int32_t             m_RemoteServerID;
     static volatile int64_t m_GlobalCompileTime;
 
@@ -41,6 +47,11 @@ public:
 
     static volatile long            GlobalCompileTasks(){return m_GlobalCompileTasks; }
     static volatile long            GlobalCompileTasksMax(){return m_GlobalCompileTasksMax; }
+    // requests which waited for an identical request that was already compiling, instead of compiling themselves
+    static volatile long            GlobalCoalescedTasks(){return m_GlobalCoalescedTasks; }
+    static volatile long            GlobalInFlightCompiles(){return m_GlobalInFlightCompiles; }
+    // requests compiling right now, locally or on a fallback server; cache hits and coalesced waiters don't count
+    static volatile long            GlobalActiveCompiles(){return m_GlobalActiveCompiles; }
 };
 
 class CCompilerError
@@ -0,0 +1,488 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#include "CrySimpleReactor.hpp"
+
+#if defined(CRYSIMPLE_HAS_REACTOR)
+
+#include "CrySimpleSock.hpp"
+#include "CrySimpleServer.hpp"
+
+#include <Core/StdTypes.hpp>
+#include <Core/Error.hpp>
+#include <Core/STLHelper.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace
+{
+    static volatile AtomicCountType numberOfOpenConnections = 0;
+    static volatile AtomicCountType numberOfQueuedRequests = 0;
+
+    // epoll user data of the two descriptors which are not connections
+    const uint64_t LISTEN_ID = 0;
+    const uint64_t WAKEUP_ID = 1;
+    const uint64_t FIRST_CONNECTION_ID = 2;
+
+    const uint64_t MAX_REQUEST_SIZE = 64 * 1024 * 1024;
+    const int MAX_EVENTS = 256;
+
+    enum EConnectionState
+    {
+        ECS_READING,
+        ECS_COMPILING,
+        ECS_WRITING,
+    };
+
+    struct SConnection
+    {
+        SOCKET              m_Socket;
+        uint32_t            m_PeerIP;
+        EConnectionState    m_State;
+        bool                m_SwapEndian;
+        uint8_t             m_Header[8];
+        size_t              m_HeaderRead;
+        tdDataVector        m_Request;
+        size_t              m_RequestRead;
+        tdDataVector        m_Response;
+        size_t              m_ResponseSent;
+    };
+
+    struct SCompileRequest
+    {
+        uint64_t            m_ConnectionID;
+        uint32_t            m_PeerIP;
+        bool                m_SwapEndian;
+        tdDataVector        m_Data;         // the request going to the worker, the framed response coming back
+    };
+}
+
+struct CCrySimpleReactor::Implementation
+{
+    CCrySimpleSock*                 m_pListenSocket;
+    int                             m_Epoll;
+    int                             m_Wakeup;
+    uint32_t                        m_MaxQueuedRequests;
+    uint32_t                        m_Outstanding;      // received but not answered, only touched by the reactor thread
+    bool                            m_AcceptPaused;
+    uint64_t                        m_NextConnectionID;
+    std::unordered_map<uint64_t, std::unique_ptr<SConnection> > m_Connections;
+
+    std::vector<std::thread>        m_Workers;
+    std::mutex                      m_QueueMutex;
+    std::condition_variable         m_QueueCondition;
+    std::deque<SCompileRequest>     m_Queue;
+    std::deque<SCompileRequest>     m_Completed;
+    bool                            m_Shutdown;
+
+    void                            Accept();
+    void                            OnConnectionEvent(uint64_t ID, uint32_t Events);
+    void                            Read(uint64_t ID, SConnection& rConnection);
+    void                            Write(uint64_t ID, SConnection& rConnection);
+    void                            Close(uint64_t ID);
+    void                            DrainCompleted();
+    void                            PauseAccept(bool bPause);
+    void                            WorkerLoop();
+};
+
+CCrySimpleReactor::CCrySimpleReactor(CCrySimpleSock* pListenSocket, uint32_t WorkerCount, uint32_t MaxQueuedRequests)
+    : m_pImpl(new Implementation)
+{
+    m_pImpl->m_pListenSocket        =   pListenSocket;
+    m_pImpl->m_MaxQueuedRequests    =   MaxQueuedRequests ? MaxQueuedRequests : 1;
+    m_pImpl->m_Outstanding          =   0;
+    m_pImpl->m_AcceptPaused         =   false;
+    m_pImpl->m_NextConnectionID     =   FIRST_CONNECTION_ID;
+    m_pImpl->m_Shutdown             =   false;
+
+    m_pImpl->m_Epoll    =   epoll_create1(EPOLL_CLOEXEC);
+    m_pImpl->m_Wakeup   =   eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_pImpl->m_Epoll < 0 || m_pImpl->m_Wakeup < 0)
+    {
+        CrySimple_ERROR("Could not create the epoll reactor");
+    }
+
+    const SOCKET Listen = pListenSocket->Handle();
+    fcntl(Listen, F_SETFL, fcntl(Listen, F_GETFL, 0) | O_NONBLOCK);
+
+    epoll_event Event;
+    Event.events    =   EPOLLIN;
+    Event.data.u64  =   LISTEN_ID;
+    epoll_ctl(m_pImpl->m_Epoll, EPOLL_CTL_ADD, Listen, &Event);
+    Event.events    =   EPOLLIN;
+    Event.data.u64  =   WAKEUP_ID;
+    epoll_ctl(m_pImpl->m_Epoll, EPOLL_CTL_ADD, m_pImpl->m_Wakeup, &Event);
+
+    if (!WorkerCount)
+    {
+        WorkerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t a = 0; a < WorkerCount; a++)
+    {
+        m_pImpl->m_Workers.push_back(std::thread(&Implementation::WorkerLoop, m_pImpl.get()));
+    }
+
+    printf("Serving requests with %u compile workers, at most %u requests in flight\n", WorkerCount, m_pImpl->m_MaxQueuedRequests);
+}
+
+CCrySimpleReactor::~CCrySimpleReactor()
+{
+    {
+        std::lock_guard<std::mutex> Lock(m_pImpl->m_QueueMutex);
+        m_pImpl->m_Shutdown = true;
+    }
+    m_pImpl->m_QueueCondition.notify_all();
+    for (size_t a = 0; a < m_pImpl->m_Workers.size(); a++)
+    {
+        m_pImpl->m_Workers[a].join();
+    }
+
+    while (!m_pImpl->m_Connections.empty())
+    {
+        m_pImpl->Close(m_pImpl->m_Connections.begin()->first);
+    }
+    close(m_pImpl->m_Wakeup);
+    close(m_pImpl->m_Epoll);
+}
+
+volatile AtomicCountType CCrySimpleReactor::OpenConnections()
+{
+    return numberOfOpenConnections;
+}
+
+volatile AtomicCountType CCrySimpleReactor::QueuedRequests()
+{
+    return numberOfQueuedRequests;
+}
+
+void CCrySimpleReactor::Run()
+{
+    epoll_event Events[MAX_EVENTS];
+    while (true)
+    {
+        int Count = epoll_wait(m_pImpl->m_Epoll, Events, MAX_EVENTS, -1);
+        if (Count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            CrySimple_ERROR("epoll_wait failed");
+        }
+
+        for (int a = 0; a < Count; a++)
+        {
+            const uint64_t ID = Events[a].data.u64;
+            if (ID == LISTEN_ID)
+            {
+                m_pImpl->Accept();
+            }
+            else if (ID == WAKEUP_ID)
+            {
+                uint64_t Value;
+                while (read(m_pImpl->m_Wakeup, &Value, sizeof(Value)) == sizeof(Value))
+                {
+                }
+                m_pImpl->DrainCompleted();
+            }
+            else
+            {
+                m_pImpl->OnConnectionEvent(ID, Events[a].events);
+            }
+        }
+
+        // connections were closed or results were sent, see if the backlog can be let in again
+        if (m_pImpl->m_AcceptPaused && m_pImpl->m_Connections.size() < m_pImpl->m_MaxQueuedRequests && m_pImpl->m_Outstanding < m_pImpl->m_MaxQueuedRequests)
+        {
+            m_pImpl->Accept();
+        }
+    }
+}
+
+void CCrySimpleReactor::Implementation::PauseAccept(bool bPause)
+{
+    if (bPause == m_AcceptPaused)
+    {
+        return;
+    }
+
+    // leaving new connections in the listen backlog is the back pressure, the clients simply wait longer to connect.
+    epoll_event Event;
+    Event.events    =   bPause ? 0 : EPOLLIN;
+    Event.data.u64  =   LISTEN_ID;
+    epoll_ctl(m_Epoll, EPOLL_CTL_MOD, m_pListenSocket->Handle(), &Event);
+    m_AcceptPaused = bPause;
+}
+
+void CCrySimpleReactor::Implementation::Accept()
+{
+    while (m_Connections.size() < m_MaxQueuedRequests && m_Outstanding < m_MaxQueuedRequests)
+    {
+        sockaddr_in Addr;
+        socklen_t AddrSize = sizeof(Addr);
+        SOCKET Sock = accept4(m_pListenSocket->Handle(), reinterpret_cast<sockaddr*>(&Addr), &AddrSize, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (Sock == INVALID_SOCKET)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+            {
+                logmessage("Socket accept error: %d\n", errno);
+            }
+            PauseAccept(false);
+            return;
+        }
+
+        std::unique_ptr<SConnection> pConnection(new SConnection);
+        pConnection->m_Socket       =   Sock;
+        pConnection->m_PeerIP       =   Addr.sin_addr.s_addr;
+        pConnection->m_State        =   ECS_READING;
+        pConnection->m_SwapEndian   =   false;
+        pConnection->m_HeaderRead   =   0;
+        pConnection->m_RequestRead  =   0;
+        pConnection->m_ResponseSent =   0;
+
+        const uint64_t ID = m_NextConnectionID++;
+        epoll_event Event;
+        Event.events    =   EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        Event.data.u64  =   ID;
+        if (epoll_ctl(m_Epoll, EPOLL_CTL_ADD, Sock, &Event) != 0)
+        {
+            close(Sock);
+            continue;
+        }
+
+        InterlockedIncrement(&numberOfOpenConnections);
+        SConnection& rConnection = *pConnection;
+        m_Connections[ID] = std::move(pConnection);
+
+        // edge triggered, whatever already arrived won't be reported again
+        Read(ID, rConnection);
+    }
+
+    // too many connections are being read or waiting for their results, let the rest wait in the backlog
+    PauseAccept(true);
+}
+
+void CCrySimpleReactor::Implementation::OnConnectionEvent(uint64_t ID, uint32_t Events)
+{
+    auto it = m_Connections.find(ID);
+    if (it == m_Connections.end())
+    {
+        return;
+    }
+    SConnection& rConnection = *it->second;
+
+    if (Events & (EPOLLERR | EPOLLHUP))
+    {
+        Close(ID);
+        return;
+    }
+
+    if ((Events & EPOLLIN) && rConnection.m_State == ECS_READING)
+    {
+        Read(ID, rConnection);
+    }
+    else if ((Events & EPOLLOUT) && rConnection.m_State == ECS_WRITING)
+    {
+        Write(ID, rConnection);
+    }
+}
+
+void CCrySimpleReactor::Implementation::Read(uint64_t ID, SConnection& rConnection)
+{
+    while (rConnection.m_State == ECS_READING)
+    {
+        uint8_t* pTarget;
+        size_t Remaining;
+        if (rConnection.m_HeaderRead < sizeof(rConnection.m_Header))
+        {
+            pTarget     =   rConnection.m_Header + rConnection.m_HeaderRead;
+            Remaining   =   sizeof(rConnection.m_Header) - rConnection.m_HeaderRead;
+        }
+        else
+        {
+            pTarget     =   &rConnection.m_Request[rConnection.m_RequestRead];
+            Remaining   =   rConnection.m_Request.size() - rConnection.m_RequestRead;
+        }
+
+        ssize_t Received = recv(rConnection.m_Socket, pTarget, Remaining, 0);
+        if (Received < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                logmessage("Error while receiving tcp-data (Error Code: %i)\n", errno);
+                Close(ID);
+            }
+            return;
+        }
+        if (Received == 0)
+        {
+            // the client went away before sending the whole request
+            Close(ID);
+            return;
+        }
+
+        if (rConnection.m_HeaderRead < sizeof(rConnection.m_Header))
+        {
+            rConnection.m_HeaderRead += Received;
+            if (rConnection.m_HeaderRead == sizeof(rConnection.m_Header))
+            {
+                uint64_t Size;
+                if (!CCrySimpleSock::ParseRequestSize(rConnection.m_Header, Size, rConnection.m_SwapEndian) || Size > MAX_REQUEST_SIZE)
+                {
+                    logmessage("Error while reciving size of data - Invalid size\n");
+                    Close(ID);
+                    return;
+                }
+                rConnection.m_Request.resize(static_cast<size_t>(Size));
+            }
+            continue;
+        }
+
+        rConnection.m_RequestRead += Received;
+        if (rConnection.m_RequestRead == rConnection.m_Request.size())
+        {
+            rConnection.m_State = ECS_COMPILING;
+
+            SCompileRequest Request;
+            Request.m_ConnectionID  =   ID;
+            Request.m_PeerIP        =   rConnection.m_PeerIP;
+            Request.m_SwapEndian    =   rConnection.m_SwapEndian;
+            Request.m_Data.swap(rConnection.m_Request);
+            {
+                std::lock_guard<std::mutex> Lock(m_QueueMutex);
+                m_Queue.push_back(std::move(Request));
+            }
+            m_QueueCondition.notify_one();
+            InterlockedIncrement(&numberOfQueuedRequests);
+            m_Outstanding++;
+        }
+    }
+}
+
+void CCrySimpleReactor::Implementation::Write(uint64_t ID, SConnection& rConnection)
+{
+    while (rConnection.m_ResponseSent < rConnection.m_Response.size())
+    {
+        ssize_t Sent = send(rConnection.m_Socket, &rConnection.m_Response[rConnection.m_ResponseSent],
+                rConnection.m_Response.size() - rConnection.m_ResponseSent, MSG_NOSIGNAL);
+        if (Sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                logmessage("Socket send error: %d\n", errno);
+                Close(ID);
+            }
+            // otherwise wait for EPOLLOUT
+            return;
+        }
+        rConnection.m_ResponseSent += Sent;
+    }
+
+    // one request per connection, same as the blocking server
+    Close(ID);
+}
+
+void CCrySimpleReactor::Implementation::Close(uint64_t ID)
+{
+    auto it = m_Connections.find(ID);
+    if (it == m_Connections.end())
+    {
+        return;
+    }
+
+    // a connection which is still compiling is left for DrainCompleted to count down, its result is thrown away.
+    epoll_ctl(m_Epoll, EPOLL_CTL_DEL, it->second->m_Socket, nullptr);
+    shutdown(it->second->m_Socket, SHUT_RDWR);
+    closesocket(it->second->m_Socket);
+    m_Connections.erase(it);
+    InterlockedDecrement(&numberOfOpenConnections);
+}
+
+void CCrySimpleReactor::Implementation::DrainCompleted()
+{
+    std::deque<SCompileRequest> Completed;
+    {
+        std::lock_guard<std::mutex> Lock(m_QueueMutex);
+        Completed.swap(m_Completed);
+    }
+
+    for (size_t a = 0; a < Completed.size(); a++)
+    {
+        m_Outstanding--;
+
+        auto it = m_Connections.find(Completed[a].m_ConnectionID);
+        if (it == m_Connections.end())
+        {
+            continue;
+        }
+        SConnection& rConnection = *it->second;
+        rConnection.m_State = ECS_WRITING;
+        rConnection.m_Response.swap(Completed[a].m_Data);
+        Write(Completed[a].m_ConnectionID, rConnection);
+    }
+}
+
+void CCrySimpleReactor::Implementation::WorkerLoop()
+{
+    while (true)
+    {
+        SCompileRequest Request;
+        {
+            std::unique_lock<std::mutex> Lock(m_QueueMutex);
+            m_QueueCondition.wait(Lock, [this]() { return m_Shutdown || !m_Queue.empty(); });
+            if (m_Shutdown)
+            {
+                return;
+            }
+            Request = std::move(m_Queue.front());
+            m_Queue.pop_front();
+        }
+        InterlockedDecrement(&numberOfQueuedRequests);
+
+        tdDataVector Vec;
+        Vec.swap(Request.m_Data);
+        EProtocolVersion Version    =   EPV_V001;
+        ECrySimpleJobState State    =   ECSJS_JOBNOTFOUND;
+        CCrySimpleServer::ProcessRequest(Vec, Request.m_PeerIP, State, Version);
+        CCrySimpleSock::FrameResponse(Vec, State, Version, Request.m_SwapEndian, Request.m_Data);
+
+        {
+            std::lock_guard<std::mutex> Lock(m_QueueMutex);
+            m_Completed.push_back(std::move(Request));
+        }
+        const uint64_t One = 1;
+        write(m_Wakeup, &One, sizeof(One));
+    }
+}
+
+#endif
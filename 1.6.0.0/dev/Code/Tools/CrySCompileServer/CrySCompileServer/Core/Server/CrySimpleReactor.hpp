@@ -0,0 +1,48 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#ifndef __CRYSIMPLEREACTOR__
+#define __CRYSIMPLEREACTOR__
+
+#include <Core/Common.h>
+
+#if defined(AZ_PLATFORM_LINUX)
+#define CRYSIMPLE_HAS_REACTOR
+
+#include <memory>
+
+class CCrySimpleSock;
+
+// Serves the compile protocol from a single epoll thread instead of a job per connection.
+// Connections are read and written without blocking, requests which have been received in full are handed to a
+// fixed number of compile workers.  Once MaxQueuedRequests are waiting or being compiled no more connections are
+// accepted, clients wait in the listen backlog until a worker frees up.
+class CCrySimpleReactor
+{
+public:
+    CCrySimpleReactor(CCrySimpleSock* pListenSocket, uint32_t WorkerCount, uint32_t MaxQueuedRequests);
+    ~CCrySimpleReactor();
+
+    // never returns unless the listen socket fails
+    void                            Run();
+
+    static volatile AtomicCountType OpenConnections();
+    static volatile AtomicCountType QueuedRequests();
+
+private:
+    struct Implementation;
+    std::unique_ptr<Implementation> m_pImpl;
+};
+
+#endif
+
+#endif
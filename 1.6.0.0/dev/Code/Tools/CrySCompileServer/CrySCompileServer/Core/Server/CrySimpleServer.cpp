@@ -22,6 +22,8 @@
 #include "CrySimpleJobRequest.hpp"
 #include "CrySimpleCache.hpp"
 #include "CrySimpleErrorLog.hpp"
+#include "CrySimpleReactor.hpp"
+#include "CrySimpleBenchmark.hpp"
 #include "ShaderList.hpp"
 
 #include <Core/StdTypes.hpp>
@@ -148,6 +150,39 @@ void MakeErrorVec(const std::string& errorText, tdDataVector& Vec)
     }
 }
 
+void ReportRequestError(const ICryError* err, CCrySimpleJob* pJob, tdDataVector& Vec, ECrySimpleJobState& State)
+{
+    CCrySimpleServer::IncrementExceptionCount();
+
+    CRYSIMPLE_LOG("<Error> " + err->GetErrorName());
+
+    std::string returnStr = err->GetErrorDetails(ICryError::OUTPUT_TTY);
+
+    // Send error back
+    MakeErrorVec(returnStr, Vec);
+
+    if (pJob)
+    {
+        State   =   pJob->State();
+
+        if (State == ECSJS_ERROR_COMPILE && SEnviropment::Instance().m_PrintErrors)
+        {
+            printf("\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
+            printf("%s\n", err->GetErrorName().c_str());
+            printf("%s\n", returnStr.c_str());
+            printf("\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n\n");
+        }
+    }
+
+    bool added = CCrySimpleErrorLog::Instance().Add((ICryError*)err);
+
+    // error log hasn't taken ownership, delete this error.
+    if (!added)
+    {
+        delete err;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 class CompileJob
     : public AZ::Job
@@ -165,157 +200,152 @@ private:
 void CompileJob::Process()
 {
     std::vector<uint8_t> Vec;
-    std::unique_ptr<CCrySimpleJob> Job;
     EProtocolVersion Version    =   EPV_V001;
     ECrySimpleJobState State    =   ECSJS_JOBNOTFOUND;
     try
     {
-        if (m_pThreadData->Socket()->Recv(Vec))
+        if (!m_pThreadData->Socket()->Recv(Vec))
         {
-            std::string Request(reinterpret_cast<const char*>(&Vec[0]), Vec.size());
-            TiXmlDocument ReqParsed("Request.xml");
-            ReqParsed.Parse(Request.c_str());
+            return;
+        }
+    }
+    catch (const ICryError* err)
+    {
+        ReportRequestError(err, nullptr, Vec, State);
+        m_pThreadData->Socket()->Send(Vec, State, Version);
+        return;
+    }
 
-            if (ReqParsed.Error())
-            {
-                CrySimple_ERROR("failed to parse request XML");
-                return;
-            }
-            const TiXmlElement* pElement = ReqParsed.FirstChildElement();
-            if (!pElement)
-            {
-                CrySimple_ERROR("failed to extract First Element of the request");
-                return;
-            }
-            const char* pVersion            =   pElement->Attribute("Version");
-            std::string platform(pElement->Attribute("Platform"));
+    CCrySimpleServer::ProcessRequest(Vec, m_pThreadData->Socket()->PeerIP(), State, Version);
 
-            SEnviropment::Instance().m_Platform = "";
+    if (Version >= EPV_V0021)
+    {
+        m_pThreadData->Socket()->WaitForShutDownEvent(true);
+    }
+    m_pThreadData->Socket()->Send(Vec, State, Version);
 
-            static std::unordered_map<std::string, std::string> dumpShadersFolders {
-                {
-                    "GL4", "Shaders\\GL4\\"
-                }, {
-                    "GLES3_0", "Shaders\\GLES3_0\\"
-                }, {
-                    "GLES3_1", "Shaders\\GLES3_1\\"
-                }, {
-                    "DX11", "Shaders\\DX11\\"
-                }, {
-                    "METAL", "Shaders\\METAL\\"
-                }
-            };
-            auto foundShaderFolder = dumpShadersFolders.find(platform);
-            if (foundShaderFolder != end(dumpShadersFolders))
+    if (Version >= EPV_V0021)
+    {
+        /*
+        // wait until message has been succesfully delived before shutting down the connection
+        if(!m_pThreadData->Socket()->RecvResult())
+        {
+            printf("\nInvalid result from client\n");
+        }
+        */
+    }
+}
+
+void CCrySimpleServer::ProcessRequest(std::vector<uint8_t>& Vec, uint32_t PeerIP, ECrySimpleJobState& State, EProtocolVersion& Version)
+{
+    std::unique_ptr<CCrySimpleJob> Job;
+    Version =   EPV_V001;
+    State   =   ECSJS_JOBNOTFOUND;
+    try
+    {
+        std::string Request(reinterpret_cast<const char*>(&Vec[0]), Vec.size());
+        TiXmlDocument ReqParsed("Request.xml");
+        ReqParsed.Parse(Request.c_str());
+
+        // the error text is sent back, flagged as an error rather than as an unknown job
+        if (ReqParsed.Error())
+        {
+            State   =   ECSJS_ERROR;
+            CrySimple_ERROR("failed to parse request XML");
+            return;
+        }
+        const TiXmlElement* pElement = ReqParsed.FirstChildElement();
+        if (!pElement)
+        {
+            State   =   ECSJS_ERROR;
+            CrySimple_ERROR("failed to extract First Element of the request");
+            return;
+        }
+        const char* pVersion            =   pElement->Attribute("Version");
+        std::string platform(pElement->Attribute("Platform"));
+
+        SEnviropment::Instance().m_Platform = "";
+
+        static std::unordered_map<std::string, std::string> dumpShadersFolders {
             {
-                SEnviropment::Instance().m_Platform = foundShaderFolder->first;
-                SEnviropment::Instance().m_Shader = SEnviropment::Instance().m_Root + foundShaderFolder->second;
+                "GL4", "Shaders\\GL4\\"
+            }, {
+                "GLES3_0", "Shaders\\GLES3_0\\"
+            }, {
+                "GLES3_1", "Shaders\\GLES3_1\\"
+            }, {
+                "DX11", "Shaders\\DX11\\"
+            }, {
+                "METAL", "Shaders\\METAL\\"
             }
+        };
+        auto foundShaderFolder = dumpShadersFolders.find(platform);
+        if (foundShaderFolder != end(dumpShadersFolders))
+        {
+            SEnviropment::Instance().m_Platform = foundShaderFolder->first;
+            SEnviropment::Instance().m_Shader = SEnviropment::Instance().m_Root + foundShaderFolder->second;
+        }
 
-            AZ::IO::SystemFile::CreateDir(SEnviropment::Instance().m_Shader.c_str());
+        AZ::IO::SystemFile::CreateDir(SEnviropment::Instance().m_Shader.c_str());
 
-            //new request type?
-            if (pVersion)
+        //new request type?
+        if (pVersion)
+        {
+            if (std::string(pVersion) == "2.1")
             {
-                if (std::string(pVersion) == "2.1")
-                {
-                    Version =   EPV_V0021;
-                }
-                else if (std::string(pVersion) == "2.0")
-                {
-                    Version =   EPV_V002;
-                }
+                Version =   EPV_V0021;
+            }
+            else if (std::string(pVersion) == "2.0")
+            {
+                Version =   EPV_V002;
             }
+        }
 
-            if (Version >= EPV_V002)
+        if (Version >= EPV_V002)
+        {
+            const char* pJobType    =   pElement->Attribute("JobType");
+            if (pJobType)
             {
-                if (Version >= EPV_V0021)
+                const std::string JobType(pJobType);
+                if (JobType == "RequestLine")
                 {
-                    m_pThreadData->Socket()->WaitForShutDownEvent(true);
+                    Job = std::make_unique<CCrySimpleJobRequest>(PeerIP);
+                    Job->Execute(pElement);
+                    State   =   Job->State();
+                    Vec.resize(0);
                 }
-
-                const char* pJobType    =   pElement->Attribute("JobType");
-                if (pJobType)
+                else
+                if (JobType == "Compile")
                 {
-                    const std::string JobType(pJobType);
-                    if (JobType == "RequestLine")
+                    if (!SEnviropment::Instance().m_DumpRequests.empty())
                     {
-                        Job = std::make_unique<CCrySimpleJobRequest>(m_pThreadData->Socket()->PeerIP());
-                        Job->Execute(pElement);
-                        State   =   Job->State();
-                        Vec.resize(0);
-                    }
-                    else
-                    if (JobType == "Compile")
-                    {
-                        Job = std::make_unique<CCrySimpleJobCompile2>(m_pThreadData->Socket()->PeerIP(), &Vec);
-                        Job->Execute(pElement);
-                        State   =   Job->State();
-                    }
-                    else
-                    {
-                        printf("\nRequested unkown job %s\n", pJobType);
+                        CCrySimpleBenchmark::RecordRequest(SEnviropment::Instance().m_DumpRequests, Vec);
                     }
+                    Job = std::make_unique<CCrySimpleJobCompile2>(PeerIP, &Vec);
+                    Job->Execute(pElement);
+                    State   =   Job->State();
                 }
                 else
                 {
-                    printf("\nVersion 2.0 or higher but has no JobType tag\n");
+                    printf("\nRequested unkown job %s\n", pJobType);
                 }
             }
             else
             {
-                //legacy request
-                Version =   EPV_V001;
-                Job = std::make_unique<CCrySimpleJobCompile1>(m_pThreadData->Socket()->PeerIP(), &Vec);
-                Job->Execute(pElement);
-            }
-            m_pThreadData->Socket()->Send(Vec, State, Version);
-
-            if (Version >= EPV_V0021)
-            {
-                /*
-                // wait until message has been succesfully delived before shutting down the connection
-                if(!m_pThreadData->Socket()->RecvResult())
-                {
-                    printf("\nInvalid result from client\n");
-                }
-                */
+                printf("\nVersion 2.0 or higher but has no JobType tag\n");
             }
         }
+        else
+        {
+            //legacy request
+            Version =   EPV_V001;
+            Job = std::make_unique<CCrySimpleJobCompile1>(PeerIP, &Vec);
+            Job->Execute(pElement);
+        }
     }
     catch (const ICryError* err)
     {
-        CCrySimpleServer::IncrementExceptionCount();
-
-        CRYSIMPLE_LOG("<Error> " + err->GetErrorName());
-
-        std::string returnStr = err->GetErrorDetails(ICryError::OUTPUT_TTY);
-
-        // Send error back
-        MakeErrorVec(returnStr, Vec);
-
-        if (Job.get())
-        {
-            State   =   Job->State();
-
-            if (State == ECSJS_ERROR_COMPILE && SEnviropment::Instance().m_PrintErrors)
-            {
-                printf("\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
-                printf("%s\n", err->GetErrorName().c_str());
-                printf("%s\n", returnStr.c_str());
-                printf("\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n\n");
-            }
-        }
-
-        bool added = CCrySimpleErrorLog::Instance().Add((ICryError*)err);
-
-        // error log hasn't taken ownership, delete this error.
-        if (!added)
-        {
-            delete err;
-        }
-
-        m_pThreadData->Socket()->Send(Vec, State, Version);
+        ReportRequestError(err, Job.get(), Vec, State);
     }
 }
 
@@ -381,6 +411,7 @@ void LoadCache()
         printf("Cache file corrupted!!!\n");
         printf("Restoring backup cache...\n");
         AZ::IO::SystemFile::Delete((SEnviropment::Instance().m_Cache + "Cache.dat").c_str());
+        AZ::IO::SystemFile::Delete((SEnviropment::Instance().m_Cache + "Cache.idx").c_str()); // the index was made for the file we just deleted
         printf("Copy %s to %s\n", (SEnviropment::Instance().m_Cache + "Cache.bak").c_str(), (SEnviropment::Instance().m_Cache + "Cache.dat").c_str());
         CopyFileOnPlatform((SEnviropment::Instance().m_Cache + "Cache.bak").c_str(), (SEnviropment::Instance().m_Cache + "Cache.dat").c_str(), FALSE);
         if (!CCrySimpleCache::Instance().LoadCacheFile(SEnviropment::Instance().m_Cache + "Cache.dat"))
@@ -418,6 +449,10 @@ CCrySimpleServer::CCrySimpleServer()
     AZ::Job* tickThreadJob = AZ::CreateJobFunction(&TickThread, autoDeleteJobWhenDone);
     tickThreadJob->Start();
 
+#if defined(CRYSIMPLE_HAS_REACTOR)
+    CCrySimpleReactor Reactor(m_pServerSocket, SEnviropment::Instance().m_CompileWorkers, SEnviropment::Instance().m_MaxQueuedRequests);
+    Reactor.Run();
+#else
     uint32_t JobCounter = 0;
     while (1)
     {
@@ -429,6 +464,7 @@ CCrySimpleServer::CCrySimpleServer()
             compileJob->Start();
         }
     }
+#endif
     CrySimple_SECURE_END
 }
 
@@ -15,7 +15,9 @@
 #define __CRYSIMPLESERVER__
 
 #include <Core/Common.h>
+#include "CrySimpleJob.hpp"
 #include <string>
+#include <vector>
 
 extern bool g_Success;
 
@@ -42,12 +44,16 @@ public:
     uint32_t      m_MailInterval; // seconds since last error to flush error mails
 
     bool                    m_Caching;
+    uint32_t                m_CacheMemoryBudget; // megabytes of compiled shaders kept in memory, the rest is read back from the cache file. 0 for no limit
     bool                    m_PrintErrors = 1;
     bool          m_PrintListUpdates;
     bool          m_DedupeErrors;
     bool          m_DumpShaders = 1;
     std::string     m_FallbackServer;
     int32_t                 m_FallbackTreshold;
+    uint32_t                m_CompileWorkers;       // threads compiling requests when connections are handled by the reactor, 0 for one per core
+    uint32_t                m_MaxQueuedRequests;    // requests received but not answered yet before the reactor stops accepting connections
+    std::string     m_DumpRequests;         // file every compile request is appended to, to be replayed with -benchmark. empty to disable
 
     static SEnviropment&    Instance();
 };
@@ -64,6 +70,10 @@ public:
 
     static AtomicCountType          GetExceptionCount() { return ms_ExceptionCount; }
     static void                             IncrementExceptionCount();
+
+    // Runs a request which has been received in full, Vec holds the request and is replaced with the response.
+    // Errors are logged and turned into an error response.
+    static void                             ProcessRequest(std::vector<uint8_t>& Vec, uint32_t PeerIP, ECrySimpleJobState& State, EProtocolVersion& Version);
 };
 
 #endif
@@ -395,6 +395,45 @@ int CCrySimpleSock::Recv(char* acData, int len, int flags)
     return recived;
 }
 
+bool CCrySimpleSock::ParseRequestSize(const uint8_t* pHeader, uint64_t& rSize, bool& rSwapEndian)
+{
+    CrySimpleRecvSize size;
+    memcpy(size.m_Data8, pHeader, sizeof(size.m_Data8));
+    if (size.m_Data64 == 0)
+    {
+        return false;
+    }
+
+    rSwapEndian =   (size.m_Data64 >> 32) != 0;
+    if (rSwapEndian)
+    {
+        CSTLHelper::EndianSwizzleU64(size.m_Data64);
+    }
+    rSize = size.m_Data64;
+    return true;
+}
+
+void CCrySimpleSock::FrameResponse(const std::vector<uint8_t>& rVecIn, size_t state, EProtocolVersion version, bool SwapEndian, std::vector<uint8_t>& rVec)
+{
+    const size_t offset = version == EPV_V001 ? 4 : 5;
+    rVec.resize(rVecIn.size() + offset);
+    if (rVecIn.size())
+    {
+        *(uint32_t*)(&rVec[0]) = (uint32_t)rVecIn.size();
+        memcpy(&rVec[offset], &rVecIn[0], rVecIn.size());
+    }
+
+    if (version >= EPV_V002)
+    {
+        rVec[4] =   static_cast<uint8_t>(state);
+    }
+
+    if (SwapEndian)
+    {
+        CSTLHelper::EndianSwizzleU32(*(uint32_t*)&rVec[0]);
+    }
+}
+
 bool CCrySimpleSock::Recv(std::vector<uint8_t>& rVec)
 {
     CrySimpleRecvSize size;
@@ -413,7 +452,7 @@ bool CCrySimpleSock::Recv(std::vector<uint8_t>& rVec)
         return false;
     }
 
-    if (size.m_Data64 == 0)
+    if (!ParseRequestSize(size.m_Data8, size.m_Data64, m_pImpl->m_SwapEndian))
     {
         int WSAError = WSAGetLastError();
         char acTmp[1024];
@@ -423,12 +462,6 @@ bool CCrySimpleSock::Recv(std::vector<uint8_t>& rVec)
         return false;
     }
 
-    m_pImpl->m_SwapEndian   =   (size.m_Data64 >> 32) != 0;
-    if (m_pImpl->m_SwapEndian)
-    {
-        CSTLHelper::EndianSwizzleU64(size.m_Data64);
-    }
-
     rVec.clear();
     rVec.resize(static_cast<size_t>(size.m_Data64));
 
@@ -513,26 +546,44 @@ bool CCrySimpleSock::Backward(std::vector<uint8_t>& rVec)
     return true;
 }
 
-void CCrySimpleSock::Send(const std::vector<uint8_t>& rVecIn, size_t state, EProtocolVersion version)
+bool CCrySimpleSock::RecvResponse(std::vector<uint8_t>& rVec, uint8_t& rState)
 {
-    const size_t offset = version == EPV_V001 ? 4 : 5;
-    tdDataVector& rVec = m_pImpl->m_tempSendBuffer;
-    rVec.resize(rVecIn.size() + offset);
-    if (rVecIn.size())
+    uint8_t header[5];
+    for (int a = 0; a < 5; )
     {
-        *(uint32_t*)(&rVec[0]) = (uint32_t)rVecIn.size();
-        memcpy(&rVec[offset], &rVecIn[0], rVecIn.size());
+        int read = recv(m_pImpl->m_Socket, reinterpret_cast<char*>(&header[a]), 5 - a, 0);
+        if (read <= 0)
+        {
+            CrySimple_ERROR("Error while reciving size of data");
+            return false;
+        }
+        a += read;
     }
 
-    if (version >= EPV_V002)
-    {
-        rVec[4] =   static_cast<uint8_t>(state);
-    }
+    const uint32_t size = *reinterpret_cast<uint32_t*>(&header[0]);
+    rState = header[4];
 
-    if (m_pImpl->m_SwapEndian)
+    rVec.clear();
+    rVec.resize(static_cast<size_t>(size));
+
+    for (uint32_t a = 0; a < size; )
     {
-        CSTLHelper::EndianSwizzleU32(*(uint32_t*)&rVec[0]);
+        int read = recv(m_pImpl->m_Socket, reinterpret_cast<char*>(&rVec[a]), size - a, 0);
+        if (read <= 0)
+        {
+            CrySimple_ERROR("Error while reciving tcp-data");
+            return false;
+        }
+        a += read;
     }
+    m_pImpl->m_bHasReceivedData = true;
+    return true;
+}
+
+void CCrySimpleSock::Send(const std::vector<uint8_t>& rVecIn, size_t state, EProtocolVersion version)
+{
+    tdDataVector& rVec = m_pImpl->m_tempSendBuffer;
+    FrameResponse(rVecIn, state, version, m_pImpl->m_SwapEndian, rVec);
 
     const size_t BLOCKSIZE = 4 * 1024;
 
@@ -610,6 +661,11 @@ bool CCrySimpleSock::Valid() const
     return m_pImpl->m_Socket != INVALID_SOCKET;
 }
 
+SOCKET CCrySimpleSock::Handle() const
+{
+    return m_pImpl->m_Socket;
+}
+
 void CCrySimpleSock::WaitForShutDownEvent(bool bValue)
 {
     m_pImpl->m_WaitForShutdownEvent = bValue;
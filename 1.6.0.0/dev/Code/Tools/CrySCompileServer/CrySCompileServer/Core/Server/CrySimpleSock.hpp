@@ -16,6 +16,7 @@
 
 #include <Core/Common.h>
 #include <Core/STLHelper.hpp>
+#include "CrySimpleJob.hpp"
 
 #if defined(AZ_PLATFORM_LINUX) || defined(AZ_PLATFORM_APPLE_OSX)
 typedef int SOCKET;
@@ -36,13 +37,6 @@ typedef int SOCKET;
 
 //#define USE_WSAEVENTS
 
-enum EProtocolVersion
-{
-    EPV_V001,
-    EPV_V002,
-    EPV_V0021,
-};
-
 class CCrySimpleSock
 {
 public:
@@ -74,6 +68,8 @@ public:
     bool            RecvResult();
 
     bool            Backward(std::vector<uint8_t>& rVec);
+    // client side counterpart of Send for protocol 2.x, rVec receives the payload without the state byte
+    bool            RecvResponse(std::vector<uint8_t>& rVec, uint8_t& rState);
     void            Send(const std::vector<uint8_t>& rVec, size_t State, EProtocolVersion Version);
     void            Forward(const std::vector<uint8_t>& rVec);
 
@@ -84,10 +80,17 @@ public:
 
     bool            Valid() const;
 
+    SOCKET          Handle() const;
+
     void            WaitForShutDownEvent(bool bValue);
 
     static volatile AtomicCountType GetOpenSockets();
 
+    // the wire format, shared with code which does its own (non blocking) socket io.
+    // a request starts with its size as 8 bytes, in the byte order of the client.
+    static bool     ParseRequestSize(const uint8_t* pHeader, uint64_t& rSize, bool& rSwapEndian);
+    static void     FrameResponse(const std::vector<uint8_t>& rVecIn, size_t State, EProtocolVersion Version, bool SwapEndian, std::vector<uint8_t>& rOut);
+
 private:
     struct Implementation;
     std::unique_ptr<Implementation> m_pImpl;
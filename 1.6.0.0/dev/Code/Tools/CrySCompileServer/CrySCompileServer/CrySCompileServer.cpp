@@ -14,6 +14,7 @@
 #include "Core/StdTypes.hpp"
 #include "Core/Server/CrySimpleServer.hpp"
 #include "Core/Server/CrySimpleHTTP.hpp"
+#include "Core/Server/CrySimpleBenchmark.hpp"
 
 #include <AzFramework/StringFunc/StringFunc.h>
 
@@ -60,6 +61,10 @@ public:
         {
             SEnviropment::Instance().m_Caching = atoi(strValue.c_str()) != 0;
         }
+        if (azstricmp(strKey.c_str(), "CacheMemoryBudget") == 0)
+        {
+            SEnviropment::Instance().m_CacheMemoryBudget = atoi(strValue.c_str());
+        }
         if (azstricmp(strKey.c_str(), "PrintErrors") == 0)
         {
             SEnviropment::Instance().m_PrintErrors = atoi(strValue.c_str()) != 0;
@@ -80,6 +85,18 @@ public:
         {
             SEnviropment::Instance().m_FallbackTreshold = atoi(strValue.c_str());
         }
+        if (azstricmp(strKey.c_str(), "CompileWorkers") == 0)
+        {
+            SEnviropment::Instance().m_CompileWorkers = atoi(strValue.c_str());
+        }
+        if (azstricmp(strKey.c_str(), "MaxQueuedRequests") == 0)
+        {
+            SEnviropment::Instance().m_MaxQueuedRequests = atoi(strValue.c_str());
+        }
+        if (azstricmp(strKey.c_str(), "DumpRequests") == 0)
+        {
+            SEnviropment::Instance().m_DumpRequests = strValue;
+        }
         if (azstricmp(strKey.c_str(), "DumpShaders") == 0)
         {
             SEnviropment::Instance().m_DumpShaders = atoi(strValue.c_str()) != 0;
@@ -220,11 +237,15 @@ void InitDefaults()
     SEnviropment::Instance().m_MailInterval             = 10;
     SEnviropment::Instance().m_MailServer               = "example.com";
     SEnviropment::Instance().m_Caching                      =   true;
+    SEnviropment::Instance().m_CacheMemoryBudget    =   1024;
     SEnviropment::Instance().m_PrintErrors              = true;
     SEnviropment::Instance().m_DedupeErrors             = true;
     SEnviropment::Instance().m_PrintListUpdates     = true;
     SEnviropment::Instance().m_FallbackTreshold     =   16;
     SEnviropment::Instance().m_FallbackServer           =   "";
+    SEnviropment::Instance().m_CompileWorkers           =   0;
+    SEnviropment::Instance().m_MaxQueuedRequests        =   256;
+    SEnviropment::Instance().m_DumpRequests             =   "";
 }
 
 int main(int argc, char* argv[])
@@ -266,8 +287,23 @@ int main(int argc, char* argv[])
         CCrySimpleServer();
     }
     else
+    if (argc >= 3 && strcmp(argv[1], "-benchmark") == 0)
+    {
+        CConfigFile config;
+
+        config.ParseConfig("config.ini");
+
+        const std::string Host  =   argc > 3 ? argv[3] : "127.0.0.1";
+        const int Connections   =   argc > 4 ? atoi(argv[4]) : 64;
+        const int Repeat        =   argc > 5 ? atoi(argv[5]) : 1;
+        CCrySimpleBenchmark Benchmark(argv[2], Host, static_cast<uint16_t>(SEnviropment::Instance().m_port), Connections, Repeat);
+        Benchmark.Run();
+    }
+    else
     {
-        const char Info[] = "usage: without param ";
+        const char Info[] = "usage: without param \n"
+            "       -benchmark <RequestFile> [host] [connections] [repeat]\n"
+            "       RequestFile is written by a server running with DumpRequests=<RequestFile> in its config.ini\n";
         printf(Info);
     }
 
@@ -55,6 +55,21 @@ private:
     mutable std::FILE* file;
 };
 
+// Receives the text of selected elements while the document is being parsed, so large content can be converted
+// on the fly instead of being kept as a node content string.
+struct IXmlContentHandler
+{
+    virtual ~IXmlContentHandler() {}
+
+    // Called when an element starts. Returning true routes the element's text to OnContent() and leaves the
+    // content of the node empty.
+    virtual bool WantsContent(const char* tag) = 0;
+    // Called with consecutive pieces of the element's text, a number or word may be split between two calls.
+    virtual void OnContent(IXmlNode* node, const char* data, int len) = 0;
+    // Called when the element ends, no more text follows for this node.
+    virtual void OnContentEnd(IXmlNode* node) = 0;
+};
+
 class IXMLSerializer
 {
 public:
@@ -62,6 +77,8 @@ public:
     virtual bool Write(XmlNodeRef root, const char* szFileName) = 0;
 
     virtual XmlNodeRef Read(const IXmlBufferSource& source, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer) = 0;
+    // Same as above, text of elements claimed by pContentHandler is passed to it instead of being stored.
+    virtual XmlNodeRef Read(const IXmlBufferSource& source, IXmlContentHandler* pContentHandler, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer) = 0;
 };
 
 #endif // CRYINCLUDE_CRYXML_IXMLSERIALIZER_H
@@ -0,0 +1,167 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "stdafx.h"
+#include <AzTest/AzTest.h>
+
+#include "../XML/xml.h"
+
+namespace
+{
+    XmlNodeRef ParseXml(const char* text)
+    {
+        XmlParser parser(false);
+        return parser.parseBuffer(text);
+    }
+}
+
+TEST(CryXMLNodeTest, GetAttr_IgnoresKeyCase)
+{
+    XmlNodeRef node = ParseXml("<root Name=\"parsed\"/>");
+    ASSERT_TRUE(node);
+
+    EXPECT_STREQ("parsed", node->getAttr("Name"));
+    EXPECT_STREQ("parsed", node->getAttr("name"));
+    EXPECT_STREQ("parsed", node->getAttr("NAME"));
+    EXPECT_TRUE(node->haveAttr("nAmE"));
+
+    // setting a differently spelled key overrides the same attribute
+    node->setAttr("NAME", "set");
+    EXPECT_EQ(1, node->getNumAttributes());
+    EXPECT_STREQ("set", node->getAttr("name"));
+
+    // keys this document never saw are simply missing
+    const char* value = nullptr;
+    EXPECT_FALSE(node->getAttr("Unknown", &value));
+    EXPECT_STREQ("", value);
+    EXPECT_STREQ("", node->getAttr("Unknown"));
+    EXPECT_FALSE(node->haveAttr("Nam"));
+
+    // keys are matched per document
+    XmlNodeRef other = new CXmlNode("other");
+    other->setAttr("Only", "1");
+    EXPECT_FALSE(node->haveAttr("only"));
+    EXPECT_TRUE(other->haveAttr("ONLY"));
+}
+
+TEST(CryXMLNodeTest, Clone_CopiesTheWholeTree)
+{
+    XmlNodeRef root = ParseXml("<root a=\"1\" B=\"2\"><child c=\"3\">text</child><empty/></root>");
+    ASSERT_TRUE(root);
+
+    XmlNodeRef copy = root->clone();
+    root = nullptr;
+
+    ASSERT_TRUE(copy);
+    EXPECT_STREQ("root", copy->getTag());
+    EXPECT_EQ(2, copy->getNumAttributes());
+    EXPECT_STREQ("1", copy->getAttr("A"));
+    EXPECT_STREQ("2", copy->getAttr("b"));
+    ASSERT_EQ(2, copy->getChildCount());
+
+    XmlNodeRef child = copy->getChild(0);
+    EXPECT_STREQ("child", child->getTag());
+    EXPECT_STREQ("3", child->getAttr("c"));
+    EXPECT_STREQ("text", child->getContent());
+    EXPECT_TRUE(child->getParent() == copy);
+    EXPECT_STREQ("empty", copy->getChild(1)->getTag());
+    EXPECT_EQ(0, copy->getChild(1)->getNumAttributes());
+
+    // the clone does not share attributes with the original
+    XmlNodeRef source = ParseXml("<root a=\"1\"/>");
+    XmlNodeRef second = source->clone();
+    second->setAttr("a", "changed");
+    EXPECT_STREQ("1", source->getAttr("a"));
+    EXPECT_STREQ("changed", second->getAttr("a"));
+}
+
+TEST(CryXMLNodeTest, CopyAttributes_BetweenDocuments)
+{
+    XmlNodeRef from = ParseXml("<from Key=\"value\" other=\"2\"/>");
+    XmlNodeRef to = ParseXml("<to KEY=\"old\" kept=\"yes\"/>");
+    ASSERT_TRUE(from);
+    ASSERT_TRUE(to);
+
+    to->copyAttributes(from);
+
+    // the source document can go away, the copied strings belong to the target document
+    from = nullptr;
+
+    EXPECT_EQ(2, to->getNumAttributes());
+    EXPECT_STREQ("value", to->getAttr("key"));
+    EXPECT_STREQ("2", to->getAttr("Other"));
+    EXPECT_FALSE(to->haveAttr("kept"));
+
+    const char* key = nullptr;
+    const char* value = nullptr;
+    ASSERT_TRUE(to->getAttributeByIndex(0, &key, &value));
+    EXPECT_STREQ("Key", key);
+    EXPECT_STREQ("value", value);
+
+    // a node built on its own can take attributes from a parsed one too
+    XmlNodeRef parsed = ParseXml("<parsed x=\"1\"/>");
+    XmlNodeRef standalone = new CXmlNode("standalone");
+    standalone->copyAttributes(parsed);
+    parsed = nullptr;
+    EXPECT_STREQ("1", standalone->getAttr("X"));
+}
+
+TEST(CryXMLNodeTest, CopyAttributes_WithinDocument)
+{
+    XmlNodeRef root = ParseXml("<root><a k=\"1\"/><b/></root>");
+    ASSERT_TRUE(root);
+
+    XmlNodeRef a = root->getChild(0);
+    XmlNodeRef b = root->getChild(1);
+    b->copyAttributes(a);
+    EXPECT_STREQ("1", b->getAttr("K"));
+
+    // changing the copy leaves the source alone
+    b->setAttr("k", "2");
+    b->setAttr("extra", "3");
+    EXPECT_STREQ("1", a->getAttr("k"));
+    EXPECT_EQ(1, a->getNumAttributes());
+    EXPECT_STREQ("2", b->getAttr("k"));
+}
+
+TEST(CryXMLNodeTest, Children_OutliveTheDocumentRoot)
+{
+    XmlNodeRef root = ParseXml("<root><child name=\"first\"><grandchild/></child><child name=\"second\"/></root>");
+    ASSERT_TRUE(root);
+
+    XmlNodeRef first = root->getChild(0);
+    XmlNodeRef grandchild = first->getChild(0);
+    XmlNodeRef added = root->newChild("added");
+    added->setAttr("Name", "third");
+
+    root = nullptr;
+
+    // the children keep the document alive but lose their parent
+    EXPECT_FALSE(first->getParent());
+    EXPECT_STREQ("child", first->getTag());
+    EXPECT_STREQ("first", first->getAttr("NAME"));
+    EXPECT_TRUE(grandchild->getParent() == first);
+    EXPECT_STREQ("third", added->getAttr("name"));
+
+    // they can still be changed and moved into another document
+    first->setAttr("name", "renamed");
+    XmlNodeRef other = new CXmlNode("other");
+    other->addChild(first);
+    EXPECT_TRUE(first->getParent() == other);
+    EXPECT_STREQ("renamed", other->getChild(0)->getAttr("name"));
+
+    first = nullptr;
+    added = nullptr;
+    EXPECT_STREQ("grandchild", grandchild->getTag());
+    other = nullptr;
+    EXPECT_FALSE(grandchild->getParent());
+    grandchild = nullptr;
+}
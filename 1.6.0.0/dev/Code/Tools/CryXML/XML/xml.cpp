@@ -249,13 +249,215 @@ public:
     virtual size_t GetStringLength() { return m_string.size(); };
 };
 
-class CXmlStringPool
+//////////////////////////////////////////////////////////////////////////
+// Memory of one document: value strings, interned tags and keys, nodes and attribute arrays.
+// Nothing is freed individually, everything goes when the last node referencing the pool is released.
+class CXmlDocumentPool
     : public IXmlStringPool
 {
 public:
+    enum
+    {
+        ARENA_BLOCK_SIZE = 64 * 1024,
+        ARENA_ALIGNMENT = 16,
+    };
+
+    CXmlDocumentPool()
+        : m_arenaBlocks(0)
+        , m_arenaPtr(0)
+        , m_arenaEnd(0)
+        , m_internCount(0)
+    {
+    }
+
+    ~CXmlDocumentPool()
+    {
+        ArenaBlock* p = m_arenaBlocks;
+        while (p)
+        {
+            ArenaBlock* temp = p->next;
+            free(p);
+            p = temp;
+        }
+    }
+
+    void SetBlockSize(unsigned int nBlockSize) { m_stringPool.SetBlockSize(nBlockSize); }
+
     char* AddString(const char* str) { return m_stringPool.Append(str, (int)strlen(str)); }
+
+    const char* InternString(const char* str, const char** pKeyId)
+    {
+        if (m_internCount * 2 >= m_internTable.size())
+        {
+            GrowInternTable();
+        }
+
+        const unsigned int hash = HashKey(str);
+        const size_t mask = m_internTable.size() - 1;
+        const char* keyId = 0;
+        size_t slot = hash & mask;
+        for (; m_internTable[slot].text; slot = (slot + 1) & mask)
+        {
+            const InternEntry& entry = m_internTable[slot];
+            if (entry.hash != hash)
+            {
+                continue;
+            }
+            if (strcmp(entry.text, str) == 0)
+            {
+                if (pKeyId)
+                {
+                    *pKeyId = entry.id;
+                }
+                return entry.text;
+            }
+            if (!keyId && ascii_stricmp(entry.text, str) == 0)
+            {
+                keyId = entry.id;
+            }
+        }
+
+        // New spelling, it shares the id of any key differing only in case
+        InternEntry& entry = m_internTable[slot];
+        entry.text = AddString(str);
+        entry.id = keyId ? keyId : entry.text;
+        entry.hash = hash;
+        ++m_internCount;
+
+        if (pKeyId)
+        {
+            *pKeyId = entry.id;
+        }
+        return entry.text;
+    }
+
+    const char* FindKeyId(const char* str) const
+    {
+        if (!m_internCount || !str)
+        {
+            return 0;
+        }
+
+        const unsigned int hash = HashKey(str);
+        const size_t mask = m_internTable.size() - 1;
+        for (size_t slot = hash & mask; m_internTable[slot].text; slot = (slot + 1) & mask)
+        {
+            const InternEntry& entry = m_internTable[slot];
+            if (entry.hash == hash && ascii_stricmp(entry.text, str) == 0)
+            {
+                return entry.id;
+            }
+        }
+        return 0;
+    }
+
+    void* Allocate(size_t size)
+    {
+        size = (size + ARENA_ALIGNMENT - 1) & ~size_t(ARENA_ALIGNMENT - 1);
+        if (size > size_t(m_arenaEnd - m_arenaPtr))
+        {
+            // Oversized requests get a block of their own so the current block keeps its free space
+            if (size > ARENA_BLOCK_SIZE / 4)
+            {
+                return AllocArenaBlock(size, false);
+            }
+            AllocArenaBlock(ARENA_BLOCK_SIZE, true);
+        }
+        char* ptr = m_arenaPtr;
+        m_arenaPtr += size;
+        return ptr;
+    }
+
+    void Deallocate(void* ptr, size_t size)
+    {
+        // Only the most recent allocation can be given back. A growing vector allocates its new buffer before
+        // freeing the old one, so old buffers stay in the arena until the pool goes away; with 1.5x or 2x growth
+        // they add up to at most twice the final buffer.
+        size = (size + ARENA_ALIGNMENT - 1) & ~size_t(ARENA_ALIGNMENT - 1);
+        if ((char*)ptr + size == m_arenaPtr)
+        {
+            m_arenaPtr = (char*)ptr;
+        }
+    }
+
 private:
+    struct ArenaBlock
+    {
+        ArenaBlock* next;
+        size_t size;
+    };
+
+    struct InternEntry
+    {
+        const char* text;
+        const char* id;
+        unsigned int hash;
+    };
+
+    // Case-insensitive so keys differing only in case land in the same probe sequence
+    static unsigned int HashKey(const char* str)
+    {
+        unsigned int hash = 2166136261u;
+        for (; *str; ++str)
+        {
+            unsigned int c = (unsigned char)*str;
+            if (c >= 'A' && c <= 'Z')
+            {
+                c -= 'A' - 'a';
+            }
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash;
+    }
+
+    char* AllocArenaBlock(size_t size, bool bMakeCurrent)
+    {
+        const size_t headerSize = (sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~size_t(ARENA_ALIGNMENT - 1);
+        ArenaBlock* pBlock = (ArenaBlock*)malloc(headerSize + size);
+        pBlock->size = size;
+        pBlock->next = m_arenaBlocks;
+        m_arenaBlocks = pBlock;
+
+        char* data = (char*)pBlock + headerSize;
+        if (bMakeCurrent)
+        {
+            m_arenaPtr = data;
+            m_arenaEnd = data + size;
+        }
+        return data;
+    }
+
+    void GrowInternTable()
+    {
+        std::vector<InternEntry> oldTable;
+        oldTable.swap(m_internTable);
+
+        const InternEntry emptyEntry = { 0, 0, 0 };
+        m_internTable.resize(oldTable.empty() ? 256 : oldTable.size() * 2, emptyEntry);
+
+        const size_t mask = m_internTable.size() - 1;
+        for (size_t i = 0; i < oldTable.size(); ++i)
+        {
+            if (oldTable[i].text)
+            {
+                size_t slot = oldTable[i].hash & mask;
+                while (m_internTable[slot].text)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                m_internTable[slot] = oldTable[i];
+            }
+        }
+    }
+
     CSimpleStringPool m_stringPool;
+
+    ArenaBlock* m_arenaBlocks;
+    char* m_arenaPtr;
+    char* m_arenaEnd;
+
+    std::vector<InternEntry> m_internTable;
+    size_t m_internCount;
 };
 
 /**
@@ -266,7 +468,26 @@ private:
 
 void CXmlNode::DeleteThis()
 {
-    delete this;
+    // Keep the pool alive until the members holding pool memory are gone, the last node out frees it
+    IXmlStringPool* pPool = m_pStringPool;
+    if (pPool)
+    {
+        pPool->AddRef();
+    }
+
+    if (m_bPoolAllocated)
+    {
+        this->~CXmlNode();
+    }
+    else
+    {
+        delete this;
+    }
+
+    if (pPool)
+    {
+        pPool->Release();
+    }
 }
 
 CXmlNode::~CXmlNode()
@@ -277,7 +498,10 @@ CXmlNode::~CXmlNode()
         IXmlNode* node = *it;
         ((CXmlNode*)node)->m_parent = 0;
     }
-    m_pStringPool->Release();
+    if (m_pStringPool)
+    {
+        m_pStringPool->Release();
+    }
 }
 
 CXmlNode::CXmlNode()
@@ -286,33 +510,51 @@ CXmlNode::CXmlNode()
     m_content = "";
     m_parent = 0;
     m_nRefCount = 0;
+    m_bPoolAllocated = false;
     m_pStringPool = 0; // must be changed later.
 }
 
 CXmlNode::CXmlNode(const char* tag)
+    : m_pStringPool(new CXmlDocumentPool)
+    , m_attributes(CXmlPoolAllocator<XmlAttribute>(m_pStringPool))
+{
+    m_content = "";
+    m_parent = 0;
+    m_nRefCount = 0;
+    m_bPoolAllocated = false;
+    m_pStringPool->AddRef();
+    m_tag = m_pStringPool->InternString(tag);
+}
+
+CXmlNode::CXmlNode(IXmlStringPool* pPool)
+    : m_pStringPool(pPool)
+    , m_attributes(CXmlPoolAllocator<XmlAttribute>(pPool))
 {
     m_content = "";
     m_parent = 0;
     m_nRefCount = 0;
-    m_pStringPool = new CXmlStringPool;
+    m_bPoolAllocated = true;
     m_pStringPool->AddRef();
-    m_tag = m_pStringPool->AddString(tag);
+    m_tag = "";
+}
+
+CXmlNode* CXmlNode::Create(IXmlStringPool* pPool, const char* tag)
+{
+    CXmlNode* pNewNode = new(pPool->Allocate(sizeof(CXmlNode)))CXmlNode(pPool);
+    pNewNode->m_tag = pPool->InternString(tag);
+    return pNewNode;
 }
 
 //////////////////////////////////////////////////////////////////////////
 XmlNodeRef CXmlNode::createNode(const char* tag)
 {
-    CXmlNode* pNewNode = new CXmlNode;
-    pNewNode->m_pStringPool = m_pStringPool;
-    m_pStringPool->AddRef();
-    pNewNode->m_tag = m_pStringPool->AddString(tag);
-    return XmlNodeRef(pNewNode);
+    return XmlNodeRef(Create(m_pStringPool, tag));
 }
 
 //////////////////////////////////////////////////////////////////////////
 void CXmlNode::setTag(const char* tag)
 {
-    m_tag = m_pStringPool->AddString(tag);
+    m_tag = m_pStringPool->InternString(tag);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -324,7 +566,8 @@ void CXmlNode::setContent(const char* str)
 //////////////////////////////////////////////////////////////////////////
 bool CXmlNode::isTag(const char* tag) const
 {
-    return g_pXmlStrCmp(tag, m_tag) == 0;
+    // Tags are interned, so a tag taken from another node of the document matches without a string compare
+    return tag == m_tag || g_pXmlStrCmp(tag, m_tag) == 0;
 }
 
 const char* CXmlNode::getAttr(const char* key) const
@@ -382,7 +625,7 @@ void CXmlNode::setAttr(const char* key, const char* value)
     if (it == m_attributes.end())
     {
         XmlAttribute tempAttr;
-        tempAttr.key = m_pStringPool->AddString(key);
+        tempAttr.key = m_pStringPool->InternString(key, &tempAttr.id);
         tempAttr.value = m_pStringPool->AddString(value);
         m_attributes.push_back(tempAttr);
         // Sort attributes.
@@ -845,7 +1088,7 @@ void CXmlNode::copyAttributes(XmlNodeRef fromNode)
         m_attributes.resize(n->m_attributes.size());
         for (int i = 0; i < (int)n->m_attributes.size(); i++)
         {
-            m_attributes[i].key = m_pStringPool->AddString(n->m_attributes[i].key);
+            m_attributes[i].key = m_pStringPool->InternString(n->m_attributes[i].key, &m_attributes[i].id);
             m_attributes[i].value = m_pStringPool->AddString(n->m_attributes[i].value);
         }
     }
@@ -871,10 +1114,7 @@ bool CXmlNode::getAttributeByIndex(int index, const char** key, const char** val
 //////////////////////////////////////////////////////////////////////////
 XmlNodeRef CXmlNode::clone()
 {
-    CXmlNode* node = new CXmlNode;
-    node->m_pStringPool = m_pStringPool;
-    m_pStringPool->AddRef();
-    node->m_tag = m_tag;
+    CXmlNode* node = Create(m_pStringPool, m_tag);
     node->m_content = m_content;
     // Clone attributes.
     CXmlNode* n = (CXmlNode*)(IXmlNode*)node;
@@ -1076,7 +1316,6 @@ bool CXmlNode::saveToFile(const char* fileName)
 ******************************************************************************
 */
 class XmlParserImp
-    : public IXmlStringPool
 {
 public:
     explicit XmlParserImp(bool bRemoveNonessentialSpacesFromContent);
@@ -1085,9 +1324,7 @@ public:
     bool parse(const char* buffer, int bufLen);
     XmlNodeRef endParse(XmlString& errorString);
 
-    // Add new string to pool.
-    char* AddString(const char* str) { return m_stringPool.Append(str, (int)strlen(str)); }
-    //char* AddString( const char *str ) { return (char*)str; }
+    void setContentHandler(IXmlContentHandler* pHandler) { m_pContentHandler = pHandler; }
 
 protected:
     void    onStartElement(const char* tagName, const char** atts);
@@ -1104,6 +1341,14 @@ protected:
     }
     static void characterData(void* userData, const char* s, int len)
     {
+        XmlParserImp* const pImp = (XmlParserImp*)userData;
+        // Text of claimed elements goes to the handler straight from the expat buffer
+        if (pImp->m_pClaimedNode && pImp->m_pClaimedNode == pImp->nodeStack.back())
+        {
+            pImp->m_pContentHandler->OnContent(pImp->m_pClaimedNode, s, len);
+            return;
+        }
+
         char str[500000];
         if (len > sizeof(str) - 1)
         {
@@ -1112,7 +1357,7 @@ protected:
         }
         memcpy(str, s, len);
         str[len] = 0;
-        ((XmlParserImp*)userData)->onRawData(str);
+        pImp->onRawData(str);
     }
 
     // First node will become root node.
@@ -1120,8 +1365,13 @@ protected:
     XmlNodeRef m_root;
 
     XML_Parser m_parser;
-    CSimpleStringPool m_stringPool;
+    // Pool of the document being parsed, handed over to its nodes in endParse
+    CXmlDocumentPool* m_pPool;
     bool m_bRemoveNonessentialSpacesFromContent;
+
+    IXmlContentHandler* m_pContentHandler;
+    // Element whose text currently goes to m_pContentHandler, claimed elements do not nest
+    IXmlNode* m_pClaimedNode;
 };
 
 /**
@@ -1132,10 +1382,7 @@ protected:
 void    XmlParserImp::onStartElement(const char* tagName, const char** atts)
 {
     XmlNodeRef parent;
-    CXmlNode* pCNode = new CXmlNode;
-    pCNode->m_pStringPool = this;
-    pCNode->m_pStringPool->AddRef();
-    pCNode->m_tag = AddString(tagName);
+    CXmlNode* pCNode = CXmlNode::Create(m_pPool, tagName);
 
     XmlNodeRef node = pCNode;
 
@@ -1157,6 +1404,11 @@ void    XmlParserImp::onStartElement(const char* tagName, const char** atts)
     uint64 line = XML_GetCurrentLineNumber((XML_Parser)m_parser);
     node->setLine(line > INT_MAX ? INT_MAX : (int)line);
 
+    if (m_pContentHandler && !m_pClaimedNode && m_pContentHandler->WantsContent(tagName))
+    {
+        m_pClaimedNode = pCNode;
+    }
+
     // Call start element callback.
     int i = 0;
     int numAttrs = 0;
@@ -1172,8 +1424,8 @@ void    XmlParserImp::onStartElement(const char* tagName, const char** atts)
         int nAttr = 0;
         while (atts[i] != 0)
         {
-            pCNode->m_attributes[nAttr].key = AddString(atts[i]);
-            pCNode->m_attributes[nAttr].value = AddString(atts[i + 1]);
+            pCNode->m_attributes[nAttr].key = m_pPool->InternString(atts[i], &pCNode->m_attributes[nAttr].id);
+            pCNode->m_attributes[nAttr].value = m_pPool->AddString(atts[i + 1]);
             nAttr++;
             i += 2;
         }
@@ -1187,6 +1439,11 @@ void    XmlParserImp::onEndElement(const char* tagName)
     assert(!nodeStack.empty());
     if (!nodeStack.empty())
     {
+        if (m_pClaimedNode && m_pClaimedNode == nodeStack.back())
+        {
+            m_pContentHandler->OnContentEnd(m_pClaimedNode);
+            m_pClaimedNode = 0;
+        }
         nodeStack.pop_back();
     }
 }
@@ -1254,6 +1511,9 @@ XmlParserImp::XmlParserImp(bool bRemoveNonessentialSpacesFromContent)
     m_bRemoveNonessentialSpacesFromContent = bRemoveNonessentialSpacesFromContent;
 
     m_root = 0;
+    m_pPool = 0;
+    m_pContentHandler = 0;
+    m_pClaimedNode = 0;
     nodeStack.reserve(100);
 
     XML_Memory_Handling_Suite memHandler;
@@ -1271,13 +1531,26 @@ XmlParserImp::XmlParserImp(bool bRemoveNonessentialSpacesFromContent)
 XmlParserImp::~XmlParserImp()
 {
     XML_ParserFree(m_parser);
+    if (m_pPool)
+    {
+        m_pPool->Release();
+    }
 }
 
 void XmlParserImp::beginParse()
 {
     m_root = 0;
+    m_pClaimedNode = 0;
+    nodeStack.clear();
 
-    m_stringPool.SetBlockSize(1 << 20);
+    // Each document gets a pool of its own so releasing the document frees all of its memory at once
+    if (m_pPool)
+    {
+        m_pPool->Release();
+    }
+    m_pPool = new CXmlDocumentPool;
+    m_pPool->AddRef();
+    m_pPool->SetBlockSize(1 << 20);
 }
 
 bool XmlParserImp::parse(const char* buffer, int bufLen)
@@ -1322,18 +1595,31 @@ XmlNodeRef XmlParserImp::endParse(XmlString& errorString)
 
     XmlNodeRef root = m_root;
     m_root = 0;
+    m_pClaimedNode = 0;
+    nodeStack.clear();
+
+    // From here on the nodes alone keep the pool alive
+    if (m_pPool)
+    {
+        m_pPool->Release();
+        m_pPool = 0;
+    }
     return root;
 }
 
 XmlParser::XmlParser(bool bRemoveNonessentialSpacesFromContent)
 {
     m_pImpl = new XmlParserImp(bRemoveNonessentialSpacesFromContent);
-    m_pImpl->AddRef();
 }
 
 XmlParser::~XmlParser()
 {
-    m_pImpl->Release();
+    delete m_pImpl;
+}
+
+void XmlParser::setContentHandler(IXmlContentHandler* pHandler)
+{
+    m_pImpl->setContentHandler(pHandler);
 }
 
 //! Parse xml file.
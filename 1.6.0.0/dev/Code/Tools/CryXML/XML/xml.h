@@ -19,11 +19,15 @@
 #include <vector>
 #include <set>
 #include <algorithm>
+#include <new>
 
 #include "IXml.h"
 
 struct IXmlBufferSource;
+struct IXmlContentHandler;
 
+// Memory shared by all nodes of one document.  Every node holds a reference, the strings, nodes and attribute arrays
+// allocated from the pool are freed in bulk when the last node of the document is released.
 struct IXmlStringPool
 {
 public:
@@ -38,10 +42,72 @@ public:
         }
     };
     virtual char* AddString(const char* str) = 0;
+
+    //! Returns the pooled copy of a tag or attribute key, equal strings share a single copy.
+    //! pKeyId receives a pointer shared by every key which matches case-insensitively.
+    virtual const char* InternString(const char* str, const char** pKeyId = 0) = 0;
+    //! Returns the key id for str, or 0 if no key matching str was ever interned in this pool.
+    virtual const char* FindKeyId(const char* str) const = 0;
+
+    //! Raw memory which lives as long as the pool, Deallocate only reclaims the most recent allocation.
+    virtual void* Allocate(size_t size) = 0;
+    virtual void Deallocate(void* ptr, size_t size) = 0;
 private:
     int m_refCount;
 };
 
+// STL allocator handing out pool memory, falls back to the heap when constructed without a pool.
+template<class T>
+class CXmlPoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<class U>
+    struct rebind
+    {
+        typedef CXmlPoolAllocator<U> other;
+    };
+
+    CXmlPoolAllocator(IXmlStringPool* pPool = 0)
+        : m_pPool(pPool) {}
+    template<class U>
+    CXmlPoolAllocator(const CXmlPoolAllocator<U>& other)
+        : m_pPool(other.m_pPool) {}
+
+    T* allocate(size_t n, const void* = 0)
+    {
+        return m_pPool ? (T*)m_pPool->Allocate(n * sizeof(T)) : (T*)malloc(n * sizeof(T));
+    }
+    void deallocate(T* p, size_t n)
+    {
+        if (m_pPool)
+        {
+            m_pPool->Deallocate(p, n * sizeof(T));
+        }
+        else
+        {
+            free(p);
+        }
+    }
+    void construct(T* p, const T& val) { new(p) T(val); }
+    void destroy(T* p) { p->~T(); }
+    size_t max_size() const { return size_t(-1) / sizeof(T); }
+
+    template<class U>
+    bool operator==(const CXmlPoolAllocator<U>& other) const { return m_pPool == other.m_pPool; }
+    template<class U>
+    bool operator!=(const CXmlPoolAllocator<U>& other) const { return m_pPool != other.m_pPool; }
+
+    IXmlStringPool* m_pPool;
+};
+
 /************************************************************************/
 /* XmlParser class, Parse xml and return root xml node if success.      */
 /************************************************************************/
@@ -59,6 +125,9 @@ public:
 
     XmlNodeRef parseSource(const IXmlBufferSource* source);
 
+    //! Route the text of elements claimed by the handler to it instead of storing it as node content.
+    void setContentHandler(IXmlContentHandler* pHandler);
+
     const char* getErrorString() const { return m_errorString; }
 
 private:
@@ -77,6 +146,8 @@ struct XmlAttribute
 {
     const char* key;
     const char* value;
+    //! Interned id of the key, equal for keys which compare equal case-insensitively.
+    const char* id;
 
     bool operator<(const XmlAttribute& attr) const { return g_pXmlStrCmp(key, attr.key) < 0; }
     bool operator>(const XmlAttribute& attr) const { return g_pXmlStrCmp(key, attr.key) > 0; }
@@ -85,7 +156,7 @@ struct XmlAttribute
 };
 
 //! Xml node attributes class.
-typedef std::vector<XmlAttribute>   XmlAttributes;
+typedef std::vector<XmlAttribute, CXmlPoolAllocator<XmlAttribute> > XmlAttributes;
 typedef XmlAttributes::iterator XmlAttrIter;
 typedef XmlAttributes::const_iterator XmlAttrConstIter;
 
@@ -106,6 +177,9 @@ public:
     //! Destructor.
     ~CXmlNode();
 
+    //! Creates a node in pool memory, it is destroyed with the pool rather than freed on its own.
+    static CXmlNode* Create(IXmlStringPool* pPool, const char* tag);
+
     virtual void DeleteThis();
 
     //! Create new XML node.
@@ -258,33 +332,31 @@ private:
     void AddToXmlString(XmlString& xml, int level) const;
     XmlString MakeValidXmlString(const XmlString& xml) const;
     bool IsValidXmlString(const char* str) const;
+    // Every key is interned in the pool, so looking the key up once turns the search into pointer comparisons.
     XmlAttrConstIter GetAttrConstIterator(const char* key) const
     {
-        XmlAttribute tempAttr;
-        tempAttr.key = key;
-
-        XmlAttributes::const_iterator it = std::find(m_attributes.begin(), m_attributes.end(), tempAttr);
-        return it;
-
-        /*
-        XmlAttributes::const_iterator it = std::lower_bound( m_attributes.begin(),m_attributes.end(),tempAttr );
-        if (it != m_attributes.end() && _stricmp(it->key,key) == 0)
-        return it;
+        if (m_attributes.empty())
+        {
+            return m_attributes.end();
+        }
+        const char* id = m_pStringPool->FindKeyId(key);
+        if (!id)
+        {
+            return m_attributes.end();
+        }
+        for (XmlAttrConstIter it = m_attributes.begin(); it != m_attributes.end(); ++it)
+        {
+            if (it->id == id)
+            {
+                return it;
+            }
+        }
         return m_attributes.end();
-        */
     }
     XmlAttrIter GetAttrIterator(const char* key)
     {
-        XmlAttribute tempAttr;
-        tempAttr.key = key;
-
-        XmlAttributes::iterator it = std::find(m_attributes.begin(), m_attributes.end(), tempAttr);
-        return it;
-
-        //      XmlAttributes::iterator it = std::lower_bound( m_attributes.begin(),m_attributes.end(),tempAttr );
-        //if (it != m_attributes.end() && _stricmp(it->key,key) == 0)
-        //return it;
-        //return m_attributes.end();
+        XmlAttrConstIter it = GetAttrConstIterator(key);
+        return m_attributes.begin() + (it - m_attributes.begin());
     }
     const char* GetValue(const char* key) const
     {
@@ -297,8 +369,12 @@ private:
     }
 
 private:
+    explicit CXmlNode(IXmlStringPool* pPool);
+
     //! Line in XML file where this node firstly appeared (usefull for debugging).
     int m_line;
+    //! Node lives in m_pStringPool's memory rather than on the heap.
+    bool m_bPoolAllocated;
 
     //! Tag of XML node.
     const char* m_tag;
@@ -28,8 +28,14 @@ bool XMLSerializer::Write(XmlNodeRef root, const char* szFileName)
 }
 
 XmlNodeRef XMLSerializer::Read(const IXmlBufferSource& source, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer)
+{
+    return Read(source, 0, bRemoveNonessentialSpacesFromContent, nErrorBufferSize, szErrorBuffer);
+}
+
+XmlNodeRef XMLSerializer::Read(const IXmlBufferSource& source, IXmlContentHandler* pContentHandler, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer)
 {
     XmlParser parser(bRemoveNonessentialSpacesFromContent);
+    parser.setContentHandler(pContentHandler);
     XmlNodeRef root = parser.parseSource(&source);
     if (nErrorBufferSize > 0 && szErrorBuffer)
     {
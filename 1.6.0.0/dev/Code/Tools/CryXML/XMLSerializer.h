@@ -26,6 +26,7 @@ public:
     virtual bool Write(XmlNodeRef root, const char* szFileName);
 
     virtual XmlNodeRef Read(const IXmlBufferSource& source, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer);
+    virtual XmlNodeRef Read(const IXmlBufferSource& source, IXmlContentHandler* pContentHandler, bool bRemoveNonessentialSpacesFromContent, int nErrorBufferSize, char* szErrorBuffer);
 };
 
 #endif // CRYINCLUDE_CRYXML_XMLSERIALIZER_H
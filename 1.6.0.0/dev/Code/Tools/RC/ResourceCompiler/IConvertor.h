@@ -57,6 +57,10 @@ struct ConvertorInitContext
     const IConfig* config;
     size_t inputFileCount;
     const RcFile* inputFiles;
+    // Threads the current pass may use: value of /threads, or 1 when files are
+    // retried single-threaded after running out of memory. Convertors may use
+    // it to size their own worker pools.
+    int maxThreads;
 };
 
 // Convertor interface, all converters must implement this interface.
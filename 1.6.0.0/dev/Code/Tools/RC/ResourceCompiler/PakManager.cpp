@@ -21,6 +21,235 @@
 #include <ResourceCompiler.h> // for functions like GetSourceRootsReversed
 #include "CryCrc32.h"
 #include "ZipEncryptor.h"
+#include <zlib.h>  // Z_OK
+#include <chrono>
+
+namespace
+{
+    struct ZipCompression
+    {
+        int method;
+        int level;
+    };
+
+    // "store", "deflate[:level]", "lz4" or "lz4hc[:level]"
+    bool ParseZipCompression(const string& text, ZipCompression& compression)
+    {
+        std::vector<string> parts;
+        StringHelpers::Split(StringHelpers::Trim(text), ":", false, parts);
+        if (parts.empty() || parts.size() > 2)
+        {
+            return false;
+        }
+
+        const bool hasLevel = parts.size() == 2;
+        const int level = hasLevel ? atoi(parts[1].c_str()) : -1;
+        if (StringHelpers::EqualsIgnoreCase(parts[0], "store"))
+        {
+            compression.method = ZipFile::METHOD_STORE;
+            compression.level = 0;
+            return !hasLevel;
+        }
+        if (StringHelpers::EqualsIgnoreCase(parts[0], "deflate"))
+        {
+            compression.method = ZipFile::METHOD_DEFLATE;
+            compression.level = hasLevel ? level : 6;
+            return compression.level >= 1 && compression.level <= 9;
+        }
+        if (StringHelpers::EqualsIgnoreCase(parts[0], "lz4"))
+        {
+            compression.method = ZipFile::METHOD_LZ4;
+            compression.level = 0;
+            return !hasLevel;
+        }
+        if (StringHelpers::EqualsIgnoreCase(parts[0], "lz4hc"))
+        {
+            compression.method = ZipFile::METHOD_LZ4;
+            compression.level = hasLevel ? level : 9;
+            return compression.level >= 1 && compression.level <= 16;
+        }
+        return false;
+    }
+
+    const char* GetZipCompressionName(const ZipCompression& compression)
+    {
+        switch (compression.method)
+        {
+        case ZipFile::METHOD_STORE:
+            return "store";
+        case ZipFile::METHOD_LZ4:
+            return compression.level > 0 ? "lz4hc" : "lz4";
+        default:
+            return "deflate";
+        }
+    }
+
+    // Compression picked by file extension, set with "zip_compression_ext=dds=lz4,cgf=lz4hc:9,xml=deflate:9"
+    class ExtensionCompressionPolicy
+        : public ZipDir::ICompressionPolicy
+    {
+    public:
+        bool Parse(const string& text)
+        {
+            std::vector<string> entries;
+            StringHelpers::Split(text, ",", false, entries);
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                const size_t pos = entries[i].find('=');
+                if (pos == string::npos)
+                {
+                    return false;
+                }
+
+                const string ext = StringHelpers::MakeLowerCase(StringHelpers::Trim(entries[i].substr(0, pos)));
+                ZipCompression compression;
+                if (ext.empty() || !ParseZipCompression(entries[i].substr(pos + 1), compression))
+                {
+                    return false;
+                }
+                m_compressions[ext] = compression;
+            }
+            return true;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_compressions.empty();
+        }
+
+        virtual void GetCompression(const char* filenameInZip, int& method, int& level) const
+        {
+            const string ext = StringHelpers::MakeLowerCase(PathHelpers::FindExtension(filenameInZip));
+            const std::map<string, ZipCompression>::const_iterator it = m_compressions.find(ext);
+            if (it != m_compressions.end())
+            {
+                method = it->second.method;
+                level = it->second.level;
+            }
+        }
+
+    private:
+        std::map<string, ZipCompression> m_compressions;
+    };
+
+    // Compresses the files with every method and reports ratio and decode speed per extension. Files are sampled
+    // up to a limit per extension so a benchmark of a full build doesn't take as long as the build itself.
+    void BenchmarkZipCompression(const std::vector<string>& realFilenames, int deflateLevel)
+    {
+        const size_t maxBytesPerExtension = 256 * 1024 * 1024;
+        const ZipCompression compressions[] =
+        {
+            { ZipFile::METHOD_DEFLATE, deflateLevel > 0 ? deflateLevel : 6 },
+            { ZipFile::METHOD_LZ4, 0 },
+            { ZipFile::METHOD_LZ4, 9 },
+        };
+        const size_t compressionCount = sizeof(compressions) / sizeof(compressions[0]);
+
+        struct Stats
+        {
+            size_t fileCount;
+            uint64 uncompressedBytes;
+            uint64 compressedBytes[compressionCount];
+            double decodeSeconds[compressionCount];
+            size_t decodeFailures[compressionCount];
+        };
+        std::map<string, Stats> statsByExtension;
+
+        std::vector<char> uncompressed;
+        std::vector<char> compressed;
+        std::vector<char> decoded;
+
+        for (size_t i = 0; i < realFilenames.size(); ++i)
+        {
+            const string ext = StringHelpers::MakeLowerCase(PathHelpers::FindExtension(realFilenames[i]));
+            Stats& stats = statsByExtension[ext]; // value-initialized, so all zero for a new extension
+            if (stats.uncompressedBytes >= maxBytesPerExtension)
+            {
+                continue;
+            }
+
+            FILE* f = nullptr;
+            if (fopen_s(&f, realFilenames[i].c_str(), "rb") != 0 || !f)
+            {
+                continue;
+            }
+            fseek(f, 0, SEEK_END);
+            const long fileSize = ftell(f);
+            fseek(f, 0, SEEK_SET);
+            uncompressed.resize(fileSize > 0 ? fileSize : 0);
+            const bool bRead = fileSize > 0 && fread(&uncompressed[0], fileSize, 1, f) == 1;
+            fclose(f);
+            if (!bRead)
+            {
+                continue;
+            }
+
+            ++stats.fileCount;
+            stats.uncompressedBytes += fileSize;
+            decoded.resize(fileSize);
+
+            for (size_t c = 0; c < compressionCount; ++c)
+            {
+                const ZipCompression& compression = compressions[c];
+                compressed.resize(ZipDir::ZipRawCompressBound(compression.method, fileSize));
+                unsigned long compressedSize = (unsigned long)compressed.size();
+                const int error = compression.method == ZipFile::METHOD_LZ4
+                    ? ZipDir::ZipRawCompressLZ4(&uncompressed[0], &compressedSize, &compressed[0], fileSize, compression.level)
+                    : ZipDir::ZipRawCompress(&uncompressed[0], &compressedSize, &compressed[0], fileSize, compression.level);
+                if (error != Z_OK)
+                {
+                    compressedSize = fileSize;
+                }
+                stats.compressedBytes[c] += compressedSize;
+                if (error != Z_OK)
+                {
+                    continue;
+                }
+
+                unsigned long decodedSize = (unsigned long)fileSize;
+                const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                const int decodeError = ZipDir::ZipRawUncompressMethod(compression.method, &decoded[0], &decodedSize, &compressed[0], compressedSize);
+                stats.decodeSeconds[c] += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+                // a fast decoder is worthless if it doesn't give back the original data
+                if (decodeError != Z_OK || decodedSize != (unsigned long)fileSize || memcmp(&decoded[0], &uncompressed[0], fileSize) != 0)
+                {
+                    ++stats.decodeFailures[c];
+                    RCLogError("Zip compression benchmark: %s:%d does not decode back to the original data of %s",
+                        GetZipCompressionName(compression), compression.level, realFilenames[i].c_str());
+                }
+            }
+        }
+
+        RCLog("Zip compression benchmark (ratio = compressed / uncompressed, decode speed in MB/s of uncompressed data):");
+        for (std::map<string, Stats>::const_iterator it = statsByExtension.begin(); it != statsByExtension.end(); ++it)
+        {
+            const Stats& stats = it->second;
+            if (stats.uncompressedBytes == 0)
+            {
+                continue;
+            }
+
+            string line;
+            line.Format("  %-10s %6u files %10.2f MB", it->first.empty() ? "<none>" : it->first.c_str(), (unsigned)stats.fileCount, stats.uncompressedBytes / (1024.0 * 1024.0));
+            for (size_t c = 0; c < compressionCount; ++c)
+            {
+                const double ratio = double(stats.compressedBytes[c]) / double(stats.uncompressedBytes);
+                const double speed = stats.decodeSeconds[c] > 0.0 ? stats.uncompressedBytes / (1024.0 * 1024.0) / stats.decodeSeconds[c] : 0.0;
+                string column;
+                column.Format(" | %s:%d %.3f %8.1f MB/s", GetZipCompressionName(compressions[c]), compressions[c].level, ratio, speed);
+                if (stats.decodeFailures[c])
+                {
+                    string failures;
+                    failures.Format(" (%u FAILED)", (unsigned)stats.decodeFailures[c]);
+                    column += failures;
+                }
+                line += column;
+            }
+            RCLog("%s", line.c_str());
+        }
+    }
+}
 
 //////////////////////////////////////////////////////////////////////////
 PakManager::PakManager(IProgress* pProgress)
@@ -40,6 +269,10 @@ void PakManager::RegisterKeys(IResourceCompiler* pRC)
     pRC->RegisterKey("zip_encrypt_key", "Specifies a 128-bit key in hexadecimal format: 32-character string. Low endian format.");
     pRC->RegisterKey("zip_encrypt_content", "Encrypts files inside of zip. Works only when zip_encrypt enabled. Disabled by default.");
     pRC->RegisterKey("zip_compression", "Specify compression level for zipped files. [0-9] 0=no compression, 9=max compression. Default is 6.");
+    pRC->RegisterKey("zip_compression_ext", "Per extension compression of zipped files, overriding zip_compression. Comma separated list of ext=method\n"
+        "with method store, deflate[:level], lz4 or lz4hc[:level], e.g. dds=lz4,cgf=lz4hc:9,xml=deflate:9.\n"
+        "Ignored for zip_encrypt_content, encrypted files are always deflated.");
+    pRC->RegisterKey("zip_benchmark", "Logs compression ratio and decode speed of deflate, lz4 and lz4hc per file extension of the files being zipped.");
     pRC->RegisterKey("zip_sort", "Define sorting type when adding files to the pak, currently supported:\n"
         "nosort, size, streaming, suffix, alphabetically. Alphabetically is default.");
     pRC->RegisterKey("zip_split", "Define split type for distributing files into different paks automatically, currently supported:\n"
@@ -319,6 +552,18 @@ PakManager::ECallResult PakManager::CreatePakFile(
 
     const int zipCompressionLevel = config->GetAsInt("zip_compression", 6, 6);
 
+    ExtensionCompressionPolicy compressionPolicy;
+    {
+        const string compressionExt = config->GetAsString("zip_compression_ext", "", "");
+        if (!compressionExt.empty() && !compressionPolicy.Parse(compressionExt))
+        {
+            RCLogError("Invalid zip_compression_ext argument: '%s'. Creating of pak failed.", compressionExt.c_str());
+            return eCallResult_BadArgs;
+        }
+    }
+
+    const bool bBenchmark = config->GetAsBool("zip_benchmark", false, true);
+
     ECallResult bResult = eCallResult_Succeeded;
     for (std::map<string, std::vector<PakHelpers::PakEntry> >::iterator it = fileMap.begin(); it != fileMap.end(); ++it)
     {
@@ -423,6 +668,11 @@ PakManager::ECallResult PakManager::CreatePakFile(
             realFilenames.push_back(sRealFilename);
         }
 
+        if (bBenchmark)
+        {
+            BenchmarkZipCompression(realFilenames, zipCompressionLevel);
+        }
+
         std::vector<const char*> realFilenamePtrs;
         std::vector<const char*> filenameInZipPtrs;
         std::vector<const char*> filenameInZipPtrsForDelete;
@@ -575,7 +825,8 @@ PakManager::ECallResult PakManager::CreatePakFile(
                 const int threadCount = GetMaxThreads() == 1 ? 0 : GetMaxThreads();
                 pPakFile->zip->UpdateMultipleFiles(&realFilenamePtrs[0], &filenameInZipPtrs[0], filenameCount,
                     zipCompressionLevel, zipEncrypt && zipEncryptContent, nMaxZipSize, nMinSrcSize, nMaxSrcSize,
-                    threadCount, &errorReporter, bSplitOnSizeOverflow ? &sizeSplitter : nullptr);
+                    threadCount, &errorReporter, bSplitOnSizeOverflow ? &sizeSplitter : nullptr,
+                    compressionPolicy.IsEmpty() ? nullptr : &compressionPolicy);
 
                 // divide files in case it has overflown the maximum allowed file-size
                 if (bSplitOnSizeOverflow)
@@ -362,6 +362,9 @@ static void CompileFilesMultiThreaded(
 
     bool bLogMemory = false;
 
+    // Threads a convertor may use on top of the compiler threads, see ConvertorInitContext::maxThreads
+    int maxThreads = pRC->GetMaxThreads();
+
     while (!a_files.m_inputFiles.empty())
     {
         // Never create more threads than needed
@@ -379,6 +382,7 @@ static void CompileFilesMultiThreaded(
             initContext.config = &pRC->GetMultiplatformConfig().getConfig();
             initContext.inputFiles = a_files.m_inputFiles.empty() ? 0 : &a_files.m_inputFiles[0];
             initContext.inputFileCount = a_files.m_inputFiles.size();
+            initContext.maxThreads = maxThreads;
 
             convertor->Init(initContext);
         }
@@ -461,6 +465,7 @@ static void CompileFilesMultiThreaded(
                 RCLogWarning("Switching to single-thread mode and trying to convert the files again");
                 a_files.m_inputFiles.insert(a_files.m_inputFiles.end(), a_files.m_outOfMemoryFiles.begin(), a_files.m_outOfMemoryFiles.end());
                 threadCount = 1;
+                maxThreads = 1;
                 bLogMemory = true;
             }
             else
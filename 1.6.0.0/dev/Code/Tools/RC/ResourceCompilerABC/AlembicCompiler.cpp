@@ -26,6 +26,8 @@
 #include "../../CryEngine/Cry3DEngine/MeshCompiler/TangentSpaceCalculation.h"
 #include "StringUtils.h"
 
+#include <psapi.h>       // GetProcessMemoryInfo()
+
 namespace
 {
     QuatTNS FromAlembicMatrix(const Alembic::AbcGeom::M44d& abcMatrix)
@@ -320,6 +322,104 @@ namespace
         AlembicCompiler::FrameJobGroupData* m_pJobGroupData;
         GeomCache::Mesh& m_mesh;
     };
+
+    // Digests of the vertex data of one mesh sample. Two samples with equal digests hold the same data.
+    struct AlembicSampleDigest
+    {
+        Alembic::AbcGeom::ArraySampleKey m_positionDigest;
+        Alembic::AbcGeom::ArraySampleKey m_normalsDigest;
+        Alembic::AbcGeom::ArraySampleKey m_normalIndicesDigest;
+        Alembic::AbcGeom::ArraySampleKey m_texcoordDigest;
+        Alembic::AbcGeom::ArraySampleKey m_texcoordIndicesDigest;
+        Alembic::AbcGeom::ArraySampleKey m_colorsDigest;
+        Alembic::AbcGeom::ArraySampleKey m_colorIndicesDigest;
+
+        bool operator==(const AlembicSampleDigest& digest) const
+        {
+            return m_positionDigest == digest.m_positionDigest
+                   && m_normalsDigest == digest.m_normalsDigest && m_normalIndicesDigest == digest.m_normalIndicesDigest
+                   && m_texcoordDigest == digest.m_texcoordDigest && m_texcoordIndicesDigest == digest.m_texcoordIndicesDigest
+                   && m_colorsDigest == digest.m_colorsDigest && m_colorIndicesDigest == digest.m_colorIndicesDigest;
+        }
+    };
+
+    struct AlembicSampleDigestHash
+    {
+        size_t operator()(const AlembicSampleDigest& digest) const
+        {
+            // Positions change whenever anything else does in practice, see std::hash<AlembicMeshDigest>
+            return Alembic::AbcGeom::StdHash(digest.m_positionDigest);
+        }
+    };
+
+    template<class ParamType>
+    bool GetGeomParamDigests(const ParamType& param, const Alembic::Abc::ISampleSelector& selector,
+        Alembic::AbcGeom::ArraySampleKey& valuesDigest, Alembic::AbcGeom::ArraySampleKey& indicesDigest)
+    {
+        if (!param.getValueProperty().getKey(valuesDigest, selector))
+        {
+            return false;
+        }
+
+        return !param.isIndexed() || param.getIndexProperty().getKey(indicesDigest, selector);
+    }
+
+    // Color params can be of several types, so they are looked up as plain properties: either an array of
+    // values or, if indexed, a compound of values and indices.
+    bool GetColorParamDigests(Alembic::AbcGeom::IPolyMeshSchema& meshSchema, const std::string& colorParamName, const Alembic::Abc::ISampleSelector& selector,
+        Alembic::AbcGeom::ArraySampleKey& valuesDigest, Alembic::AbcGeom::ArraySampleKey& indicesDigest)
+    {
+        Alembic::Abc::ICompoundProperty arbGeomParams = meshSchema.getArbGeomParams();
+        const Alembic::Abc::PropertyHeader* pPropertyHeader = arbGeomParams ? arbGeomParams.getPropertyHeader(colorParamName) : nullptr;
+        if (!pPropertyHeader)
+        {
+            return false;
+        }
+
+        if (pPropertyHeader->isArray())
+        {
+            Alembic::Abc::IArrayProperty values(arbGeomParams, colorParamName);
+            return values.getKey(valuesDigest, selector);
+        }
+
+        if (pPropertyHeader->isCompound())
+        {
+            Alembic::Abc::ICompoundProperty param(arbGeomParams, colorParamName);
+            Alembic::Abc::IArrayProperty values(param, ".vals");
+            Alembic::Abc::IArrayProperty indices(param, ".indices");
+            return values.getKey(valuesDigest, selector) && indices.getKey(indicesDigest, selector);
+        }
+
+        return false;
+    }
+
+    // Reads the digests Alembic stores with each sample. This doesn't read or decompress the sample data.
+    bool GetSampleDigest(Alembic::AbcGeom::IPolyMeshSchema& meshSchema, const GeomCache::Mesh& mesh, const Alembic::Abc::index_t sampleIndex, AlembicSampleDigest& digest)
+    {
+        const Alembic::Abc::ISampleSelector selector(sampleIndex);
+
+        if (!meshSchema.getPositionsProperty().getKey(digest.m_positionDigest, selector))
+        {
+            return false;
+        }
+
+        if (mesh.m_bHasNormals && !GetGeomParamDigests(meshSchema.getNormalsParam(), selector, digest.m_normalsDigest, digest.m_normalIndicesDigest))
+        {
+            return false;
+        }
+
+        if (mesh.m_bHasTexcoords && !GetGeomParamDigests(meshSchema.getUVsParam(), selector, digest.m_texcoordDigest, digest.m_texcoordIndicesDigest))
+        {
+            return false;
+        }
+
+        if (mesh.m_bHasColors && !GetColorParamDigests(meshSchema, mesh.m_colorParamName, selector, digest.m_colorsDigest, digest.m_colorIndicesDigest))
+        {
+            return false;
+        }
+
+        return true;
+    }
 }
 
 AlembicMeshDigest::AlembicMeshDigest(Alembic::AbcGeom::IPolyMeshSchema& meshSchema)
@@ -446,6 +546,9 @@ AlembicCompiler::AlembicCompiler(ICryXML* pXMLParser)
     , m_nextFrameToWrite(0)
     , m_numJobsFinished(0)
     , m_b32BitIndices(false)
+    , m_memoryBudget(0)
+    , m_numFrameJobGroups(0)
+    , m_maxEncoderFrames(0)
 {
     m_rootNode.m_type = GeomCacheFile::eNodeType_Transform;
     m_rootNode.m_transformType = GeomCacheFile::eTransformType_Constant;
@@ -566,7 +669,16 @@ bool AlembicCompiler::Process()
     geomCacheWriter.WriteStaticData(normalizedFrameTimes, m_meshes, m_rootNode);
 
     // Export animated data (frames)
+    ComputeFrameWindow(threadPool, geomCacheEncoder);
+    if (m_maxEncoderFrames > 0)
+    {
+        geomCacheEncoder.SetMaxBufferedFrames(m_maxEncoderFrames);
+        RCLog("  Frame window: %u frames compiling, up to %u frames encoding (%.1f MiB per frame)",
+            m_numFrameJobGroups, geomCacheEncoder.GetMaxBufferedFrames(), static_cast<double>(EstimateFrameMemory()) / (1024.0 * 1024.0));
+    }
     geomCacheEncoder.Init();
+
+    const DWORD animationStartTime = GetTickCount();
     if (!CompileAnimationData(archive, geomCacheEncoder, threadPool))
     {
         Cleanup();
@@ -576,6 +688,7 @@ bool AlembicCompiler::Process()
     geomCacheEncoder.Flush();
     GeomCacheWriterStats stats = geomCacheWriter.FinishWriting();
     threadPool.WaitAllJobs();
+    const DWORD animationDurationMS = GetTickCount() - animationStartTime;
 
     const Alembic::Abc::chrono_t sequenceLength = m_frameTimes.back() - m_frameTimes.front();
     const double headerDataMegaBytes = static_cast<double>(stats.m_headerDataSize) / (1024.0 * 1024.0);
@@ -598,6 +711,18 @@ bool AlembicCompiler::Process()
         RCLog("  Average data rate: %.2f MiB/s", (double)animationDataMegaBytes / sequenceLength);
     }
 
+    const double animationSeconds = std::max(static_cast<double>(animationDurationMS) / 1000.0, 0.001);
+    RCLog("  Compiled %Iu frames in %.1f s (%.1f frames/s)", numFrames, animationSeconds, static_cast<double>(numFrames) / animationSeconds);
+
+    // The working set is per process, so with several files compiled in parallel this is the peak of all of them
+    PROCESS_MEMORY_COUNTERS memoryCounters;
+    ZeroMemory(&memoryCounters, sizeof(memoryCounters));
+    memoryCounters.cb = sizeof(memoryCounters);
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+    {
+        RCLog("  Peak working set: %.1f MiB", static_cast<double>(memoryCounters.PeakWorkingSetSize) / (1024.0 * 1024.0));
+    }
+
     Cleanup();
 
     if (!UpToDateFileHelpers::SetMatchingFileTime(GetOutputPath(), sourcePath))
@@ -1226,6 +1351,7 @@ XmlNodeRef AlembicCompiler::ReadConfig(const string& configPath, IXMLSerializer*
     string playbackFromMemory = "0";
     string positionPrecision = "1";
     float uvMax = RC_ABC_AUTOMATIC_UVMAX_DETECTION_VALUE;
+    string memoryBudget = "0";
 
     if (config)
     {
@@ -1267,6 +1393,11 @@ XmlNodeRef AlembicCompiler::ReadConfig(const string& configPath, IXMLSerializer*
         {
             uvMax = static_cast<float>(atof(config->getAttr("UVmax")));
         }
+
+        if (config->haveAttr("MemoryBudget"))
+        {
+            memoryBudget = config->getAttr("MemoryBudget");
+        }
     }
     else
     {
@@ -1298,6 +1429,7 @@ XmlNodeRef AlembicCompiler::ReadConfig(const string& configPath, IXMLSerializer*
     playbackFromMemory = m_CC.config->GetAsString("playbackFromMemory", playbackFromMemory, playbackFromMemory);
     positionPrecision = m_CC.config->GetAsString("positionPrecision", positionPrecision, positionPrecision);
     uvMax = m_CC.config->GetAsFloat("uvMax", uvMax, uvMax);
+    memoryBudget = m_CC.config->GetAsString("memoryBudget", memoryBudget, memoryBudget);
 
     // Check if we need to convert the axis
     m_bConvertYUpToZUp = upAxis.compareNoCase("Y") == 0;
@@ -1363,6 +1495,14 @@ XmlNodeRef AlembicCompiler::ReadConfig(const string& configPath, IXMLSerializer*
         RCLog("  Using UVmax %g", m_uvMax);
     }
 
+    // Memory budget for frames in flight in MiB
+    const int memoryBudgetMegaBytes = atoi(memoryBudget.c_str());
+    m_memoryBudget = (memoryBudgetMegaBytes > 0) ? static_cast<uint64>(memoryBudgetMegaBytes) * 1024 * 1024 : 0;
+    if (m_memoryBudget > 0)
+    {
+        RCLog("  Streaming frames within a %d MiB memory budget", memoryBudgetMegaBytes);
+    }
+
     config->setAttr("UpAxis", upAxis);
     config->setAttr("MeshPrediction", meshPrediction);
     config->setAttr("UseBFrames", useBFrames);
@@ -1371,6 +1511,7 @@ XmlNodeRef AlembicCompiler::ReadConfig(const string& configPath, IXMLSerializer*
     config->setAttr("PlaybackFromMemory", playbackFromMemory);
     config->setAttr("PositionPrecision", positionPrecision);
     config->setAttr("UVmax", uvMax);
+    config->setAttr("MemoryBudget", memoryBudget);
 
     return config;
 }
@@ -1464,12 +1605,77 @@ void AlembicCompiler::PrintNodeTreeRec(GeomCache::Node& node, string padding)
     }
 }
 
+uint64 AlembicCompiler::EstimateFrameMemory() const
+{
+    uint64 frameMemory = 0;
+
+    for (size_t meshIndex = 0; meshIndex < m_meshes.size(); ++meshIndex)
+    {
+        const GeomCache::Mesh& mesh = *m_meshes[meshIndex];
+        if (mesh.m_animatedStreams == 0)
+        {
+            continue;
+        }
+
+        // The first frame was compiled with the static data, its size is a good guess for all others
+        const GeomCache::MeshData& meshData = mesh.m_staticMeshData;
+        uint64 meshFrameMemory = meshData.m_positions.size() * sizeof(GeomCacheFile::Position)
+            + meshData.m_texcoords.size() * sizeof(GeomCacheFile::Texcoords)
+            + meshData.m_qTangents.size() * sizeof(GeomCacheFile::QTangent)
+            + (meshData.m_reds.size() + meshData.m_greens.size() + meshData.m_blues.size() + meshData.m_alphas.size()) * sizeof(GeomCacheFile::Color);
+
+        if (mesh.m_animatedStreams & GeomCacheFile::eStream_Indices)
+        {
+            for (auto iter = mesh.m_indicesMap.begin(); iter != mesh.m_indicesMap.end(); ++iter)
+            {
+                meshFrameMemory += iter->second.size() * sizeof(uint32);
+            }
+        }
+
+        frameMemory += meshFrameMemory;
+    }
+
+    // A frame is held raw until it is encoded and then once more encoded until it is written
+    return frameMemory * 2;
+}
+
+void AlembicCompiler::ComputeFrameWindow(ThreadUtils::StealingThreadPool& threadPool, const GeomCacheEncoder& geomCacheEncoder)
+{
+    const uint maxFrameJobGroups = threadPool.GetNumThreads() * 2;
+    const uint minEncoderFrames = geomCacheEncoder.GetMinBufferedFrames();
+
+    // Without a budget frames are compiled as far ahead as the encoder allows by default
+    m_numFrameJobGroups = maxFrameJobGroups;
+    m_maxEncoderFrames = 0;
+
+    const uint64 frameMemory = EstimateFrameMemory();
+    if (m_memoryBudget == 0 || frameMemory == 0)
+    {
+        return;
+    }
+
+    // The encoder has to hold a number of frames to encode b frames, the job groups share the rest of the budget
+    const uint64 budgetFrames = m_memoryBudget / frameMemory;
+    if (budgetFrames < minEncoderFrames + 1)
+    {
+        RCLogWarning("  Memory budget holds %I64u frames of %.1f MiB, but at least %u are needed. Budget will be exceeded.",
+            budgetFrames, static_cast<double>(frameMemory) / (1024.0 * 1024.0), minEncoderFrames + 1);
+        m_numFrameJobGroups = 1;
+        m_maxEncoderFrames = minEncoderFrames;
+    }
+    else
+    {
+        m_numFrameJobGroups = static_cast<uint>(std::min<uint64>(budgetFrames - minEncoderFrames, maxFrameJobGroups));
+        m_maxEncoderFrames = static_cast<uint>(std::min<uint64>(budgetFrames - m_numFrameJobGroups, std::numeric_limits<uint>::max()));
+    }
+}
+
 bool AlembicCompiler::CompileAnimationData(Alembic::Abc::IArchive& archive, GeomCacheEncoder& geomCacheEncoder, ThreadUtils::StealingThreadPool& threadPool)
 {
     RCLog("Compiling animation data...");
 
     // Set up parallel frame processing
-    const uint numJobGroups = threadPool.GetNumThreads() * 2;
+    const uint numJobGroups = m_numFrameJobGroups;
     m_jobGroupData.resize(numJobGroups);
 
     for (uint i = 0; i < numJobGroups; ++i)
@@ -1892,11 +2098,26 @@ bool AlembicCompiler::ComputeVertexHashes(std::vector<uint64>& abcVertexHashes,
     // Reset mesh AABB
     mesh.m_aabb.Reset();
 
+    // Frames often share samples, either because the mesh is sampled less often than the scene or because parts of
+    // the animation hold still. Hashing the same data again only changes the hash values, not which vertices share a
+    // hash, so each distinct sample is read once. Samples are told apart by the digests Alembic stores with them.
+    std::unordered_set<AlembicSampleDigest, AlembicSampleDigestHash> hashedSamples;
+    const bool bSkipHashedSamples = (lastFrame - firstFrame) > 1;
+
     for (size_t currentFrame = firstFrame; currentFrame < lastFrame; ++currentFrame)
     {
         Alembic::Abc::chrono_t frameTime = m_frameTimes[currentFrame];
         auto index = meshTimeSampling.getNearIndex(frameTime, numMeshSamples);
 
+        if (bSkipHashedSamples)
+        {
+            AlembicSampleDigest sampleDigest;
+            if (GetSampleDigest(meshSchema, mesh, index.first, sampleDigest) && !hashedSamples.insert(sampleDigest).second)
+            {
+                continue;
+            }
+        }
+
         Alembic::AbcGeom::IPolyMeshSchema::Sample frameSample = meshSchema.getValue(index.first);
 
         // Just check to make sure. This should not happen.
@@ -210,6 +210,12 @@ private:
     // Prints the node tree
     void PrintNodeTreeRec(GeomCache::Node& node, string padding);
 
+    // Estimates the memory one frame of animated data takes while it is compiled and encoded
+    uint64 EstimateFrameMemory() const;
+
+    // Sizes the window of frames that are in flight between compilation and encoding to fit the memory budget
+    void ComputeFrameWindow(ThreadUtils::StealingThreadPool& threadPool, const GeomCacheEncoder& geomCacheEncoder);
+
     // Compile stream of frames and  send them to the cache writer
     bool CompileAnimationData(Alembic::Abc::IArchive& archive, GeomCacheEncoder& geomCacheEncoder, ThreadUtils::StealingThreadPool& threadPool);
 
@@ -281,6 +287,7 @@ private:
     GeomCacheFile::EBlockCompressionFormat m_blockCompressionFormat;
     double m_positionPrecision;
     float m_uvMax;
+    uint64 m_memoryBudget; // bytes, 0 for no limit
 
     // Time
     std::vector<Alembic::Abc::TimeSampling> m_timeSamplings;
@@ -303,6 +310,10 @@ private:
     // For detecting cloned meshes
     std::unordered_map<AlembicMeshDigest, std::shared_ptr<GeomCache::Mesh> > m_digestToMeshMap;
 
+    // Size of the frame window
+    uint m_numFrameJobGroups;
+    uint m_maxEncoderFrames;
+
     // The next job group hat will be used
     uint m_nextJobGroupIndex;
 
@@ -20,7 +20,7 @@
 
 namespace
 {
-    // Maximum number of frames buffered before the encoder waits
+    // Default maximum number of frames buffered before the encoder waits
     const uint g_kMaxBufferedFrames = 60;
 
     // Helper to add blob data to std::vector<uint8>
@@ -63,6 +63,7 @@ GeomCacheEncoder::GeomCacheEncoder(GeomCacheWriter& geomCacheWriter, GeomCache::
     , m_jobGroupDone(true)
     , m_bUseBFrames(bUseBFrames)
     , m_indexFrameDistance(indexFrameDistance)
+    , m_maxBufferedFrames(g_kMaxBufferedFrames)
 {
     STATIC_ASSERT(g_kMaxBufferedFrames >= GeomCacheFile::kMaxIFrameDistance,
         "g_kMaxBufferedFrames needs to be >= GeomCacheFile::kMaxIFrameDistance");
@@ -80,6 +81,18 @@ void GeomCacheEncoder::Init()
     CountNodesRec(m_rootNode);
 }
 
+void GeomCacheEncoder::SetMaxBufferedFrames(const uint maxBufferedFrames)
+{
+    m_maxBufferedFrames = std::min(std::max(maxBufferedFrames, GetMinBufferedFrames()), g_kMaxBufferedFrames);
+}
+
+uint GeomCacheEncoder::GetMinBufferedFrames() const
+{
+    // B frames are encoded when the next index frame arrives, so all frames in between must stay buffered.
+    // Without B frames every frame still needs its predecessor.
+    return m_bUseBFrames ? m_indexFrameDistance : 1;
+}
+
 void GeomCacheEncoder::CountNodesRec(GeomCache::Node& currentNode)
 {
     ++m_numNodes;
@@ -107,7 +120,7 @@ void GeomCacheEncoder::AddFrame(const Alembic::Abc::chrono_t frameTime, const AA
 
     // Check if there is enough space left in frames deque, otherwise wait until there is again
     ThreadUtils::AutoLock lockFrames(m_framesCS);
-    while (m_frames.size() > g_kMaxBufferedFrames)
+    while (m_frames.size() > m_maxBufferedFrames)
     {
         m_frameRemovedCV.Sleep(m_framesCS);
     }
@@ -70,6 +70,12 @@ public:
         const bool bUseBFrames, const uint indexFrameDistance);
 
     void Init();
+
+    // Lowers the number of raw frames the encoder keeps before AddFrame waits. Clamped to the
+    // minimum the frame type pattern needs, as index frames need all frames up to the next index frame.
+    void SetMaxBufferedFrames(const uint maxBufferedFrames);
+    uint GetMinBufferedFrames() const;
+    uint GetMaxBufferedFrames() const { return m_maxBufferedFrames; }
     void AddFrame(const Alembic::Abc::chrono_t frameTime, const AABB& aabb, const bool bIsLastFrame);
     void Flush();
 
@@ -103,6 +109,9 @@ private:
     bool m_bUseBFrames;
     uint m_indexFrameDistance;
 
+    // Maximum number of frames buffered before the encoder waits
+    uint m_maxBufferedFrames;
+
     // Number of animated nodes to compile
     unsigned int m_numNodes;
 
@@ -21,6 +21,7 @@
 
 #include "IRCLog.h"                         // IRCLog
 #include "MathHelpers.h"                                        // MathHelpers
+#include "StealingThreadPool.h"             // ThreadUtils::StealingThreadPool
 
 #include "CryTextureSquisher/CryTextureSquisher.h"
 
@@ -62,6 +63,92 @@ namespace
 
         pUserData->m_dstOffset = size * (stride * blocks);
     }
+
+    struct CrySquisherTile
+    {
+        CryTextureSquisher::CompressorParameters m_compress;
+        CrySquisherCallbackUserData m_userData;
+    };
+
+    void CrySquisherCompressTile(CrySquisherTile* pTile)
+    {
+        CryTextureSquisher::Compress(pTile->m_compress);
+    }
+
+    // Tiles of one mip shared by at most threadBudget jobs, each job takes the next tile until none is left
+    struct CrySquisherTileQueue
+    {
+        std::vector<CrySquisherTile>* m_pTiles;
+        volatile LONG m_nextTile;
+    };
+
+    void CrySquisherCompressTiles(CrySquisherTileQueue* pQueue)
+    {
+        const LONG tileCount = (LONG)pQueue->m_pTiles->size();
+        for (LONG tile = InterlockedIncrement(&pQueue->m_nextTile) - 1; tile < tileCount; tile = InterlockedIncrement(&pQueue->m_nextTile) - 1)
+        {
+            CrySquisherCompressTile(&(*pQueue->m_pTiles)[tile]);
+        }
+    }
+
+    // Compresses a mip as independent tiles of whole 4x4-block rows, concurrently if a thread pool is given.
+    // Returns the number of bytes written to pDstMem.
+    uint32 CrySquisherCompressTiled(const CryTextureSquisher::CompressorParameters& compress, ImageObject* pImageObject, char* pDstMem, uint32 dwDstPitch, ThreadUtils::StealingThreadPool* pThreadPool, int threadBudget)
+    {
+        const uint32 blockRows = (compress.height + 3) / 4;
+
+        // a few tiles per thread keep the pool balanced when some blocks take the slow cluster-fit path
+        const uint32 tileBlockRows = (pThreadPool && (threadBudget > 1)) ? std::max<uint32>(1, blockRows / (threadBudget * 4)) : blockRows;
+        const uint32 tileCount = (blockRows + tileBlockRows - 1) / tileBlockRows;
+
+        std::vector<CrySquisherTile> tiles(tileCount);
+        for (uint32 tile = 0; tile < tileCount; ++tile)
+        {
+            const uint32 y = tile * tileBlockRows * 4;
+
+            CrySquisherTile& t = tiles[tile];
+            t.m_userData.m_pImageObject = pImageObject;
+            t.m_userData.m_dstOffset = 0;
+            t.m_userData.m_dstMem = pDstMem + tile * tileBlockRows * dwDstPitch;
+
+            t.m_compress = compress;
+            t.m_compress.srcBuffer = (const char*)compress.srcBuffer + y * compress.pitch;
+            t.m_compress.height = std::min<uint32>(tileBlockRows * 4, compress.height - y);
+            t.m_compress.userPtr = &t.m_userData;
+            t.m_compress.userOutputFunction = CrySquisherOutputCallback;
+        }
+
+        if (tileCount > 1)
+        {
+            // the pool is shared by all images compiled concurrently, so no more than
+            // threadBudget jobs are submitted for this mip and they pull the tiles themselves
+            CrySquisherTileQueue queue;
+            queue.m_pTiles = &tiles;
+            queue.m_nextTile = 0;
+
+            const uint32 jobCount = std::min<uint32>(threadBudget, tileCount);
+
+            ThreadUtils::JobGroupWaiter waiter;
+            ThreadUtils::JobGroup* pJobGroup = pThreadPool->CreateJobGroup(&ThreadUtils::JobGroupWaiter::Signal, &waiter);
+            for (uint32 job = 0; job < jobCount; ++job)
+            {
+                pJobGroup->Add(&CrySquisherCompressTiles, &queue);
+            }
+            pJobGroup->Submit();
+            waiter.Wait();
+        }
+        else
+        {
+            CrySquisherCompressTile(&tiles[0]);
+        }
+
+        uint32 dstOffset = 0;
+        for (uint32 tile = 0; tile < tileCount; ++tile)
+        {
+            dstOffset += tiles[tile].m_userData.m_dstOffset;
+        }
+        return dstOffset;
+    }
 } // namespace
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -160,11 +247,6 @@ ImageToProcess::EResult ImageToProcess::ConvertFormatWithCTSquisher(const CImage
                 pRet->GetImagePointer(dwMip, pDstMem, dwDstPitch);
 
                 {
-                    CrySquisherCallbackUserData userData;
-                    userData.m_pImageObject = pRet.get();
-                    userData.m_dstOffset = 0;
-                    userData.m_dstMem = pDstMem;
-
                     CryTextureSquisher::CompressorParameters compress;
 
                     compress.srcBuffer = pSrcMem;
@@ -208,6 +290,7 @@ ImageToProcess::EResult ImageToProcess::ConvertFormatWithCTSquisher(const CImage
                         compress.weights[2] = 0.125f;
                         break;
                     }
+                    compress.weights[3] = 1.0f;
 
                     if (pProps->GetNormalizeRange())
                     {
@@ -237,9 +320,6 @@ ImageToProcess::EResult ImageToProcess::ConvertFormatWithCTSquisher(const CImage
                           (quality == eQuality_Slow    ? CryTextureSquisher::eQualityProfile_High :
                            CryTextureSquisher::eQualityProfile_Medium)));
 
-                    compress.userPtr = &userData;
-                    compress.userOutputFunction = CrySquisherOutputCallback;
-
                     switch (fmtDst)
                     {
                     case ePixelFormat_DXT1:
@@ -299,9 +379,9 @@ ImageToProcess::EResult ImageToProcess::ConvertFormatWithCTSquisher(const CImage
                         return eResult_Failed;
                     }
 
-                    CryTextureSquisher::Compress(compress);
+                    const uint32 dstOffset = CrySquisherCompressTiled(compress, pRet.get(), pDstMem, dwDstPitch, pProps->GetFilterThreadPool(), pProps->GetFilterThreadBudget());
 
-                    assert(userData.m_dstOffset == dwDstPitch * ((dwLocalHeight + 3) / 4));
+                    assert(dstOffset == dwDstPitch * ((dwLocalHeight + 3) / 4));
                 }
             } // for: all mips
         }
@@ -558,6 +638,7 @@ bool ConvertToDXTFormatARGB(const ImageObject& src, ImageObject& dst)
     compress.weights[0] = 0.2126f;
     compress.weights[1] = 0.7152f;
     compress.weights[2] = 0.0722f;
+    compress.weights[3] = 1.0f;
     compress.perceptual = false;
     compress.quality = CryTextureSquisher::eQualityProfile_High;
     compress.userPtr = &userData;
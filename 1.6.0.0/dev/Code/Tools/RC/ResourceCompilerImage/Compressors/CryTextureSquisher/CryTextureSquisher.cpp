@@ -19,8 +19,6 @@
 #include "ColorBlockRGBA4x4f.h"
 #include "CryTextureSquisher.h"
 
-static ThreadUtils::CriticalSection s_squishLock;
-
 // preserve the ability to link with the old squish (which is in NvTT)
 #define squish  squishccr
 #define SQUISH_USE_CPP
@@ -312,6 +310,75 @@ static struct ParameterMatrix
     },
 };
 
+/* -------------------------------------------------------------------------------------------------------------
+ * perceptual weights
+ *
+ * squish keeps the custom colour metric in process-wide state, so encodes with
+ * different weights can't overlap. Encodes sharing flags and weights (all tiles
+ * of a mip, usually all textures of a preset) can, so instead of serializing all
+ * perceptual encodes the metric is held shared by every encode that agrees on it.
+ */
+class CSquishMetricGate
+{
+public:
+    CSquishMetricGate()
+        : m_users(0)
+        , m_waiters(0)
+        , m_flags(0)
+    {
+        memset(m_weights, 0, sizeof(m_weights));
+    }
+
+    void Acquire(int flags, const float* weights)
+    {
+        ThreadUtils::AutoLock lock(m_lock);
+
+        // new users of the active metric queue up behind waiters of a different one, or those would starve
+        while ((m_users > 0) && (!IsActive(flags, weights) || (m_waiters > 0)))
+        {
+            ++m_waiters;
+            m_releasedCV.Sleep(m_lock);
+            --m_waiters;
+        }
+
+        if (m_users == 0)
+        {
+            m_flags = flags;
+            memcpy(m_weights, weights, sizeof(m_weights));
+
+            squish::SetWeights(flags, m_weights);
+        }
+
+        ++m_users;
+    }
+
+    void Release()
+    {
+        ThreadUtils::AutoLock lock(m_lock);
+
+        assert(m_users > 0);
+        if (--m_users == 0)
+        {
+            m_releasedCV.WakeAll();
+        }
+    }
+
+private:
+    bool IsActive(int flags, const float* weights) const
+    {
+        return (m_flags == flags) && (memcmp(m_weights, weights, sizeof(m_weights)) == 0);
+    }
+
+    ThreadUtils::CriticalSection m_lock;
+    ThreadUtils::ConditionVariable m_releasedCV;
+    int m_users;
+    int m_waiters;
+    int m_flags;
+    float m_weights[4];
+};
+
+static CSquishMetricGate s_squishMetricGate;
+
 /* -------------------------------------------------------------------------------------------------------------
  * compression functions
  */
@@ -356,11 +423,7 @@ void CryTextureSquisher::Compress(const CryTextureSquisher::CompressorParameters
 
     if (compress.perceptual && (flags & squish::kColourMetricPerceptual))
     {
-        s_squishLock.Lock();
-    }
-    if (compress.perceptual && (flags & squish::kColourMetricPerceptual))
-    {
-        squish::SetWeights(sqio.flags, &compress.weights[0]);
+        s_squishMetricGate.Acquire(sqio.flags, &compress.weights[0]);
     }
 
     const unsigned int savedFpeMask = MathHelpers::EnableFloatingPointExceptions(~(_EM_INEXACT | _EM_UNDERFLOW | _EM_OVERFLOW | _EM_INVALID));
@@ -478,7 +541,7 @@ void CryTextureSquisher::Compress(const CryTextureSquisher::CompressorParameters
 
     if (compress.perceptual && (flags & squish::kColourMetricPerceptual))
     {
-        s_squishLock.Unlock();
+        s_squishMetricGate.Release();
     }
 
     MathHelpers::EnableFloatingPointExceptions(savedFpeMask);
@@ -18,6 +18,7 @@
 
 #include <math.h>
 #include "FIR-Weights.h"
+#include "StealingThreadPool.h"
 
 /* ####################################################################################################################
  */
@@ -996,83 +997,143 @@ static void RunAlgorithm(const float* i, float* o, struct prcparm* parm)
     filterCCleanUp(orderedNum);
 }
 
-static void SplitAlgorithm(const void* i, void* o, struct prcparm* templ, int threads = 8)
+/* #################################################################################################################### \
+ * thread-pool dispatch of SplitAlgorithm() fractions
+ */
+struct SplitFraction
 {
-    struct prcparm fraction[32];
-    int t, istart = 0, sstart = 0, ostart = 0;
-    const bool scaler = true;
+    const float* i;
+    float* o;
+    struct prcparm parm;
+};
+
+struct SplitCompletion
+{
+    ThreadUtils::CriticalSection lock;
+    ThreadUtils::ConditionVariable finishedCV;
+    bool bFinished;
+};
+
+static void RunFraction(SplitFraction* fraction)
+{
+    CheckBoundaries(fraction->i, fraction->o, &fraction->parm);
+    RunAlgorithm(fraction->i, fraction->o, &fraction->parm);
+}
+
+static void FinishFractions(SplitCompletion* completion)
+{
+    ThreadUtils::AutoLock lock(completion->lock);
+    completion->bFinished = true;
+    completion->finishedCV.WakeAll();
+}
+
+static unsigned int GreatestCommonDivisor(unsigned int a, unsigned int b)
+{
+    while (b)
+    {
+        const unsigned int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/* #################################################################################################################### \
+ * splits the image into horizontal bands and filters them on the given thread-pool
+ *
+ * fractions are only independent if every band reads unmodified source data, so
+ * in-place and caged (regional) filtering still run as a single fraction; band
+ * boundaries are placed on output rows which map onto whole source rows so the
+ * filter phase of every band matches the unsplit run exactly
+ */
+static void SplitAlgorithm(const float* i, float* o, struct prcparm* templ, ThreadUtils::StealingThreadPool* pThreadPool, int threads)
+{
+    enum
+    {
+        kMaxFractions = 32
+    };
 
-    int theight = 0;
+    int fractions = 0;
 
-    /* prepare data to be emitted to the threads */
-    for (t = 0; t < threads; t++)
+    if (pThreadPool && (threads > 1) && (i != o) && !templ->regional && !templ->caged)
     {
-        fraction[t] = *templ;
+        /* smallest out-row step hitting exact in-rows, aligned to the 16-row transpose blocks */
+        const unsigned int exact = templ->resample.rowquo / GreatestCommonDivisor(templ->resample.rowquo, templ->resample.rowrem);
+        const unsigned int step = (exact * 16) / GreatestCommonDivisor(exact, 16);
 
-        /* adjust the processing-region according to the available threads */
+        fractions = minimum<int>(minimum<int>(threads, kMaxFractions), templ->outrows / step);
+
+        if (fractions > 1)
         {
-#undef  split       /* only prefix-threads need aligned transpose (for not trashing suffix-thread data) */
-#define split(rows) !scaler                                         \
-    ? ((rows * (t + 1)) / threads) & (~(t != threads - 1 ? 15 : 0)) \
-    : ((rows * (t + 1)) / threads) & (~0)
-
-            /* area covered */
-            const int  inrows = (fraction[t].regional ? fraction[t].region.inrows  : fraction[t].inrows);
-            const int  incols = (fraction[t].regional ? fraction[t].region.incols  : fraction[t].incols);
-            const int subrows = (fraction[t].regional ? fraction[t].region.subrows : fraction[t].subrows);
-            const int subcols = (fraction[t].regional ? fraction[t].region.subcols : fraction[t].subcols);
-            const int outrows = (fraction[t].regional ? fraction[t].region.outrows : fraction[t].outrows);
-            const int outcols = (fraction[t].regional ? fraction[t].region.outcols : fraction[t].outcols);
-
-            /* splitting blocks */
-            const int istop = split(inrows), sstop = split(subrows), ostop = split(outrows);
-            const int irows = istop - istart, srows = sstop - sstart, orows = ostop - ostart;
-            const int icols = incols, scols = subcols, ocols = outcols;
-
-            assert(irows > 0);
-            assert(orows > 0);
-            assert(icols > 0);
-            assert(ocols > 0);
-
-            /* now we are regional */
-            fraction[t].regional       = true;
-
-            /* take previous regionality into account */
-            fraction[t].region.intop += istart;
-            fraction[t].region.subtop += sstart;
-            fraction[t].region.outtop += ostart;
-            fraction[t].region.inrows = irows;
-            fraction[t].region.subrows = srows;
-            fraction[t].region.outrows = orows;
-
-            /* take previous regionality into account */
-            fraction[t].region.inleft += 0;
-            fraction[t].region.subleft += 0;
-            fraction[t].region.outleft += 0;
-            fraction[t].region.incols  = icols;
-            fraction[t].region.subcols  = scols;
-            fraction[t].region.outcols  = ocols;
-
-            /* advance block */
-            istart = istop;
-            sstart = sstop;
-            ostart = ostop;
-
-            /* check */
-            theight += irows;
-        }
+            SplitFraction fraction[kMaxFractions];
+            int istart = 0, ostart = 0, theight = 0;
+
+            const int steps = templ->outrows / step;
+
+            SplitCompletion completion;
+            completion.bFinished = false;
+
+            ThreadUtils::JobGroup* pJobGroup = pThreadPool->CreateJobGroup(&FinishFractions, &completion);
+
+            /* prepare data to be emitted to the threads */
+            for (int t = 0; t < fractions; t++)
+            {
+                const int ostop = (t != fractions - 1 ? ((steps * (t + 1)) / fractions) * step : templ->outrows);
+                const int istop = (t != fractions - 1 ? (ostop * templ->resample.rowrem) / templ->resample.rowquo : templ->inrows);
+
+                assert(t == fractions - 1 || ((ostop * templ->resample.rowrem) % templ->resample.rowquo) == 0);
+                assert(istop > istart);
+                assert(ostop > ostart);
+
+                fraction[t].i = i;
+                fraction[t].o = o;
+                fraction[t].parm = *templ;
+
+                /* now we are regional, but not caged: bands may fetch their neighbours' rows */
+                fraction[t].parm.regional = true;
+
+                fraction[t].parm.region.intop = istart;
+                fraction[t].parm.region.outtop = ostart;
+                fraction[t].parm.region.inrows = istop - istart;
+                fraction[t].parm.region.outrows = ostop - ostart;
+
+                fraction[t].parm.region.inleft = 0;
+                fraction[t].parm.region.outleft = 0;
+                fraction[t].parm.region.incols = templ->incols;
+                fraction[t].parm.region.outcols = templ->outcols;
 
-        // the algorithm supports "i" and "o" pointing to the same memory
-        CheckBoundaries((float*)i, (float*)o, &fraction[t]);
-        RunAlgorithm((float*)i, (float*)o, &fraction[t]);
+                pJobGroup->Add(&RunFraction, &fraction[t]);
+
+                /* advance block */
+                istart = istop;
+                ostart = ostop;
+
+                /* check */
+                theight += fraction[t].parm.region.inrows;
+            }
+
+            assert(theight == templ->inrows);
+
+            pJobGroup->Submit();
+
+            ThreadUtils::AutoLock lock(completion.lock);
+            while (!completion.bFinished)
+            {
+                completion.finishedCV.Sleep(completion.lock);
+            }
+
+            return;
+        }
     }
 
-    assert(theight >= (templ->regional ? templ->region.inrows : templ->inrows));
+    // the algorithm supports "i" and "o" pointing to the same memory
+    CheckBoundaries(i, o, templ);
+    RunAlgorithm(i, o, templ);
 }
 
 /* #################################################################################################################### \
  */
-void ImageObject::FilterImage(int filterIndex, int filterOp, float blurH, float blurV, const ImageObject* srcImg, int srcMip, int dstMip, RECT* srcRect, RECT* dstRect)
+void ImageObject::FilterImage(int filterIndex, int filterOp, float blurH, float blurV, const ImageObject* srcImg, int srcMip, int dstMip, RECT* srcRect, RECT* dstRect, ThreadUtils::StealingThreadPool* pThreadPool, int threadBudget)
 {
     uint32 srcWidth, srcHeight;
     char* pSrcMem;
@@ -1221,12 +1282,7 @@ void ImageObject::FilterImage(int filterIndex, int filterOp, float blurH, float
             break;
         }
 
-        // TODO: not working yet, debug and enable
-        //      SplitAlgorithm(pSrcMem, pDestMem, &parm);
-
-        // the algorithm supports "pSrcMem" and "pDestMem" pointing to the same memory
-        CheckBoundaries((float*)pSrcMem, (float*)pDestMem, &parm);
-        RunAlgorithm((float*)pSrcMem, (float*)pDestMem, &parm);
+        SplitAlgorithm((float*)pSrcMem, (float*)pDestMem, &parm, pThreadPool, threadBudget);
 
         delete parm.resample.wf;
     }
@@ -1236,7 +1292,7 @@ void ImageObject::FilterImage(const CImageProperties* pProps, const ImageObject*
 {
     if (pProps)
     {
-        FilterImage(pProps->GetMipGenerationMethodIndex(), pProps->GetMipGenerationEvalIndex(), pProps->GetMipHorizontalBlurring(), pProps->GetMipVerticalBlurring(), srcImg, srcMip, dstMip, srcRect, dstRect);
+        FilterImage(pProps->GetMipGenerationMethodIndex(), pProps->GetMipGenerationEvalIndex(), pProps->GetMipHorizontalBlurring(), pProps->GetMipVerticalBlurring(), srcImg, srcMip, dstMip, srcRect, dstRect, pProps->GetFilterThreadPool(), pProps->GetFilterThreadBudget());
     }
     else
     {
@@ -97,9 +97,11 @@ bool CImageCompiler::CheckForExistingPreset(const ConvertContext& CC, const stri
 
 
 // constructor
-CImageCompiler::CImageCompiler(const CImageConvertor::PresetAliases& presetAliases)
+CImageCompiler::CImageCompiler(const CImageConvertor::PresetAliases& presetAliases, ThreadUtils::StealingThreadPool* pFilterThreadPool, int filterThreadBudget)
     : m_Progress(*this)
     , m_presetAliases(presetAliases)
+    , m_pFilterThreadPool(pFilterThreadPool)
+    , m_filterThreadBudget(filterThreadBudget)
 {
     m_pInputImage = 0;
     m_pFinalImage = 0;
@@ -867,6 +869,7 @@ bool CImageCompiler::Process()
         }
 
         m_Props.SetPropsCC(&m_CC, bDisablePreview);
+        m_Props.SetFilterThreading(m_pFilterThreadPool, m_filterThreadBudget);
     }
 
     const bool bSuccess = ProcessImplementation();
@@ -39,7 +39,9 @@ class CImageCompiler
 
 public:
 
-    CImageCompiler(const CImageConvertor::PresetAliases& presetAliases);
+    // Arguments:
+    //   pFilterThreadPool - can be 0
+    CImageCompiler(const CImageConvertor::PresetAliases& presetAliases, ThreadUtils::StealingThreadPool* pFilterThreadPool = 0, int filterThreadBudget = 1);
     virtual ~CImageCompiler();
 
     // Arguments:
@@ -169,6 +171,9 @@ private: // ------------------------------------------------------------------
 
     const CImageConvertor::PresetAliases& m_presetAliases;
 
+    ThreadUtils::StealingThreadPool* m_pFilterThreadPool;    // can be 0
+    int                       m_filterThreadBudget;
+
     ImageObject*              m_pInputImage;                    // input image
     ImageObject*              m_pFinalImage;                    // changed destination image
 
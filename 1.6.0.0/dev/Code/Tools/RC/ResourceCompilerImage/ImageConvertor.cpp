@@ -17,6 +17,7 @@
 #include "ICfgFile.h"
 #include "ImageConvertor.h"
 #include "ImageCompiler.h"
+#include "StealingThreadPool.h"
 
 #define _TIFF_DATA_TYPEDEFS_                // because we defined uint32,... already
 #include "../../../SDKs/tiff/libtiff/tiffio.h"  // TIFF library
@@ -98,12 +99,15 @@ static void LoadPresetAliases(
 }
 
 CImageConvertor::CImageConvertor(IResourceCompiler* pRC)
+    : m_pFilterThreadPool(0)
+    , m_filterThreadBudget(1)
 {
     LoadPresetAliases(pRC->GetIniFile(), m_presetAliases);
 }
 
 CImageConvertor::~CImageConvertor()
 {
+    DeInit();
 }
 
 void CImageConvertor::Release()
@@ -115,11 +119,38 @@ void CImageConvertor::Init(const ConvertorInitContext& context)
 {
     TIFFSetErrorHandler(TiffErrorHandler);
     TIFFSetWarningHandler(TiffWarningHandler);
+
+    // RC runs one compiler per file on up to /threads threads. Cores left idle
+    // by small batches are given to the FIR filter of each image instead, so
+    // a single huge texture can't starve the per-file parallelism.
+    // context.maxThreads is 1 when RC retries out-of-memory files single-
+    // threaded, no pool is started then.
+    const int maxThreads = (context.maxThreads > 1) ? context.maxThreads : 1;
+    const int compilerCount = Util::getClamped((int)context.inputFileCount, 1, maxThreads);
+
+    m_filterThreadBudget = maxThreads / compilerCount;
+
+    if (m_filterThreadBudget > 1)
+    {
+        m_pFilterThreadPool = new ThreadUtils::StealingThreadPool(m_filterThreadBudget * compilerCount);
+        m_pFilterThreadPool->Start();
+    }
+    else
+    {
+        m_filterThreadBudget = 1;
+    }
+}
+
+void CImageConvertor::DeInit()
+{
+    delete m_pFilterThreadPool;
+    m_pFilterThreadPool = 0;
+    m_filterThreadBudget = 1;
 }
 
 ICompiler* CImageConvertor::CreateCompiler()
 {
-    return new CImageCompiler(m_presetAliases);
+    return new CImageCompiler(m_presetAliases, m_pFilterThreadPool, m_filterThreadBudget);
 }
 
 bool CImageConvertor::SupportsMultithreading() const
@@ -20,6 +20,11 @@
 
 struct IResourceCompiler;
 
+namespace ThreadUtils
+{
+    class StealingThreadPool;
+}
+
 class CImageConvertor
     : public IConvertor
 {
@@ -34,6 +39,7 @@ public:
     // interface IConvertor ----------------------------------------------------
     virtual void Release();
     virtual void Init(const ConvertorInitContext& context);
+    virtual void DeInit();
     virtual ICompiler* CreateCompiler();
     virtual bool SupportsMultithreading() const;
     virtual const char* GetExt(int index) const;
@@ -41,6 +47,10 @@ public:
 
 private:
     PresetAliases m_presetAliases;
+
+    // shared by all compilers of the current batch to split filtering of single images
+    ThreadUtils::StealingThreadPool* m_pFilterThreadPool;
+    int m_filterThreadBudget;
 };
 
 #endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERIMAGE_IMAGECONVERTOR_H
@@ -621,7 +621,9 @@ public:
 
     // Image filtering
     void FilterImage(const CImageProperties* pProps, const ImageObject* srcImg, int srcMip, int dstMip, RECT* srcRect, RECT* dstRect);
-    void FilterImage(int filterIndex, int filterOp, float blurH, float blurV, const ImageObject* srcImg, int srcMip, int dstMip, RECT* srcRect, RECT* dstRect);
+    // Arguments:
+    //   pThreadPool - can be 0, otherwise the image is split into up to threadBudget bands filtered concurrently
+    void FilterImage(int filterIndex, int filterOp, float blurH, float blurV, const ImageObject* srcImg, int srcMip, int dstMip, RECT* srcRect, RECT* dstRect, ThreadUtils::StealingThreadPool* pThreadPool = 0, int threadBudget = 1);
 
     // ---------------------------------------------------------------------------------
 
@@ -29,6 +29,11 @@
 
 #include "Converters/NormalFromHeight.h"    // CBumpProperties
 
+namespace ThreadUtils
+{
+    class StealingThreadPool;
+}
+
 
 class CImageProperties
 {
@@ -82,6 +87,8 @@ public:
 
     CImageProperties()
         : m_pCC(0)
+        , m_pFilterThreadPool(0)
+        , m_filterThreadBudget(1)
         , m_AlphaAsBump(true)
         , m_BumpToNormal(false)
     {
@@ -121,6 +128,25 @@ public:
             : (m_pCC ? m_pCC->config->GetAsBool("preview", true, true) : true);
     }
 
+    // Arguments:
+    //  pThreadPool - can be 0
+    //  threadBudget - max number of bands a single FilterImage() call may process concurrently
+    void SetFilterThreading(ThreadUtils::StealingThreadPool* pThreadPool, int threadBudget)
+    {
+        m_pFilterThreadPool = pThreadPool;
+        m_filterThreadBudget = (pThreadPool && (threadBudget > 1)) ? threadBudget : 1;
+    }
+
+    ThreadUtils::StealingThreadPool* GetFilterThreadPool() const
+    {
+        return m_pFilterThreadPool;
+    }
+
+    int GetFilterThreadBudget() const
+    {
+        return m_filterThreadBudget;
+    }
+
     void setKeyValue(const char* key, const char* value)
     {
         m_pCC->multiConfig->setKeyValue(eCP_PriorityFile, key, value);
@@ -1346,6 +1372,8 @@ public: // ---------------------------------------------------------------------
 private: // ---------------------------------------------------------------------
 
     ConvertContext* m_pCC;                    // can be 0
+    ThreadUtils::StealingThreadPool* m_pFilterThreadPool;   // can be 0
+    int             m_filterThreadBudget;     // >= 1
 };
 
 #endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERIMAGE_IMAGEPROPERTIES_H
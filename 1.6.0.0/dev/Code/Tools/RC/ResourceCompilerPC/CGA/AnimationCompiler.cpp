@@ -37,6 +37,7 @@
 #include "PakXmlFileBufferSource.h"
 #include "DBAEnumerator.h"
 #include "DBATableEnumerator.h"
+#include "DBABuildManifest.h"
 #include "Plugins/EditorAnimation/Shared/CompressionPresetTable.h"
 #include <RcFile.h>
 
@@ -190,6 +191,7 @@ CAnimationConvertor::CAnimationConvertor(ICryXML* pXMLParser, IPakSystem* pPakSy
     : m_pPakSystem(pPakSystem)
     , m_pXMLParser(pXMLParser)
     , m_config(0)
+    , m_maxThreads(1)
     , m_tempPath(pRC->GetTmpPath())
     , m_fancyAnimationIndex(0)
     , m_changedAnimationCount(0)
@@ -209,6 +211,7 @@ void CAnimationConvertor::Init(const ConvertorInitContext& context)
     m_cbaLoader.reset();
 
     m_config = context.config;
+    m_maxThreads = context.maxThreads;
 
     m_sourceGameFolderPath = context.config->GetAsString("sourceroot", "", "");
     if (m_sourceGameFolderPath.empty())
@@ -403,6 +406,287 @@ static vector<string> GetJointNames(const CSkeletonInfo* skeleton)
     return result;
 }
 
+namespace
+{
+    struct DBARebuildJob;
+
+    // Limits the number of DBAs whose animations are loaded at the same time. A DBA holds all
+    // controllers of its animations until its finishing job has written it, so without the limit
+    // the pool could load every animation of the project before the first DBA is saved.
+    struct DBARebuildWindow
+    {
+        ThreadUtils::CriticalSection criticalSection;
+        ThreadUtils::ConditionVariable finishedCV;
+        size_t inFlight;
+        size_t maxInFlight;
+
+        explicit DBARebuildWindow(size_t maxDBAsInFlight)
+            : inFlight(0)
+            , maxInFlight(maxDBAsInFlight)
+        {
+        }
+
+        void Enter()
+        {
+            ThreadUtils::AutoLock lock(criticalSection);
+            while (inFlight >= maxInFlight)
+            {
+                finishedCV.Sleep(criticalSection);
+            }
+            ++inFlight;
+        }
+
+        void Leave()
+        {
+            ThreadUtils::AutoLock lock(criticalSection);
+            --inFlight;
+            finishedCV.WakeAll();
+        }
+    };
+
+    // Compressed animation which belongs to a DBA, loaded by a worker of the database rebuild
+    struct DBARebuildCAF
+    {
+        DBARebuildJob* dba;
+        EnumeratedCAF caf;
+        string compressedPath;
+        size_t fileSize;
+
+        string animationPath;
+        GlobalAnimationHeaderCAF header;
+        GlobalAnimationHeaderAIM aimHeader;
+        bool loaded;
+        bool isAIM;
+        bool aimValid;
+        bool saveInDBA;
+
+        DBARebuildCAF()
+            : dba(0)
+            , fileSize(0)
+            , loaded(false)
+            , isAIM(false)
+            , aimValid(false)
+            , saveInDBA(false)
+        {
+        }
+    };
+
+    struct DBARebuildJob
+    {
+        string innerPath;
+        string outPath;
+        string sourceGameFolderPath;
+        bool bigEndianOutput;
+        bool streamPrepare;
+        int pointerSize;
+        // the DBA on disk was built from exactly these animations, it's not written again
+        bool upToDate;
+        bool saveFailed;
+        DBARebuildWindow* window;
+
+        std::vector<DBARebuildCAF> cafs;
+        std::vector<DBABuildManifest::Animation> manifestAnimations;
+
+        size_t inputSize;
+        size_t outputSize;
+        size_t animCount;
+
+        DBARebuildJob()
+            : bigEndianOutput(false)
+            , streamPrepare(false)
+            , pointerSize(0)
+            , upToDate(false)
+            , saveFailed(false)
+            , window(0)
+            , inputSize(0)
+            , outputSize(0)
+            , animCount(0)
+        {
+        }
+    };
+}
+
+static void LoadDBAAnimationJob(DBARebuildCAF* item)
+{
+    const DBARebuildJob* const dba = item->dba;
+    const char* const compressedCAFPath = item->compressedPath.c_str();
+
+    CChunkFile chunkFile;
+    GlobalAnimationHeaderCAF& globalAnimationHeader = item->header;
+    if (!globalAnimationHeader.LoadCAF(compressedCAFPath, eCAFLoadCompressedOnly, &chunkFile))
+    {
+        RCLogError("Failed to load a compressed animation '%s'.", compressedCAFPath);
+        return;
+    }
+
+    const string animationPath = UnifiedPath(item->caf.path);
+    if (animationPath.empty())
+    {
+        RCLogError("Unexpected error with animation %s. Root animation folder is: %s", item->caf.path.c_str(), dba->sourceGameFolderPath.c_str());
+        return;
+    }
+    item->animationPath = animationPath;
+
+    item->isAIM = chunkFile.FindChunkByType(ChunkType_GlobalAnimationHeaderAIM) != 0;
+    if (item->isAIM)
+    {
+        GlobalAnimationHeaderAIM& gaim = item->aimHeader;
+        if (!gaim.LoadAIM(compressedCAFPath, eCAFLoadCompressedOnly))
+        {
+            RCLogError("Unable to load AIM/LOOK: '%s'.", compressedCAFPath);
+        }
+        else if (animationPath != gaim.m_FilePath)
+        {
+            RCLogError("AIM loaded with wrong m_FilePath: '%s' (should be '%s').",
+                gaim.m_FilePath.c_str(), animationPath.c_str());
+        }
+        else if (!gaim.IsValid())
+        {
+            RCLogError("AIM header contains invalid values (NANs): '%s'.", compressedCAFPath);
+        }
+        else
+        {
+            item->aimValid = true;
+        }
+        globalAnimationHeader.OnAimpose(); // we need this info to skip aim-poses in the IMG file
+    }
+
+    globalAnimationHeader.SetFilePathCAF(animationPath.c_str());
+    item->saveInDBA = !item->isAIM && !dba->innerPath.empty() && !item->caf.skipDBA;
+
+    if (item->saveInDBA)
+    {
+        const string dbaPath = UnifiedPath(dba->innerPath);
+        globalAnimationHeader.SetFilePathDBA(dbaPath);
+
+        globalAnimationHeader.OnAssetLoaded();
+        globalAnimationHeader.ClearAssetOnDemand();
+    }
+    else
+    {
+        globalAnimationHeader.OnAssetOnDemand();
+        globalAnimationHeader.ClearAssetLoaded();
+    }
+
+    item->loaded = true;
+}
+
+// Finishing job of a DBA's group, runs once all of its animations are loaded
+static void SaveDBAJob(DBARebuildJob* dba)
+{
+    for (size_t anim = 0; anim < dba->cafs.size(); ++anim)
+    {
+        const DBARebuildCAF& item = dba->cafs[anim];
+        if (item.loaded && item.saveInDBA)
+        {
+            dba->inputSize += item.fileSize;
+            ++dba->animCount;
+        }
+    }
+
+    if (!dba->innerPath.empty() && dba->animCount != 0)
+    {
+        if (!dba->upToDate)
+        {
+            CTrackStorage storage(dba->bigEndianOutput);
+            for (size_t anim = 0; anim < dba->cafs.size(); ++anim)
+            {
+                const DBARebuildCAF& item = dba->cafs[anim];
+                if (item.loaded && item.saveInDBA)
+                {
+                    storage.AddAnimation(item.header);
+                }
+            }
+            if (!storage.SaveDataBase905(dba->outPath.c_str(), dba->streamPrepare, dba->pointerSize))
+            {
+                RCLogError("Failed to save DBA '%s'.", dba->outPath.c_str());
+                dba->saveFailed = true;
+            }
+        }
+
+        if (FileUtil::FileExists(dba->outPath.c_str()))
+        {
+            dba->outputSize = (size_t)FileUtil::GetFileSize(dba->outPath.c_str());
+        }
+    }
+
+    // Only the headers are needed from here on, the animation manager doesn't keep controllers
+    for (size_t anim = 0; anim < dba->cafs.size(); ++anim)
+    {
+        dba->cafs[anim].header.m_arrController.clear();
+    }
+
+    if (dba->window)
+    {
+        dba->window->Leave();
+    }
+}
+
+typedef std::map<string, GlobalAnimationHeaderCAF> TImageHeaders;
+
+// Reads the headers of the previous Animations.img, keyed by animation path
+static void LoadImageHeaders(const string& imgPath, TImageHeaders& headers)
+{
+    if (!FileUtil::FileExists(imgPath.c_str()))
+    {
+        return;
+    }
+
+    CChunkFile chunkFile;
+    if (!chunkFile.Read(imgPath.c_str()))
+    {
+        return;
+    }
+
+    const int numChunks = chunkFile.NumChunks();
+    for (int i = 0; i < numChunks; ++i)
+    {
+        GlobalAnimationHeaderCAF header;
+        if (header.LoadFromHeaderChunk(chunkFile.GetChunk(i), imgPath.c_str()))
+        {
+            headers[header.m_FilePath] = header;
+        }
+    }
+}
+
+// An up to date DBA doesn't need its animations loaded if the previous Animations.img has
+// the headers they produced for this DBA. Aimposes and animations kept out of the DBA are
+// loaded as before.
+static bool TakeHeadersFromImage(DBARebuildJob& dba, const TImageHeaders& headers)
+{
+    if (!dba.upToDate || dba.innerPath.empty() || headers.empty())
+    {
+        return false;
+    }
+
+    const string dbaPath = UnifiedPath(dba.innerPath);
+    const uint32 dbaPathCRC32 = CCrc32::ComputeLowercase(dbaPath.c_str());
+    for (size_t anim = 0; anim < dba.cafs.size(); ++anim)
+    {
+        const DBARebuildCAF& item = dba.cafs[anim];
+        if (item.caf.skipDBA)
+        {
+            return false;
+        }
+        const TImageHeaders::const_iterator it = headers.find(UnifiedPath(item.caf.path));
+        if (it == headers.end() || it->second.IsAimpose() || it->second.m_FilePathDBACRC32 != dbaPathCRC32)
+        {
+            return false;
+        }
+    }
+
+    for (size_t anim = 0; anim < dba.cafs.size(); ++anim)
+    {
+        DBARebuildCAF& item = dba.cafs[anim];
+        item.animationPath = UnifiedPath(item.caf.path);
+        item.header = headers.find(item.animationPath)->second;
+        item.header.SetFilePathDBA(dbaPath);
+        item.saveInDBA = true;
+        item.loaded = true;
+    }
+    return true;
+}
+
 bool CAnimationConvertor::RebuildDatabases()
 {
     if (m_config->GetAsBool("SkipDba", false, true))
@@ -508,26 +792,35 @@ bool CAnimationConvertor::RebuildDatabases()
         dbaInputFile = m_cbaPath;
     }
 
+    const string dbaSettings = StringHelpers::Format("%s%d%s", bigEndianOutput ? "be" : "le", pointerSize * 8, bStreamPrepare ? "s" : "");
+    const string manifestPath = PathHelpers::Join(targetGameFolderPath, PathHelpers::Join(m_configSubfolder, "DBATable.manifest"));
+
+    DBABuildManifest manifest;
+    if (!m_config->GetAsBool("refresh", false, true))
+    {
+        manifest.Load(manifestPath);
+    }
+
+    // Enumerators aren't thread-safe, collect all DBAs and their animations first
     const size_t dbaCount = enumerator->GetDBACount();
+    std::vector<DBARebuildJob> dbaJobs(dbaCount);
+    size_t upToDateCount = 0;
     for (size_t dbaIndex = 0; dbaIndex < dbaCount; ++dbaIndex)
     {
         EnumeratedDBA dba;
         enumerator->GetDBA(&dba, dbaIndex);
 
-        const string& dbaInnerPath = dba.innerPath;
+        DBARebuildJob& job = dbaJobs[dbaIndex];
+        job.innerPath = dba.innerPath;
+        job.outPath = PathHelpers::Join(targetGameFolderPath, dba.innerPath);
+        job.sourceGameFolderPath = m_sourceGameFolderPath;
+        job.bigEndianOutput = bigEndianOutput;
+        job.streamPrepare = bStreamPrepare;
+        job.pointerSize = pointerSize;
+        job.cafs.reserve(dba.animationCount);
 
-
-        std::unique_ptr<CTrackStorage> storage;
-        if (!dbaInnerPath.empty())
-        {
-            storage.reset(new CTrackStorage(bigEndianOutput));
-        }
-
-        std::vector<AnimationJob> animations;
-        animations.resize(dba.animationCount);
-
-        size_t dbaInputSize = 0;
-        size_t dbaAnimCount = 0;
+        std::vector<DBABuildManifest::Animation> manifestAnimations;
+        manifestAnimations.reserve(dba.animationCount);
 
         for (size_t anim = 0; anim < dba.animationCount; ++anim)
         {
@@ -544,78 +837,103 @@ bool CAnimationConvertor::RebuildDatabases()
                 continue;
             }
 
-            CChunkFile chunkFile;
-            GlobalAnimationHeaderCAF globalAnimationHeader;
-            if (!globalAnimationHeader.LoadCAF(compressedCAFPath.c_str(), eCAFLoadCompressedOnly, &chunkFile))
+            job.cafs.push_back(DBARebuildCAF());
+            DBARebuildCAF& item = job.cafs.back();
+            item.caf = caf;
+            item.compressedPath = compressedCAFPath;
+            item.fileSize = (size_t)FileUtil::GetFileSize(compressedCAFPath.c_str());
+
+            DBABuildManifest::Animation manifestAnimation;
+            manifestAnimation.path = caf.path;
+            manifestAnimation.skipDBA = caf.skipDBA;
+            manifestAnimation.fileSize = item.fileSize;
+            manifestAnimation.fileTime = DBABuildManifest::GetFileTimeValue(FileUtil::GetLastWriteFileTime(compressedCAFPath.c_str()));
+            manifestAnimations.push_back(manifestAnimation);
+        }
+
+        if (!job.innerPath.empty() && manifest.IsUpToDate(job.outPath, job.innerPath, dbaSettings, manifestAnimations))
+        {
+            job.upToDate = true;
+            ++upToDateCount;
+        }
+        job.manifestAnimations.swap(manifestAnimations);
+    }
+
+    // Up to date DBAs take their headers from the previous Animations.img instead of loading their animations
+    size_t headersFromImageCount = 0;
+    if (upToDateCount > 0)
+    {
+        TImageHeaders imageHeaders;
+        LoadImageHeaders(PathHelpers::Join(targetGameFolderPath, "Animations\\Animations.img"), imageHeaders);
+        for (size_t dbaIndex = 0; dbaIndex < dbaCount; ++dbaIndex)
+        {
+            DBARebuildJob& job = dbaJobs[dbaIndex];
+            if (TakeHeadersFromImage(job, imageHeaders))
             {
-                RCLogError("Failed to load a compressed animation '%s'.", compressedCAFPath.c_str());
-                continue;
+                SaveDBAJob(&job);
+                ++headersFromImageCount;
             }
+        }
+    }
 
-
-            const string animationPath = UnifiedPath(caf.path);
-            if (animationPath.empty())
+    // Load all remaining animations in parallel. Every DBA is a job group, its finishing job assembles and
+    // writes the DBA from the loaded animations in enumeration order, so the output doesn't depend
+    // on the number of threads. Only a few DBAs are in flight at once, which bounds the memory
+    // held by loaded controllers while still keeping every worker busy.
+    {
+        const int numThreads = m_maxThreads > 0 ? m_maxThreads : 1;
+        ThreadUtils::StealingThreadPool pool(numThreads);
+        DBARebuildWindow window(2 * numThreads);
+        pool.Start();
+        for (size_t dbaIndex = 0; dbaIndex < dbaCount; ++dbaIndex)
+        {
+            DBARebuildJob& job = dbaJobs[dbaIndex];
+            // DBAs without animations or with headers already taken from the image
+            if (job.cafs.empty() || job.cafs[0].loaded)
             {
-                RCLogError("Unexpected error with animation %s. Root animation folder is: %s", caf.path.c_str(), m_sourceGameFolderPath.c_str());
                 continue;
             }
 
-            const bool isAIM = chunkFile.FindChunkByType(ChunkType_GlobalAnimationHeaderAIM) != 0;
-            if (isAIM)
+            window.Enter();
+            job.window = &window;
+            ThreadUtils::JobGroup* pJobGroup = pool.CreateJobGroup(&SaveDBAJob, &job);
+            for (size_t anim = 0; anim < job.cafs.size(); ++anim)
             {
-                GlobalAnimationHeaderAIM gaim;
-                if (!gaim.LoadAIM(compressedCAFPath.c_str(), eCAFLoadCompressedOnly))
-                {
-                    RCLogError("Unable to load AIM/LOOK: '%s'.", compressedCAFPath.c_str());
-                }
-                else if (animationPath != gaim.m_FilePath)
-                {
-                    RCLogError("AIM loaded with wrong m_FilePath: '%s' (should be '%s').",
-                        gaim.m_FilePath.c_str(), animationPath.c_str());
-                }
-                else if (!gaim.IsValid())
-                {
-                    RCLogError("AIM header contains invalid values (NANs): '%s'.", compressedCAFPath.c_str());
-                }
-                else
-                {
-                    if (!animationManager.AddAIMHeaderOnly(gaim))
-                    {
-                        RCLogWarning("CAF(AIM) file was added to more than one DBA: '%s'", animationPath.c_str());
-                    }
-                }
-                globalAnimationHeader.OnAimpose(); // we need this info to skip aim-poses in the IMG file
+                job.cafs[anim].dba = &job;
+                pJobGroup->Add(&LoadDBAAnimationJob, &job.cafs[anim]);
             }
+            pJobGroup->Submit();
+        }
+        pool.WaitAllJobs();
+    }
 
-            globalAnimationHeader.SetFilePathCAF(animationPath.c_str());
-            const bool saveInDBA = !isAIM && !dbaInnerPath.empty() && !caf.skipDBA;
-
-            if (saveInDBA)
-            {
-                const string dbaPath = UnifiedPath(dbaInnerPath);
-                globalAnimationHeader.SetFilePathDBA(dbaPath);
+    // Headers go to the animation manager in enumeration order, it decides which DBA owns an animation
+    // listed more than once.
+    for (size_t dbaIndex = 0; dbaIndex < dbaCount; ++dbaIndex)
+    {
+        const DBARebuildJob& job = dbaJobs[dbaIndex];
+        const string& dbaInnerPath = job.innerPath;
 
-                globalAnimationHeader.OnAssetLoaded();
-                globalAnimationHeader.ClearAssetOnDemand();
-            }
-            else
+        for (size_t anim = 0; anim < job.cafs.size(); ++anim)
+        {
+            const DBARebuildCAF& item = job.cafs[anim];
+            if (!item.loaded)
             {
-                globalAnimationHeader.OnAssetOnDemand();
-                globalAnimationHeader.ClearAssetLoaded();
+                continue;
             }
 
-            if (!animationManager.AddCAFHeaderOnly(globalAnimationHeader))
+            if (item.isAIM && item.aimValid)
             {
-                RCLogWarning("CAF file was added to more than one DBA: '%s'",
-                    globalAnimationHeader.m_FilePath.c_str());
+                if (!animationManager.AddAIMHeaderOnly(item.aimHeader))
+                {
+                    RCLogWarning("CAF(AIM) file was added to more than one DBA: '%s'", item.animationPath.c_str());
+                }
             }
 
-            if (storage.get() && saveInDBA)
+            if (!animationManager.AddCAFHeaderOnly(item.header))
             {
-                storage->AddAnimation(globalAnimationHeader);
-
-                dbaInputSize += (size_t)FileUtil::GetFileSize(compressedCAFPath.c_str());
-                ++dbaAnimCount;
+                RCLogWarning("CAF file was added to more than one DBA: '%s'",
+                    item.header.m_FilePath.c_str());
             }
         }
 
@@ -629,39 +947,49 @@ bool CAnimationConvertor::RebuildDatabases()
             }
         }
 
-        if (storage.get())
+        if (!dbaInnerPath.empty())
         {
-            if (dbaAnimCount != 0)
+            if (job.animCount != 0)
             {
-                const string dbaOutPath = PathHelpers::Join(targetGameFolderPath, dbaInnerPath);
-                storage->SaveDataBase905(dbaOutPath.c_str(), bStreamPrepare, pointerSize);
+                const size_t dbaInputSize = job.inputSize;
+                const size_t dbaOutputSize = job.outputSize;
 
-                size_t dbaOutputSize = 0;
-                if (FileUtil::FileExists(dbaOutPath.c_str()))
-                {
-                    dbaOutputSize = (size_t)FileUtil::GetFileSize(dbaOutPath.c_str());
-                }
-
-                RCLog("DBA %i KB -> %i KB (%02.1f%%) anims: %i '%s'",
+                RCLog("DBA %i KB -> %i KB (%02.1f%%) anims: %i '%s'%s",
                     dbaInputSize / 1024, dbaOutputSize / 1024,
-                    double(dbaOutputSize) / dbaInputSize * 100.0, dbaAnimCount, dbaInnerPath.c_str());
+                    double(dbaOutputSize) / dbaInputSize * 100.0, job.animCount, dbaInnerPath.c_str(),
+                    job.upToDate ? " (up to date)" : "");
 
                 if (m_rc)
                 {
-                    m_rc->AddInputOutputFilePair(dbaInputFile, dbaOutPath.c_str());
+                    m_rc->AddInputOutputFilePair(dbaInputFile, job.outPath.c_str());
+                }
+
+                if (job.saveFailed)
+                {
+                    manifest.Remove(dbaInnerPath);
+                }
+                else if (!job.upToDate)
+                {
+                    manifest.SetBuilt(job.outPath, dbaInnerPath, dbaSettings, job.manifestAnimations);
                 }
 
                 totalInputSize += dbaInputSize;
                 totalOutputSize += dbaOutputSize;
-                totalAnimCount += dbaAnimCount;
+                totalAnimCount += job.animCount;
             }
             else
             {
                 RCLogWarning("No valid animations found which belong to the DBA '%s', so it's not created.", dbaInnerPath.c_str());
+                manifest.Remove(dbaInnerPath);
             }
         }
     }
 
+    if (upToDateCount > 0)
+    {
+        RCLog("%i of %i DBAs were up to date, %i of them without loading their animations.", (int)upToDateCount, (int)dbaCount, (int)headersFromImageCount);
+    }
+
     if (m_usingIntermediateCAF)
     {
         RCLog("Looking for non dba animations for creating animation .img files.");
@@ -829,6 +1157,9 @@ bool CAnimationConvertor::RebuildDatabases()
         m_rc->AddInputOutputFilePair(imageInputFile.c_str(), sDirectionalBlendsImgFilename);
     }
 
+    // Saved only after the images, up to date DBAs rely on Animations.img matching the manifest
+    manifest.Save(manifestPath);
+
     if (!unusedDBAs.empty())
     {
         RCLog("Following DBAs are not used anymore:");
@@ -195,6 +195,7 @@ private:
     IPakSystem* m_pPakSystem;
     ICryXML* m_pXMLParser;
     const IConfig* m_config;
+    int m_maxThreads;
     volatile LONG m_fancyAnimationIndex;
     volatile LONG m_changedAnimationCount;
     int m_refCount;
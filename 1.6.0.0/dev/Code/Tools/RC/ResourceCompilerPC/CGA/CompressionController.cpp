@@ -16,32 +16,9 @@
 #include "AnimationLoader.h"
 #include "CompressionController.h"
 #include "ControllerPQ.h"
+#include "KeyReduction.h"
 #include "Util.h"
 
-// Returns true if angular difference between two quaternions is bigger than
-// the one specified by cosOfHalfMaxAngle.
-// cosOfHalfMaxAngle == cosf(maxAngleDifferenceInRadians * 0.5f)
-static inline bool error_quatCos(const Quat& q1, const Quat& q2, const float cosOfHalfMaxAngle)
-{
-    //  const float cosOfHalfAngle = fabsf(q1.v.x * q2.v.x + q1.v.y * q2.v.y + q1.v.z * q2.v.z + q1.v.w * q1.v.w);
-    // Note about "1 - fabsf(" and "- 1)": q1 | q1 might return values > 1, so we map them to values < 1.
-    const float cosOfHalfAngle = 1 - fabsf(fabsf(q1 | q2) - 1);
-    return cosOfHalfAngle < cosOfHalfMaxAngle;
-}
-
-
-static inline bool error_vec3(const Vec3& v1, const Vec3& v2, const float maxAllowedDistanceSquared)
-{
-    const float x = v1.x - v2.x;
-    const float y = v1.y - v2.y;
-    const float z = v1.z - v2.z;
-
-    const float distanceSquared = x * x + y * y + z * z;
-
-    return distanceSquared > maxAllowedDistanceSquared;
-}
-
-
 
 bool ObtainTrackData(
     const GlobalAnimationHeaderCAF& header,
@@ -999,52 +976,37 @@ void CCompressonator::CompressRotations(CController* pController, ECompressionFo
     pNewTrack->SetKeyTimesInformation(pTimes);
     pController->SetRotationController(pNewTrack);
 
-    unsigned int iFirstKey = 0;
-
-    pTimes->AddKeyTime(f32(m_RotTimes[iFirstKey]));
-    pStorage->AddValue(m_Rotations[iFirstKey]);
+    if (!bRemoveKeys)
+    {
+        for (uint32 i = 0; i < numKeys; ++i)
+        {
+            pTimes->AddKeyTime(f32(m_RotTimes[i]));
+            pStorage->AddValue(m_Rotations[i]);
+        }
+        return;
+    }
 
-    if (bRemoveKeys)
+    // Interpolation during key removal uses the keys as they will be stored, quantize each of them once
+    std::vector<Quat> quantized(numKeys);
     {
         std::unique_ptr<BaseCompressedQuat> compressed(GetCompressedQuat(rotationFormat, 1));
-        Quat first, last, interpolated;
-
-        const float maxAngleInRadians = Util::getClamped(DEG2RAD(rotationToleranceInDegrees), 0.0f, (float)gf_PI);
-        const float cosOfHalfMaxAngle = cosf(maxAngleInRadians * 0.5f);
-
-        while (iFirstKey + 2 < numKeys)
+        for (uint32 i = 0; i < numKeys; ++i)
         {
-            compressed->FromQuat(m_Rotations[iFirstKey]);
-            first = compressed->ToQuat();
-
-            unsigned int iLastKey;
-            for (iLastKey = iFirstKey + 2; iLastKey < numKeys; ++iLastKey)
-            {
-                compressed->FromQuat(m_Rotations[iLastKey]);
-                last = compressed->ToQuat();
-
-                const unsigned int count = iLastKey - iFirstKey;
-                for (unsigned int i = 1; i < count; ++i)
-                {
-                    interpolated.SetNlerp(first, last, i / (float)count);
-
-                    if (error_quatCos(interpolated, m_Rotations[iFirstKey + i], cosOfHalfMaxAngle))
-                    {
-                        goto addKey;
-                    }
-                }
-            }
-addKey:
-            iFirstKey = iLastKey - 1;
-            pTimes->AddKeyTime(f32(m_RotTimes[iFirstKey]));
-            pStorage->AddValue(m_Rotations[iFirstKey]);
+            compressed->FromQuat(m_Rotations[i]);
+            quantized[i] = compressed->ToQuat();
         }
     }
 
-    for (++iFirstKey; iFirstKey < numKeys; ++iFirstKey)
+    const float maxAngleInRadians = Util::getClamped(DEG2RAD(rotationToleranceInDegrees), 0.0f, (float)gf_PI);
+    const float cosOfHalfMaxAngle = cosf(maxAngleInRadians * 0.5f);
+
+    std::vector<uint32> keptKeys;
+    KeyReduction::ReduceRotations(m_Rotations, quantized, cosOfHalfMaxAngle, keptKeys);
+
+    for (size_t i = 0; i < keptKeys.size(); ++i)
     {
-        pTimes->AddKeyTime(f32(m_RotTimes[iFirstKey]));
-        pStorage->AddValue(m_Rotations[iFirstKey]);
+        pTimes->AddKeyTime(f32(m_RotTimes[keptKeys[i]]));
+        pStorage->AddValue(m_Rotations[keptKeys[i]]);
     }
 }
 
@@ -1077,50 +1039,34 @@ void CCompressonator::CompressPositions(CController* pController, ECompressionFo
     pNewTrack->SetKeyTimesInformation(pTimes);
     pController->SetPositionController(pNewTrack);
 
-    unsigned int iFirstKey = 0;
-
-    pTimes->AddKeyTime(f32(m_PosTimes[iFirstKey]));
-    pStorage->AddValue(m_Positions[iFirstKey]);
+    if (!bRemoveKeys)
+    {
+        for (uint32 i = 0; i < numKeys; ++i)
+        {
+            pTimes->AddKeyTime(f32(m_PosTimes[i]));
+            pStorage->AddValue(m_Positions[i]);
+        }
+        return;
+    }
 
-    if (bRemoveKeys)
+    std::vector<Vec3> quantized(numKeys);
     {
         std::unique_ptr<BaseCompressedVec3> compressed(GetCompressedVec3(positionFormat, 1));
-        Vec3 first, last, interpolated;
-
-        const float squaredPositionTolerance = positionTolerance * positionTolerance;
-
-        while (iFirstKey + 2 < numKeys)
+        for (uint32 i = 0; i < numKeys; ++i)
         {
-            compressed->FromVec3(m_Positions[iFirstKey]);
-            first = compressed->ToVec3();
-
-            unsigned int iLastKey;
-            for (iLastKey = iFirstKey + 2; iLastKey < numKeys; ++iLastKey)
-            {
-                compressed->FromVec3(m_Positions[iLastKey]);
-                last = compressed->ToVec3();
-
-                const unsigned int count = iLastKey - iFirstKey;
-                for (unsigned int i = 1; i < count; ++i)
-                {
-                    interpolated.SetLerp(first, last, i / (float)count);
-
-                    if (error_vec3(interpolated, m_Positions[iFirstKey + i], squaredPositionTolerance))
-                    {
-                        goto addKey;
-                    }
-                }
-            }
-addKey:
-            iFirstKey = iLastKey - 1;
-            pTimes->AddKeyTime(f32(m_PosTimes[iFirstKey]));
-            pStorage->AddValue(m_Positions[iFirstKey]);
+            compressed->FromVec3(m_Positions[i]);
+            quantized[i] = compressed->ToVec3();
         }
     }
 
-    for (++iFirstKey; iFirstKey < numKeys; ++iFirstKey)
+    const float squaredPositionTolerance = positionTolerance * positionTolerance;
+
+    std::vector<uint32> keptKeys;
+    KeyReduction::ReducePositions(m_Positions, quantized, squaredPositionTolerance, keptKeys);
+
+    for (size_t i = 0; i < keptKeys.size(); ++i)
     {
-        pTimes->AddKeyTime(f32(m_PosTimes[iFirstKey]));
-        pStorage->AddValue(m_Positions[iFirstKey]);
+        pTimes->AddKeyTime(f32(m_PosTimes[keptKeys[i]]));
+        pStorage->AddValue(m_Positions[keptKeys[i]]);
     }
 }
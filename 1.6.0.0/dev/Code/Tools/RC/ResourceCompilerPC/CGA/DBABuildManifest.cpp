@@ -0,0 +1,173 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+// Original file Copyright Crytek GMBH or its affiliates, used under license.
+
+#include "StdAfx.h"
+#include "DBABuildManifest.h"
+
+#include "FileUtil.h"
+#include "StringHelpers.h"
+
+namespace
+{
+    const char* const s_manifestHeader = "DBABuildManifest 1";
+
+    // Paths come last on a line, they may contain spaces
+    string ReadPath(const char* line)
+    {
+        string path = line;
+        while (!path.empty() && (path[path.length() - 1] == '\n' || path[path.length() - 1] == '\r'))
+        {
+            path.erase(path.length() - 1);
+        }
+        return path;
+    }
+
+    bool GetOutputFileState(const string& dbaPath, uint64& size, uint64& time)
+    {
+        const __int64 fileSize = FileUtil::GetFileSize(dbaPath.c_str());
+        if (fileSize < 0)
+        {
+            return false;
+        }
+        size = (uint64)fileSize;
+        time = DBABuildManifest::GetFileTimeValue(FileUtil::GetLastWriteFileTime(dbaPath.c_str()));
+        return true;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void DBABuildManifest::Load(const string& filename)
+{
+    m_dbas.clear();
+
+    FILE* const pFile = fopen(filename.c_str(), "rt");
+    if (!pFile)
+    {
+        return;
+    }
+
+    const size_t maxLineLength = 2048;
+    char line[maxLineLength];
+
+    bool bValid = fgets(line, maxLineLength, pFile) && StringHelpers::StartsWith(string(line), string(s_manifestHeader));
+
+    DBA* pCurrentDBA = 0;
+    while (bValid && fgets(line, maxLineLength, pFile))
+    {
+        char settings[64];
+        unsigned long long size = 0;
+        unsigned long long time = 0;
+        int skipDBA = 0;
+        int pathOffset = 0;
+
+        if (sscanf(line, "dba %63s %llu %llu %n", settings, &size, &time, &pathOffset) == 3 && pathOffset > 0)
+        {
+            pCurrentDBA = &m_dbas[ReadPath(line + pathOffset)];
+            pCurrentDBA->settings = settings;
+            pCurrentDBA->outputSize = size;
+            pCurrentDBA->outputTime = time;
+        }
+        else if (pCurrentDBA && sscanf(line, "caf %d %llu %llu %n", &skipDBA, &size, &time, &pathOffset) == 3 && pathOffset > 0)
+        {
+            Animation animation;
+            animation.path = ReadPath(line + pathOffset);
+            animation.skipDBA = skipDBA != 0;
+            animation.fileSize = size;
+            animation.fileTime = time;
+            pCurrentDBA->animations.push_back(animation);
+        }
+        else
+        {
+            bValid = false;
+        }
+    }
+
+    fclose(pFile);
+
+    if (!bValid)
+    {
+        RCLogWarning("Ignoring malformed DBA build manifest '%s', all DBAs will be rebuilt.", filename.c_str());
+        m_dbas.clear();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool DBABuildManifest::Save(const string& filename) const
+{
+    FILE* const pFile = fopen(filename.c_str(), "wt");
+    if (!pFile)
+    {
+        RCLogWarning("Failed to write DBA build manifest '%s', all DBAs will be rebuilt next time.", filename.c_str());
+        return false;
+    }
+
+    fprintf(pFile, "%s\n", s_manifestHeader);
+    for (DBAMap::const_iterator it = m_dbas.begin(); it != m_dbas.end(); ++it)
+    {
+        const DBA& dba = it->second;
+        fprintf(pFile, "dba %s %llu %llu %s\n", dba.settings.c_str(), (unsigned long long)dba.outputSize, (unsigned long long)dba.outputTime, it->first.c_str());
+        for (size_t i = 0; i < dba.animations.size(); ++i)
+        {
+            const Animation& animation = dba.animations[i];
+            fprintf(pFile, "caf %d %llu %llu %s\n", animation.skipDBA ? 1 : 0, (unsigned long long)animation.fileSize, (unsigned long long)animation.fileTime, animation.path.c_str());
+        }
+    }
+
+    const bool bOk = ferror(pFile) == 0;
+    fclose(pFile);
+    return bOk;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool DBABuildManifest::IsUpToDate(const string& dbaPath, const string& dbaInnerPath, const string& settings, const std::vector<Animation>& animations) const
+{
+    DBAMap::const_iterator it = m_dbas.find(dbaInnerPath);
+    if (it == m_dbas.end())
+    {
+        return false;
+    }
+
+    const DBA& dba = it->second;
+    if (dba.settings != settings || dba.animations != animations)
+    {
+        return false;
+    }
+
+    uint64 outputSize;
+    uint64 outputTime;
+    return GetOutputFileState(dbaPath, outputSize, outputTime) && outputSize == dba.outputSize && outputTime == dba.outputTime;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void DBABuildManifest::SetBuilt(const string& dbaPath, const string& dbaInnerPath, const string& settings, const std::vector<Animation>& animations)
+{
+    DBA dba;
+    if (!GetOutputFileState(dbaPath, dba.outputSize, dba.outputTime))
+    {
+        Remove(dbaInnerPath);
+        return;
+    }
+    dba.settings = settings;
+    dba.animations = animations;
+    m_dbas[dbaInnerPath] = dba;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void DBABuildManifest::Remove(const string& dbaInnerPath)
+{
+    m_dbas.erase(dbaInnerPath);
+}
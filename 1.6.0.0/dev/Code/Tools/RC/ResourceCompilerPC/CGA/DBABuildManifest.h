@@ -0,0 +1,82 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+// Original file Copyright Crytek GMBH or its affiliates, used under license.
+
+#ifndef CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_DBABUILDMANIFEST_H
+#define CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_DBABUILDMANIFEST_H
+#pragma once
+
+
+// DBABuildManifest remembers the compressed animations every DBA was built from,
+// so a database rebuild can keep DBAs whose animations didn't change.
+// It is stored next to DBATable in the target folder, one file per platform output.
+class DBABuildManifest
+{
+public:
+    struct Animation
+    {
+        string path;
+        bool skipDBA;
+        uint64 fileSize;
+        uint64 fileTime;
+
+        Animation()
+            : skipDBA(false)
+            , fileSize(0)
+            , fileTime(0)
+        {
+        }
+
+        bool operator==(const Animation& other) const
+        {
+            return fileSize == other.fileSize && fileTime == other.fileTime && skipDBA == other.skipDBA && path == other.path;
+        }
+    };
+
+    struct DBA
+    {
+        // output format settings the DBA was written with
+        string settings;
+        uint64 outputSize;
+        uint64 outputTime;
+        std::vector<Animation> animations;
+
+        DBA()
+            : outputSize(0)
+            , outputTime(0)
+        {
+        }
+    };
+
+    static uint64 GetFileTimeValue(const FILETIME& fileTime)
+    {
+        return ((uint64)fileTime.dwHighDateTime << 32) | fileTime.dwLowDateTime;
+    }
+
+    // Missing or malformed manifests are treated as empty, every DBA gets rebuilt then.
+    void Load(const string& filename);
+    bool Save(const string& filename) const;
+
+    // Returns true if dbaPath exists on disk as it was written from exactly these animations.
+    bool IsUpToDate(const string& dbaPath, const string& dbaInnerPath, const string& settings, const std::vector<Animation>& animations) const;
+
+    // Records the DBA which has just been written to dbaPath.
+    void SetBuilt(const string& dbaPath, const string& dbaInnerPath, const string& settings, const std::vector<Animation>& animations);
+
+    void Remove(const string& dbaInnerPath);
+
+private:
+    typedef std::map<string, DBA> DBAMap;
+    DBAMap m_dbas;
+};
+
+#endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_DBABUILDMANIFEST_H
@@ -872,6 +872,20 @@ bool GlobalAnimationHeaderCAF::SaveToChunkFile(IChunkFile* chunkFile, bool bigEn
     return true;
 }
 
+bool GlobalAnimationHeaderCAF::LoadFromHeaderChunk(const IChunkFile::ChunkDesc* chunk, const char* logFilename)
+{
+    // ReadGlobalAnimationHeader doesn't swap, headers written for the other endianness can't be read back
+    if (chunk->chunkType != ChunkType_GlobalAnimationHeaderCAF || chunk->bSwapEndian)
+    {
+        return false;
+    }
+
+    m_arrController.clear();
+    m_FootPlantBits.clear();
+
+    return ReadGlobalAnimationHeader(chunk, eCAFLoadCompressedOnly, logFilename);
+}
+
 void GlobalAnimationHeaderCAF::ExtractMotionParameters(MotionParams905* mp, bool bigEndianOutput) const
 {
     SEndiannessSwapper swap(bigEndianOutput);
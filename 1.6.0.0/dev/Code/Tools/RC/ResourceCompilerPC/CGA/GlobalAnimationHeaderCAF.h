@@ -106,6 +106,8 @@ struct GlobalAnimationHeaderCAF
 
     bool LoadCAF(const string& filename, ECAFLoadMode loadMethod, CChunkFile* chunkFile = 0);
     bool SaveToChunkFile(IChunkFile* file, bool bigEndianOutput) const;
+    // Reads back a header chunk written by SaveToChunkFile, e.g. from Animations.img. Controllers are not part of it.
+    bool LoadFromHeaderChunk(const IChunkFile::ChunkDesc* chunk, const char* logFilename);
     void ExtractMotionParameters(MotionParams905* mp, bool bigEndianOutput) const;
 
     const char* GetFilePath() const {   return m_FilePath.c_str(); };
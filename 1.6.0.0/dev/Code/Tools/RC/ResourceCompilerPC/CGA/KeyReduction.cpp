@@ -0,0 +1,389 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+// Original file Copyright Crytek GMBH or its affiliates, used under license.
+
+#include "stdafx.h"
+#include "KeyReduction.h"
+
+#include <emmintrin.h>
+#include <float.h>
+
+namespace KeyReduction
+{
+    namespace
+    {
+        // The SSE evaluation interpolates with a different operation order than Quat::SetNlerp()/Vec3::SetLerp(), so
+        // its errors can be off by a few ulp. Keys which are closer than this to the tolerance are checked exactly.
+        const float kRotationMargin = 1e-5f;
+        const float kPositionMarginScale = 1e-5f;
+
+        // Key components laid out for unaligned 4-wide loads, padded so that loads past the last key stay inside
+        struct ComponentArrays
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<float> w;
+
+            void Resize(size_t count)
+            {
+                x.resize(count + 4, 0.0f);
+                y.resize(count + 4, 0.0f);
+                z.resize(count + 4, 0.0f);
+                w.resize(count + 4, 0.0f);
+            }
+        };
+
+        inline int GetValidLanesMask(uint32 i, uint32 count)
+        {
+            const uint32 lanes = Util::getMin(count - i, 4u);
+            return (1 << lanes) - 1;
+        }
+
+        // Checks keys first + 1 .. first + count - 1 against the span between the quantized keys first and first + count.
+        // 'worst' is the offset of the key which came closest to failing the previous span, it's tested first and updated.
+        bool RotationSpanPasses(
+            const std::vector<Quat>& keys,
+            const std::vector<Quat>& quantized,
+            const ComponentArrays& components,
+            uint32 first,
+            uint32 count,
+            float cosOfHalfMaxAngle,
+            uint32& worst)
+        {
+            const Quat& p = quantized[first];
+            const Quat& q = quantized[first + count];
+            Quat interpolated;
+
+            if (worst > 0 && worst < count)
+            {
+                interpolated.SetNlerp(p, q, worst / (float)count);
+                if (error_quatCos(interpolated, keys[first + worst], cosOfHalfMaxAngle))
+                {
+                    return false;
+                }
+            }
+
+            // SetNlerp() interpolates towards -q if the quaternions are in opposite hemispheres
+            const float sign = (p | q) < 0 ? -1.0f : 1.0f;
+
+            const __m128 px = _mm_set1_ps(p.v.x);
+            const __m128 py = _mm_set1_ps(p.v.y);
+            const __m128 pz = _mm_set1_ps(p.v.z);
+            const __m128 pw = _mm_set1_ps(p.w);
+            const __m128 qx = _mm_set1_ps(q.v.x * sign);
+            const __m128 qy = _mm_set1_ps(q.v.y * sign);
+            const __m128 qz = _mm_set1_ps(q.v.z * sign);
+            const __m128 qw = _mm_set1_ps(q.w * sign);
+
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 passLimit = _mm_set1_ps(cosOfHalfMaxAngle + kRotationMargin);
+            const __m128 countVec = _mm_set1_ps((float)count);
+            const __m128 four = _mm_set1_ps(4.0f);
+            __m128 index = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+
+            float closestCos = FLT_MAX;
+            uint32 closest = worst;
+
+            for (uint32 i = 1; i < count; i += 4, index = _mm_add_ps(index, four))
+            {
+                const __m128 t = _mm_div_ps(index, countVec);
+                const __m128 s = _mm_sub_ps(one, t);
+
+                const __m128 ix = _mm_add_ps(_mm_mul_ps(px, s), _mm_mul_ps(qx, t));
+                const __m128 iy = _mm_add_ps(_mm_mul_ps(py, s), _mm_mul_ps(qy, t));
+                const __m128 iz = _mm_add_ps(_mm_mul_ps(pz, s), _mm_mul_ps(qz, t));
+                const __m128 iw = _mm_add_ps(_mm_mul_ps(pw, s), _mm_mul_ps(qw, t));
+
+                const uint32 k = first + i;
+                const __m128 kx = _mm_loadu_ps(&components.x[k]);
+                const __m128 ky = _mm_loadu_ps(&components.y[k]);
+                const __m128 kz = _mm_loadu_ps(&components.z[k]);
+                const __m128 kw = _mm_loadu_ps(&components.w[k]);
+
+                const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ix, ix), _mm_mul_ps(iy, iy)), _mm_add_ps(_mm_mul_ps(iz, iz), _mm_mul_ps(iw, iw)));
+                const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ix, kx), _mm_mul_ps(iy, ky)), _mm_add_ps(_mm_mul_ps(iz, kz), _mm_mul_ps(iw, kw)));
+                const __m128 normalizedDot = _mm_div_ps(dot, _mm_sqrt_ps(lengthSquared));
+
+                // 1 - |(|dot| - 1)|, as in error_quatCos()
+                const __m128 cosOfHalfAngle = _mm_sub_ps(one, _mm_and_ps(absMask, _mm_sub_ps(_mm_and_ps(absMask, normalizedDot), one)));
+
+                const int validLanes = GetValidLanesMask(i, count);
+                const int uncertainLanes = validLanes & ~_mm_movemask_ps(_mm_cmpge_ps(cosOfHalfAngle, passLimit));
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if (uncertainLanes & (1 << lane))
+                    {
+                        interpolated.SetNlerp(p, q, (i + lane) / (float)count);
+                        if (error_quatCos(interpolated, keys[k + lane], cosOfHalfMaxAngle))
+                        {
+                            worst = i + lane;
+                            return false;
+                        }
+                    }
+                }
+
+                float cosines[4];
+                _mm_storeu_ps(cosines, cosOfHalfAngle);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if ((validLanes & (1 << lane)) && cosines[lane] < closestCos)
+                    {
+                        closestCos = cosines[lane];
+                        closest = i + lane;
+                    }
+                }
+            }
+
+            worst = closest;
+            return true;
+        }
+
+        bool PositionSpanPasses(
+            const std::vector<Vec3>& keys,
+            const std::vector<Vec3>& quantized,
+            const ComponentArrays& components,
+            uint32 first,
+            uint32 count,
+            float maxDistanceSquared,
+            float definitePassDistanceSquared,
+            uint32& worst)
+        {
+            const Vec3& p = quantized[first];
+            const Vec3& q = quantized[first + count];
+            Vec3 interpolated;
+
+            if (worst > 0 && worst < count)
+            {
+                interpolated.SetLerp(p, q, worst / (float)count);
+                if (error_vec3(interpolated, keys[first + worst], maxDistanceSquared))
+                {
+                    return false;
+                }
+            }
+
+            const __m128 px = _mm_set1_ps(p.x);
+            const __m128 py = _mm_set1_ps(p.y);
+            const __m128 pz = _mm_set1_ps(p.z);
+            const __m128 qx = _mm_set1_ps(q.x);
+            const __m128 qy = _mm_set1_ps(q.y);
+            const __m128 qz = _mm_set1_ps(q.z);
+
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 passLimit = _mm_set1_ps(definitePassDistanceSquared);
+            const __m128 countVec = _mm_set1_ps((float)count);
+            const __m128 four = _mm_set1_ps(4.0f);
+            __m128 index = _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f);
+
+            float farthestDistanceSquared = -1.0f;
+            uint32 farthest = worst;
+
+            for (uint32 i = 1; i < count; i += 4, index = _mm_add_ps(index, four))
+            {
+                const __m128 t = _mm_div_ps(index, countVec);
+                const __m128 s = _mm_sub_ps(one, t);
+
+                const uint32 k = first + i;
+                const __m128 dx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(px, s), _mm_mul_ps(qx, t)), _mm_loadu_ps(&components.x[k]));
+                const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(py, s), _mm_mul_ps(qy, t)), _mm_loadu_ps(&components.y[k]));
+                const __m128 dz = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(pz, s), _mm_mul_ps(qz, t)), _mm_loadu_ps(&components.z[k]));
+                const __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+                const int validLanes = GetValidLanesMask(i, count);
+                const int uncertainLanes = validLanes & ~_mm_movemask_ps(_mm_cmple_ps(distanceSquared, passLimit));
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if (uncertainLanes & (1 << lane))
+                    {
+                        interpolated.SetLerp(p, q, (i + lane) / (float)count);
+                        if (error_vec3(interpolated, keys[k + lane], maxDistanceSquared))
+                        {
+                            worst = i + lane;
+                            return false;
+                        }
+                    }
+                }
+
+                float distances[4];
+                _mm_storeu_ps(distances, distanceSquared);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if ((validLanes & (1 << lane)) && distances[lane] > farthestDistanceSquared)
+                    {
+                        farthestDistanceSquared = distances[lane];
+                        farthest = i + lane;
+                    }
+                }
+            }
+
+            worst = farthest;
+            return true;
+        }
+
+        template<class TSpanPasses>
+        void Reduce(uint32 numKeys, TSpanPasses spanPasses, std::vector<uint32>& keptKeys)
+        {
+            keptKeys.clear();
+
+            uint32 iFirstKey = 0;
+            keptKeys.push_back(iFirstKey);
+
+            while (iFirstKey + 2 < numKeys)
+            {
+                uint32 worst = 1;
+                uint32 iLastKey;
+                for (iLastKey = iFirstKey + 2; iLastKey < numKeys; ++iLastKey)
+                {
+                    if (!spanPasses(iFirstKey, iLastKey - iFirstKey, worst))
+                    {
+                        break;
+                    }
+                }
+
+                iFirstKey = iLastKey - 1;
+                keptKeys.push_back(iFirstKey);
+            }
+
+            for (++iFirstKey; iFirstKey < numKeys; ++iFirstKey)
+            {
+                keptKeys.push_back(iFirstKey);
+            }
+        }
+    }
+
+    void ReduceRotations(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, float cosOfHalfMaxAngle, std::vector<uint32>& keptKeys)
+    {
+        const uint32 numKeys = keys.size();
+        assert(quantized.size() == numKeys);
+
+        ComponentArrays components;
+        components.Resize(numKeys);
+        for (uint32 i = 0; i < numKeys; ++i)
+        {
+            components.x[i] = keys[i].v.x;
+            components.y[i] = keys[i].v.y;
+            components.z[i] = keys[i].v.z;
+            components.w[i] = keys[i].w;
+        }
+
+        Reduce(numKeys,
+            [&](uint32 first, uint32 count, uint32& worst)
+            {
+                return RotationSpanPasses(keys, quantized, components, first, count, cosOfHalfMaxAngle, worst);
+            },
+            keptKeys);
+    }
+
+    void ReducePositions(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, float maxDistanceSquared, std::vector<uint32>& keptKeys)
+    {
+        const uint32 numKeys = keys.size();
+        assert(quantized.size() == numKeys);
+
+        ComponentArrays components;
+        components.Resize(numKeys);
+        float maxAbsComponent = 0.0f;
+        for (uint32 i = 0; i < numKeys; ++i)
+        {
+            components.x[i] = keys[i].x;
+            components.y[i] = keys[i].y;
+            components.z[i] = keys[i].z;
+            maxAbsComponent = Util::getMax(maxAbsComponent, Util::getMax(fabsf(keys[i].x), fabsf(keys[i].y), fabsf(keys[i].z)));
+            maxAbsComponent = Util::getMax(maxAbsComponent, Util::getMax(fabsf(quantized[i].x), fabsf(quantized[i].y), fabsf(quantized[i].z)));
+        }
+
+        // rounding differences scale with the magnitude of the positions, not with the distances
+        const float margin = maxAbsComponent * kPositionMarginScale + FLT_MIN;
+        const float maxDistance = sqrtf(maxDistanceSquared);
+        const float definitePassDistanceSquared = maxDistance > margin ? (maxDistance - margin) * (maxDistance - margin) : -1.0f;
+
+        Reduce(numKeys,
+            [&](uint32 first, uint32 count, uint32& worst)
+            {
+                return PositionSpanPasses(keys, quantized, components, first, count, maxDistanceSquared, definitePassDistanceSquared, worst);
+            },
+            keptKeys);
+    }
+
+    void ReduceRotationsReference(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, float cosOfHalfMaxAngle, std::vector<uint32>& keptKeys)
+    {
+        Reduce(keys.size(),
+            [&](uint32 first, uint32 count, uint32&)
+            {
+                Quat interpolated;
+                for (uint32 i = 1; i < count; ++i)
+                {
+                    interpolated.SetNlerp(quantized[first], quantized[first + count], i / (float)count);
+                    if (error_quatCos(interpolated, keys[first + i], cosOfHalfMaxAngle))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            },
+            keptKeys);
+    }
+
+    void ReducePositionsReference(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, float maxDistanceSquared, std::vector<uint32>& keptKeys)
+    {
+        Reduce(keys.size(),
+            [&](uint32 first, uint32 count, uint32&)
+            {
+                Vec3 interpolated;
+                for (uint32 i = 1; i < count; ++i)
+                {
+                    interpolated.SetLerp(quantized[first], quantized[first + count], i / (float)count);
+                    if (error_vec3(interpolated, keys[first + i], maxDistanceSquared))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            },
+            keptKeys);
+    }
+
+    float MaxRotationError(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, const std::vector<uint32>& keptKeys)
+    {
+        float minCosOfHalfAngle = 1.0f;
+        Quat interpolated;
+        for (size_t k = 0; k + 1 < keptKeys.size(); ++k)
+        {
+            const uint32 first = keptKeys[k];
+            const uint32 count = keptKeys[k + 1] - first;
+            for (uint32 i = 0; i <= count; ++i)
+            {
+                interpolated.SetNlerp(quantized[first], quantized[first + count], i / (float)count);
+                const float cosOfHalfAngle = 1 - fabsf(fabsf(interpolated | keys[first + i]) - 1);
+                minCosOfHalfAngle = Util::getMin(minCosOfHalfAngle, cosOfHalfAngle);
+            }
+        }
+        return 2.0f * acosf(Util::getClamped(minCosOfHalfAngle, -1.0f, 1.0f));
+    }
+
+    float MaxPositionError(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, const std::vector<uint32>& keptKeys)
+    {
+        float maxDistanceSquared = 0.0f;
+        Vec3 interpolated;
+        for (size_t k = 0; k + 1 < keptKeys.size(); ++k)
+        {
+            const uint32 first = keptKeys[k];
+            const uint32 count = keptKeys[k + 1] - first;
+            for (uint32 i = 0; i <= count; ++i)
+            {
+                interpolated.SetLerp(quantized[first], quantized[first + count], i / (float)count);
+                maxDistanceSquared = Util::getMax(maxDistanceSquared, (interpolated - keys[first + i]).GetLengthSquared());
+            }
+        }
+        return sqrtf(maxDistanceSquared);
+    }
+}
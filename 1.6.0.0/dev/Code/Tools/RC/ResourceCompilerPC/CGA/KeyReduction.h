@@ -0,0 +1,68 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+// Original file Copyright Crytek GMBH or its affiliates, used under license.
+
+#ifndef CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_KEYREDUCTION_H
+#define CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_KEYREDUCTION_H
+#pragma once
+
+
+// Returns true if angular difference between two quaternions is bigger than
+// the one specified by cosOfHalfMaxAngle.
+// cosOfHalfMaxAngle == cosf(maxAngleDifferenceInRadians * 0.5f)
+inline bool error_quatCos(const Quat& q1, const Quat& q2, const float cosOfHalfMaxAngle)
+{
+    //  const float cosOfHalfAngle = fabsf(q1.v.x * q2.v.x + q1.v.y * q2.v.y + q1.v.z * q2.v.z + q1.v.w * q1.v.w);
+    // Note about "1 - fabsf(" and "- 1)": q1 | q1 might return values > 1, so we map them to values < 1.
+    const float cosOfHalfAngle = 1 - fabsf(fabsf(q1 | q2) - 1);
+    return cosOfHalfAngle < cosOfHalfMaxAngle;
+}
+
+inline bool error_vec3(const Vec3& v1, const Vec3& v2, const float maxAllowedDistanceSquared)
+{
+    const float x = v1.x - v2.x;
+    const float y = v1.y - v2.y;
+    const float z = v1.z - v2.z;
+
+    const float distanceSquared = x * x + y * y + z * z;
+
+    return distanceSquared > maxAllowedDistanceSquared;
+}
+
+
+// Greedy key removal used by CCompressonator.
+// Starting at a kept key the span is extended one key at a time until one of the keys inside of it can't be
+// interpolated from the (quantized) span ends within tolerance anymore. The key before that becomes the next
+// kept key. The first and the last key are always kept.
+//
+// Whether a span passes isn't monotonic in its length, so the search can't skip span lengths without changing
+// the result. Instead each span is checked cheaply: the key which failed last time is tested first, and the
+// remaining keys are evaluated four at a time with SSE. Only keys whose SSE error is too close to the tolerance
+// to be sure about are re-checked with error_quatCos()/error_vec3(), so the kept keys are exactly the ones
+// of the straightforward implementation (see the *Reference functions).
+namespace KeyReduction
+{
+    // keys      - the source keys, errors are measured against them
+    // quantized - the keys as they will be stored, interpolation uses them
+    void ReduceRotations(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, float cosOfHalfMaxAngle, std::vector<uint32>& keptKeys);
+    void ReducePositions(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, float maxDistanceSquared, std::vector<uint32>& keptKeys);
+
+    // The original implementation, every span length re-checks every key in the span.
+    void ReduceRotationsReference(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, float cosOfHalfMaxAngle, std::vector<uint32>& keptKeys);
+    void ReducePositionsReference(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, float maxDistanceSquared, std::vector<uint32>& keptKeys);
+
+    // The largest error of any key when interpolating between the kept keys, as the angle in radians and as distance.
+    float MaxRotationError(const std::vector<Quat>& keys, const std::vector<Quat>& quantized, const std::vector<uint32>& keptKeys);
+    float MaxPositionError(const std::vector<Vec3>& keys, const std::vector<Vec3>& quantized, const std::vector<uint32>& keptKeys);
+}
+
+#endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CGA_KEYREDUCTION_H
@@ -597,7 +597,7 @@ static int32 AllocateTrackStorage(int32& offset, int32 size, bool bForInPlace)
     }
 }
 
-void CTrackStorage::SaveDataBase905(const char* name, bool bPrepareForInPlaceStream, int pointerSize)
+bool CTrackStorage::SaveDataBase905(const char* name, bool bPrepareForInPlaceStream, int pointerSize)
 {
     const bool bSwapEndian = (m_bBigEndianOutput ? (eEndianness_Big == eEndianness_NonNative) : (eEndianness_Big == eEndianness_Native));
 
@@ -1109,8 +1109,14 @@ void CTrackStorage::SaveDataBase905(const char* name, bool bPrepareForInPlaceStr
     if (!FileUtil::EnsureDirectoryExists(PathHelpers::GetDirectory(name).c_str()))
     {
         RCLogError("Failed creating directory for %s", name);
+        return false;
     }
 
     SetFileAttributes(name, FILE_ATTRIBUTE_ARCHIVE);
-    chunkFile.Write(name);
+    if (!chunkFile.Write(name))
+    {
+        RCLogError("Failed to write DBA %s: %s", name, chunkFile.GetLastError());
+        return false;
+    }
+    return true;
 }
@@ -119,7 +119,7 @@ public:
         return -1;
     }
 
-    void SaveDataBase905(const char* name, bool bPrepareForInPlaceStream, int pointerSize);
+    bool SaveDataBase905(const char* name, bool bPrepareForInPlaceStream, int pointerSize);
 
     const DBStatistics& GetStatistics()
     {
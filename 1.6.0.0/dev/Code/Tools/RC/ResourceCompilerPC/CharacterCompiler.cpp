@@ -29,6 +29,7 @@
 #include "IAttachment.h"
 #include "CGF\CGFNodeMerger.h"
 #include "RcFile.h"
+#include "MeshOptimizer.h"
 
 #include <iterator>
 
@@ -40,6 +41,7 @@ CharacterCompiler::CharacterCompiler(ICryXML* pXml)
     m_refCount = 1;
     m_pPhysicsInterface = NULL;
     m_bOptimizePVRStripify = false;
+    m_bOptimizeTriangleOrder = false;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -228,6 +230,7 @@ bool CharacterCompiler::ProcessWork(CLoaderCGF* cgfLoader, CContentCGF* pCGF, CC
 
     // Confetti: Nicholas Baldwin
     m_bOptimizePVRStripify = m_CC.config->GetAsInt("OptimizedPrimitiveType", 0, 0) == 1;
+    m_bOptimizeTriangleOrder = m_CC.config->GetAsInt("OptimizedPrimitiveType", 0, 0) == 2;
 
     bool bStorePositionsAsF16;
     {
@@ -712,6 +715,21 @@ CContentCGF* CharacterCompiler::MakeCompiledCGF(CContentCGF* pCGF)
                 delete pCompiledCGF;
                 return 0;
             }
+
+            if (m_bOptimizeTriangleOrder)
+            {
+                MeshOptimizer::VertexCacheStatistics statsBefore;
+                MeshOptimizer::VertexCacheStatistics statsAfter;
+                const MeshOptimizer::Settings settings;
+                MeshOptimizer::OptimizeMeshSubsets(*pNodeCGF->pMesh, settings, statsBefore, statsAfter);
+                if (m_CC.pRC->GetVerbosityLevel() > 1)
+                {
+                    RCLog("Vertex cache (%d entries) in node '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %u triangles",
+                        settings.cacheSize, pNodeCGF->name,
+                        statsBefore.GetACMR(), statsAfter.GetACMR(), statsBefore.GetATVR(), statsAfter.GetATVR(),
+                        statsAfter.triangleCount);
+                }
+            }
         }
 
         for (int i = 0, num = pCGF->GetNodeCount(); i < num; ++i)
@@ -153,6 +153,7 @@ private:
     int m_refCount;
     // Confetti: Nicholas Baldwin
     bool m_bOptimizePVRStripify;
+    bool m_bOptimizeTriangleOrder;
 };
 
 #endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_CHARACTERCOMPILER_H
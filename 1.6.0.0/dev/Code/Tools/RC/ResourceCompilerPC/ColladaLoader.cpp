@@ -45,6 +45,8 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>   // MAX_PATH
+#include <emmintrin.h>
+#include <ctime>
 
 
 namespace
@@ -250,9 +252,85 @@ namespace
     }
 }
 
+static const float s_floatPowersOfTen[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f };
+
+// Value of a "[-+]digits[.digits]" number with at most 9 digits on either side of the dot. The arithmetic is the
+// same as in the general path of read_float() so both give bit identical results.
+static inline float ComposeSimpleFloat(const char* intDigits, int intDigitCount, const char* fracDigits, int fracDigitCount, bool bNegative)
+{
+    int valInt = 0;
+    for (int i = 0; i < intDigitCount; ++i)
+    {
+        valInt = valInt * 10 + (intDigits[i] - '0');
+    }
+    int valFrac = 0;
+    for (int i = 0; i < fracDigitCount; ++i)
+    {
+        valFrac = valFrac * 10 + (fracDigits[i] - '0');
+    }
+
+    float value = (float)valInt;
+    if (valFrac)
+    {
+        value += (float)valFrac / s_floatPowersOfTen[fracDigitCount];
+    }
+    value *= bNegative ? -1.0f : 1.0f;
+    return value;
+}
+
+static inline bool IsDigit(char c)
+{
+    return unsigned(c - '0') < 10;
+}
+
+// Reads a simple number which needs no strtol()/strtod() call, returns false for anything else.
+bool ReadSimpleFloat(const char* buf, float& value, const char*& end)
+{
+    const char* p = buf;
+    const bool bNegative = (*p == '-');
+    if (*p == '-' || *p == '+')
+    {
+        ++p;
+    }
+    const char* const intDigits = p;
+    while (IsDigit(*p))
+    {
+        ++p;
+    }
+    const int intDigitCount = int(p - intDigits);
+    const char* fracDigits = p;
+    int fracDigitCount = 0;
+    if (*p == '.')
+    {
+        fracDigits = ++p;
+        while (IsDigit(*p))
+        {
+            ++p;
+        }
+        fracDigitCount = int(p - fracDigits);
+    }
+    if (intDigitCount + fracDigitCount == 0 || intDigitCount > 9 || fracDigitCount > 9 || (*p && !isspace(*p)))
+    {
+        return false;
+    }
+    value = ComposeSimpleFloat(intDigits, intDigitCount, fracDigits, fracDigitCount, bNegative);
+    end = p;
+    return true;
+}
+
 // float reader (same as std::strtod() but faster)
 float read_float(const char*& buf, char** endptr)
 {
+    {
+        float value;
+        const char* end;
+        if (ReadSimpleFloat(buf, value, end))
+        {
+            *endptr = (char*)end;
+            return value;
+        }
+    }
+
     const char* p;
     int count_num = 0;
     int count_dot = 0;
@@ -374,6 +452,41 @@ float read_float(const char*& buf, char** endptr)
     return value;
 }
 
+// int reader (same as int(std::strtol(buf, endptr, 0)) but faster)
+int read_int(const char* buf, char** endptr)
+{
+    const char* p = buf;
+    while (isspace(*p))
+    {
+        ++p;
+    }
+    const bool bNegative = (*p == '-');
+    if (*p == '-' || *p == '+')
+    {
+        ++p;
+    }
+    const char* const digits = p;
+    while (IsDigit(*p))
+    {
+        ++p;
+    }
+    const int digitCount = int(p - digits);
+
+    // Leading zeros select octal or hexadecimal, longer numbers may overflow
+    if (digitCount == 0 || digitCount > 9 || (digits[0] == '0' && (digitCount > 1 || *p == 'x' || *p == 'X')))
+    {
+        return int(std::strtol(buf, endptr, 0));
+    }
+
+    int value = 0;
+    for (int i = 0; i < digitCount; ++i)
+    {
+        value = value * 10 + (digits[i] - '0');
+    }
+    *endptr = (char*)p;
+    return bNegative ? -value : value;
+}
+
 static bool StringToInt(const string& str, int& value)
 {
     const char* cstr = str.c_str();
@@ -440,7 +553,7 @@ IntStream::IntStream(const char* text)
 int IntStream::Read()
 {
     char* end;
-    int value = int(std::strtol(this->position, &end, 0));
+    int value = read_int(this->position, &end);
     if (end == this->position)
     {
         return -1;
@@ -454,6 +567,278 @@ int IntStream::Read()
 
 //////////////////////////////////////////////////////////////////////////
 
+static inline int LowestSetBit(int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Finds the extent of the number at p by classifying 16 bytes at once. Sets sign, dot and length masks of the
+// number and returns false if it is longer than 15 characters or not followed by a whitespace or the terminator.
+// At least 16 bytes must be readable at p.
+static inline bool ClassifyNumber16(const char* p, int& digitMask, int& dotMask, int& length)
+{
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+    digitMask = _mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+                _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1))));
+    dotMask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('.')));
+    // Bytes up to and including ' ', which covers whitespace and the terminator
+    const int endMask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(' ')), chunk));
+    if (!endMask)
+    {
+        return false;
+    }
+    length = LowestSetBit(endMask);
+    return p[length] == 0 || isspace(p[length]);
+}
+
+// 16 bytes at a time counterpart of ReadSimpleFloat()
+bool ReadSimpleFloat16(const char*& p, float& value)
+{
+    int digitMask, dotMask, length;
+    if (!ClassifyNumber16(p, digitMask, dotMask, length))
+    {
+        return false;
+    }
+    const int signLength = (p[0] == '-' || p[0] == '+') ? 1 : 0;
+    const int bodyMask = ((1 << length) - 1) & ~((1 << signLength) - 1);
+    const int dots = dotMask & bodyMask;
+    if (((digitMask | dots) & bodyMask) != bodyMask || (dots & (dots - 1)))
+    {
+        return false;
+    }
+    const int dotPosition = dots ? LowestSetBit(dots) : length;
+    const int intDigitCount = dotPosition - signLength;
+    const int fracDigitCount = dots ? length - dotPosition - 1 : 0;
+    if (intDigitCount + fracDigitCount == 0 || intDigitCount > 9 || fracDigitCount > 9)
+    {
+        return false;
+    }
+    value = ComposeSimpleFloat(p + signLength, intDigitCount, p + dotPosition + 1, fracDigitCount, p[0] == '-');
+    p += length;
+    return true;
+}
+
+// 16 bytes at a time counterpart of read_int() for decimal numbers
+bool ReadSimpleInt16(const char*& p, int& value)
+{
+    int digitMask, dotMask, length;
+    if (!ClassifyNumber16(p, digitMask, dotMask, length))
+    {
+        return false;
+    }
+    const int signLength = (p[0] == '-' || p[0] == '+') ? 1 : 0;
+    const int bodyMask = ((1 << length) - 1) & ~((1 << signLength) - 1);
+    const int digitCount = length - signLength;
+    const char* const digits = p + signLength;
+    if ((digitMask & bodyMask) != bodyMask || digitCount == 0 || digitCount > 9 || (digits[0] == '0' && digitCount > 1))
+    {
+        return false;
+    }
+    int result = 0;
+    for (int i = 0; i < digitCount; ++i)
+    {
+        result = result * 10 + (digits[i] - '0');
+    }
+    value = (p[0] == '-') ? -result : result;
+    p += length;
+    return true;
+}
+
+// Same loop as ColladaArray::Parse() with the simple numbers taken care of by the 16 byte readers
+template <ColladaArrayType TypeCode, typename DataType>
+static bool ConvertNumbers(const char* p, std::vector<DataType>& values, bool (* readSimple)(const char*&, DataType&))
+{
+    for (;; )
+    {
+        while (isspace(*p))
+        {
+            p++;
+        }
+
+        if (*p == 0)
+        {
+            return true;
+        }
+
+        DataType value;
+        if (!readSimple(p, value))
+        {
+            bool success = true;
+            value = ArrayType<TypeCode>::Parse(p, success);
+            if (!success)
+            {
+                return false;
+            }
+        }
+        values.push_back(value);
+    }
+}
+
+ColladaArrayStreamer::ColladaArrayStreamer()
+    : m_pNode(0)
+    , m_type(TYPE_FLOAT)
+    , m_bFailed(false)
+    , m_textLength(0)
+    , m_arrayCount(0)
+    , m_textSize(0)
+    , m_peakTextSize(0)
+    , m_convertedSize(0)
+{
+}
+
+ColladaArrayStreamer::~ColladaArrayStreamer()
+{
+    for (std::map<IXmlNode*, IColladaArray*>::iterator it = m_arrays.begin(); it != m_arrays.end(); ++it)
+    {
+        delete (*it).second;
+    }
+}
+
+bool ColladaArrayStreamer::WantsContent(const char* tag)
+{
+    return strcmp(tag, "float_array") == 0 || strcmp(tag, "int_array") == 0;
+}
+
+void ColladaArrayStreamer::BeginArray(IXmlNode* node)
+{
+    m_pNode = node;
+    m_type = (strcmp(node->getTag(), "float_array") == 0) ? TYPE_FLOAT : TYPE_INT;
+    m_bFailed = false;
+    m_floats.clear();
+    m_ints.clear();
+    m_textLength = 0;
+
+    // The count attribute is only a hint, do not let a bogus one allocate huge buffers up front
+    static const int maxReservedCount = 1 << 24;
+    int count = 0;
+    if (node->getAttr("count", count) && count > 0)
+    {
+        const size_t reservedCount = size_t(count < maxReservedCount ? count : maxReservedCount);
+        if (m_type == TYPE_FLOAT)
+        {
+            m_floats.reserve(reservedCount);
+        }
+        else
+        {
+            m_ints.reserve(reservedCount);
+        }
+    }
+}
+
+void ColladaArrayStreamer::OnContent(IXmlNode* node, const char* data, int len)
+{
+    if (node != m_pNode)
+    {
+        BeginArray(node);
+    }
+    m_textSize += len;
+    if (m_bFailed || len <= 0)
+    {
+        return;
+    }
+
+    static const size_t padding = 16;
+    m_text.resize(m_textLength);
+    m_text.insert(m_text.end(), data, data + len);
+    m_textLength = m_text.size();
+    m_text.resize(m_textLength + padding, 0);
+    if (m_textLength > m_peakTextSize)
+    {
+        m_peakTextSize = m_textLength;
+    }
+
+    // Everything up to the last whitespace can be converted, the rest may be a number which continues in the
+    // next piece
+    size_t textEnd = m_textLength;
+    while (textEnd > 0 && !isspace(m_text[textEnd - 1]))
+    {
+        --textEnd;
+    }
+    if (textEnd > 0)
+    {
+        ConvertText(textEnd - 1);
+        m_text.erase(m_text.begin(), m_text.begin() + textEnd);
+        m_textLength -= textEnd;
+    }
+}
+
+void ColladaArrayStreamer::ConvertText(size_t textEnd)
+{
+    m_text[textEnd] = 0;
+    const bool bConverted = (m_type == TYPE_FLOAT)
+        ? ConvertNumbers<TYPE_FLOAT>(&m_text[0], m_floats, &ReadSimpleFloat16)
+        : ConvertNumbers<TYPE_INT>(&m_text[0], m_ints, &ReadSimpleInt16);
+    if (!bConverted)
+    {
+        m_bFailed = true;
+    }
+}
+
+void ColladaArrayStreamer::OnContentEnd(IXmlNode* node)
+{
+    if (node != m_pNode)
+    {
+        // No text at all, which is an empty array
+        BeginArray(node);
+    }
+
+    if (!m_bFailed && m_textLength > 0)
+    {
+        ConvertText(m_textLength);
+    }
+
+    IColladaArray* pArray = 0;
+    if (!m_bFailed)
+    {
+        if (m_type == TYPE_FLOAT)
+        {
+            ColladaFloatArray* const pFloatArray = new ColladaFloatArray();
+            pFloatArray->Swap(m_floats);
+            m_convertedSize += pFloatArray->GetSize() * sizeof(float);
+            pArray = pFloatArray;
+        }
+        else
+        {
+            ColladaIntArray* const pIntArray = new ColladaIntArray();
+            pIntArray->Swap(m_ints);
+            m_convertedSize += pIntArray->GetSize() * sizeof(int);
+            pArray = pIntArray;
+        }
+        ++m_arrayCount;
+    }
+
+    // Nodes stay alive as long as the document, so the first result for a node is the only one
+    if (!m_arrays.insert(std::make_pair(node, pArray)).second)
+    {
+        delete pArray;
+    }
+
+    m_pNode = 0;
+    m_textLength = 0;
+    m_text.clear();
+}
+
+bool ColladaArrayStreamer::TakeArray(IXmlNode* node, IColladaArray*& pArray)
+{
+    std::map<IXmlNode*, IColladaArray*>::iterator it = m_arrays.find(node);
+    if (it == m_arrays.end())
+    {
+        return false;
+    }
+    pArray = (*it).second;
+    m_arrays.erase(it);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 static string TidyCAFName(const string& filename)
 {
     string copy;
@@ -472,7 +857,8 @@ static string TidyCAFName(const string& filename)
 
 bool ColladaLoaderImpl::Load(std::vector<ExportFile>& exportFiles, std::vector<sMaterialLibrary>& materialLibraryList, const char* szFileName, ICryXML* pCryXML, IPakSystem* pPakSystem, IColladaLoaderListener* pListener)
 {
-    XmlNodeRef root = this->LoadXML(szFileName, pPakSystem, pCryXML, pListener);
+    ColladaArrayStreamer arrayStreamer;
+    XmlNodeRef root = this->LoadXML(szFileName, arrayStreamer, pPakSystem, pCryXML, pListener);
     if (root == 0)
     {
         return false;
@@ -519,7 +905,7 @@ bool ColladaLoaderImpl::Load(std::vector<ExportFile>& exportFiles, std::vector<s
     }
 
     ArrayMap arrays;
-    if (!this->ParseArrays(arrays, tagMap, pListener))
+    if (!this->ParseArrays(arrays, arrayStreamer, tagMap, pListener))
     {
         return false;
     }
@@ -905,9 +1291,10 @@ void ColladaLoaderImpl::EnsureRootHasIdentityTransform(CContentCGF* cgf, ICollad
     }
 }
 
-XmlNodeRef ColladaLoaderImpl::LoadXML(const char* szFileName, IPakSystem* pPakSystem, ICryXML* pCryXML, IColladaLoaderListener* pListener)
+XmlNodeRef ColladaLoaderImpl::LoadXML(const char* szFileName, ColladaArrayStreamer& arrayStreamer, IPakSystem* pPakSystem, ICryXML* pCryXML, IColladaLoaderListener* pListener)
 {
     ReportInfo(pListener, "Loading XML...");
+    const clock_t loadStartTime = clock();
 
     // Get the xml serializer.
     IXMLSerializer* pSerializer = pCryXML->GetXMLSerializer();
@@ -918,7 +1305,8 @@ XmlNodeRef ColladaLoaderImpl::LoadXML(const char* szFileName, IPakSystem* pPakSy
         const bool bRemoveNonessentialSpacesFromContent = false;
         char szErrorBuffer[1024];
         szErrorBuffer[0] = 0;
-        root = pSerializer->Read(PakXmlFileBufferSource(pPakSystem, szFileName), bRemoveNonessentialSpacesFromContent, sizeof(szErrorBuffer), szErrorBuffer);
+        // Numeric arrays are converted while reading, so their text never has to be held by the document
+        root = pSerializer->Read(PakXmlFileBufferSource(pPakSystem, szFileName), &arrayStreamer, bRemoveNonessentialSpacesFromContent, sizeof(szErrorBuffer), szErrorBuffer);
         if (!root)
         {
             const char* const pErrorStr =
@@ -930,7 +1318,13 @@ XmlNodeRef ColladaLoaderImpl::LoadXML(const char* szFileName, IPakSystem* pPakSy
         }
     }
 
-    ReportInfo(pListener, "Finished loading XML.\n");
+    static const float megabyte = 1024 * 1024;
+    ReportInfo(pListener, "Finished loading XML in %.2f seconds. Converted %d arrays from %.1fMb of text to %.1fMb of values, peak unconverted text %.1fKb.\n",
+        float(clock() - loadStartTime) / CLOCKS_PER_SEC,
+        arrayStreamer.GetArrayCount(),
+        arrayStreamer.GetTextSize() / megabyte,
+        arrayStreamer.GetConvertedSize() / megabyte,
+        arrayStreamer.GetPeakTextSize() / 1024.0f);
 
     return root;
 }
@@ -1058,7 +1452,7 @@ bool ColladaLoaderImpl::ParseElementIdsAndTags(XmlNodeRef node, std::map<string,
 }
 
 
-bool ColladaLoaderImpl::ParseArrays(ArrayMap& arrays, const TagMultimap& tagMap, IColladaLoaderListener* pListener)
+bool ColladaLoaderImpl::ParseArrays(ArrayMap& arrays, ColladaArrayStreamer& arrayStreamer, const TagMultimap& tagMap, IColladaLoaderListener* pListener)
 {
     // Create a list of node tags that indicate arrays.
     std::pair<string, ColladaArrayType> typeList[] = {
@@ -1082,7 +1476,7 @@ bool ColladaLoaderImpl::ParseArrays(ArrayMap& arrays, const TagMultimap& tagMap,
             XmlNodeRef node = (*itNodeEntry).second;
             if (node->haveAttr("id"))
             {
-                IColladaArray* pArray = this->ParseArray(node, type, pListener);
+                IColladaArray* pArray = this->ParseArray(node, type, arrayStreamer, pListener);
                 if (pArray)
                 {
                     arrays.insert(std::make_pair(node->getAttr("id"), pArray));
@@ -1122,9 +1516,19 @@ static IColladaArray* CreateColladaArray(ColladaArrayType type)
     }
 }
 
-IColladaArray* ColladaLoaderImpl::ParseArray(XmlNodeRef node, ColladaArrayType type, IColladaLoaderListener* pListener)
+IColladaArray* ColladaLoaderImpl::ParseArray(XmlNodeRef node, ColladaArrayType type, ColladaArrayStreamer& arrayStreamer, IColladaLoaderListener* pListener)
 {
-    IColladaArray* pArray = CreateColladaArray(type);
+    IColladaArray* pArray = 0;
+    if (arrayStreamer.TakeArray(node, pArray))
+    {
+        if (!pArray)
+        {
+            ReportError(pListener, LINE_LOG " '%s' contains invalid data.", node->getLine(), node->getTag());
+        }
+        return pArray;
+    }
+
+    pArray = CreateColladaArray(type);
     if (!pArray->Parse(node->getContent(), pListener))
     {
         delete pArray;
@@ -18,6 +18,7 @@
 
 #include "CGFContent.h"
 #include "../../CryXML/ICryXML.h"
+#include "../../CryXML/IXMLSerializer.h"
 #include "IXml.h"
 #include "Export/HelperData.h"
 #include "Export/MeshUtils.h"
@@ -111,6 +112,18 @@ void ReportError(IColladaLoaderListener* pListener, const char* szFormat, ...);
 // float reader (same as std::strtod() but faster)
 float read_float(const char*& buf, char** endptr);
 
+// int reader (same as int(std::strtol(buf, endptr, 0)) but faster)
+int read_int(const char* buf, char** endptr);
+
+// Reads a "[-+]digits[.digits]" number with at most 9 digits on either side of the dot, returns false for anything
+// else. The result is bit identical to read_float().
+bool ReadSimpleFloat(const char* buf, float& value, const char*& end);
+
+// 16 bytes at a time counterparts of ReadSimpleFloat() and of read_int() for decimal numbers, used on the array
+// text ColladaArrayStreamer converts. At least 16 bytes must be readable at p, which is advanced past the number.
+bool ReadSimpleFloat16(const char*& p, float& value);
+bool ReadSimpleInt16(const char*& p, int& value);
+
 template <typename T>
 class ResourceMap
     : public std::map<string, T*>
@@ -197,7 +210,7 @@ public:
     static int Parse(const char*& buf, bool& success)
     {
         char* end;
-        int value = int(std::strtol(buf, &end, 0));
+        int value = read_int(buf, &end);
         if (end == buf)
         {
             success = false;
@@ -479,6 +492,12 @@ public:
         return int(this->data.size());
     }
 
+    // Takes over the values, values receives the previous content of the array.
+    void Swap(std::vector<DataType>& values)
+    {
+        this->data.swap(values);
+    }
+
 private:
     std::vector<DataType> data;
 };
@@ -510,6 +529,51 @@ private:
     const char* position;
 };
 
+// Converts the text of float_array and int_array elements into typed arrays while the document is being read.
+// The text is converted piece by piece as the parser delivers it, so it never becomes node content and at most one
+// partial number per array is held on to.
+class ColladaArrayStreamer
+    : public IXmlContentHandler
+{
+public:
+    ColladaArrayStreamer();
+    ~ColladaArrayStreamer();
+
+    virtual bool WantsContent(const char* tag);
+    virtual void OnContent(IXmlNode* node, const char* data, int len);
+    virtual void OnContentEnd(IXmlNode* node);
+
+    // Returns false if the node was not streamed. Otherwise ownership of the array passes to the caller, pArray is
+    // 0 if the node contained invalid data.
+    bool TakeArray(IXmlNode* node, IColladaArray*& pArray);
+
+    int GetArrayCount() const { return m_arrayCount; }
+    size_t GetTextSize() const { return m_textSize; }
+    size_t GetPeakTextSize() const { return m_peakTextSize; }
+    size_t GetConvertedSize() const { return m_convertedSize; }
+
+private:
+    void BeginArray(IXmlNode* node);
+    // Converts the text before textEnd, which must be a whitespace or the end of the text
+    void ConvertText(size_t textEnd);
+
+    std::map<IXmlNode*, IColladaArray*> m_arrays;
+
+    IXmlNode* m_pNode;
+    ColladaArrayType m_type;
+    bool m_bFailed;
+    std::vector<float> m_floats;
+    std::vector<int> m_ints;
+    // Text not converted yet, followed by zero padding so numbers can be classified 16 bytes at a time
+    std::vector<char> m_text;
+    size_t m_textLength;
+
+    int m_arrayCount;
+    size_t m_textSize;
+    size_t m_peakTextSize;
+    size_t m_convertedSize;
+};
+
 struct ColladaColor
 {
     ColladaColor()
@@ -1314,7 +1378,7 @@ public:
     bool Load(std::vector<ExportFile>& exportFiles, std::vector<sMaterialLibrary>& materialLibraryList, const char* szFileName, ICryXML* pCryXML, IPakSystem* pPakSystem, IColladaLoaderListener* pListener);
 
 private:
-    XmlNodeRef LoadXML(const char* szFileName, IPakSystem* pPakSystem, ICryXML* pCryXML, IColladaLoaderListener* pListener);
+    XmlNodeRef LoadXML(const char* szFileName, ColladaArrayStreamer& arrayStreamer, IPakSystem* pPakSystem, ICryXML* pCryXML, IColladaLoaderListener* pListener);
 
     bool ParseColladaVector(XmlNodeRef node, Vec2& param, IColladaLoaderListener* pListener);
     bool ParseColladaVector(XmlNodeRef node, Vec3& param, IColladaLoaderListener* pListener);
@@ -1337,8 +1401,8 @@ private:
     bool ParseMaterials(MaterialMap& materials, const EffectMap& effects, const TagMultimap& tagMap, IColladaLoaderListener* pListener);
     ColladaMaterial* ParseMaterial(XmlNodeRef node, const EffectMap& effects, IColladaLoaderListener* pListener);
 
-    bool ParseArrays(ArrayMap& arrays, const TagMultimap& tagMap, IColladaLoaderListener* pListener);
-    IColladaArray* ParseArray(XmlNodeRef node, ColladaArrayType type, IColladaLoaderListener* pListener);
+    bool ParseArrays(ArrayMap& arrays, ColladaArrayStreamer& arrayStreamer, const TagMultimap& tagMap, IColladaLoaderListener* pListener);
+    IColladaArray* ParseArray(XmlNodeRef node, ColladaArrayType type, ColladaArrayStreamer& arrayStreamer, IColladaLoaderListener* pListener);
 
     bool ParseDataSources(DataSourceMap& sources, const ArrayMap& arrays, const TagMultimap& tagMap, IColladaLoaderListener* pListener);
     ColladaDataSource* ParseDataSource(XmlNodeRef node, const ArrayMap& arrays, IColladaLoaderListener* pListener);
@@ -0,0 +1,500 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#include "stdafx.h"
+#include "MeshOptimizer.h"
+#include <IIndexedMesh.h>
+#include <algorithm>
+
+namespace MeshOptimizer
+{
+    namespace
+    {
+        // Vertex -> triangles adjacency in compressed rows
+        struct VertexTriangles
+        {
+            std::vector<uint32> offsets;
+            std::vector<uint32> triangles;
+
+            void Build(const uint32* indices, size_t indexCount, size_t vertexCount)
+            {
+                offsets.assign(vertexCount + 1, 0);
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    ++offsets[indices[i] + 1];
+                }
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    offsets[v + 1] += offsets[v];
+                }
+
+                triangles.resize(indexCount);
+                std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    triangles[fill[indices[i]]++] = uint32(i / 3);
+                }
+            }
+        };
+
+        // FIFO cache simulation: a vertex is in the cache if it was added less than cacheSize misses ago.
+        // Timestamps start far enough apart that a fresh cache holds nothing.
+        class FifoCache
+        {
+        public:
+            FifoCache(size_t vertexCount, int cacheSize)
+                : m_timestamps(vertexCount, 0)
+                , m_cacheSize(uint32(cacheSize))
+                , m_time(uint32(cacheSize) + 1)
+            {
+            }
+
+            // Returns true if the vertex had to be transformed
+            bool Access(uint32 vertex)
+            {
+                if (m_time - m_timestamps[vertex] > m_cacheSize)
+                {
+                    m_timestamps[vertex] = m_time++;
+                    return true;
+                }
+                return false;
+            }
+
+            void Flush()
+            {
+                m_time += m_cacheSize + 1;
+            }
+
+        private:
+            std::vector<uint32> m_timestamps;
+            uint32 m_cacheSize;
+            uint32 m_time;
+        };
+
+        struct Cluster
+        {
+            uint32 firstTriangle;
+            uint32 triangleCount;
+            float sortKey;
+        };
+
+        struct ClusterSortGreater
+        {
+            bool operator()(const Cluster& a, const Cluster& b) const
+            {
+                return a.sortKey > b.sortKey;
+            }
+        };
+
+        Vec3 TriangleCross(const uint32* triangle, const Vec3* positions)
+        {
+            const Vec3& p0 = positions[triangle[0]];
+            return (positions[triangle[1]] - p0).Cross(positions[triangle[2]] - p0);
+        }
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(const uint32* indices, size_t indexCount, size_t vertexCount, int cacheSize)
+    {
+        VertexCacheStatistics result;
+        result.triangleCount = uint32(indexCount / 3);
+
+        FifoCache cache(vertexCount, cacheSize);
+        std::vector<bool> referenced(vertexCount, false);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            const uint32 vertex = indices[i];
+            if (cache.Access(vertex))
+            {
+                ++result.transformCount;
+            }
+            if (!referenced[vertex])
+            {
+                referenced[vertex] = true;
+                ++result.vertexCount;
+            }
+        }
+        return result;
+    }
+
+    void OptimizeVertexCache(uint32* indices, size_t indexCount, size_t vertexCount, int cacheSize, std::vector<uint32>& clusterStarts)
+    {
+        clusterStarts.clear();
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        VertexTriangles adjacency;
+        adjacency.Build(indices, triangleCount * 3, vertexCount);
+
+        std::vector<uint32> liveTriangles(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+        }
+
+        std::vector<uint32> cacheTimestamps(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32> deadEnds;
+        std::vector<uint32> candidates;
+        std::vector<uint32> result;
+        result.reserve(triangleCount * 3);
+
+        const uint32 cacheSize32 = uint32(cacheSize);
+        uint32 time = cacheSize32 + 1;
+        size_t cursor = 0;
+
+        // Next vertex with triangles left: the most recent dead end, otherwise the next one in input order
+        struct DeadEndSkipper
+        {
+            static int Skip(const std::vector<uint32>& live, std::vector<uint32>& deadEnds, size_t& cursor)
+            {
+                while (!deadEnds.empty())
+                {
+                    const uint32 vertex = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (live[vertex] > 0)
+                    {
+                        return int(vertex);
+                    }
+                }
+                for (; cursor < live.size(); ++cursor)
+                {
+                    if (live[cursor] > 0)
+                    {
+                        return int(cursor);
+                    }
+                }
+                return -1;
+            }
+        };
+
+        int fanVertex = DeadEndSkipper::Skip(liveTriangles, deadEnds, cursor);
+        clusterStarts.push_back(0);
+        while (fanVertex >= 0)
+        {
+            // Emit all remaining triangles around the fanning vertex
+            candidates.clear();
+            for (uint32 a = adjacency.offsets[fanVertex], aEnd = adjacency.offsets[fanVertex + 1]; a < aEnd; ++a)
+            {
+                const uint32 triangle = adjacency.triangles[a];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+                emitted[triangle] = true;
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32 vertex = indices[triangle * 3 + corner];
+                    result.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --liveTriangles[vertex];
+                    if (time - cacheTimestamps[vertex] > cacheSize32)
+                    {
+                        cacheTimestamps[vertex] = time++;
+                    }
+                }
+            }
+
+            // Prefer the candidate that stays in the cache while its remaining triangles are emitted and
+            // entered it the longest time ago
+            int nextVertex = -1;
+            int bestPriority = -1;
+            for (size_t c = 0; c < candidates.size(); ++c)
+            {
+                const uint32 vertex = candidates[c];
+                if (liveTriangles[vertex] == 0)
+                {
+                    continue;
+                }
+                int priority = 0;
+                const uint32 age = time - cacheTimestamps[vertex];
+                if (age + 2 * liveTriangles[vertex] <= cacheSize32)
+                {
+                    priority = int(age);
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    nextVertex = int(vertex);
+                }
+            }
+
+            if (nextVertex < 0)
+            {
+                nextVertex = DeadEndSkipper::Skip(liveTriangles, deadEnds, cursor);
+                if (nextVertex >= 0)
+                {
+                    clusterStarts.push_back(uint32(result.size() / 3));
+                }
+            }
+            fanVertex = nextVertex;
+        }
+
+        assert(result.size() == triangleCount * 3);
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    void OptimizeOverdraw(uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, int cacheSize, float threshold, const std::vector<uint32>& clusterStarts)
+    {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || clusterStarts.empty())
+        {
+            return;
+        }
+
+        const float meshACMR = AnalyzeVertexCache(indices, triangleCount * 3, vertexCount, cacheSize).GetACMR();
+
+        // Split each cluster as soon as its own ACMR is within threshold of the whole range
+        std::vector<Cluster> clusters;
+        {
+            FifoCache cache(vertexCount, cacheSize);
+            for (size_t c = 0; c < clusterStarts.size(); ++c)
+            {
+                const uint32 start = clusterStarts[c];
+                const uint32 end = (c + 1 < clusterStarts.size()) ? clusterStarts[c + 1] : uint32(triangleCount);
+
+                Cluster cluster;
+                cluster.firstTriangle = start;
+                cluster.triangleCount = 0;
+                cluster.sortKey = 0.0f;
+                uint32 misses = 0;
+                cache.Flush();
+                for (uint32 t = start; t < end; ++t)
+                {
+                    for (int corner = 0; corner < 3; ++corner)
+                    {
+                        misses += cache.Access(indices[t * 3 + corner]) ? 1 : 0;
+                    }
+                    ++cluster.triangleCount;
+
+                    if (t + 1 < end && float(misses) <= threshold * meshACMR * cluster.triangleCount)
+                    {
+                        clusters.push_back(cluster);
+                        cluster.firstTriangle = t + 1;
+                        cluster.triangleCount = 0;
+                        misses = 0;
+                        cache.Flush();
+                    }
+                }
+                clusters.push_back(cluster);
+            }
+        }
+
+        // Clusters far out along their own normal are likely to occlude the others, draw them first
+        Vec3 meshCentroid(0.0f, 0.0f, 0.0f);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+        {
+            meshCentroid += positions[indices[i]];
+        }
+        meshCentroid /= float(triangleCount * 3);
+
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            Cluster& cluster = clusters[c];
+            Vec3 centroid(0.0f, 0.0f, 0.0f);
+            Vec3 normal(0.0f, 0.0f, 0.0f);
+            float area = 0.0f;
+            for (uint32 t = cluster.firstTriangle, tEnd = cluster.firstTriangle + cluster.triangleCount; t < tEnd; ++t)
+            {
+                const uint32* triangle = &indices[t * 3];
+                const Vec3 cross = TriangleCross(triangle, positions);
+                const float triangleArea = cross.GetLength();
+                centroid += (positions[triangle[0]] + positions[triangle[1]] + positions[triangle[2]]) * (triangleArea / 3.0f);
+                normal += cross;
+                area += triangleArea;
+            }
+            const float normalLength = normal.GetLength();
+            if (area > 0.0f && normalLength > 0.0f)
+            {
+                centroid /= area;
+                cluster.sortKey = (centroid - meshCentroid).Dot(normal / normalLength);
+            }
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), ClusterSortGreater());
+
+        std::vector<uint32> result;
+        result.reserve(triangleCount * 3);
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            const uint32* first = &indices[clusters[c].firstTriangle * 3];
+            result.insert(result.end(), first, first + clusters[c].triangleCount * 3);
+        }
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    void OptimizeTriangleOrder(uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, const Settings& settings)
+    {
+        std::vector<uint32> clusterStarts;
+        OptimizeVertexCache(indices, indexCount, vertexCount, settings.cacheSize, clusterStarts);
+        if (settings.overdrawThreshold > 0.0f && positions)
+        {
+            OptimizeOverdraw(indices, indexCount, positions, vertexCount, settings.cacheSize, settings.overdrawThreshold, clusterStarts);
+        }
+    }
+
+    void BuildMeshlets(Meshlets& meshlets, const uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, int maxVertices, int maxTriangles)
+    {
+        assert(maxVertices >= 3 && maxVertices <= 256 && maxTriangles >= 1);
+        std::vector<uint8> localIndices(vertexCount, 0);
+        std::vector<bool> inMeshlet(vertexCount, false);
+
+        Meshlet meshlet;
+        meshlet.vertexOffset = uint32(meshlets.vertices.size());
+        meshlet.triangleOffset = uint32(meshlets.triangles.size() / 3);
+        meshlet.vertexCount = 0;
+        meshlet.triangleCount = 0;
+
+        struct Finisher
+        {
+            static void Finish(Meshlets& meshlets, Meshlet& meshlet, std::vector<bool>& inMeshlet, const Vec3* positions)
+            {
+                const uint32* vertices = &meshlets.vertices[meshlet.vertexOffset];
+                const uint8* triangles = &meshlets.triangles[meshlet.triangleOffset * 3];
+
+                Vec3 boxMin = positions[vertices[0]];
+                Vec3 boxMax = boxMin;
+                for (uint32 v = 0; v < meshlet.vertexCount; ++v)
+                {
+                    const Vec3& p = positions[vertices[v]];
+                    boxMin.Set(std::min(boxMin.x, p.x), std::min(boxMin.y, p.y), std::min(boxMin.z, p.z));
+                    boxMax.Set(std::max(boxMax.x, p.x), std::max(boxMax.y, p.y), std::max(boxMax.z, p.z));
+                    inMeshlet[vertices[v]] = false;
+                }
+                meshlet.center = (boxMin + boxMax) * 0.5f;
+                float radiusSquared = 0.0f;
+                for (uint32 v = 0; v < meshlet.vertexCount; ++v)
+                {
+                    radiusSquared = std::max(radiusSquared, (positions[vertices[v]] - meshlet.center).GetLengthSquared());
+                }
+                meshlet.radius = sqrtf(radiusSquared);
+
+                // Normal cone from the unit normals of the non-degenerate triangles
+                std::vector<Vec3> normals;
+                normals.reserve(meshlet.triangleCount);
+                Vec3 axis(0.0f, 0.0f, 0.0f);
+                for (uint32 t = 0; t < meshlet.triangleCount; ++t)
+                {
+                    const uint32 triangle[3] = { vertices[triangles[t * 3]], vertices[triangles[t * 3 + 1]], vertices[triangles[t * 3 + 2]] };
+                    const Vec3 cross = TriangleCross(triangle, positions);
+                    const float length = cross.GetLength();
+                    if (length > 0.0f)
+                    {
+                        normals.push_back(cross / length);
+                        axis += normals.back();
+                    }
+                }
+                const float axisLength = axis.GetLength();
+                meshlet.coneAxis.Set(0.0f, 0.0f, 0.0f);
+                meshlet.coneCutoff = 1.0f;
+                if (!normals.empty() && axisLength > 0.0f)
+                {
+                    axis /= axisLength;
+                    float cutoff = 1.0f;
+                    for (size_t n = 0; n < normals.size(); ++n)
+                    {
+                        cutoff = std::min(cutoff, axis.Dot(normals[n]));
+                    }
+                    if (cutoff > 0.0f)
+                    {
+                        meshlet.coneAxis = axis;
+                        meshlet.coneCutoff = cutoff;
+                    }
+                }
+
+                meshlets.meshlets.push_back(meshlet);
+                meshlet.vertexOffset = uint32(meshlets.vertices.size());
+                meshlet.triangleOffset = uint32(meshlets.triangles.size() / 3);
+                meshlet.vertexCount = 0;
+                meshlet.triangleCount = 0;
+            }
+        };
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            const uint32* triangle = &indices[i];
+            int newVertices = 0;
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                newVertices += inMeshlet[triangle[corner]] ? 0 : 1;
+            }
+            // Repeated vertices within the triangle are counted twice, which only makes the check conservative
+            if (meshlet.vertexCount + newVertices > uint32(maxVertices) || meshlet.triangleCount + 1 > uint32(maxTriangles))
+            {
+                Finisher::Finish(meshlets, meshlet, inMeshlet, positions);
+            }
+
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const uint32 vertex = triangle[corner];
+                if (!inMeshlet[vertex])
+                {
+                    inMeshlet[vertex] = true;
+                    localIndices[vertex] = uint8(meshlet.vertexCount++);
+                    meshlets.vertices.push_back(vertex);
+                }
+                meshlets.triangles.push_back(localIndices[vertex]);
+            }
+            ++meshlet.triangleCount;
+        }
+
+        if (meshlet.triangleCount > 0)
+        {
+            Finisher::Finish(meshlets, meshlet, inMeshlet, positions);
+        }
+    }
+
+    void OptimizeMeshSubsets(CMesh& mesh, const Settings& settings, VertexCacheStatistics& statsBefore, VertexCacheStatistics& statsAfter)
+    {
+        std::vector<uint32> indices;
+        for (int nSubset = 0; nSubset < mesh.GetSubSetCount(); ++nSubset)
+        {
+            const SMeshSubset& subset = mesh.m_subsets[nSubset];
+            if (subset.nNumIndices < 3)
+            {
+                continue;
+            }
+
+            // work on the vertex range the subset uses, not on the whole vertex buffer
+            vtx_idx* const pIndices = mesh.m_pIndices + subset.nFirstIndexId;
+            uint32 firstVertex = pIndices[0];
+            uint32 lastVertex = pIndices[0];
+            for (int i = 1; i < subset.nNumIndices; ++i)
+            {
+                firstVertex = std::min(firstVertex, uint32(pIndices[i]));
+                lastVertex = std::max(lastVertex, uint32(pIndices[i]));
+            }
+            const size_t vertexCount = lastVertex - firstVertex + 1;
+
+            indices.resize(subset.nNumIndices);
+            for (int i = 0; i < subset.nNumIndices; ++i)
+            {
+                indices[i] = uint32(pIndices[i]) - firstVertex;
+            }
+
+            // meshes with 16 bit positions have no float positions to sort clusters by
+            const Vec3* const positions = mesh.m_pPositions ? mesh.m_pPositions + firstVertex : 0;
+
+            statsBefore.Add(AnalyzeVertexCache(&indices[0], indices.size(), vertexCount, settings.cacheSize));
+            OptimizeTriangleOrder(&indices[0], indices.size(), positions, vertexCount, settings);
+            statsAfter.Add(AnalyzeVertexCache(&indices[0], indices.size(), vertexCount, settings.cacheSize));
+
+            for (int i = 0; i < subset.nNumIndices; ++i)
+            {
+                pIndices[i] = vtx_idx(indices[i] + firstVertex);
+            }
+        }
+    }
+}
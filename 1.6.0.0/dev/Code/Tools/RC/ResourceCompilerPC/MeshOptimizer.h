@@ -0,0 +1,122 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#ifndef CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_MESHOPTIMIZER_H
+#define CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_MESHOPTIMIZER_H
+#pragma once
+
+#include <vector>
+#include "BaseTypes.h"     // uint8, uint32
+#include "Cry_Vector3.h"   // Vec3
+
+class CMesh;
+
+// Triangle list optimizations for the GPU vertex pipeline.
+// The functions work on one index range that is drawn with a single call, e.g. a material subset. Indices refer to
+// a vertex buffer of vertexCount vertices which may be shared with other ranges, so unreferenced vertices are fine.
+//
+// Triangle order is produced with Tipsify (Sander, Nehab, Barczak: "Fast Triangle Reordering for Vertex Locality
+// and Reduced Overdraw", 2007). The clusters it produces are then sorted so triangles facing outwards from the
+// center of the mesh are drawn first, which lowers overdraw without giving up much of the cache efficiency.
+namespace MeshOptimizer
+{
+    struct Settings
+    {
+        Settings()
+            : cacheSize(16)
+            , overdrawThreshold(1.05f)
+        {
+        }
+
+        // Size of the FIFO post-transform cache which is optimized for and simulated for the statistics
+        int cacheSize;
+        // Clusters may have an ACMR of up to overdrawThreshold times the one of the cache optimized order,
+        // smaller clusters sort better. Zero skips overdraw ordering.
+        float overdrawThreshold;
+    };
+
+    struct VertexCacheStatistics
+    {
+        VertexCacheStatistics()
+            : triangleCount(0)
+            , vertexCount(0)
+            , transformCount(0)
+        {
+        }
+
+        void Add(const VertexCacheStatistics& other)
+        {
+            triangleCount += other.triangleCount;
+            vertexCount += other.vertexCount;
+            transformCount += other.transformCount;
+        }
+
+        // Average cache miss ratio, vertex shader invocations per triangle (0.5 is ideal for large grids)
+        float GetACMR() const { return triangleCount ? float(transformCount) / triangleCount : 0.0f; }
+        // Average transform to vertex ratio, vertex shader invocations per referenced vertex (1 is ideal)
+        float GetATVR() const { return vertexCount ? float(transformCount) / vertexCount : 0.0f; }
+
+        uint32 triangleCount;
+        uint32 vertexCount;     // distinct vertices referenced
+        uint32 transformCount;
+    };
+
+    struct Meshlet
+    {
+        uint32 vertexOffset;    // into Meshlets::vertices
+        uint32 triangleOffset;  // into Meshlets::triangles, in triangles
+        uint32 vertexCount;
+        uint32 triangleCount;
+
+        // Bounding sphere of the vertices
+        Vec3 center;
+        float radius;
+        // Every triangle normal is within acos(coneCutoff) of coneAxis. All triangles face away from a camera for
+        // which the angle between coneAxis and (center - camera) plus asin(radius / distance) is less than
+        // 90 degrees minus that. coneCutoff is 1 if the normals are spread too wide for the test to be useful.
+        Vec3 coneAxis;
+        float coneCutoff;
+    };
+
+    struct Meshlets
+    {
+        std::vector<Meshlet> meshlets;
+        // Vertex buffer indices used by the meshlets
+        std::vector<uint32> vertices;
+        // Three local vertex indices per triangle, relative to the meshlet's vertexOffset
+        std::vector<uint8> triangles;
+    };
+
+    // Simulates a FIFO post-transform cache of cacheSize entries, which starts out empty
+    VertexCacheStatistics AnalyzeVertexCache(const uint32* indices, size_t indexCount, size_t vertexCount, int cacheSize);
+
+    // Reorders the triangles for the post-transform cache.
+    // clusterStarts receives the first triangle of each run which Tipsify started at a dead end.
+    void OptimizeVertexCache(uint32* indices, size_t indexCount, size_t vertexCount, int cacheSize, std::vector<uint32>& clusterStarts);
+
+    // Splits the clusters further while they stay within threshold of the cache efficiency of the whole range,
+    // then reorders them to reduce overdraw
+    void OptimizeOverdraw(uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, int cacheSize, float threshold, const std::vector<uint32>& clusterStarts);
+
+    // OptimizeVertexCache() followed by OptimizeOverdraw() as configured by settings
+    void OptimizeTriangleOrder(uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, const Settings& settings);
+
+    // Groups the triangles, in order, into meshlets of at most maxVertices (up to 256) vertices and maxTriangles
+    // triangles and appends them to meshlets
+    void BuildMeshlets(Meshlets& meshlets, const uint32* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, int maxVertices, int maxTriangles);
+
+    // OptimizeTriangleOrder() on every subset of a mesh compiled by the mesh compiler. Subset ranges and the vertex
+    // order stay as they are. The statistics of all subsets before and after are added to statsBefore/statsAfter.
+    void OptimizeMeshSubsets(CMesh& mesh, const Settings& settings, VertexCacheStatistics& statsBefore, VertexCacheStatistics& statsAfter);
+}
+
+#endif // CRYINCLUDE_TOOLS_RC_RESOURCECOMPILERPC_MESHOPTIMIZER_H
@@ -157,7 +157,8 @@ void __stdcall RegisterConvertors(IResourceCompiler* const pRC)
     //    add option for outputting triangle strip mesh primitives for processors that prefer them.
     pRC->RegisterKey("OptimizedPrimitiveType", "[CGF/CHR] Choose the preferred optimized mesh primitive type\n"
         "0 = Forsyth Indexed Triangle Lists Algorithm (default)\n"
-        "1 = PowerVR Indexed Triangle Strips Lists Algorithm");
+        "1 = PowerVR Indexed Triangle Strips Lists Algorithm\n"
+        "2 = Forsyth, then Tipsify triangle order with overdraw-aware clusters per subset (logs ACMR/ATVR)");
     pRC->RegisterKey("ComputeSubsetTexelDensity", "[CGF] Compute per-subset texel density");
     pRC->RegisterKey("SplitLODs", "[CGF] Auto split LODs into the separate files");
 
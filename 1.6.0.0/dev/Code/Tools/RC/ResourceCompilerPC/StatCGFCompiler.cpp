@@ -762,6 +762,7 @@ bool CStatCGFCompiler::Process()
         const bool bCompactVertexStreams = m_CC.config->GetAsBool("CompactVertexStreams", false, true);
         // Confetti: Nicholas Baldwin
         const bool bOptimizePVRStripify = m_CC.config->GetAsInt("OptimizedPrimitiveType", 0, 0) == 1;
+        const bool bOptimizeTriangleOrder = m_CC.config->GetAsInt("OptimizedPrimitiveType", 0, 0) == 2;
         const bool bComputeSubsetTexelDensity = m_CC.config->GetAsBool("ComputeSubsetTexelDensity", false, true);
         const bool bSplitLods = m_CC.config->GetAsBool("SplitLODs", false, true);
 
@@ -924,6 +925,7 @@ bool CStatCGFCompiler::Process()
         statCgfCompiler.SetSplitLods(bSplitLods);
         // Confetti: Nicholas Baldwin
         statCgfCompiler.SetOptimizeStripify(bOptimizePVRStripify);
+        statCgfCompiler.SetOptimizeTriangleOrder(bOptimizeTriangleOrder);
 
         if (m_CC.pRC->GetVerbosityLevel() > 2)
         {
@@ -15,6 +15,7 @@
 #include "StaticObjectCompiler.h"
 #include "StatCGFPhysicalize.h"
 #include "../../CryEngine/Cry3DEngine/MeshCompiler/MeshCompiler.h"
+#include "MeshOptimizer.h"
 #include "CGF\CGFNodeMerger.h"
 #include "StringHelpers.h"
 #include "Util.h"
@@ -126,6 +127,7 @@ CStaticObjectCompiler::CStaticObjectCompiler(CPhysicsInterface* pPhysicsInterfac
     , m_bConsole(bConsole)
     , m_logVerbosityLevel(logVerbosityLevel)
     , m_bOptimizePVRStripify(false)
+    , m_bOptimizeTriangleOrder(false)
 {
     m_bSplitLODs = false;
     m_bOwnLod0 = false;
@@ -161,6 +163,12 @@ void CStaticObjectCompiler::SetOptimizeStripify(bool bStripify)
     m_bOptimizePVRStripify = bStripify;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CStaticObjectCompiler::SetOptimizeTriangleOrder(bool bOptimize)
+{
+    m_bOptimizeTriangleOrder = bOptimize;
+}
+
 //////////////////////////////////////////////////////////////////////////
 CContentCGF* CStaticObjectCompiler::MakeCompiledCGF(CContentCGF* pCGF, bool const forceRecompile)
 {
@@ -430,6 +438,21 @@ bool CStaticObjectCompiler::CompileMeshes(CContentCGF* pCGF)
                 RCLogError("Failed to compile geometry in node '%s' in file %s - %s", pNodeCGF->name, pCGF->GetFilename(), meshCompiler.GetLastError());
                 return false;
             }
+
+            if (m_bOptimizeTriangleOrder && !pNodeCGF->bPhysicsProxy)
+            {
+                MeshOptimizer::VertexCacheStatistics statsBefore;
+                MeshOptimizer::VertexCacheStatistics statsAfter;
+                const MeshOptimizer::Settings settings;
+                MeshOptimizer::OptimizeMeshSubsets(*pNodeCGF->pMesh, settings, statsBefore, statsAfter);
+                if (m_logVerbosityLevel > 1)
+                {
+                    RCLog("Vertex cache (%d entries) in node '%s': ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %u triangles",
+                        settings.cacheSize, pNodeCGF->name,
+                        statsBefore.GetACMR(), statsAfter.GetACMR(), statsBefore.GetATVR(), statsAfter.GetATVR(),
+                        statsAfter.triangleCount);
+                }
+            }
         }
     }
     return true;
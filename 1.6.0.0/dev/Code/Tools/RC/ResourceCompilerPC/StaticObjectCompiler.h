@@ -32,6 +32,8 @@ public:
     void SetSplitLods(bool bSplit);
     // Confetti: Nicholas Baldwin
     void SetOptimizeStripify(bool bStripify);
+    // reorders the triangles of every render mesh subset with MeshOptimizer after the mesh compiler
+    void SetOptimizeTriangleOrder(bool bOptimize);
     void SetUseMikkTB(bool bUseMikkTB);
 
     CContentCGF* MakeCompiledCGF(CContentCGF* pCGF, bool const forceRecompile = false);
@@ -67,6 +69,7 @@ private:
     bool m_bUseMikkTB;
     // Confetti: Nicholas Baldwin
     bool m_bOptimizePVRStripify;
+    bool m_bOptimizeTriangleOrder;
 
 public:
     enum
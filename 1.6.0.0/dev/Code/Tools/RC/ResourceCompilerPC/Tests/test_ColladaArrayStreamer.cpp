@@ -0,0 +1,234 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "stdafx.h"
+#include <AzTest/AzTest.h>
+
+#include "../../CryXML/ICryXML.h"
+#include "../../CryXML/IXMLSerializer.h"
+#include "ColladaLoader.h"
+
+namespace
+{
+    // hands the text to the parser at most chunkSize bytes at a time, so numbers get split between reads
+    class ChunkedXmlBufferSource
+        : public IXmlBufferSource
+    {
+    public:
+        ChunkedXmlBufferSource(const std::string& text, int chunkSize)
+            : m_text(text)
+            , m_chunkSize(chunkSize)
+            , m_position(0)
+        {
+        }
+
+        virtual int Read(void* buffer, int size) const
+        {
+            const int count = std::min(std::min(size, m_chunkSize), int(m_text.size() - m_position));
+            memcpy(buffer, m_text.data() + m_position, count);
+            m_position += count;
+            return count;
+        }
+
+    private:
+        const std::string& m_text;
+        const int m_chunkSize;
+        mutable size_t m_position;
+    };
+
+    ICryXML* LoadICryXML()
+    {
+        HMODULE hXMLLibrary = CryLoadLibrary("CryXML.dll");
+        if (hXMLLibrary == NULL)
+        {
+            return nullptr;
+        }
+        FnGetICryXML pfnGetICryXML = (FnGetICryXML)CryGetProcAddress(hXMLLibrary, "GetICryXML");
+        return pfnGetICryXML ? pfnGetICryXML() : nullptr;
+    }
+
+    const int s_chunkSizes[] = { 1, 2, 3, 7, 16, 4096 };
+}
+
+class ColladaArrayStreamerTest
+    : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_pCryXML = LoadICryXML();
+        ASSERT_NE(nullptr, m_pCryXML) << "CryXML.dll must be next to the test module";
+    }
+
+    XmlNodeRef Parse(const std::string& text, int chunkSize, ColladaArrayStreamer& streamer)
+    {
+        char szErrorBuffer[1024];
+        szErrorBuffer[0] = 0;
+        XmlNodeRef root = m_pCryXML->GetXMLSerializer()->Read(ChunkedXmlBufferSource(text, chunkSize), &streamer, false, sizeof(szErrorBuffer), szErrorBuffer);
+        EXPECT_TRUE(root) << szErrorBuffer;
+        return root;
+    }
+
+    ICryXML* m_pCryXML;
+};
+
+TEST_F(ColladaArrayStreamerTest, SplitNumbers_ReadLikeWholeText)
+{
+    const char* const floatText = "1.5 -2.25\n\t0.125 3e2 -1234567.1234567 .5 7 +0.000001 98765.4321 -0.0";
+    const char* const intText = "10 -20\n 0x1F 0 123456789 -7 010";
+    const std::string document = std::string("<COLLADA><float_array count=\"10\">") + floatText
+        + "</float_array><p>1 2 3</p><int_array count=\"7\">" + intText + "</int_array></COLLADA>";
+
+    std::vector<float> expectedFloats;
+    for (const char* p = floatText; *p; )
+    {
+        char* end;
+        expectedFloats.push_back(float(strtod(p, &end)));
+        for (p = end; isspace(*p); ++p)
+        {
+        }
+    }
+    std::vector<int> expectedInts;
+    for (const char* p = intText; *p; )
+    {
+        char* end;
+        expectedInts.push_back(int(strtol(p, &end, 0)));
+        for (p = end; isspace(*p); ++p)
+        {
+        }
+    }
+
+    std::vector<float> wholeFloats;
+    for (int chunkSize : s_chunkSizes)
+    {
+        ColladaArrayStreamer streamer;
+        XmlNodeRef root = Parse(document, chunkSize, streamer);
+        ASSERT_TRUE(root);
+        ASSERT_EQ(3, root->getChildCount());
+        EXPECT_EQ(2, streamer.GetArrayCount()) << chunkSize;
+        EXPECT_EQ(strlen(floatText) + strlen(intText), streamer.GetTextSize()) << chunkSize;
+
+        // the text is consumed by the streamer, other elements keep theirs
+        XmlNodeRef floatNode = root->getChild(0);
+        EXPECT_STREQ("", floatNode->getContent());
+        EXPECT_STREQ("1 2 3", root->getChild(1)->getContent());
+        IColladaArray* pArray = nullptr;
+        EXPECT_FALSE(streamer.TakeArray(root->getChild(1), pArray));
+
+        ASSERT_TRUE(streamer.TakeArray(floatNode, pArray));
+        ASSERT_NE(nullptr, pArray);
+        std::vector<float> floats;
+        EXPECT_TRUE(pArray->ReadAsFloat(floats, 1, 0, nullptr));
+        delete pArray;
+        ASSERT_EQ(expectedFloats.size(), floats.size()) << chunkSize;
+        for (size_t i = 0; i < floats.size(); ++i)
+        {
+            EXPECT_FLOAT_EQ(expectedFloats[i], floats[i]) << chunkSize << " " << i;
+        }
+
+        // where the text was split makes no difference at all
+        if (wholeFloats.empty())
+        {
+            wholeFloats = floats;
+        }
+        EXPECT_EQ(0, memcmp(wholeFloats.data(), floats.data(), floats.size() * sizeof(float))) << chunkSize;
+
+        ASSERT_TRUE(streamer.TakeArray(root->getChild(2), pArray));
+        ASSERT_NE(nullptr, pArray);
+        std::vector<int> ints;
+        EXPECT_TRUE(pArray->ReadAsInt(ints, 1, 0, nullptr));
+        delete pArray;
+        EXPECT_EQ(expectedInts, ints) << chunkSize;
+
+        // an array can only be taken once
+        EXPECT_FALSE(streamer.TakeArray(floatNode, pArray));
+    }
+}
+
+TEST_F(ColladaArrayStreamerTest, EmptyArrays_AreValid)
+{
+    const std::string document =
+        "<COLLADA>"
+        "<float_array count=\"0\"/>"
+        "<float_array count=\"3\"></float_array>"
+        "<int_array count=\"0\"> \n\t </int_array>"
+        "<float_array count=\"1000000000\">2.5</float_array>"
+        "</COLLADA>";
+
+    for (int chunkSize : s_chunkSizes)
+    {
+        ColladaArrayStreamer streamer;
+        XmlNodeRef root = Parse(document, chunkSize, streamer);
+        ASSERT_TRUE(root);
+        ASSERT_EQ(4, root->getChildCount());
+        EXPECT_EQ(4, streamer.GetArrayCount()) << chunkSize;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            IColladaArray* pArray = nullptr;
+            ASSERT_TRUE(streamer.TakeArray(root->getChild(i), pArray)) << chunkSize << " " << i;
+            ASSERT_NE(nullptr, pArray) << chunkSize << " " << i;
+            EXPECT_EQ(0, pArray->GetSize()) << chunkSize << " " << i;
+            delete pArray;
+        }
+
+        // a bogus count is only a hint
+        IColladaArray* pArray = nullptr;
+        ASSERT_TRUE(streamer.TakeArray(root->getChild(3), pArray));
+        ASSERT_NE(nullptr, pArray);
+        std::vector<float> floats;
+        EXPECT_TRUE(pArray->ReadAsFloat(floats, 1, 0, nullptr));
+        delete pArray;
+        ASSERT_EQ(1u, floats.size());
+        EXPECT_EQ(2.5f, floats[0]);
+    }
+}
+
+TEST_F(ColladaArrayStreamerTest, InvalidTokens_FailOnlyTheirArray)
+{
+    const std::string document =
+        "<COLLADA>"
+        "<float_array>1 2 zz 3</float_array>"
+        "<int_array>1 2.5 3</int_array>"
+        "<float_array>1.5 2,5</float_array>"
+        "<int_array>4 x</int_array>"
+        "<float_array>4 5.25 6</float_array>"
+        "</COLLADA>";
+
+    for (int chunkSize : s_chunkSizes)
+    {
+        ColladaArrayStreamer streamer;
+        XmlNodeRef root = Parse(document, chunkSize, streamer);
+        ASSERT_TRUE(root);
+        ASSERT_EQ(5, root->getChildCount());
+        EXPECT_EQ(1, streamer.GetArrayCount()) << chunkSize;
+
+        // a streamed node without an array holds invalid data
+        for (int i = 0; i < 4; ++i)
+        {
+            IColladaArray* pArray = reinterpret_cast<IColladaArray*>(1);
+            ASSERT_TRUE(streamer.TakeArray(root->getChild(i), pArray)) << chunkSize << " " << i;
+            EXPECT_EQ(nullptr, pArray) << chunkSize << " " << i;
+        }
+
+        // a failed array doesn't affect the arrays after it
+        IColladaArray* pArray = nullptr;
+        ASSERT_TRUE(streamer.TakeArray(root->getChild(4), pArray));
+        ASSERT_NE(nullptr, pArray);
+        std::vector<float> floats;
+        EXPECT_TRUE(pArray->ReadAsFloat(floats, 1, 0, nullptr));
+        delete pArray;
+        ASSERT_EQ(3u, floats.size());
+        EXPECT_EQ(4.0f, floats[0]);
+        EXPECT_EQ(5.25f, floats[1]);
+        EXPECT_EQ(6.0f, floats[2]);
+    }
+}
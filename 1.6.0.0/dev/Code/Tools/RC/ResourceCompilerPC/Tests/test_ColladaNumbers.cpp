@@ -0,0 +1,263 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "stdafx.h"
+#include <AzTest/AzTest.h>
+
+#include "ColladaLoader.h"
+
+namespace
+{
+    // the 16 byte readers may look at 16 bytes from the number on, the streamer pads its text with zeros the same way
+    class PaddedText
+    {
+    public:
+        explicit PaddedText(const char* text, size_t offset = 0)
+            : m_buffer(offset + strlen(text) + 16, 0)
+        {
+            memcpy(&m_buffer[offset], text, strlen(text));
+            m_start = &m_buffer[offset];
+        }
+
+        const char* Get() const { return m_start; }
+
+    private:
+        std::vector<char> m_buffer;
+        const char* m_start;
+    };
+
+    uint32 FloatBits(float value)
+    {
+        uint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // reads text with all float readers, checks the simple readers agree bit for bit and that every reader matches
+    // strtod() up to rounding, returns the value
+    float ReadFloatAllWays(const char* text, size_t expectedLength)
+    {
+        const PaddedText padded(text);
+
+        char* strtodEnd = nullptr;
+        const float expected = float(strtod(padded.Get(), &strtodEnd));
+        EXPECT_EQ(expectedLength, size_t(strtodEnd - padded.Get())) << text;
+
+        float simple = 0.0f;
+        const char* simpleEnd = nullptr;
+        EXPECT_TRUE(ReadSimpleFloat(padded.Get(), simple, simpleEnd)) << text;
+        EXPECT_EQ(expectedLength, size_t(simpleEnd - padded.Get())) << text;
+
+        const char* p16 = padded.Get();
+        float simple16 = 0.0f;
+        EXPECT_TRUE(ReadSimpleFloat16(p16, simple16)) << text;
+        EXPECT_EQ(expectedLength, size_t(p16 - padded.Get())) << text;
+
+        const char* general = padded.Get();
+        char* generalEnd = nullptr;
+        const float generalValue = read_float(general, &generalEnd);
+        EXPECT_EQ(expectedLength, size_t(generalEnd - padded.Get())) << text;
+
+        EXPECT_EQ(FloatBits(simple), FloatBits(simple16)) << text;
+        EXPECT_FLOAT_EQ(expected, simple) << text;
+        EXPECT_FLOAT_EQ(expected, generalValue) << text;
+        return simple;
+    }
+}
+
+TEST(ColladaNumbersTest, SimpleFloats_AllReadersAgree)
+{
+    EXPECT_FLOAT_EQ(0.0f, ReadFloatAllWays("0", 1));
+    EXPECT_FLOAT_EQ(1.5f, ReadFloatAllWays("1.5", 3));
+    EXPECT_FLOAT_EQ(0.25f, ReadFloatAllWays(".25", 3));
+    EXPECT_FLOAT_EQ(7.0f, ReadFloatAllWays("7.", 2));
+    EXPECT_FLOAT_EQ(123456789.0f, ReadFloatAllWays("123456789", 9));
+    EXPECT_FLOAT_EQ(0.123456789f, ReadFloatAllWays("0.123456789", 11));
+    EXPECT_FLOAT_EQ(float(strtod("98765.4321", nullptr)), ReadFloatAllWays("98765.4321", 10));
+}
+
+TEST(ColladaNumbersTest, SimpleFloats_Signs)
+{
+    EXPECT_FLOAT_EQ(-2.75f, ReadFloatAllWays("-2.75", 5));
+    EXPECT_FLOAT_EQ(2.75f, ReadFloatAllWays("+2.75", 5));
+    EXPECT_FLOAT_EQ(-0.5f, ReadFloatAllWays("-.5", 3));
+
+    // negative zero keeps its sign like strtod() does
+    EXPECT_EQ(FloatBits(-0.0f), FloatBits(ReadFloatAllWays("-0.0", 4)));
+
+    float value;
+    const char* end;
+    const PaddedText signOnly("-");
+    EXPECT_FALSE(ReadSimpleFloat(signOnly.Get(), value, end));
+    const char* p = signOnly.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+
+    const PaddedText doubleSign("--1");
+    EXPECT_FALSE(ReadSimpleFloat(doubleSign.Get(), value, end));
+    p = doubleSign.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+}
+
+TEST(ColladaNumbersTest, Exponents_FallBackToStrtod)
+{
+    const char* const texts[] = { "1e3", "-2.5E-2", "6.02e+23", "1.#INF", "nan" };
+    for (const char* text : texts)
+    {
+        const PaddedText padded(text);
+
+        float value;
+        const char* end;
+        EXPECT_FALSE(ReadSimpleFloat(padded.Get(), value, end)) << text;
+        const char* p = padded.Get();
+        EXPECT_FALSE(ReadSimpleFloat16(p, value)) << text;
+        EXPECT_EQ(padded.Get(), p) << text;
+    }
+
+    const char* text = "-2.5E-2";
+    char* end = nullptr;
+    EXPECT_FLOAT_EQ(-0.025f, read_float(text, &end));
+    EXPECT_EQ(text + strlen(text), end);
+}
+
+TEST(ColladaNumbersTest, TooManyDigits_FallBack)
+{
+    float value;
+    const char* end;
+    const PaddedText longInt("1234567890");
+    EXPECT_FALSE(ReadSimpleFloat(longInt.Get(), value, end));
+    const char* p = longInt.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+
+    const PaddedText longFrac("0.1234567890");
+    EXPECT_FALSE(ReadSimpleFloat(longFrac.Get(), value, end));
+    p = longFrac.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+
+    const char* text = longFrac.Get();
+    char* generalEnd = nullptr;
+    EXPECT_FLOAT_EQ(0.123456789f, read_float(text, &generalEnd));
+}
+
+TEST(ColladaNumbersTest, Whitespace_EndsNumbers)
+{
+    EXPECT_FLOAT_EQ(1.25f, ReadFloatAllWays("1.25 2", 4));
+    EXPECT_FLOAT_EQ(-3.0f, ReadFloatAllWays("-3\t4", 2));
+    EXPECT_FLOAT_EQ(8.5f, ReadFloatAllWays("8.5\n", 3));
+    EXPECT_FLOAT_EQ(8.5f, ReadFloatAllWays("8.5\r\n9", 3));
+
+    // a number must end at whitespace or the terminator, anything else isn't simple
+    float value;
+    const char* end;
+    const PaddedText trailing("1.5,2");
+    EXPECT_FALSE(ReadSimpleFloat(trailing.Get(), value, end));
+    const char* p = trailing.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+    int intValue;
+    p = trailing.Get();
+    EXPECT_FALSE(ReadSimpleInt16(p, intValue));
+}
+
+TEST(ColladaNumbersTest, SixteenByteWindow_Boundaries)
+{
+    // 15 characters, the terminator is the last byte of the window
+    EXPECT_FLOAT_EQ(float(strtod("1234567.1234567", nullptr)), ReadFloatAllWays("1234567.1234567", 15));
+    // 15 characters followed by whitespace at the last byte of the window
+    EXPECT_FLOAT_EQ(float(strtod("-123456.1234567", nullptr)), ReadFloatAllWays("-123456.1234567 1", 15));
+
+    // 16 characters don't fit the window, the 16 byte reader leaves them to the general path
+    const PaddedText sixteen("-1234567.1234567");
+    float value;
+    const char* p = sixteen.Get();
+    EXPECT_FALSE(ReadSimpleFloat16(p, value));
+    EXPECT_EQ(sixteen.Get(), p);
+    const char* text = sixteen.Get();
+    char* end = nullptr;
+    EXPECT_FLOAT_EQ(float(strtod("-1234567.1234567", nullptr)), read_float(text, &end));
+
+    int intValue;
+    const PaddedText sixteenInts("1234567890123456");
+    p = sixteenInts.Get();
+    EXPECT_FALSE(ReadSimpleInt16(p, intValue));
+
+    // the same number read at every offset in front of a 16 byte boundary
+    for (size_t offset = 0; offset < 16; ++offset)
+    {
+        const PaddedText shifted("-98.765 4", offset);
+        p = shifted.Get();
+        ASSERT_TRUE(ReadSimpleFloat16(p, value)) << offset;
+        EXPECT_EQ(shifted.Get() + 7, p) << offset;
+        EXPECT_FLOAT_EQ(-98.765f, value) << offset;
+
+        const PaddedText shiftedInt("-98765 4", offset);
+        p = shiftedInt.Get();
+        ASSERT_TRUE(ReadSimpleInt16(p, intValue)) << offset;
+        EXPECT_EQ(shiftedInt.Get() + 6, p) << offset;
+        EXPECT_EQ(-98765, intValue) << offset;
+    }
+}
+
+TEST(ColladaNumbersTest, SimpleInts_MatchStrtol)
+{
+    const char* const texts[] = { "0", "7", "-7", "+42", "123456789", "-123456789", "2147483" };
+    for (const char* text : texts)
+    {
+        const PaddedText padded(text);
+        const long expected = strtol(text, nullptr, 0);
+
+        const char* p = padded.Get();
+        int value16 = 0;
+        EXPECT_TRUE(ReadSimpleInt16(p, value16)) << text;
+        EXPECT_EQ(padded.Get() + strlen(text), p) << text;
+        EXPECT_EQ(expected, value16) << text;
+
+        char* end = nullptr;
+        EXPECT_EQ(expected, read_int(padded.Get(), &end)) << text;
+        EXPECT_EQ(padded.Get() + strlen(text), end) << text;
+    }
+}
+
+TEST(ColladaNumbersTest, ReadInt_SpecialForms)
+{
+    // octal and hexadecimal go through strtol(), the 16 byte reader refuses them
+    const char* const texts[] = { "010", "0x1F", "-0X10", "2147483647", "-2147483648", "4294967296" };
+    for (const char* text : texts)
+    {
+        const PaddedText padded(text);
+
+        char* end = nullptr;
+        char* expectedEnd = nullptr;
+        const int expected = int(strtol(padded.Get(), &expectedEnd, 0));
+        EXPECT_EQ(expected, read_int(padded.Get(), &end)) << text;
+        EXPECT_EQ(expectedEnd, end) << text;
+
+        const char* p = padded.Get();
+        int value16;
+        EXPECT_FALSE(ReadSimpleInt16(p, value16)) << text;
+    }
+
+    // leading whitespace is skipped like strtol() does
+    char* end = nullptr;
+    const char* text = " \t\n-15 3";
+    EXPECT_EQ(-15, read_int(text, &end));
+    EXPECT_EQ(text + 6, end);
+
+    // no number at all leaves end at the start
+    text = "abc";
+    read_int(text, &end);
+    EXPECT_EQ(text, end);
+
+    // a dot ends an int in read_int() but isn't simple for the 16 byte reader
+    const PaddedText withDot("12.5");
+    const char* p = withDot.Get();
+    int value16;
+    EXPECT_FALSE(ReadSimpleInt16(p, value16));
+    EXPECT_EQ(12, read_int(withDot.Get(), &end));
+}
@@ -0,0 +1,187 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "stdafx.h"
+#include <AzTest/AzTest.h>
+
+#include "CGA/KeyReduction.h"
+
+namespace
+{
+    // deterministic noise, the tests must not depend on the CRT's rand()
+    class NoiseSource
+    {
+    public:
+        explicit NoiseSource(uint32 seed)
+            : m_state(seed)
+        {
+        }
+
+        // uniform in [-1, 1]
+        float Next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) * (2.0f / 16777215.0f) - 1.0f;
+        }
+
+    private:
+        uint32 m_state;
+    };
+
+    // stands in for the storage formats: rounds every component to a fixed grid
+    float Quantize(float value, float step)
+    {
+        return floorf(value / step + 0.5f) * step;
+    }
+
+    std::vector<Quat> QuantizeRotations(const std::vector<Quat>& keys)
+    {
+        std::vector<Quat> quantized(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            const float step = 1.0f / 4096.0f;
+            quantized[i] = Quat(Quantize(keys[i].w, step), Quantize(keys[i].v.x, step), Quantize(keys[i].v.y, step), Quantize(keys[i].v.z, step));
+        }
+        return quantized;
+    }
+
+    std::vector<Vec3> QuantizePositions(const std::vector<Vec3>& keys)
+    {
+        std::vector<Vec3> quantized(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            const float step = 1.0f / 1024.0f;
+            quantized[i] = Vec3(Quantize(keys[i].x, step), Quantize(keys[i].y, step), Quantize(keys[i].z, step));
+        }
+        return quantized;
+    }
+
+    std::vector<Quat> MakeRotations(uint32 count, float noise, bool flipSigns)
+    {
+        NoiseSource random(count);
+        std::vector<Quat> keys(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const float t = i / 30.0f;
+            Ang3 angles(sinf(t) * 1.2f, cosf(t * 0.7f) * 0.8f, t * 0.3f);
+            angles += Ang3(random.Next(), random.Next(), random.Next()) * noise;
+            keys[i] = Quat::CreateRotationXYZ(angles);
+            if (flipSigns && (i % 3) == 1)
+            {
+                keys[i] = -keys[i];
+            }
+        }
+        return keys;
+    }
+
+    std::vector<Vec3> MakePositions(uint32 count, float noise)
+    {
+        NoiseSource random(count);
+        std::vector<Vec3> keys(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const float t = i / 30.0f;
+            keys[i] = Vec3(sinf(t) * 2.0f, t * 0.5f, cosf(t * 1.3f) * 0.25f) + Vec3(random.Next(), random.Next(), random.Next()) * noise;
+        }
+        return keys;
+    }
+
+    void CheckRotations(const std::vector<Quat>& keys, float toleranceInDegrees)
+    {
+        const std::vector<Quat> quantized = QuantizeRotations(keys);
+        const float cosOfHalfMaxAngle = cosf(DEG2RAD(toleranceInDegrees) * 0.5f);
+
+        std::vector<uint32> expected;
+        std::vector<uint32> actual;
+        KeyReduction::ReduceRotationsReference(keys, quantized, cosOfHalfMaxAngle, expected);
+        KeyReduction::ReduceRotations(keys, quantized, cosOfHalfMaxAngle, actual);
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(KeyReduction::MaxRotationError(keys, quantized, expected), KeyReduction::MaxRotationError(keys, quantized, actual));
+    }
+
+    void CheckPositions(const std::vector<Vec3>& keys, float tolerance)
+    {
+        const std::vector<Vec3> quantized = QuantizePositions(keys);
+
+        std::vector<uint32> expected;
+        std::vector<uint32> actual;
+        KeyReduction::ReducePositionsReference(keys, quantized, tolerance * tolerance, expected);
+        KeyReduction::ReducePositions(keys, quantized, tolerance * tolerance, actual);
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(KeyReduction::MaxPositionError(keys, quantized, expected), KeyReduction::MaxPositionError(keys, quantized, actual));
+    }
+
+    const float s_rotationTolerances[] = { 0.0f, 0.01f, 0.1f, 0.5f, 2.0f, 10.0f };
+    const float s_positionTolerances[] = { 0.0f, 0.0001f, 0.001f, 0.01f, 0.1f };
+}
+
+TEST(KeyReductionTest, Rotations_MatchReference)
+{
+    const uint32 counts[] = { 1, 2, 3, 4, 5, 7, 33, 400 };
+    const float noises[] = { 0.0f, 0.0005f, 0.01f, 0.2f };
+    for (uint32 count : counts)
+    {
+        for (float noise : noises)
+        {
+            for (float tolerance : s_rotationTolerances)
+            {
+                CheckRotations(MakeRotations(count, noise, false), tolerance);
+                CheckRotations(MakeRotations(count, noise, true), tolerance);
+            }
+        }
+    }
+}
+
+TEST(KeyReductionTest, Positions_MatchReference)
+{
+    const uint32 counts[] = { 1, 2, 3, 4, 5, 7, 33, 400 };
+    const float noises[] = { 0.0f, 0.00005f, 0.002f, 0.05f };
+    for (uint32 count : counts)
+    {
+        for (float noise : noises)
+        {
+            for (float tolerance : s_positionTolerances)
+            {
+                CheckPositions(MakePositions(count, noise), tolerance);
+            }
+        }
+    }
+}
+
+TEST(KeyReductionTest, StaticTrack_KeepsOnlyEnds)
+{
+    const std::vector<Quat> rotations(100, Quat::CreateRotationZ(0.5f));
+    const std::vector<Vec3> positions(100, Vec3(1.0f, 2.0f, 3.0f));
+
+    std::vector<uint32> keptKeys;
+    KeyReduction::ReduceRotations(rotations, rotations, cosf(DEG2RAD(0.1f) * 0.5f), keptKeys);
+    ASSERT_EQ(2, keptKeys.size());
+    EXPECT_EQ(0, keptKeys[0]);
+    EXPECT_EQ(99, keptKeys[1]);
+
+    KeyReduction::ReducePositions(positions, positions, 0.001f * 0.001f, keptKeys);
+    ASSERT_EQ(2, keptKeys.size());
+    EXPECT_EQ(0, keptKeys[0]);
+    EXPECT_EQ(99, keptKeys[1]);
+}
+
+TEST(KeyReductionTest, LargeCoordinates_MatchReference)
+{
+    std::vector<Vec3> keys = MakePositions(200, 0.001f);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] += Vec3(5000.0f, -3000.0f, 100.0f);
+    }
+    CheckPositions(keys, 0.001f);
+    CheckPositions(keys, 0.01f);
+}
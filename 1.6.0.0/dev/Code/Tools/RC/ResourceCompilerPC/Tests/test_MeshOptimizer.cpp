@@ -0,0 +1,228 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "stdafx.h"
+#include <AzTest/AzTest.h>
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+
+namespace
+{
+    // regular grid of cellsX * cellsY quads in the xy plane, two triangles per quad
+    struct GridMesh
+    {
+        GridMesh(int cellsX, int cellsY)
+        {
+            const int columns = cellsX + 1;
+            for (int y = 0; y <= cellsY; ++y)
+            {
+                for (int x = 0; x <= cellsX; ++x)
+                {
+                    positions.push_back(Vec3(float(x), float(y), 0.0f));
+                }
+            }
+            for (int y = 0; y < cellsY; ++y)
+            {
+                for (int x = 0; x < cellsX; ++x)
+                {
+                    const uint32 v0 = uint32(y * columns + x);
+                    const uint32 v1 = v0 + 1;
+                    const uint32 v2 = v0 + columns;
+                    const uint32 v3 = v2 + 1;
+                    const uint32 quad[6] = { v0, v1, v2, v2, v1, v3 };
+                    indices.insert(indices.end(), quad, quad + 6);
+                }
+            }
+        }
+
+        std::vector<Vec3> positions;
+        std::vector<uint32> indices;
+    };
+
+    // deterministic shuffle of the triangles, the tests must not depend on the CRT's rand()
+    void ShuffleTriangles(std::vector<uint32>& indices, uint32 seed)
+    {
+        uint32 state = seed;
+        for (size_t t = indices.size() / 3; t > 1; --t)
+        {
+            state = state * 1664525u + 1013904223u;
+            const size_t other = (state >> 8) % t;
+            std::swap_ranges(&indices[(t - 1) * 3], &indices[(t - 1) * 3] + 3, &indices[other * 3]);
+        }
+    }
+
+    // sorted triangles, each rotated so its smallest index comes first, which keeps the winding
+    std::vector<std::vector<uint32> > CanonicalTriangles(const std::vector<uint32>& indices)
+    {
+        std::vector<std::vector<uint32> > result;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            std::vector<uint32> triangle(indices.begin() + i, indices.begin() + i + 3);
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            result.push_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST(MeshOptimizerTest, AnalyzeVertexCache_CountsMisses)
+{
+    // two triangles sharing an edge: four vertices, four transforms with any cache that holds three
+    const uint32 indices[6] = { 0, 1, 2, 2, 1, 3 };
+    const MeshOptimizer::VertexCacheStatistics stats = MeshOptimizer::AnalyzeVertexCache(indices, 6, 4, 16);
+    EXPECT_EQ(2, stats.triangleCount);
+    EXPECT_EQ(4, stats.vertexCount);
+    EXPECT_EQ(4, stats.transformCount);
+    EXPECT_FLOAT_EQ(2.0f, stats.GetACMR());
+    EXPECT_FLOAT_EQ(1.0f, stats.GetATVR());
+
+    // a cache of one entry only hits when a corner repeats the previous one
+    EXPECT_EQ(5, MeshOptimizer::AnalyzeVertexCache(indices, 6, 4, 1).transformCount);
+}
+
+TEST(MeshOptimizerTest, OptimizeTriangleOrder_LowersACMR)
+{
+    GridMesh grid(32, 32);
+    ShuffleTriangles(grid.indices, 12345);
+
+    const MeshOptimizer::Settings settings;
+    const MeshOptimizer::VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache(&grid.indices[0], grid.indices.size(), grid.positions.size(), settings.cacheSize);
+    MeshOptimizer::OptimizeTriangleOrder(&grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), settings);
+    const MeshOptimizer::VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(&grid.indices[0], grid.indices.size(), grid.positions.size(), settings.cacheSize);
+
+    EXPECT_EQ(before.triangleCount, after.triangleCount);
+    EXPECT_EQ(before.vertexCount, after.vertexCount);
+    // a shuffled grid transforms almost every corner, a good order gets well below one vertex per triangle
+    EXPECT_GT(before.GetACMR(), 2.0f);
+    EXPECT_LT(after.GetACMR(), 0.9f);
+    EXPECT_LT(after.GetATVR(), 1.8f);
+
+    // overdraw ordering may only cost what the threshold allows on top of the cache optimized order
+    GridMesh cacheOnly(32, 32);
+    ShuffleTriangles(cacheOnly.indices, 12345);
+    MeshOptimizer::Settings noOverdraw;
+    noOverdraw.overdrawThreshold = 0.0f;
+    MeshOptimizer::OptimizeTriangleOrder(&cacheOnly.indices[0], cacheOnly.indices.size(), &cacheOnly.positions[0], cacheOnly.positions.size(), noOverdraw);
+    const float cacheOnlyACMR = MeshOptimizer::AnalyzeVertexCache(&cacheOnly.indices[0], cacheOnly.indices.size(), cacheOnly.positions.size(), settings.cacheSize).GetACMR();
+    EXPECT_LE(cacheOnlyACMR, before.GetACMR());
+    EXPECT_LE(after.GetACMR(), cacheOnlyACMR * settings.overdrawThreshold * 1.25f);
+}
+
+TEST(MeshOptimizerTest, OptimizeTriangleOrder_PermutesTriangles)
+{
+    GridMesh grid(17, 9);
+    ShuffleTriangles(grid.indices, 777);
+    // a few vertices nothing refers to, as in a vertex buffer shared by several subsets
+    grid.positions.resize(grid.positions.size() + 5, Vec3(100.0f, 0.0f, 0.0f));
+    const std::vector<uint32> original = grid.indices;
+
+    MeshOptimizer::Settings settings;
+    settings.cacheSize = 12;
+    MeshOptimizer::OptimizeTriangleOrder(&grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), settings);
+
+    ASSERT_EQ(original.size(), grid.indices.size());
+    EXPECT_TRUE(CanonicalTriangles(original) == CanonicalTriangles(grid.indices));
+
+    // without positions only the cache order is applied, which must be a permutation as well
+    grid.indices = original;
+    MeshOptimizer::OptimizeTriangleOrder(&grid.indices[0], grid.indices.size(), nullptr, grid.positions.size(), settings);
+    EXPECT_TRUE(CanonicalTriangles(original) == CanonicalTriangles(grid.indices));
+}
+
+TEST(MeshOptimizerTest, OptimizeVertexCache_ClusterStartsAreOrdered)
+{
+    GridMesh grid(20, 20);
+    ShuffleTriangles(grid.indices, 42);
+
+    std::vector<uint32> clusterStarts;
+    MeshOptimizer::OptimizeVertexCache(&grid.indices[0], grid.indices.size(), grid.positions.size(), 16, clusterStarts);
+
+    ASSERT_FALSE(clusterStarts.empty());
+    EXPECT_EQ(0, clusterStarts[0]);
+    for (size_t c = 1; c < clusterStarts.size(); ++c)
+    {
+        EXPECT_LT(clusterStarts[c - 1], clusterStarts[c]);
+        EXPECT_LT(clusterStarts[c], grid.indices.size() / 3);
+    }
+}
+
+TEST(MeshOptimizerTest, BuildMeshlets_RespectsLimits)
+{
+    GridMesh grid(24, 24);
+    MeshOptimizer::Settings settings;
+    MeshOptimizer::OptimizeTriangleOrder(&grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), settings);
+
+    const int maxVertices = 64;
+    const int maxTriangles = 126;
+    MeshOptimizer::Meshlets meshlets;
+    MeshOptimizer::BuildMeshlets(meshlets, &grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), maxVertices, maxTriangles);
+
+    ASSERT_FALSE(meshlets.meshlets.empty());
+    EXPECT_EQ(grid.indices.size(), meshlets.triangles.size());
+
+    // the meshlets reproduce the triangles in order
+    std::vector<uint32> rebuilt;
+    for (size_t m = 0; m < meshlets.meshlets.size(); ++m)
+    {
+        const MeshOptimizer::Meshlet& meshlet = meshlets.meshlets[m];
+        EXPECT_GT(meshlet.vertexCount, 0u);
+        EXPECT_LE(meshlet.vertexCount, uint32(maxVertices));
+        EXPECT_GT(meshlet.triangleCount, 0u);
+        EXPECT_LE(meshlet.triangleCount, uint32(maxTriangles));
+        ASSERT_LE(meshlet.vertexOffset + meshlet.vertexCount, meshlets.vertices.size());
+        ASSERT_LE((meshlet.triangleOffset + meshlet.triangleCount) * 3, meshlets.triangles.size());
+
+        for (uint32 t = 0; t < meshlet.triangleCount * 3; ++t)
+        {
+            const uint8 local = meshlets.triangles[meshlet.triangleOffset * 3 + t];
+            ASSERT_LT(local, meshlet.vertexCount);
+            rebuilt.push_back(meshlets.vertices[meshlet.vertexOffset + local]);
+        }
+
+        // the bounding sphere contains all vertices, the grid is flat so the cone is tight around +z
+        for (uint32 v = 0; v < meshlet.vertexCount; ++v)
+        {
+            const Vec3& p = grid.positions[meshlets.vertices[meshlet.vertexOffset + v]];
+            EXPECT_LE((p - meshlet.center).GetLength(), meshlet.radius * 1.0001f + 0.0001f);
+        }
+        EXPECT_NEAR(1.0f, meshlet.coneAxis.z, 0.0001f);
+        EXPECT_NEAR(1.0f, meshlet.coneCutoff, 0.0001f);
+    }
+    EXPECT_TRUE(rebuilt == grid.indices);
+}
+
+TEST(MeshOptimizerTest, BuildMeshlets_SmallLimits)
+{
+    GridMesh grid(5, 5);
+
+    // one triangle per meshlet
+    MeshOptimizer::Meshlets single;
+    MeshOptimizer::BuildMeshlets(single, &grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), 3, 1);
+    ASSERT_EQ(grid.indices.size() / 3, single.meshlets.size());
+    for (size_t m = 0; m < single.meshlets.size(); ++m)
+    {
+        EXPECT_EQ(3u, single.meshlets[m].vertexCount);
+        EXPECT_EQ(1u, single.meshlets[m].triangleCount);
+    }
+
+    // four vertices fit exactly one quad
+    MeshOptimizer::Meshlets quads;
+    MeshOptimizer::BuildMeshlets(quads, &grid.indices[0], grid.indices.size(), &grid.positions[0], grid.positions.size(), 4, 64);
+    ASSERT_EQ(grid.indices.size() / 6, quads.meshlets.size());
+    for (size_t m = 0; m < quads.meshlets.size(); ++m)
+    {
+        EXPECT_EQ(4u, quads.meshlets[m].vertexCount);
+        EXPECT_EQ(2u, quads.meshlets[m].triangleCount);
+    }
+}
@@ -102,10 +102,12 @@ namespace AZ
                 }
 
                 // Vertex coloring always uses the first vertex color stream.
-                context.m_mesh.ReallocStream(CMesh::COLORS_0, context.m_mesh.GetVertexCount());
-                for (int i = 0; i < context.m_mesh.GetVertexCount(); ++i)
+                const int vertexCount = context.m_mesh.GetVertexCount();
+                context.m_mesh.ReallocStream(CMesh::COLORS_0, vertexCount);
+                const SceneDataTypes::Color* colorArray = colors->GetColors();
+                for (int i = 0; i < vertexCount; ++i)
                 {
-                    const SceneDataTypes::Color& color = colors->GetColor(i);
+                    const SceneDataTypes::Color& color = colorArray ? colorArray[i] : colors->GetColor(i);
                     context.m_mesh.m_pColor0[i] = SMeshColor(
                             static_cast<uint8_t>(GetClamp<float>(color.red, 0.0f, 1.0f) * 255.0f),
                             static_cast<uint8_t>(GetClamp<float>(color.green, 0.0f, 1.0f) * 255.0f),
@@ -73,74 +73,120 @@ namespace AZ
 
         void CgfMeshExporter::SetMeshFaces(const SceneDataTypes::IMeshData& meshData, CMesh& mesh, EPhysicsGeomType physicalizeType) const
         {
-            if (meshData.GetFaceCount() == 0)
+            const uint32_t faceCount = meshData.GetFaceCount();
+            if (faceCount == 0)
             {
                 AZ_TracePrintf(AZ::SceneAPI::Utilities::LogWindow, "No mesh faces specified.");
                 return;
             }
 
-            mesh.ReallocStream(CMesh::FACES, meshData.GetFaceCount());
-            for (uint32_t i = 0; i < meshData.GetFaceCount(); ++i)
+            // Read straight from the face streams when the mesh data stores them as arrays.
+            const SceneDataTypes::IMeshData::Face* faces = meshData.GetFaces();
+            const unsigned int* faceMaterialIds = meshData.GetFaceMaterialIds();
+
+            // Create and use a unified subset if the mesh is chosen to be physicalized
+            const bool useUnifiedSubset = physicalizeType == PHYS_GEOM_TYPE_DEFAULT_PROXY ||
+                physicalizeType == PHYS_GEOM_TYPE_OBSTRUCT;
+
+            mesh.ReallocStream(CMesh::FACES, faceCount);
+            int maxMaterialIndex = 0;
+            for (uint32_t i = 0; i < faceCount; ++i)
             {
-                const SceneDataTypes::IMeshData::Face& face = meshData.GetFaceInfo(i);
+                const SceneDataTypes::IMeshData::Face& face = faces ? faces[i] : meshData.GetFaceInfo(i);
                 mesh.m_pFaces[i].v[0] = face.vertexIndex[0];
                 mesh.m_pFaces[i].v[1] = face.vertexIndex[1];
                 mesh.m_pFaces[i].v[2] = face.vertexIndex[2];
 
-                // Create and use a unified subset if the mesh is chosen to be physicalized
-                if (physicalizeType == PHYS_GEOM_TYPE_DEFAULT_PROXY ||
-                    physicalizeType == PHYS_GEOM_TYPE_OBSTRUCT)
+                if (useUnifiedSubset)
                 {
                     mesh.m_pFaces[i].nSubset = 0;
-                    if (mesh.m_subsets.empty())
-                    {
-                        SMeshSubset meshSubset;
-                        meshSubset.nMatID = 0;
-                        mesh.m_subsets.push_back(meshSubset);
-                    }
                 }
                 else
                 {
-                    int materialIndex = meshData.GetFaceMaterialId(i);
+                    int materialIndex = faceMaterialIds ? faceMaterialIds[i] : meshData.GetFaceMaterialId(i);
                     mesh.m_pFaces[i].nSubset = materialIndex;
+                    maxMaterialIndex = AZ::GetMax<int>(maxMaterialIndex, materialIndex);
+                }
+            }
 
-                    while (mesh.m_subsets.size() <= materialIndex)
-                    {
-                        SMeshSubset meshSubset;
-                        meshSubset.nMatID = mesh.m_subsets.size();
-                        mesh.m_subsets.push_back(meshSubset);
-                    }
+            if (useUnifiedSubset)
+            {
+                if (mesh.m_subsets.empty())
+                {
+                    SMeshSubset meshSubset;
+                    meshSubset.nMatID = 0;
+                    mesh.m_subsets.push_back(meshSubset);
+                }
+            }
+            else
+            {
+                while (mesh.m_subsets.size() <= maxMaterialIndex)
+                {
+                    SMeshSubset meshSubset;
+                    meshSubset.nMatID = mesh.m_subsets.size();
+                    mesh.m_subsets.push_back(meshSubset);
                 }
             }
         }
 
         void CgfMeshExporter::SetMeshVertices(const SceneDataTypes::IMeshData& meshData, CMesh& mesh) const
         {
-            mesh.ReallocStream(CMesh::POSITIONS, meshData.GetVertexCount());
-            for (uint32_t i = 0; i < meshData.GetVertexCount(); ++i)
+            const uint32_t vertexCount = meshData.GetVertexCount();
+            mesh.ReallocStream(CMesh::POSITIONS, vertexCount);
+            if (vertexCount == 0)
             {
-                const Vector3& position = meshData.GetPosition(i);
-                mesh.m_pPositions[i] = Vec3(position.GetX(), position.GetY(), position.GetZ());
+                return;
+            }
+
+            const Vector3* positions = meshData.GetPositions();
+            if (positions)
+            {
+                // AZ::Vector3 is padded to four floats while Vec3 is packed, so the stream is converted rather
+                // than copied. Without the per-vertex virtual calls this is a plain load/store loop.
+                for (uint32_t i = 0; i < vertexCount; ++i)
+                {
+                    mesh.m_pPositions[i] = Vec3(positions[i].GetX(), positions[i].GetY(), positions[i].GetZ());
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < vertexCount; ++i)
+                {
+                    const Vector3& position = meshData.GetPosition(i);
+                    mesh.m_pPositions[i] = Vec3(position.GetX(), position.GetY(), position.GetZ());
+                }
             }
         }
 
         void CgfMeshExporter::SetMeshNormals(const SceneDataTypes::IMeshData& meshData, CMesh& mesh) const
         {
             // Cgf requires normals. If they're missing add a stream of default normals.
-            mesh.ReallocStream(CMesh::NORMALS, meshData.GetVertexCount());
+            const uint32_t vertexCount = meshData.GetVertexCount();
+            mesh.ReallocStream(CMesh::NORMALS, vertexCount);
             if (meshData.HasNormalData())
             {
-                for (int i = 0; i < meshData.GetVertexCount(); ++i)
+                const Vector3* normals = meshData.GetNormals();
+                if (normals)
+                {
+                    for (uint32_t i = 0; i < vertexCount; ++i)
+                    {
+                        mesh.m_pNorms[i] = SMeshNormal(Vec3(normals[i].GetX(), normals[i].GetY(), normals[i].GetZ()));
+                    }
+                }
+                else
                 {
-                    const Vector3& normal = meshData.GetNormal(i);
-                    mesh.m_pNorms[i] = SMeshNormal(Vec3(normal.GetX(), normal.GetY(), normal.GetZ()));
+                    for (uint32_t i = 0; i < vertexCount; ++i)
+                    {
+                        const Vector3& normal = meshData.GetNormal(i);
+                        mesh.m_pNorms[i] = SMeshNormal(Vec3(normal.GetX(), normal.GetY(), normal.GetZ()));
+                    }
                 }
             }
             else
             {
                 AZ_TracePrintf(AZ::SceneAPI::Utilities::LogWindow, "No mesh normals detected. Adding default normals.");
                 static const SMeshNormal defaultNormal(Vec3(1.0f, 0.0f, 0.0f));
-                for (int i = 0; i < meshData.GetVertexCount(); ++i)
+                for (uint32_t i = 0; i < vertexCount; ++i)
                 {
                     mesh.m_pNorms[i] = defaultNormal;
                 }
@@ -100,10 +100,22 @@ namespace AZ
                     return SceneEvents::ProcessingResult::Failure;
                 }
 
-                for (int i = 0; i < context.m_mesh.GetVertexCount(); ++i)
+                const int vertexCount = context.m_mesh.GetVertexCount();
+                const AZ::Vector2* uvArray = uvs->GetUVs();
+                if (uvArray)
                 {
-                    const AZ::Vector2& uv = uvs->GetUV(i);
-                    context.m_mesh.m_pTexCoord[i] = SMeshTexCoord(uv.GetX(), uv.GetY());
+                    for (int i = 0; i < vertexCount; ++i)
+                    {
+                        context.m_mesh.m_pTexCoord[i] = SMeshTexCoord(uvArray[i].GetX(), uvArray[i].GetY());
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < vertexCount; ++i)
+                    {
+                        const AZ::Vector2& uv = uvs->GetUV(i);
+                        context.m_mesh.m_pTexCoord[i] = SMeshTexCoord(uv.GetX(), uv.GetY());
+                    }
                 }
             }
             else //CGF needs something in the texture channel so dummy coords if we don't have any uv's supplied
@@ -35,6 +35,12 @@ void __stdcall RegisterConvertors(IResourceCompiler* pRC)
 
     AZStd::shared_ptr<AZ::RC::SceneConfig> config = AZStd::make_shared<AZ::RC::SceneConfig>();
     pRC->RegisterConvertor("SceneConverter", new AZ::RC::SceneConverter(config));
+
+    pRC->RegisterKey("fbxMeshThreads",
+        "[FBX] number of threads the meshes of a scene are converted on\n"
+        "1=convert on the importing thread (default)\n"
+        "0=use as many threads as /threads allows\n"
+        "N=use N threads");
 }
 
 void __stdcall InitializeAzEnvironment(AZ::EnvironmentInstance sharedEnvironment)
@@ -14,8 +14,10 @@
 #include <SceneConverter.h>
 #include <SceneCompiler.h>
 #include <ISceneConfig.h>
+#include <IConfig.h>
 #include <AzCore/std/iterator.h>
 #include <SceneAPI/SceneCore/Events/AssetImportRequest.h>
+#include <SceneAPI/FbxSceneBuilder/FbxImportRequestHandler.h>
 
 namespace AZ
 {
@@ -39,6 +41,17 @@ namespace AZ
             delete this;
         }
 
+        void SceneConverter::Init(const ConvertorInitContext& context)
+        {
+            // Meshes are converted on the importing thread unless asked for, 0 uses the threads this pass may use.
+            int threadCount = context.config->GetAsInt("fbxMeshThreads", 1, 1);
+            if (threadCount <= 0)
+            {
+                threadCount = context.maxThreads;
+            }
+            SceneAPI::FbxSceneImporter::FbxImportRequestHandler::SetMeshConversionThreadCount(threadCount > 1 ? threadCount : 1);
+        }
+
         ICompiler* SceneConverter::CreateCompiler()
         {
             return new SceneCompiler(m_config);
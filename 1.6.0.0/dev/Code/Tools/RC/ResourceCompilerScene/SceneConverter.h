@@ -29,6 +29,7 @@ namespace AZ
             explicit SceneConverter(const AZStd::shared_ptr<ISceneConfig>& config);
 
             void Release() override;
+            void Init(const ConvertorInitContext& context) override;
             ICompiler* CreateCompiler() override;
             bool SupportsMultithreading() const override;
             const char* GetExt(int index) const override;
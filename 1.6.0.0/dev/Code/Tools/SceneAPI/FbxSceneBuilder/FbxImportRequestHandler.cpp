@@ -36,6 +36,7 @@ namespace AZ
         namespace FbxSceneImporter
         {
             const char* FbxImportRequestHandler::s_extension = ".fbx";
+            unsigned int FbxImportRequestHandler::s_meshConversionThreadCount = 1;
 
             AZ_CLASS_ALLOCATOR_IMPL(FbxImportRequestHandler, AZ::SystemAllocator, 0)
 
@@ -64,9 +65,15 @@ namespace AZ
                 scene.SetSourceFilename(path);
 
                 FbxImporter importer;
+                importer.SetThreadCount(s_meshConversionThreadCount);
                 return importer.PopulateFromFile(path.c_str(), scene) ? Events::LoadingResult::AssetLoaded : Events::LoadingResult::AssetFailure;
             }
 
+            void FbxImportRequestHandler::SetMeshConversionThreadCount(unsigned int threadCount)
+            {
+                s_meshConversionThreadCount = threadCount;
+            }
+
             Events::ProcessingResult FbxImportRequestHandler::UpdateManifest(Containers::Scene& scene, ManifestAction action, RequestingApplication requester)
             {
                 if (action == ManifestAction::ConstructDefault && requester != RequestingApplication::AssetProcessor)
@@ -37,8 +37,13 @@ namespace AZ
                 FBX_SCENE_BUILDER_API Events::ProcessingResult UpdateManifest(Containers::Scene& scene, ManifestAction action,
                     RequestingApplication requester) override;
 
+                // Sets the number of threads meshes are converted on for assets loaded afterwards, see
+                //      FbxImporter::SetThreadCount. Defaults to 1.
+                FBX_SCENE_BUILDER_API static void SetMeshConversionThreadCount(unsigned int threadCount);
+
             private:
                 static const char* s_extension;
+                static unsigned int s_meshConversionThreadCount;
             };
         } // FbxSceneImporter
     } // SceneAPI
@@ -10,15 +10,18 @@
 *
 */
 
-#include <queue>
 #include <AzCore/Math/Transform.h>
+#include <AzCore/std/sort.h>
 #include <AzCore/std/string/string.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/parallel/thread.h>
 #include <AzCore/std/smart_ptr/make_shared.h>
 #include <SceneAPI/FbxSceneBuilder/FbxImporter.h>
 #include <SceneAPI/FbxSDKWrapper/FbxSceneWrapper.h>
 #include <SceneAPI/FbxSDKWrapper/FbxMeshWrapper.h>
 #include <SceneAPI/SceneCore/Containers/Scene.h>
 #include <SceneAPI/SceneCore/Containers/SceneGraph.h>
+#include <SceneAPI/SceneCore/Utilities/Reporting.h>
 #include <SceneAPI/SceneData/GraphData/TransformData.h>
 #include <SceneAPI/FbxSceneBuilder/FbxMeshBuilder.h>
 #include <SceneAPI/FbxSceneBuilder/FbxMaterialBuilder.h>
@@ -31,30 +34,28 @@ namespace AZ
     {
         namespace FbxSceneImporter
         {
-            struct QueueNode
-            {
-                std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> m_node;
-                Containers::SceneGraph::NodeIndex m_parent;
+            const size_t FbxImporter::ImportNode::s_noParent;
 
-                QueueNode() = default;
-                QueueNode(std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper>&& node, Containers::SceneGraph::NodeIndex parent)
-                    : m_node(std::move(node))
-                    , m_parent(parent)
-                {
-                }
-            };
+            FbxImporter::ImportNode::ImportNode(std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper>&& node, size_t parent)
+                : m_node(std::move(node))
+                , m_parent(parent)
+                , m_polygonCount(0)
+            {
+            }
 
             const char* FbxImporter::s_transformNodeName = "transform";
 
             FbxImporter::FbxImporter()
                 : m_sceneWrapper(new FbxSDKWrapper::FbxSceneWrapper())
                 , m_sceneSystem(new FbxSceneSystem())
+                , m_threadCount(1)
             {
             }
 
             FbxImporter::FbxImporter(std::unique_ptr<FbxSDKWrapper::FbxSceneWrapper>&& specifiedScene)
                 : m_sceneWrapper(std::move(specifiedScene))
                 , m_sceneSystem(new FbxSceneSystem())
+                , m_threadCount(1)
             {
                 if (!m_sceneWrapper)
                 {
@@ -86,6 +87,11 @@ namespace AZ
                 return PopulateFromFile(path.c_str(), scene);
             }
 
+            void FbxImporter::SetThreadCount(unsigned int threadCount)
+            {
+                m_threadCount = threadCount;
+            }
+
             bool FbxImporter::ConvertFbxScene(Containers::Scene& scene) const
             {
                 std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> fbxRoot = m_sceneWrapper->GetRootNode();
@@ -94,44 +100,56 @@ namespace AZ
                     return false;
                 }
 
-                std::queue<QueueNode> nodes;
-                nodes.emplace(std::move(fbxRoot), scene.GetGraph().GetRoot());
+                Containers::SceneGraph& graph = scene.GetGraph();
 
-                while (!nodes.empty())
+                // Gather the hierarchy breadth first, which is the order the nodes are added to the graph in.
+                AZStd::vector<ImportNode> nodes;
+                nodes.emplace_back(std::move(fbxRoot), ImportNode::s_noParent);
+                for (size_t index = 0; index < nodes.size(); ++index)
                 {
-                    QueueNode& node = nodes.front();
+                    std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> fbxNode = nodes[index].m_node;
+                    AZ_Assert(fbxNode, "Empty fbx node queued");
 
-                    AZ_Assert(node.m_node, "Empty fbx node queued");
-                    Containers::SceneGraph::NodeIndex currentNodeIndex = AppendNodeToScene(scene.GetGraph(), node.m_parent, *node.m_node);
+                    nodes[index].m_mesh = fbxNode->GetMesh();
+                    nodes[index].m_polygonCount = nodes[index].m_mesh ? nodes[index].m_mesh->GetPolygonCount() : 0;
 
-                    int childCount = node.m_node->GetChildCount();
+                    int childCount = fbxNode->GetChildCount();
                     for (int i = 0; i < childCount; ++i)
                     {
-                        std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> child = node.m_node->GetChild(i);
+                        std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> child = fbxNode->GetChild(i);
                         if (child)
                         {
-                            nodes.emplace(std::move(child), currentNodeIndex);
+                            nodes.emplace_back(std::move(child), index);
                         }
                     }
-                    nodes.pop();
+                }
+
+                // Meshes don't depend on each other or on the graph, so they're converted concurrently.
+                ConvertMeshNodes(nodes, graph);
+
+                // Parents are always added before their children, so their graph index is known by then.
+                AZStd::vector<Containers::SceneGraph::NodeIndex> graphNodes;
+                graphNodes.reserve(nodes.size());
+                for (ImportNode& node : nodes)
+                {
+                    Containers::SceneGraph::NodeIndex parent = node.m_parent == ImportNode::s_noParent ? graph.GetRoot() : graphNodes[node.m_parent];
+                    graphNodes.push_back(AppendNodeToScene(graph, parent, *node.m_node, node.m_meshContent));
                 }
 
                 return true;
             }
 
-            Containers::SceneGraph::NodeIndex FbxImporter::AppendNodeToScene(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const
+            Containers::SceneGraph::NodeIndex FbxImporter::AppendNodeToScene(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent,
+                FbxSDKWrapper::FbxNodeWrapper& node, FbxNodeContent& meshContent) const
             {
                 // Always create a node, even if it remains empty.
                 parent = graph.AddChild(parent, node.GetName());
 
                 // Build Transform
-                bool nodeUsed = BuildSkinNode(graph, parent, node);
-                if (!nodeUsed)
-                {
-                    nodeUsed = BuildMeshNode(graph, parent, node);
-                }
+                bool nodeUsed = meshContent.m_content != nullptr;
                 if (nodeUsed)
                 {
+                    meshContent.Commit(graph, parent);
                     BuildMaterialNode(graph, parent, node);
                 }
 
@@ -161,20 +179,65 @@ namespace AZ
                 return AZStd::make_shared<SceneData::GraphData::TransformData>(localTransform);
             }
 
-            bool FbxImporter::BuildMeshNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const
+            void FbxImporter::ConvertMeshNodes(AZStd::vector<ImportNode>& nodes, Containers::SceneGraph& graph) const
             {
-                AZ_Assert(!graph.HasNodeContent(parent), "BuildMeshNode was failed as the node was already used");
-                FbxMeshBuilder meshBuilder(node.GetMesh(), graph, parent, m_sceneSystem);
-                meshBuilder.BuildMesh();
-                return graph.HasNodeContent(parent);
+                AZStd::vector<ImportNode*> meshNodes;
+                for (ImportNode& node : nodes)
+                {
+                    if (node.m_mesh)
+                    {
+                        meshNodes.push_back(&node);
+                    }
+                }
+                if (meshNodes.empty())
+                {
+                    return;
+                }
+
+                // Hand out the largest meshes first so the threads run out of work at about the same time.
+                AZStd::sort(meshNodes.begin(), meshNodes.end(),
+                    [](const ImportNode* lhs, const ImportNode* rhs)
+                    {
+                        return lhs->m_polygonCount > rhs->m_polygonCount;
+                    });
+
+                unsigned int threadCount = m_threadCount != 0 ? m_threadCount : AZStd::thread::hardware_concurrency();
+                threadCount = AZStd::GetMax(1u, AZStd::GetMin(threadCount, static_cast<unsigned int>(meshNodes.size())));
+
+                AZStd::atomic<size_t> nextMeshNode(0);
+                auto convertMeshNodes = [&]()
+                    {
+                        for (size_t index = nextMeshNode.fetch_add(1); index < meshNodes.size(); index = nextMeshNode.fetch_add(1))
+                        {
+                            ConvertMeshNode(*meshNodes[index], graph);
+                        }
+                    };
+
+                // The importing thread converts meshes as well instead of only waiting.
+                AZStd::vector<AZStd::thread> workers;
+                workers.reserve(threadCount - 1);
+                for (unsigned int i = 1; i < threadCount; ++i)
+                {
+                    workers.emplace_back(convertMeshNodes);
+                }
+                convertMeshNodes();
+                for (AZStd::thread& worker : workers)
+                {
+                    worker.join();
+                }
+
+                AZ_TracePrintf(Utilities::LogWindow, "Converted %i meshes on %i threads.", static_cast<int>(meshNodes.size()), threadCount);
             }
 
-            bool FbxImporter::BuildSkinNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const
+            void FbxImporter::ConvertMeshNode(ImportNode& node, Containers::SceneGraph& graph) const
             {
-                AZ_Assert(!graph.HasNodeContent(parent), "BuildMeshNode was failed as the node was already used");
-                FbxSkinBuilder skinBuilder(node.GetMesh(), graph, parent, m_sceneSystem);
-                skinBuilder.BuildSkin();
-                return graph.HasNodeContent(parent);
+                // The builders only read the graph when committing, which is left to the importing thread.
+                FbxSkinBuilder skinBuilder(node.m_mesh, graph, graph.GetRoot(), m_sceneSystem);
+                if (!skinBuilder.ConvertSkin(node.m_meshContent))
+                {
+                    FbxMeshBuilder meshBuilder(node.m_mesh, graph, graph.GetRoot(), m_sceneSystem);
+                    meshBuilder.ConvertMesh(node.m_meshContent);
+                }
             }
 
             bool FbxImporter::BuildBoneNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const
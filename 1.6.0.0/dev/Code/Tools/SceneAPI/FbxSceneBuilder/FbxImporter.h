@@ -13,8 +13,10 @@
 */
 
 #include <memory>
+#include <AzCore/std/containers/vector.h>
 #include <AzCore/std/smart_ptr/shared_ptr.h>
 #include <SceneAPI/FbxSceneBuilder/FbxSceneBuilderConfiguration.h>
+#include <SceneAPI/FbxSceneBuilder/FbxNodeContent.h>
 #include <SceneAPI/SceneCore/Import/IImporter.h>
 #include <SceneAPI/SceneCore/Containers/SceneGraph.h>
 #include <SceneAPI/FbxSceneBuilder/FbxSceneSystem.h>
@@ -26,6 +28,7 @@ namespace AZ
     namespace FbxSDKWrapper
     {
         class FbxNodeWrapper;
+        class FbxMeshWrapper;
         class FbxSceneWrapper;
     }
 
@@ -52,21 +55,43 @@ namespace AZ
                 FBX_SCENE_BUILDER_API bool PopulateFromFile(const char* path, Containers::Scene& scene) const override;
                 FBX_SCENE_BUILDER_API bool PopulateFromFile(const std::string& path, Containers::Scene& scene) const override;
 
+                // Sets the number of threads meshes are converted on. 0 uses one thread per hardware thread. The default of 1
+                //      converts all meshes on the importing thread, as the FBX SDK doesn't document reading separate meshes
+                //      of one scene from several threads as safe.
+                FBX_SCENE_BUILDER_API void SetThreadCount(unsigned int threadCount);
+
             protected:
+                // A node from the fbx hierarchy and the mesh content converted for it, waiting to be added to the graph.
+                struct ImportNode
+                {
+                    static const size_t s_noParent = static_cast<size_t>(-1);
+
+                    ImportNode(std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper>&& node, size_t parent);
+
+                    std::shared_ptr<FbxSDKWrapper::FbxNodeWrapper> m_node;
+                    std::shared_ptr<FbxSDKWrapper::FbxMeshWrapper> m_mesh;
+                    FbxNodeContent m_meshContent;
+                    // Index of the parent in the import list
+                    size_t m_parent;
+                    int m_polygonCount;
+                };
+
                 FBX_SCENE_BUILDER_API bool ConvertFbxScene(Containers::Scene& scene) const;
                 FBX_SCENE_BUILDER_API Containers::SceneGraph::NodeIndex AppendNodeToScene(
-                    Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const;
+                    Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node, FbxNodeContent& meshContent) const;
 
                 FBX_SCENE_BUILDER_API AZStd::shared_ptr<DataTypes::IGraphObject> BuildTransform(FbxSDKWrapper::FbxNodeWrapper& node) const;
 
-                FBX_SCENE_BUILDER_API bool BuildMeshNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const;
-                FBX_SCENE_BUILDER_API bool BuildSkinNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const;
+                // Converts the meshes of all nodes, spread over the configured number of threads. The graph isn't modified.
+                FBX_SCENE_BUILDER_API void ConvertMeshNodes(AZStd::vector<ImportNode>& nodes, Containers::SceneGraph& graph) const;
+                FBX_SCENE_BUILDER_API void ConvertMeshNode(ImportNode& node, Containers::SceneGraph& graph) const;
                 FBX_SCENE_BUILDER_API bool BuildBoneNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const;
                 FBX_SCENE_BUILDER_API bool BuildTransformNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node, bool parentNodeUsed) const;
                 FBX_SCENE_BUILDER_API bool BuildMaterialNode(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex parent, FbxSDKWrapper::FbxNodeWrapper& node) const;
 
                 std::unique_ptr<FbxSDKWrapper::FbxSceneWrapper> m_sceneWrapper;
                 std::shared_ptr<FbxSceneSystem> m_sceneSystem;
+                unsigned int m_threadCount;
             };
         } // FbxSceneImporter
     } // SceneAPI
@@ -45,16 +45,27 @@ namespace AZ
             }
 
             bool FbxMeshBuilder::BuildMesh()
+            {
+                FbxNodeContent content;
+                if (!ConvertMesh(content))
+                {
+                    return false;
+                }
+                content.Commit(m_graph, m_targetNode);
+                return true;
+            }
+
+            bool FbxMeshBuilder::ConvertMesh(FbxNodeContent& content)
             {
                 if (!m_fbxMesh)
                 {
                     return false;
                 }
                 AZStd::shared_ptr<SceneData::GraphData::MeshData> mesh = AZStd::make_shared<SceneData::GraphData::MeshData>();
-                return BuildMeshInternal(mesh);
+                return BuildMeshInternal(mesh, content);
             }
 
-            bool FbxMeshBuilder::BuildMeshInternal(const AZStd::shared_ptr<SceneData::GraphData::MeshData>& mesh)
+            bool FbxMeshBuilder::BuildMeshInternal(const AZStd::shared_ptr<SceneData::GraphData::MeshData>& mesh, FbxNodeContent& content)
             {
                 // Get mesh subset count by scanning material IDs in meshes.
                 // For negative material ids we will add an additional
@@ -65,6 +76,11 @@ namespace AZ
                 int minMeshMaterialIndex = INT_MAX;
                 int maxMeshMaterialIndex = INT_MIN;
 
+                // Every polygon vertex becomes a mesh vertex and polygons are triangulated as fans, count both
+                // so the mesh streams are allocated once
+                size_t meshVertexCount = 0;
+                size_t meshFaceCount = 0;
+
                 {
                     FbxLayerElementArrayTemplate<int>* fbxMaterialIndices;
                     m_fbxMesh->GetMaterialIndices(&fbxMaterialIndices); // per polygon
@@ -79,6 +95,9 @@ namespace AZ
                             continue;
                         }
 
+                        meshVertexCount += fbxPolygonVertexCount;
+                        meshFaceCount += fbxPolygonVertexCount - 2;
+
                         // Get the material index of each polygon
                         const int meshMaterialIndex = fbxMaterialIndices ? (*fbxMaterialIndices)[fbxPolygonIndex] : -1;
                         minMeshMaterialIndex = AZ::GetMin<int>(minMeshMaterialIndex, meshMaterialIndex);
@@ -103,6 +122,8 @@ namespace AZ
 
                 // Fill geometry
 
+                mesh->ReserveContainerSpace(meshVertexCount, meshFaceCount);
+
                 {
                     // Control points contain positions of vertices
                     AZStd::vector<Vector3> fbxControlPoints = m_fbxMesh->GetControlPoints();
@@ -212,20 +233,19 @@ namespace AZ
                 }
 
                 m_vertexCount = mesh->GetVertexCount();
-                m_graph.SetContent(m_targetNode, AZStd::move(mesh));
+                content.m_content = mesh;
                 
                 // Append vertex color streams if found.
-                ProcessVertexColors();
+                ProcessVertexColors(content);
 
                 // Append uv/texcoord information if found.
-                ProcessVertexUVs();
+                ProcessVertexUVs(content);
                 
                 return true;
             }
 
-            void FbxMeshBuilder::ProcessVertexColors()
+            void FbxMeshBuilder::ProcessVertexColors(FbxNodeContent& content)
             {
-                Containers::SceneGraph::NodeIndex currentNode = m_targetNode;
                 for (int index = 0; index < m_fbxMesh->GetElementVertexColorCount(); ++index)
                 {
                     FbxSDKWrapper::FbxVertexColorWrapper fbxVertexColors = m_fbxMesh->GetElementVertexColor(index);
@@ -243,18 +263,18 @@ namespace AZ
                         continue;
                     }
 
+                    FbxNodeContent::Child child;
                     if (Containers::SceneGraph::IsValidName(fbxVertexColors.GetName()))
                     {
-                        currentNode = m_graph.AddChild(m_targetNode, fbxVertexColors.GetName(), AZStd::move(vertexColors));
+                        child.m_name = fbxVertexColors.GetName();
                     }
                     else
                     {
-                        AZStd::string name("colorStream_");
-                        name += AZStd::to_string(index);
-                        currentNode = m_graph.AddChild(m_targetNode, name.c_str(), AZStd::move(vertexColors));
+                        child.m_name = "colorStream_";
+                        child.m_name += AZStd::to_string(index);
                     }
-
-                    m_graph.MakeEndPoint(currentNode);
+                    child.m_content = AZStd::move(vertexColors);
+                    content.m_children.push_back(AZStd::move(child));
                 }
             }
 
@@ -303,9 +323,8 @@ namespace AZ
                 return colorData;
             }
 
-            void FbxMeshBuilder::ProcessVertexUVs()
+            void FbxMeshBuilder::ProcessVertexUVs(FbxNodeContent& content)
             {
-                Containers::SceneGraph::NodeIndex currentNode = m_targetNode;
                 int uv_count = m_fbxMesh->GetElementUVCount();
                 for (int index = 0; index < uv_count; ++index)
                 {
@@ -326,8 +345,10 @@ namespace AZ
                         continue;
                     }
 
-                    currentNode = m_graph.AddChild(m_targetNode, fbxVertexUVs.GetName(), AZStd::move(vertexUVs));
-                    m_graph.MakeEndPoint(currentNode);
+                    FbxNodeContent::Child child;
+                    child.m_name = fbxVertexUVs.GetName();
+                    child.m_content = AZStd::move(vertexUVs);
+                    content.m_children.push_back(AZStd::move(child));
                 }
             }
 
@@ -17,6 +17,7 @@
 #include <AzCore/std/smart_ptr/shared_ptr.h>
 #include <SceneAPI/SceneCore/Containers/SceneGraph.h>
 #include <SceneAPI/FbxSceneBuilder/FbxSceneBuilderConfiguration.h>
+#include <SceneAPI/FbxSceneBuilder/FbxNodeContent.h>
 
 namespace AZ
 {
@@ -48,6 +49,8 @@ namespace AZ
             // FbxMeshBuilder builds the SceneGraph data MeshData from FbxMeshWrapper data
             //      It converts positions, normals, texture coordinates & vertex colors and faces
             //      on a per-vertex basis
+            //      The conversion itself doesn't touch the SceneGraph, so different meshes can be converted on separate threads
+            //      with ConvertMesh and committed to the graph afterwards by the thread that owns it.
             class FbxMeshBuilder
             {
             public:
@@ -57,14 +60,17 @@ namespace AZ
                 // Builds and adds a mesh to the SceneGraph. The result indicates if data was added, but even if true doesn't guarantee 
                 //      that all data from the source FBX file was used.
                 FBX_SCENE_BUILDER_API bool BuildMesh();
+                // Builds the mesh and its vertex streams into content without adding them to a SceneGraph. content is left empty
+                //      if this fails.
+                FBX_SCENE_BUILDER_API bool ConvertMesh(FbxNodeContent& content);
 
             protected:
-                bool BuildMeshInternal(const AZStd::shared_ptr<SceneData::GraphData::MeshData>& mesh);
+                bool BuildMeshInternal(const AZStd::shared_ptr<SceneData::GraphData::MeshData>& mesh, FbxNodeContent& content);
 
-                void ProcessVertexColors();
+                void ProcessVertexColors(FbxNodeContent& content);
                 AZStd::shared_ptr<DataTypes::IGraphObject> BuildVertexColorData(int index);
 
-                void ProcessVertexUVs();
+                void ProcessVertexUVs(FbxNodeContent& content);
                 AZStd::shared_ptr<DataTypes::IGraphObject> BuildVertexUVData(int index);
 
                 std::shared_ptr<FbxSDKWrapper::FbxMeshWrapper> m_fbxMesh;
@@ -0,0 +1,44 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#include <SceneAPI/FbxSceneBuilder/FbxNodeContent.h>
+#include <SceneAPI/SceneCore/DataTypes/IGraphObject.h>
+
+namespace AZ
+{
+    namespace SceneAPI
+    {
+        namespace FbxSceneImporter
+        {
+            void FbxNodeContent::Commit(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex target)
+            {
+                for (Child& child : m_children)
+                {
+                    Containers::SceneGraph::NodeIndex childNode = graph.AddChild(target, child.m_name.c_str(), AZStd::move(child.m_content));
+                    graph.MakeEndPoint(childNode);
+                }
+                m_children.clear();
+
+                if (m_content)
+                {
+                    graph.SetContent(target, AZStd::move(m_content));
+                }
+            }
+
+            void FbxNodeContent::Clear()
+            {
+                m_content.reset();
+                m_children.clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#include <AzCore/std/string/string.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <SceneAPI/SceneCore/Containers/SceneGraph.h>
+#include <SceneAPI/FbxSceneBuilder/FbxSceneBuilderConfiguration.h>
+
+namespace AZ
+{
+    namespace SceneAPI
+    {
+        namespace DataTypes
+        {
+            class IGraphObject;
+        }
+
+        namespace FbxSceneImporter
+        {
+            // FbxNodeContent holds the graph objects built for a single SceneGraph node without adding them to the graph.
+            //      Builders fill it from fbx data, which can happen on any thread, after which the owner of the graph
+            //      commits it. Committing in a fixed order keeps the node order independent of the build order.
+            struct FbxNodeContent
+            {
+                struct Child
+                {
+                    AZStd::string m_name;
+                    AZStd::shared_ptr<DataTypes::IGraphObject> m_content;
+                };
+
+                // Adds the children below the target as end points, in order, and sets the target's content.
+                FBX_SCENE_BUILDER_API void Commit(Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex target);
+                FBX_SCENE_BUILDER_API void Clear();
+
+                // Content of the target node itself, may be null if only children are added.
+                AZStd::shared_ptr<DataTypes::IGraphObject> m_content;
+                AZStd::vector<Child> m_children;
+            };
+        }
+    }
+}
@@ -39,24 +39,41 @@ namespace AZ
             }
 
             bool FbxSkinBuilder::BuildSkin()
+            {
+                FbxNodeContent content;
+                if (!ConvertSkin(content))
+                {
+                    return false;
+                }
+                content.Commit(m_graph, m_targetNode);
+                return true;
+            }
+
+            bool FbxSkinBuilder::ConvertSkin(FbxNodeContent& content)
             {
                 if (!m_fbxMesh)
                 {
                     return false;
                 }
                 
-                if (!ProcessSkinDeformers())
+                if (!ProcessSkinDeformers(content))
                 {
+                    content.Clear();
                     return false;
                 }
 
                 AZStd::shared_ptr<SceneData::GraphData::SkinMeshData> skinMesh = AZStd::make_shared<SceneData::GraphData::SkinMeshData>();
-                return BuildMeshInternal(skinMesh);
+                if (!BuildMeshInternal(skinMesh, content))
+                {
+                    content.Clear();
+                    return false;
+                }
+                return true;
             }
 
-            bool FbxSkinBuilder::ProcessSkinDeformers()
+            bool FbxSkinBuilder::ProcessSkinDeformers(FbxNodeContent& content)
             {
-                Containers::SceneGraph::NodeIndex currentNode = m_targetNode;
+                size_t initialChildCount = content.m_children.size();
                 for (int deformerIndex = 0; deformerIndex < m_fbxMesh->GetDeformerCount(); ++deformerIndex)
                 {
                     AZStd::shared_ptr<const FbxSDKWrapper::FbxSkinWrapper> fbxSkin = m_fbxMesh->GetSkin(deformerIndex);
@@ -77,11 +94,13 @@ namespace AZ
                         continue;
                     }
 
-                    currentNode = m_graph.AddChild(m_targetNode, fbxSkin->GetName(), AZStd::move(skinDeformer));
-                    m_graph.MakeEndPoint(currentNode);
+                    FbxNodeContent::Child child;
+                    child.m_name = fbxSkin->GetName();
+                    child.m_content = AZStd::move(skinDeformer);
+                    content.m_children.push_back(AZStd::move(child));
                 }
 
-                bool builtSkinDeformer = currentNode != m_targetNode;
+                bool builtSkinDeformer = content.m_children.size() != initialChildCount;
                 return builtSkinDeformer;
             }
 
@@ -97,26 +116,59 @@ namespace AZ
                 AZStd::shared_ptr<SceneData::GraphData::SkinWeightData> skinWeightData = AZStd::make_shared<SceneData::GraphData::SkinWeightData>();
 
                 int controlPointCount = m_fbxMesh->GetControlPointsCount();
-                skinWeightData->ResizeContainerSpace(controlPointCount);
-
                 int clusterCount = fbxSkin->GetClusterCount();
 
+                // The clusters list their links per bone, gather them first and then sort them by control point
+                //      into the single array the skin weight data stores them in.
+                size_t totalClusterPointCount = 0;
                 for (int clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
                 {
-                    int controlPointCount = fbxSkin->GetClusterControlPointIndicesCount(clusterIndex);
+                    totalClusterPointCount += fbxSkin->GetClusterControlPointIndicesCount(clusterIndex);
+                }
+                AZStd::vector<int> linkControlPoints;
+                linkControlPoints.reserve(totalClusterPointCount);
+                AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link> clusterLinks;
+                clusterLinks.reserve(totalClusterPointCount);
+                AZStd::vector<size_t> linkOffsets(controlPointCount + 1, 0);
+                for (int clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+                {
+                    int clusterPointCount = fbxSkin->GetClusterControlPointIndicesCount(clusterIndex);
                     AZStd::shared_ptr<const FbxSDKWrapper::FbxNodeWrapper> fbxLink = fbxSkin->GetClusterLink(clusterIndex);
                     AZStd::string boneName = fbxLink->GetName();
                     int boneId = skinWeightData->GetBoneId(boneName);
 
-                    for (int pointIndex = 0; pointIndex < controlPointCount; ++pointIndex)
+                    for (int pointIndex = 0; pointIndex < clusterPointCount; ++pointIndex)
                     {
+                        int controlPointIndex = fbxSkin->GetClusterControlPointIndex(clusterIndex, pointIndex);
+                        if (controlPointIndex < 0 || controlPointIndex >= controlPointCount)
+                        {
+                            AZ_TracePrintf(Utilities::WarningWindow, "Skin link to invalid control point %i ignored.", controlPointIndex);
+                            continue;
+                        }
+
                         SceneAPI::DataTypes::ISkinWeightData::Link link;
                         link.boneId = boneId;
                         link.weight = aznumeric_caster(fbxSkin->GetClusterControlPointWeight(clusterIndex, pointIndex));
-                        skinWeightData->AppendLink(fbxSkin->GetClusterControlPointIndex(clusterIndex, pointIndex), link);
+                        linkControlPoints.push_back(controlPointIndex);
+                        clusterLinks.push_back(link);
+                        ++linkOffsets[controlPointIndex + 1];
                     }
                 }
 
+                for (int i = 0; i < controlPointCount; ++i)
+                {
+                    linkOffsets[i + 1] += linkOffsets[i];
+                }
+
+                // Scatter in cluster order so every control point keeps its links in the order the clusters list them.
+                AZStd::vector<size_t> insertPositions(linkOffsets.begin(), linkOffsets.end() - 1);
+                AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link> links(clusterLinks.size());
+                for (size_t i = 0; i < clusterLinks.size(); ++i)
+                {
+                    links[insertPositions[linkControlPoints[i]]++] = clusterLinks[i];
+                }
+
+                skinWeightData->SetLinks(AZStd::move(linkOffsets), AZStd::move(links));
                 return skinWeightData;
             }
         }
@@ -28,9 +28,12 @@ namespace AZ
                 FBX_SCENE_BUILDER_API void Reset(const std::shared_ptr<FbxSDKWrapper::FbxMeshWrapper>& fbxMesh, Containers::SceneGraph& graph, Containers::SceneGraph::NodeIndex target, const std::shared_ptr<FbxSceneSystem>& sceneSystem);
 
                 FBX_SCENE_BUILDER_API bool BuildSkin();
+                // Builds the skin weights and skinned mesh into content without adding them to a SceneGraph, see
+                //      FbxMeshBuilder::ConvertMesh. content is left empty if this fails.
+                FBX_SCENE_BUILDER_API bool ConvertSkin(FbxNodeContent& content);
 
             protected:
-                bool ProcessSkinDeformers();
+                bool ProcessSkinDeformers(FbxNodeContent& content);
                 AZStd::shared_ptr<DataTypes::IGraphObject> FbxSkinBuilder::BuildSkinWeightData(int index);
             };
         }
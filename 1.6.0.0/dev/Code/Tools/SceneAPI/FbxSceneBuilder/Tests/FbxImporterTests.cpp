@@ -11,13 +11,19 @@
 *
 */
 
+#include <algorithm>
+#include <chrono>
 #include <AzTest/AzTest.h>
+#include <AzCore/std/parallel/thread.h>
+#include <AzCore/std/string/conversions.h>
 #include <SceneAPI/FbxSceneBuilder/FbxImporter.h>
+#include <SceneAPI/FbxSceneBuilder/Tests/TestFbxMesh.h>
 #include <SceneAPI/FbxSDKWrapper/Mocks/MockFbxSceneWrapper.h>
 #include <SceneAPI/FbxSDKWrapper/Mocks/MockFbxNodeWrapper.h>
 #include <SceneAPI/FbxSDKWrapper/Mocks/MockFbxSystemUnitWrapper.h>
 #include <SceneAPI/FbxSDKWrapper/Mocks/MockFbxAxisSystemWrapper.h>
 #include <SceneAPI/SceneCore/Containers/Scene.h>
+#include <SceneAPI/SceneCore/DataTypes/GraphData/IMeshData.h>
 
 namespace AZ
 {
@@ -191,7 +197,140 @@ namespace AZ
 
                 EXPECT_TRUE(IsCorrectlyNamedEmptyRootNode(sceneGraph, fbxRootIndex));
             }
+
+            class FbxImporterLargeSceneTests
+                : public FbxImporterFakeIOTests
+            {
+            protected:
+                static const int s_meshCount = 256;
+                static const int s_gridSize = 32;
+
+                void SetUp() override
+                {
+                    FbxImporterFakeIOTests::SetUp();
+
+                    ON_CALL(*m_stubFbxScene, LoadSceneFromFile(Matcher<const char*>(_)))
+                        .WillByDefault(Return(true));
+                    ON_CALL(*m_stubFbxScene, GetRootNode())
+                        .WillByDefault(Return(m_stubFbxNode));
+                    ON_CALL(*m_stubFbxNode, GetChildCount())
+                        .WillByDefault(Return(s_meshCount));
+
+                    // Every child of the root holds a grid of quads, all in the same plane but offset so they're distinguishable.
+                    m_meshNodeNames.reserve(s_meshCount);
+                    for (int meshIndex = 0; meshIndex < s_meshCount; ++meshIndex)
+                    {
+                        std::vector<AZ::Vector3> points;
+                        for (int y = 0; y <= s_gridSize; ++y)
+                        {
+                            for (int x = 0; x <= s_gridSize; ++x)
+                            {
+                                points.push_back(AZ::Vector3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(meshIndex)));
+                            }
+                        }
+                        std::vector<std::vector<int> > polygons;
+                        for (int y = 0; y < s_gridSize; ++y)
+                        {
+                            for (int x = 0; x < s_gridSize; ++x)
+                            {
+                                int corner = y * (s_gridSize + 1) + x;
+                                polygons.push_back({ corner, corner + 1, corner + s_gridSize + 2, corner + s_gridSize + 1 });
+                            }
+                        }
+                        std::shared_ptr<FbxSDKWrapper::TestFbxMesh> mesh = std::make_shared<FbxSDKWrapper::TestFbxMesh>();
+                        mesh->CreateMesh(points, polygons);
+
+                        m_meshNodeNames.push_back(AZStd::string("mesh_") + AZStd::to_string(meshIndex));
+                        std::shared_ptr<NiceMock<FbxSDKWrapper::MockFbxNodeWrapper> > node = std::make_shared<NiceMock<FbxSDKWrapper::MockFbxNodeWrapper> >();
+                        ON_CALL(*node, GetName())
+                            .WillByDefault(Return(m_meshNodeNames.back().c_str()));
+                        ON_CALL(*node, GetMesh())
+                            .WillByDefault(Return(mesh));
+                        ON_CALL(*node, EvaluateLocalTransform())
+                            .WillByDefault(Return(m_identityMatrix));
+                        ON_CALL(*node, GetGeometricTransform())
+                            .WillByDefault(Return(m_identityMatrix));
+                        ON_CALL(*node, GetChildCount())
+                            .WillByDefault(Return(0));
+                        ON_CALL(*m_stubFbxNode, GetChild(meshIndex))
+                            .WillByDefault(Return(node));
+                        m_meshNodes.push_back(node);
+                    }
+                }
+
+                // Returns the time the import took in milliseconds.
+                double Import(unsigned int threadCount, Containers::Scene& scene)
+                {
+                    m_testFbxImporter->SetThreadCount(threadCount);
+                    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                    EXPECT_TRUE(m_testFbxImporter->PopulateFromFile("fake.fbx", scene));
+                    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+                    return duration.count();
+                }
+
+                AZStd::vector<AZStd::string> m_meshNodeNames;
+                AZStd::vector<std::shared_ptr<NiceMock<FbxSDKWrapper::MockFbxNodeWrapper> > > m_meshNodes;
+            };
+
+            TEST_F(FbxImporterLargeSceneTests, PopulateSceneFromFile_ParallelConversion_SameGraphAsSerialConversion)
+            {
+                Containers::Scene serialScene("serialScene");
+                Import(1, serialScene);
+                Containers::Scene parallelScene("parallelScene");
+                // A fixed count so the conversion runs in parallel on machines with a single hardware thread as well.
+                Import(4, parallelScene);
+
+                const Containers::SceneGraph& serialGraph = serialScene.GetGraph();
+                const Containers::SceneGraph& parallelGraph = parallelScene.GetGraph();
+                ASSERT_EQ(serialGraph.GetNodeCount(), parallelGraph.GetNodeCount());
+                EXPECT_LT(static_cast<size_t>(s_meshCount), serialGraph.GetNodeCount());
+
+                auto serialNames = serialGraph.GetNameStorage();
+                auto parallelNames = parallelGraph.GetNameStorage();
+                EXPECT_TRUE(std::equal(serialNames.begin(), serialNames.end(), parallelNames.begin()));
+
+                auto serialContent = serialGraph.GetContentStorage();
+                auto parallelContent = parallelGraph.GetContentStorage();
+                auto parallelIt = parallelContent.begin();
+                for (auto serialIt = serialContent.begin(); serialIt != serialContent.end(); ++serialIt, ++parallelIt)
+                {
+                    ASSERT_EQ(*serialIt == nullptr, *parallelIt == nullptr);
+                    if (!*serialIt)
+                    {
+                        continue;
+                    }
+                    EXPECT_EQ((*serialIt)->RTTI_GetType(), (*parallelIt)->RTTI_GetType());
+
+                    AZStd::shared_ptr<const DataTypes::IMeshData> serialMesh = azrtti_cast<const DataTypes::IMeshData*>(*serialIt);
+                    AZStd::shared_ptr<const DataTypes::IMeshData> parallelMesh = azrtti_cast<const DataTypes::IMeshData*>(*parallelIt);
+                    if (serialMesh && parallelMesh)
+                    {
+                        ASSERT_EQ(serialMesh->GetVertexCount(), parallelMesh->GetVertexCount());
+                        ASSERT_EQ(serialMesh->GetFaceCount(), parallelMesh->GetFaceCount());
+                        for (unsigned int i = 0; i < serialMesh->GetVertexCount(); ++i)
+                        {
+                            EXPECT_EQ(serialMesh->GetPosition(i), parallelMesh->GetPosition(i));
+                        }
+                    }
+                }
+            }
+
+            TEST_F(FbxImporterLargeSceneTests, PopulateSceneFromFile_SerialAndParallelConversion_ReportsTimings)
+            {
+                // Warm up so neither run pays for first time allocations.
+                Containers::Scene warmUpScene("warmUpScene");
+                Import(1, warmUpScene);
+
+                Containers::Scene serialScene("serialScene");
+                double serialTime = Import(1, serialScene);
+                Containers::Scene parallelScene("parallelScene");
+                double parallelTime = Import(0, parallelScene);
+                EXPECT_EQ(serialScene.GetGraph().GetNodeCount(), parallelScene.GetGraph().GetNodeCount());
+
+                printf("[ BENCHMARK] Imported %i meshes of %i quads: serial %.2f ms, parallel on %u threads %.2f ms, speedup %.2fx\n",
+                    s_meshCount, s_gridSize * s_gridSize, serialTime, AZStd::thread::hardware_concurrency(), parallelTime,
+                    parallelTime > 0.0 ? serialTime / parallelTime : 0.0);
+            }
         }
     }
 }
-
@@ -165,6 +165,20 @@ namespace AZ
                             EXPECT_EQ(link.weight, m_stubFbxSkin->GetExpectedSkinLinkWeight(vertexIndex, linkIndex));
                         }
                     }
+
+                    // The builder fills the links in one go, so the bulk accessors must see the same links.
+                    const DataTypes::ISkinWeightData::Link* links = buildSkinWeight->GetLinks();
+                    const size_t* linkOffsets = buildSkinWeight->GetLinkOffsets();
+                    ASSERT_NE(nullptr, links);
+                    ASSERT_NE(nullptr, linkOffsets);
+                    for (size_t vertexIndex = 0; vertexIndex < buildSkinWeight->GetVertexCount(); ++vertexIndex)
+                    {
+                        ASSERT_EQ(buildSkinWeight->GetLinkCount(vertexIndex), linkOffsets[vertexIndex + 1] - linkOffsets[vertexIndex]);
+                        for (size_t linkIndex = 0; linkIndex < buildSkinWeight->GetLinkCount(vertexIndex); ++linkIndex)
+                        {
+                            EXPECT_EQ(&buildSkinWeight->GetLink(vertexIndex, linkIndex), &links[linkOffsets[vertexIndex] + linkIndex]);
+                        }
+                    }
                 }
 
                 AZStd::shared_ptr<FbxSDKWrapper::TestFbxSkin> m_stubFbxSkin;
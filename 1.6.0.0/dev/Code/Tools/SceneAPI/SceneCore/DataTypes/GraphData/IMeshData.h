@@ -49,6 +49,14 @@ namespace AZ
                 virtual const Face& GetFaceInfo(unsigned int index) const = 0;
                 virtual unsigned int GetFaceMaterialId(unsigned int index) const = 0;
 
+                // Bulk access to the streams above. Each returns the first element of a contiguous array with
+                //      GetVertexCount() or GetFaceCount() entries, or null if the stream is empty or the data
+                //      isn't stored as a single array, in which case the per-element functions must be used.
+                virtual const AZ::Vector3* GetPositions() const = 0;
+                virtual const AZ::Vector3* GetNormals() const = 0;
+                virtual const Face* GetFaces() const = 0;
+                virtual const unsigned int* GetFaceMaterialIds() const = 0;
+
                 static const int s_invalidMaterialId = 0;
             };
         }  //namespace DataTypes
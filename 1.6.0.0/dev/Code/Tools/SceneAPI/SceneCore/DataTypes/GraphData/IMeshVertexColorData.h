@@ -39,6 +39,8 @@ namespace AZ
 
                 virtual size_t GetCount() const = 0;
                 virtual const Color& GetColor(size_t index) const = 0;
+                // Contiguous array of GetCount() colors, or null if they aren't stored as a single array.
+                virtual const Color* GetColors() const = 0;
             };
         }  // DataTypes
     }  // SceneAPI
@@ -36,6 +36,8 @@ namespace AZ
 
                 virtual size_t GetCount() const = 0;
                 virtual const AZ::Vector2& GetUV(size_t index) const = 0;
+                // Contiguous array of GetCount() UVs, or null if they aren't stored as a single array.
+                virtual const AZ::Vector2* GetUVs() const = 0;
             };
         }  // DataTypes
     }  // SceneAPI
@@ -39,6 +39,13 @@ namespace AZ
                 virtual size_t GetVertexCount() const = 0;
                 virtual size_t GetLinkCount(size_t vertexIndex) const = 0;
                 virtual const Link& GetLink(size_t vertexIndex, size_t linkIndex) const = 0;
+
+                // Bulk access to the links of all vertices. The links are grouped by vertex in vertex order, the
+                //      links of vertex i are GetLinks()[GetLinkOffsets()[i]] up to GetLinks()[GetLinkOffsets()[i + 1]].
+                //      GetLinkOffsets() has GetVertexCount() + 1 entries. Both return null if the links aren't
+                //      stored this way.
+                virtual const Link* GetLinks() const = 0;
+                virtual const size_t* GetLinkOffsets() const = 0;
             };
         }  // DataTypes
     }  // SceneAPI
@@ -47,6 +47,14 @@ namespace AZ
                     const Face&(unsigned int index));
                 MOCK_CONST_METHOD1(GetFaceMaterialId,
                     unsigned int(unsigned int index));
+                MOCK_CONST_METHOD0(GetPositions,
+                    const AZ::Vector3*());
+                MOCK_CONST_METHOD0(GetNormals,
+                    const AZ::Vector3*());
+                MOCK_CONST_METHOD0(GetFaces,
+                    const Face*());
+                MOCK_CONST_METHOD0(GetFaceMaterialIds,
+                    const unsigned int*());
             };
         }  // namespace DataTypes
     }  //namespace SceneAPI
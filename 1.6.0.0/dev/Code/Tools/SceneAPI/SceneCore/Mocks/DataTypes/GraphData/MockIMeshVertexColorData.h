@@ -33,6 +33,8 @@ namespace AZ
                     size_t());
                 MOCK_CONST_METHOD1(GetColor,
                     const Color&(size_t index));
+                MOCK_CONST_METHOD0(GetColors,
+                    const Color*());
             };
         }  // namespace DataTypes
     }  //namespace SceneAPI
@@ -33,6 +33,8 @@ namespace AZ
                     size_t());
                 MOCK_CONST_METHOD1(GetUV,
                     const AZ::Vector2&(size_t index));
+                MOCK_CONST_METHOD0(GetUVs,
+                    const AZ::Vector2*());
             };
         }  // DataTypes
     }  // SceneAPI
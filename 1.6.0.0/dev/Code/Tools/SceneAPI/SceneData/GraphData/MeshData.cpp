@@ -33,6 +33,14 @@ namespace AZ
                 m_normals.push_back(normal);
             }
 
+            void MeshData::ReserveContainerSpace(size_t vertexCount, size_t faceCount)
+            {
+                m_positions.reserve(vertexCount);
+                m_normals.reserve(vertexCount);
+                m_faceList.reserve(faceCount);
+                m_faceMaterialIds.reserve(faceCount);
+            }
+
             //assume consistent winding - no stripping or fanning expected (3 index per face)
             void MeshData::AddFace(unsigned int index1, unsigned int index2, unsigned int index3, unsigned int faceMaterialId)
             {
@@ -88,6 +96,26 @@ namespace AZ
                 AZ_Assert(index < m_faceMaterialIds.size(), "GetFaceMaterialIds index not in range");
                 return m_faceMaterialIds[index];
             }
+
+            const AZ::Vector3* MeshData::GetPositions() const
+            {
+                return m_positions.empty() ? nullptr : m_positions.data();
+            }
+
+            const AZ::Vector3* MeshData::GetNormals() const
+            {
+                return m_normals.empty() ? nullptr : m_normals.data();
+            }
+
+            const DataTypes::IMeshData::Face* MeshData::GetFaces() const
+            {
+                return m_faceList.empty() ? nullptr : m_faceList.data();
+            }
+
+            const unsigned int* MeshData::GetFaceMaterialIds() const
+            {
+                return m_faceMaterialIds.empty() ? nullptr : m_faceMaterialIds.data();
+            }
         }
     }
 }
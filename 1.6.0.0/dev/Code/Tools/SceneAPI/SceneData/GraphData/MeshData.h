@@ -38,6 +38,10 @@ namespace AZ
                 SCENE_DATA_API virtual void AddPosition(const AZ::Vector3& position);
                 SCENE_DATA_API virtual void AddNormal(const AZ::Vector3& normal);
 
+                // Pre-allocates memory for the vertex and face streams so they don't need to grow while the
+                //      mesh is being filled.
+                SCENE_DATA_API void ReserveContainerSpace(size_t vertexCount, size_t faceCount);
+
                 //assume consistent winding - no stripping or fanning expected (3 index per face)
                 SCENE_DATA_API void AddFace(unsigned int index1, unsigned int index2, unsigned int index3,
                     unsigned int faceMaterialId = AZ::SceneAPI::DataTypes::IMeshData::s_invalidMaterialId);
@@ -54,7 +58,10 @@ namespace AZ
                 SCENE_DATA_API const AZ::SceneAPI::DataTypes::IMeshData::Face& GetFaceInfo(unsigned int index) const override;
                 SCENE_DATA_API unsigned int GetFaceMaterialId(unsigned int index) const override;
 
-
+                SCENE_DATA_API const AZ::Vector3* GetPositions() const override;
+                SCENE_DATA_API const AZ::Vector3* GetNormals() const override;
+                SCENE_DATA_API const AZ::SceneAPI::DataTypes::IMeshData::Face* GetFaces() const override;
+                SCENE_DATA_API const unsigned int* GetFaceMaterialIds() const override;
 
             protected:
                 AZStd::vector<AZ::Vector3>  m_positions;
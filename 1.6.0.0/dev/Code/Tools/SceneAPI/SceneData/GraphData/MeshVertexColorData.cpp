@@ -29,6 +29,11 @@ namespace AZ
                 return m_colors[index];
             }
 
+            const AZ::SceneAPI::DataTypes::Color* MeshVertexColorData::GetColors() const
+            {
+                return m_colors.empty() ? nullptr : m_colors.data();
+            }
+
             void MeshVertexColorData::ReserveContainerSpace(size_t size)
             {
                 m_colors.reserve(size);
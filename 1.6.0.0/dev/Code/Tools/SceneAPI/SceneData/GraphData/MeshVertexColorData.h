@@ -32,6 +32,7 @@ namespace AZ
 
                 SCENE_DATA_API size_t GetCount() const override;
                 SCENE_DATA_API const AZ::SceneAPI::DataTypes::Color& GetColor(size_t index) const override;
+                SCENE_DATA_API const AZ::SceneAPI::DataTypes::Color* GetColors() const override;
 
                 // Pre-allocates memory for the color storage container. This can speed up loading as
                 //      the container doesn't need to resize between adding colors.
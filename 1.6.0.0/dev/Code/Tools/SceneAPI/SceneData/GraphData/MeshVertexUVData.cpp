@@ -29,6 +29,11 @@ namespace AZ
                 return m_uvs[index];
             }
 
+            const AZ::Vector2* MeshVertexUVData::GetUVs() const
+            {
+                return m_uvs.empty() ? nullptr : m_uvs.data();
+            }
+
             void MeshVertexUVData::ReserveContainerSpace(size_t size)
             {
                 m_uvs.reserve(size);
@@ -34,6 +34,7 @@ namespace AZ
 
                 SCENE_DATA_API size_t GetCount() const override;
                 SCENE_DATA_API const AZ::Vector2& GetUV(size_t index) const override;
+                SCENE_DATA_API const AZ::Vector2* GetUVs() const override;
 
                 // Pre-allocate memory
                 SCENE_DATA_API void ReserveContainerSpace(size_t size);
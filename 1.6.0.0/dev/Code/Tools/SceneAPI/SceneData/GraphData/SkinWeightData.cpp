@@ -21,31 +21,55 @@ namespace AZ
         {
             size_t SkinWeightData::GetVertexCount() const
             {
-                return m_vertexLinks.size();
+                return m_linkOffsets.empty() ? 0 : m_linkOffsets.size() - 1;
             }
 
             size_t SkinWeightData::GetLinkCount(size_t vertexIndex) const
             {
-                AZ_Assert(vertexIndex < m_vertexLinks.size(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
-                return m_vertexLinks[vertexIndex].size();
+                AZ_Assert(vertexIndex < GetVertexCount(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
+                return m_linkOffsets[vertexIndex + 1] - m_linkOffsets[vertexIndex];
             }
 
             const SceneAPI::DataTypes::ISkinWeightData::Link& SkinWeightData::GetLink(size_t vertexIndex, size_t linkIndex) const
             {
-                AZ_Assert(vertexIndex < m_vertexLinks.size(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
-                AZ_Assert(linkIndex < m_vertexLinks[vertexIndex].size(), "Invalid link index %i for skin weight data %i.", linkIndex, vertexIndex);
-                return m_vertexLinks[vertexIndex][linkIndex];
+                AZ_Assert(vertexIndex < GetVertexCount(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
+                AZ_Assert(linkIndex < GetLinkCount(vertexIndex), "Invalid link index %i for skin weight data %i.", linkIndex, vertexIndex);
+                return m_links[m_linkOffsets[vertexIndex] + linkIndex];
+            }
+
+            const SceneAPI::DataTypes::ISkinWeightData::Link* SkinWeightData::GetLinks() const
+            {
+                return m_links.empty() ? nullptr : m_links.data();
+            }
+
+            const size_t* SkinWeightData::GetLinkOffsets() const
+            {
+                return m_linkOffsets.empty() ? nullptr : m_linkOffsets.data();
             }
 
             void SkinWeightData::ResizeContainerSpace(size_t size)
             {
-                m_vertexLinks.resize(size);
+                // New vertices start without links, removed vertices take their links with them.
+                size_t linkCount = m_linkOffsets.empty() ? 0 : m_linkOffsets.back();
+                m_linkOffsets.resize(size + 1, linkCount);
+                m_links.resize(m_linkOffsets.back());
             }
 
             void SkinWeightData::AppendLink(size_t vertexIndex, const SceneAPI::DataTypes::ISkinWeightData::Link& link)
             {
-                AZ_Assert(vertexIndex < m_vertexLinks.size(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
-                m_vertexLinks[vertexIndex].push_back(link);
+                AZ_Assert(vertexIndex < GetVertexCount(), "Invalid vertex index %i for skin weight data links.", vertexIndex);
+                m_links.insert(m_links.begin() + m_linkOffsets[vertexIndex + 1], link);
+                for (size_t i = vertexIndex + 1; i < m_linkOffsets.size(); ++i)
+                {
+                    ++m_linkOffsets[i];
+                }
+            }
+
+            void SkinWeightData::SetLinks(AZStd::vector<size_t>&& linkOffsets, AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link>&& links)
+            {
+                AZ_Assert(!linkOffsets.empty() && linkOffsets.back() == links.size(), "Skin weight link offsets don't match the number of links (%i).", links.size());
+                m_linkOffsets = AZStd::move(linkOffsets);
+                m_links = AZStd::move(links);
             }
 
             int SkinWeightData::GetBoneId(const AZStd::string& boneName)
@@ -35,14 +35,23 @@ namespace AZ
                 SCENE_DATA_API size_t GetVertexCount() const override;
                 SCENE_DATA_API size_t GetLinkCount(size_t vertexIndex) const override;
                 SCENE_DATA_API const Link& GetLink(size_t vertexIndex, size_t linkIndex) const override;
+                SCENE_DATA_API const Link* GetLinks() const override;
+                SCENE_DATA_API const size_t* GetLinkOffsets() const override;
 
                 SCENE_DATA_API void ResizeContainerSpace(size_t size);
+                // Inserts the link after the existing links of the vertex. This moves the links of all following
+                //      vertices, use SetLinks to fill all vertices at once.
                 SCENE_DATA_API void AppendLink(size_t vertexIndex, const SceneAPI::DataTypes::ISkinWeightData::Link& link);
+                // Replaces all links. linkOffsets has one entry per vertex plus a final one equal to the number of
+                //      links, see ISkinWeightData::GetLinkOffsets.
+                SCENE_DATA_API void SetLinks(AZStd::vector<size_t>&& linkOffsets, AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link>&& links);
 
                 SCENE_DATA_API int GetBoneId(const AZStd::string& boneName);
 
             protected:
-                AZStd::vector<AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link>> m_vertexLinks;
+                // Links of all vertices grouped by vertex, m_linkOffsets[i] is the first link of vertex i
+                AZStd::vector<SceneAPI::DataTypes::ISkinWeightData::Link> m_links;
+                AZStd::vector<size_t> m_linkOffsets;
                 AZStd::unordered_map<AZStd::string, int> m_boneNameIdMap;
             };
         } // GraphData
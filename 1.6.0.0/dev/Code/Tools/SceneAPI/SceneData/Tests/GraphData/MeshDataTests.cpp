@@ -121,5 +121,52 @@ namespace AZ
 
             EXPECT_EQ(0, meshData.GetFaceMaterialId(0));
         }
+
+        // ===================================================
+        // == MeshData Bulk Access                          ==
+        // ===================================================
+
+        TEST(MeshData_BulkAccess, GetPositions_DefaultConstruction_ReturnsNull)
+        {
+            AZ::SceneData::GraphData::MeshData meshData;
+
+            EXPECT_EQ(nullptr, meshData.GetPositions());
+            EXPECT_EQ(nullptr, meshData.GetNormals());
+            EXPECT_EQ(nullptr, meshData.GetFaces());
+            EXPECT_EQ(nullptr, meshData.GetFaceMaterialIds());
+        }
+
+        TEST(MeshData_BulkAccess, GetPositions_AddMultiplePositions_MatchesPerElementAccess)
+        {
+            AZ::SceneData::GraphData::MeshData meshData;
+            meshData.ReserveContainerSpace(3, 1);
+            meshData.AddPosition(AZ::Vector3(0.1f, 0.2f, 0.3f));
+            meshData.AddPosition(AZ::Vector3(1.1f, 1.2f, 1.3f));
+            meshData.AddPosition(AZ::Vector3(2.1f, 2.2f, 2.3f));
+
+            const AZ::Vector3* positions = meshData.GetPositions();
+            ASSERT_NE(nullptr, positions);
+            for (unsigned int i = 0; i < meshData.GetVertexCount(); ++i)
+            {
+                EXPECT_EQ(&meshData.GetPosition(i), &positions[i]);
+            }
+        }
+
+        TEST(MeshData_BulkAccess, GetFaces_AddMultipleFaces_MatchesPerElementAccess)
+        {
+            AZ::SceneData::GraphData::MeshData meshData;
+            meshData.AddFace(0, 1, 2, 3);
+            meshData.AddFace(2, 1, 0, 4);
+
+            const AZ::SceneAPI::DataTypes::IMeshData::Face* faces = meshData.GetFaces();
+            const unsigned int* materialIds = meshData.GetFaceMaterialIds();
+            ASSERT_NE(nullptr, faces);
+            ASSERT_NE(nullptr, materialIds);
+            for (unsigned int i = 0; i < meshData.GetFaceCount(); ++i)
+            {
+                EXPECT_EQ(&meshData.GetFaceInfo(i), &faces[i]);
+                EXPECT_EQ(meshData.GetFaceMaterialId(i), materialIds[i]);
+            }
+        }
     }
 }
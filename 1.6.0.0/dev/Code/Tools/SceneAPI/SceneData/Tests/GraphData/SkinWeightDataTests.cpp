@@ -0,0 +1,141 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#include <AzTest/AzTest.h>
+#include <SceneAPI/SceneData/GraphData/SkinWeightData.h>
+#include <SceneAPI/SceneCore/DataTypes/GraphData/ISkinWeightData.h>
+
+namespace AZ
+{
+    namespace SceneData
+    {
+        using Link = AZ::SceneAPI::DataTypes::ISkinWeightData::Link;
+
+        static Link MakeLink(int boneId, float weight)
+        {
+            Link link;
+            link.boneId = boneId;
+            link.weight = weight;
+            return link;
+        }
+
+        static void ExpectBulkMatchesPerElementAccess(const AZ::SceneData::GraphData::SkinWeightData& skinWeightData)
+        {
+            const Link* links = skinWeightData.GetLinks();
+            const size_t* linkOffsets = skinWeightData.GetLinkOffsets();
+            ASSERT_NE(nullptr, linkOffsets);
+            EXPECT_EQ(0, linkOffsets[0]);
+            for (size_t vertexIndex = 0; vertexIndex < skinWeightData.GetVertexCount(); ++vertexIndex)
+            {
+                ASSERT_EQ(skinWeightData.GetLinkCount(vertexIndex), linkOffsets[vertexIndex + 1] - linkOffsets[vertexIndex]);
+                for (size_t linkIndex = 0; linkIndex < skinWeightData.GetLinkCount(vertexIndex); ++linkIndex)
+                {
+                    EXPECT_EQ(&skinWeightData.GetLink(vertexIndex, linkIndex), &links[linkOffsets[vertexIndex] + linkIndex]);
+                }
+            }
+        }
+
+        // ===================================================
+        // == SkinWeightData Bulk Access                    ==
+        // ===================================================
+
+        TEST(SkinWeightData_BulkAccess, GetLinks_DefaultConstruction_ReturnsNull)
+        {
+            AZ::SceneData::GraphData::SkinWeightData skinWeightData;
+
+            EXPECT_EQ(0, skinWeightData.GetVertexCount());
+            EXPECT_EQ(nullptr, skinWeightData.GetLinks());
+            EXPECT_EQ(nullptr, skinWeightData.GetLinkOffsets());
+        }
+
+        TEST(SkinWeightData_BulkAccess, GetLinkOffsets_VerticesWithoutLinks_AllOffsetsZero)
+        {
+            AZ::SceneData::GraphData::SkinWeightData skinWeightData;
+            skinWeightData.ResizeContainerSpace(3);
+
+            EXPECT_EQ(3, skinWeightData.GetVertexCount());
+            EXPECT_EQ(nullptr, skinWeightData.GetLinks());
+            const size_t* linkOffsets = skinWeightData.GetLinkOffsets();
+            ASSERT_NE(nullptr, linkOffsets);
+            for (size_t i = 0; i <= skinWeightData.GetVertexCount(); ++i)
+            {
+                EXPECT_EQ(0, linkOffsets[i]);
+            }
+        }
+
+        TEST(SkinWeightData_BulkAccess, SetLinks_GroupedLinks_MatchesPerElementAccess)
+        {
+            AZ::SceneData::GraphData::SkinWeightData skinWeightData;
+            AZStd::vector<size_t> linkOffsets = { 0, 2, 2, 5 };
+            AZStd::vector<Link> links =
+            {
+                MakeLink(0, 0.25f), MakeLink(1, 0.75f),
+                MakeLink(2, 0.5f), MakeLink(0, 0.3f), MakeLink(1, 0.2f)
+            };
+            skinWeightData.SetLinks(AZStd::move(linkOffsets), AZStd::move(links));
+
+            ASSERT_EQ(3, skinWeightData.GetVertexCount());
+            EXPECT_EQ(2, skinWeightData.GetLinkCount(0));
+            EXPECT_EQ(0, skinWeightData.GetLinkCount(1));
+            EXPECT_EQ(3, skinWeightData.GetLinkCount(2));
+            EXPECT_EQ(2, skinWeightData.GetLink(2, 0).boneId);
+            EXPECT_FLOAT_EQ(0.2f, skinWeightData.GetLink(2, 2).weight);
+            ExpectBulkMatchesPerElementAccess(skinWeightData);
+        }
+
+        TEST(SkinWeightData_BulkAccess, AppendLink_OutOfOrder_KeepsLinksGroupedByVertex)
+        {
+            AZ::SceneData::GraphData::SkinWeightData skinWeightData;
+            skinWeightData.ResizeContainerSpace(3);
+            skinWeightData.AppendLink(2, MakeLink(0, 0.1f));
+            skinWeightData.AppendLink(0, MakeLink(1, 0.2f));
+            skinWeightData.AppendLink(2, MakeLink(1, 0.3f));
+            skinWeightData.AppendLink(1, MakeLink(2, 0.4f));
+            skinWeightData.AppendLink(0, MakeLink(3, 0.5f));
+
+            ASSERT_EQ(3, skinWeightData.GetVertexCount());
+            EXPECT_EQ(2, skinWeightData.GetLinkCount(0));
+            EXPECT_EQ(1, skinWeightData.GetLinkCount(1));
+            EXPECT_EQ(2, skinWeightData.GetLinkCount(2));
+            EXPECT_EQ(3, skinWeightData.GetLink(0, 1).boneId);
+            EXPECT_EQ(1, skinWeightData.GetLink(2, 1).boneId);
+            ExpectBulkMatchesPerElementAccess(skinWeightData);
+
+            const Link* links = skinWeightData.GetLinks();
+            ASSERT_NE(nullptr, links);
+            const float expectedWeights[] = { 0.2f, 0.5f, 0.4f, 0.1f, 0.3f };
+            for (size_t i = 0; i < 5; ++i)
+            {
+                EXPECT_FLOAT_EQ(expectedWeights[i], links[i].weight);
+            }
+        }
+
+        TEST(SkinWeightData_BulkAccess, ResizeContainerSpace_ShrinkAndGrow_DropsRemovedLinks)
+        {
+            AZ::SceneData::GraphData::SkinWeightData skinWeightData;
+            skinWeightData.ResizeContainerSpace(3);
+            skinWeightData.AppendLink(0, MakeLink(0, 1.0f));
+            skinWeightData.AppendLink(2, MakeLink(1, 1.0f));
+
+            skinWeightData.ResizeContainerSpace(1);
+            ASSERT_EQ(1, skinWeightData.GetVertexCount());
+            EXPECT_EQ(1, skinWeightData.GetLinkCount(0));
+            ExpectBulkMatchesPerElementAccess(skinWeightData);
+
+            skinWeightData.ResizeContainerSpace(2);
+            ASSERT_EQ(2, skinWeightData.GetVertexCount());
+            EXPECT_EQ(1, skinWeightData.GetLinkCount(0));
+            EXPECT_EQ(0, skinWeightData.GetLinkCount(1));
+            ExpectBulkMatchesPerElementAccess(skinWeightData);
+        }
+    }
+}
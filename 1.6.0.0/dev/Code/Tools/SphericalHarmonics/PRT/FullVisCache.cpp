@@ -84,7 +84,7 @@ NSH::CFullVisCache::CFullVisCache()
 
 void NSH::CFullVisCache::GenerateFullVisInfo
 (
-    const NSH::TRasterCubeImpl& crRasterCube,
+    const NSH::TRayCastAccelImpl& crAccel,
     const TVec& crOrigin,
     const float cRayLen,
     const TVec& cNormal,
@@ -103,7 +103,7 @@ void NSH::CFullVisCache::GenerateFullVisInfo
     {
         const TVec& crDir = *iter;
         anyHit.SetupRay(crDir, crOrigin, (float)cRayLen, (float)-(cNormal * crOrigin), cNormal, cRayTracingBias);
-        crRasterCube.GatherRayHitsDirection<CSimpleHit, true>(TVector3D(crOrigin.x, crOrigin.y, crOrigin.z), TVector3D(crDir.x, crDir.y, crDir.z), anyHit);
+        crAccel.GatherRayHitsDirection<CSimpleHit, true>(TVector3D(crOrigin.x, crOrigin.y, crOrigin.z), TVector3D(crDir.x, crDir.y, crDir.z), anyHit);
         if (anyHit.IsIntersecting())
         {
             hits++;
@@ -123,7 +123,7 @@ void NSH::CFullVisCache::GenerateFullVisInfo
         {
             const TVec& crDir = *iter;
             anyHit.SetupRay(crDir, crOrigin, (float)cRayLen, (float)-(cNormal * crOrigin), cNormal, cRayTracingBias);
-            crRasterCube.GatherRayHitsDirection<CSimpleHit, true>(TVector3D(crOrigin.x, crOrigin.y, crOrigin.z), TVector3D(crDir.x, crDir.y, crDir.z), anyHit);
+            crAccel.GatherRayHitsDirection<CSimpleHit, true>(TVector3D(crOrigin.x, crOrigin.y, crOrigin.z), TVector3D(crDir.x, crDir.y, crDir.z), anyHit);
             if (anyHit.IsIntersecting())
             {
                 hits++;
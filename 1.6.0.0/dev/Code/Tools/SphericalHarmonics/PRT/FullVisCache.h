@@ -37,7 +37,7 @@ namespace NSH
         //!< generates the cache for a new origin
         void GenerateFullVisInfo
         (
-            const NSH::TRasterCubeImpl& crRasterCube,
+            const NSH::TRayCastAccelImpl& crAccel,
             const TVec& crOrigin,
             const float cRayLen,
             const TVec& cNormal,
@@ -20,6 +20,10 @@
 
 #include <PRT/PRTTypes.h>
 #include "RasterCube.h"
+#include "TriangleBVH.h"
+
+//#define PRT_USE_RASTERCUBE    //ray cast through the raster cube instead of the BVH, kept to compare both
+//#define PRT_COMPARE_RAYCAST_ACCEL  //SetupGeometry also builds both structures and logs how their hits and speed differ, see CRayCaster::CompareRayCastAccel
 
 
 class CSimpleIndexedMesh;
@@ -63,6 +67,13 @@ namespace NSH
 
     //  typedef CRasterCube<RasterCubeUserT, true> TRasterCubeImpl; //!< rastercube with 3 raster tables
     typedef CRasterCube<RasterCubeUserT, false> TRasterCubeImpl;    //!< rastercube without X raster table
+    typedef CTriangleBVH<RasterCubeUserT> TTriangleBVHImpl;         //!< BVH with SSE triangle tests
+
+#if defined(PRT_USE_RASTERCUBE)
+    typedef TRasterCubeImpl TRayCastAccelImpl;      //!< acceleration structure used for ray casting
+#else
+    typedef TTriangleBVHImpl TRayCastAccelImpl;     //!< acceleration structure used for ray casting
+#endif
 
     typedef std::vector<const RasterCubeUserT*, CSHAllocator<const RasterCubeUserT*> > TRasterCubeUserTPtrVec;
 
@@ -114,11 +114,12 @@ NSH::CRayCaster::CRayCaster()
     , m_OnlyUpperHemisphere(true)
     , m_FullVisQueries(0)
     , m_FullVisSuccesses(0)
+    , m_CastRays(0)
 {
-    m_pRasterCube = new TRasterCubeImpl;
+    m_pRayCastAccel = new TRayCastAccelImpl;
     m_AllHits.m_Hits.reserve(50);//reserve for 50 hits, it is unique, so don't save it here
     m_HitData.reserve(50);//reserve for 50 hits, it is unique, so don't save it here
-    assert(m_pRasterCube);
+    assert(m_pRayCastAccel);
 }
 
 NSH::CRayCaster::~CRayCaster()
@@ -130,8 +131,8 @@ NSH::CRayCaster::~CRayCaster()
     else  //is the original
     if (m_CloneRefCount == 0)
     {
-        delete m_pRasterCube;
-        m_pRasterCube = NULL;
+        delete m_pRayCastAccel;
+        m_pRayCastAccel = NULL;
     }
 }
 
@@ -149,9 +150,15 @@ const uint32 NSH::CRayCaster::GetFullVisSuccesses() const
 {
     return m_FullVisSuccesses;
 }
+
+const uint32 NSH::CRayCaster::GetCastRays() const
+{
+    return m_CastRays;
+}
+
 void NSH::CRayCaster::ResetMeshStats()
 {
-    m_FullVisQueries = m_FullVisSuccesses = 0;
+    m_FullVisQueries = m_FullVisSuccesses = m_CastRays = 0;
 }
 
 NSH::CSmartPtr<NSH::CRayCaster, CSHAllocator<> > NSH::CRayCaster::CreateClone() const
@@ -160,7 +167,9 @@ NSH::CSmartPtr<NSH::CRayCaster, CSHAllocator<> > NSH::CRayCaster::CreateClone()
     assert(pClone);
 
     pClone->m_Parameters = m_Parameters;
-    pClone->m_pRasterCube = m_pRasterCube;
+    //clones cast through the structure of the original, drop the empty one the constructor created
+    delete pClone->m_pRayCastAccel;
+    pClone->m_pRayCastAccel = m_pRayCastAccel;
     pClone->m_pOriginal = (CRayCaster*)this;
 
     IncrementCloneRefCount();
@@ -203,12 +212,13 @@ void NSH::CRayCaster::ResetCache
     m_RayTracingBias = cRayTracingBias;
     if (cUseFullVisCache)
     {
-        m_FullVisCache.GenerateFullVisInfo(*m_pRasterCube, crFrom, cRayLen, cNormal, cRayTracingBias, cOnlyUpperHemisphere);
+        m_FullVisCache.GenerateFullVisInfo(*m_pRayCastAccel, crFrom, cRayLen, cNormal, cRayTracingBias, cOnlyUpperHemisphere);
     }
 }
 
 const bool NSH::CRayCaster::CastRay(NSH::SRayResult& rResult, const TVec& crFrom, const TVec& crDir, const double cRayLen, const TVec& crSourcePlaneNormal, const float cBias) const
 {
+    m_CastRays++;
     if (m_UseFullVisCache && m_FullVisCache.IsFullyVisible(crDir))
     {
         rResult.faceID = -1;
@@ -227,7 +237,7 @@ const bool NSH::CRayCaster::CastRay(NSH::SRayResult& rResult, const TVec& crFrom
     bool bUsedCache = true;
     if (!m_RayCache.CheckCache<CAnyHit>(m_AnyHits))//if cache was useless
     {
-        m_pRasterCube->GatherRayHitsDirection<CAnyHit, false>(TVector3D(crFrom.x, crFrom.y, crFrom.z), TVector3D(crDir.x, crDir.y, crDir.z), m_AnyHits);
+        m_pRayCastAccel->GatherRayHitsDirection<CAnyHit, false>(TVector3D(crFrom.x, crFrom.y, crFrom.z), TVector3D(crDir.x, crDir.y, crDir.z), m_AnyHits);
         bUsedCache = false;
         m_RayCache.Reset();
     }
@@ -255,6 +265,7 @@ const bool NSH::CRayCaster::CastRay(NSH::SRayResult& rResult, const TVec& crFrom
 
 const bool NSH::CRayCaster::CastRay(TRayResultVec& rResults, const TVec& crFrom, const TVec& crDir, const double cRayLen, const TVec& crSourcePlaneNormal, const float cBias) const
 {
+    m_CastRays++;
     if (m_UseFullVisCache && m_FullVisCache.IsFullyVisible(crDir))
     {
         m_FullVisQueries++;
@@ -271,7 +282,7 @@ const bool NSH::CRayCaster::CastRay(TRayResultVec& rResults, const TVec& crFrom,
     bool bUsedCache = true;
     if (!m_RayCache.CheckCache<CAllHits>(m_AllHits))//if cache was useless
     {
-        m_pRasterCube->GatherRayHitsDirection<CAllHits, false>(TVector3D(crFrom.x, crFrom.y, crFrom.z), TVector3D(crDir.x, crDir.y, crDir.z), m_AllHits);
+        m_pRayCastAccel->GatherRayHitsDirection<CAllHits, false>(TVector3D(crFrom.x, crFrom.y, crFrom.z), TVector3D(crDir.x, crDir.y, crDir.z), m_AllHits);
         bUsedCache = false;
         m_RayCache.Reset();
     }
@@ -305,7 +316,7 @@ const bool NSH::CRayCaster::SetupGeometry(const TGeomVec& crGeometries, const NT
     Vec3 minEx(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
     Vec3 maxEx(std::numeric_limits<float>::min(), std::numeric_limits<float>::min(), std::numeric_limits<float>::min());
 
-    TRasterCubeImpl&    rasterCube = *m_pRasterCube;
+    TRayCastAccelImpl&  rayCastAccel = *m_pRayCastAccel;
     const TGeomIter cEnd = crGeometries.end();
     for (TGeomIter iter = crGeometries.begin(); iter != cEnd; ++iter)
     {
@@ -343,8 +354,8 @@ const bool NSH::CRayCaster::SetupGeometry(const TGeomVec& crGeometries, const NT
     maxEx.x = std::max(s_cMinExt, maxEx.x);
     maxEx.y = std::max(s_cMinExt, maxEx.y);
     maxEx.z = std::max(s_cMinExt, maxEx.z);
-    //now deinit and init raster cube
-    rasterCube.DeInit();
+    //now deinit and init acceleration structure
+    rayCastAccel.DeInit();
     //now insert all triangles
     RasterCubeUserT* pCache = new RasterCubeUserT[triCount];
     assert(pCache);
@@ -390,28 +401,293 @@ const bool NSH::CRayCaster::SetupGeometry(const TGeomVec& crGeometries, const NT
     }
     assert(cacheCounter <= triCount);
 
-    if (!rasterCube.Init(minEx, maxEx, (uint32)cacheCounter))
+    if (!rayCastAccel.Init(minEx, maxEx, (uint32)cacheCounter))
     {
-        GetSHLog().LogError("Initialization of RasterCube failed\n");
+        GetSHLog().LogError("Initialization of ray casting acceleration structure failed\n");
+        delete [] pCache;
         return false;
     }
     for (uint32 i = 0; i < cacheCounter; ++i)
     {
-        rasterCube.PutInTriangle(pCache[i].vertices, pCache[i]);
+        rayCastAccel.PutInTriangle(pCache[i].vertices, pCache[i]);
     }
-    if (!rasterCube.PreProcess(false))
+    if (!rayCastAccel.PreProcess(false))
     {
-        GetSHLog().LogError("Preprocess for RasterCube failed\n");
+        GetSHLog().LogError("Preprocess for ray casting acceleration structure failed\n");
+        delete [] pCache;
         return false;
     }
+#if defined(PRT_USE_RASTERCUBE)
     //second pass
     for (uint32 i = 0; i < cacheCounter; ++i)
     {
-        rasterCube.PutInTriangle(pCache[i].vertices, pCache[i]);
+        rayCastAccel.PutInTriangle(pCache[i].vertices, pCache[i]);
     }
+    uint32 rasterSize[3];
+    const uint32 cMemory = rayCastAccel.CalcMemoryConsumption(rasterSize);
+    GetSHLog().Log("	ray casting through raster cube: %d triangles, %dx%dx%d cells, %.2f MB\n", (uint32)cacheCounter, rasterSize[0], rasterSize[1], rasterSize[2], (float)cMemory / (1024.f * 1024.f));
+#else
+    GetSHLog().Log("	ray casting through BVH: %d triangles, %d nodes, %.2f MB\n", rayCastAccel.GetElementCount(), rayCastAccel.GetNodeCount(), (float)rayCastAccel.CalcMemoryConsumption() / (1024.f * 1024.f));
+#endif
+#if defined(PRT_COMPARE_RAYCAST_ACCEL)
+    CompareRayCastAccel(pCache, (uint32)cacheCounter, minEx, maxEx);
+#endif
     //free cache
     delete [] pCache;
     return true;
 }
 
+#if defined(PRT_COMPARE_RAYCAST_ACCEL)
+
+static const uint32 gscCompareRayCount = 100000;            //!< rays cast through both structures
+static const uint32 gscCompareLoggedRays = 8;               //!< mismatching rays logged in detail
+
+//!< deterministic random numbers in [0..1), both structures and all runs see the same rays
+static const float CompareRandom(uint32& rState)
+{
+    rState = rState * 1664525u + 1013904223u;
+    return (float)(rState >> 8) / (float)(1 << 24);
+}
+
+static const float CompareRaysPerSecond(const uint32 cRayCount, const DWORD cStartTime)
+{
+    const float cSeconds = (float)(GetTickCount() - cStartTime) / 1000.f;
+    return (cSeconds > 0.f) ? (float)cRayCount / cSeconds : 0.f;
+}
+
+template <class TAccel>
+void NSH::CRayCaster::CastCompareRays
+(
+    const TAccel& crAccel,
+    const TCompareRayVec& crRays,
+    const float cRayLen,
+    const float cBias,
+    TCompareHitVec& rAllHits,
+    TCompareHitStartVec& rAllHitStarts,
+    TCompareHitVec& rAnyHits,
+    float& rAllHitsRaysPerSecond,
+    float& rAnyHitRaysPerSecond
+)
+{
+    CAllHits allHits;
+    CAnyHit anyHit;
+    THitVec hitData;
+    const uint32 cRayCount = (uint32)crRays.size();
+    rAllHits.resize(0);
+    rAllHitStarts.resize(0);
+    rAllHitStarts.reserve(cRayCount + 1);
+    rAnyHits.resize(cRayCount);
+
+    //same sink calls as both CastRay functions, without the ray cache and the full vis cache
+    DWORD startTime = GetTickCount();
+    for (uint32 r = 0; r < cRayCount; ++r)
+    {
+        const SCompareRay& crRay = crRays[r];
+        allHits.SetupRay(crRay.dir, crRay.origin, cRayLen, -(crRay.normal * crRay.origin), crRay.normal, cBias);
+        crAccel.template GatherRayHitsDirection<CAllHits, false>(TVector3D(crRay.origin.x, crRay.origin.y, crRay.origin.z), TVector3D(crRay.dir.x, crRay.dir.y, crRay.dir.z), allHits);
+        allHits.GetHitData(hitData);
+        rAllHitStarts.push_back((uint32)rAllHits.size());
+        const THitVec::const_iterator cEnd = hitData.end();
+        for (THitVec::const_iterator iter = hitData.begin(); iter != cEnd; ++iter)
+        {
+            SCompareHit hit;
+            hit.pMesh = iter->pHitResult->pMesh;
+            hit.faceID = iter->pHitResult->faceID;
+            hit.dist = iter->dist;
+            hit.opaque = iter->pHitResult->fastProcessing;
+            rAllHits.push_back(hit);
+        }
+    }
+    rAllHitStarts.push_back((uint32)rAllHits.size());
+    rAllHitsRaysPerSecond = CompareRaysPerSecond(cRayCount, startTime);
+
+    startTime = GetTickCount();
+    for (uint32 r = 0; r < cRayCount; ++r)
+    {
+        const SCompareRay& crRay = crRays[r];
+        anyHit.SetupRay(crRay.dir, crRay.origin, cRayLen, -(crRay.normal * crRay.origin), crRay.normal, cBias);
+        crAccel.template GatherRayHitsDirection<CAnyHit, false>(TVector3D(crRay.origin.x, crRay.origin.y, crRay.origin.z), TVector3D(crRay.dir.x, crRay.dir.y, crRay.dir.z), anyHit);
+        SCompareHit& rHit = rAnyHits[r];
+        const SHitData& crHitData = anyHit.GetHitData();
+        rHit.pMesh = crHitData.pHitResult ? crHitData.pHitResult->pMesh : NULL;
+        rHit.faceID = crHitData.pHitResult ? crHitData.pHitResult->faceID : 0;
+        rHit.dist = crHitData.dist;
+        rHit.opaque = crHitData.pHitResult ? crHitData.pHitResult->fastProcessing : false;
+    }
+    rAnyHitRaysPerSecond = CompareRaysPerSecond(cRayCount, startTime);
+}
+
+void NSH::CRayCaster::CompareRayCastAccel(const RasterCubeUserT* cpTriangles, const uint32 cTriangleCount, const Vec3& crMinExt, const Vec3& crMaxExt) const
+{
+    if (cTriangleCount == 0)
+    {
+        return;
+    }
+    //build both structures the way SetupGeometry does
+    TRasterCubeImpl rasterCube;
+    TTriangleBVHImpl bvh;
+    if (!rasterCube.Init(crMinExt, crMaxExt, cTriangleCount) || !bvh.Init(crMinExt, crMaxExt, cTriangleCount))
+    {
+        GetSHLog().LogError("Initialization of ray casting acceleration structures for comparison failed\n");
+        return;
+    }
+    for (uint32 i = 0; i < cTriangleCount; ++i)
+    {
+        rasterCube.PutInTriangle(cpTriangles[i].vertices, cpTriangles[i]);
+        bvh.PutInTriangle(cpTriangles[i].vertices, cpTriangles[i]);
+    }
+    if (!rasterCube.PreProcess(false) || !bvh.PreProcess(false))
+    {
+        GetSHLog().LogError("Preprocess for ray casting acceleration structures for comparison failed\n");
+        return;
+    }
+    //second pass for the raster cube
+    for (uint32 i = 0; i < cTriangleCount; ++i)
+    {
+        rasterCube.PutInTriangle(cpTriangles[i].vertices, cpTriangles[i]);
+    }
+
+    //rays start on random points of random triangles into the hemisphere of the triangle, like the transfer rays start on a vertex
+    TCompareRayVec rays(gscCompareRayCount);
+    uint32 randomState = 0x5eed;
+    for (uint32 r = 0; r < gscCompareRayCount; ++r)
+    {
+        const RasterCubeUserT& crTriangle = cpTriangles[std::min((uint32)(CompareRandom(randomState) * (float)cTriangleCount), cTriangleCount - 1)];
+        float u = CompareRandom(randomState);
+        float v = CompareRandom(randomState);
+        if (u + v > 1.f)
+        {
+            u = 1.f - u;
+            v = 1.f - v;
+        }
+        SCompareRay& rRay = rays[r];
+        rRay.origin = crTriangle.vertices[0] + (crTriangle.vertices[1] - crTriangle.vertices[0]) * u + (crTriangle.vertices[2] - crTriangle.vertices[0]) * v;
+        rRay.normal = crTriangle.vNormal;
+        do
+        {
+            rRay.dir = Vec3(CompareRandom(randomState) * 2.f - 1.f, CompareRandom(randomState) * 2.f - 1.f, CompareRandom(randomState) * 2.f - 1.f);
+        } while (rRay.dir.len2() > 1.f || rRay.dir.len2() < 0.0001f);
+        rRay.dir.Normalize();
+        if (rRay.dir * rRay.normal < 0.f)
+        {
+            rRay.dir = -rRay.dir;
+        }
+    }
+
+    const float cRayLen = (crMaxExt - crMinExt).len();
+    const float cBias = m_Parameters.rayTracingBias;
+    TCompareHitVec rasterAllHits, rasterAnyHits, bvhAllHits, bvhAnyHits;
+    TCompareHitStartVec rasterAllHitStarts, bvhAllHitStarts;
+    float rasterAllHitsRate, rasterAnyHitRate, bvhAllHitsRate, bvhAnyHitRate;
+    CastCompareRays(rasterCube, rays, cRayLen, cBias, rasterAllHits, rasterAllHitStarts, rasterAnyHits, rasterAllHitsRate, rasterAnyHitRate);
+    CastCompareRays(bvh, rays, cRayLen, cBias, bvhAllHits, bvhAllHitStarts, bvhAnyHits, bvhAllHitsRate, bvhAnyHitRate);
+
+    uint32 allHitsMismatches = 0, onlyRasterCubeHits = 0, onlyBVHHits = 0;
+    uint32 chainMismatches = 0, rasterChainHits = 0, bvhChainHits = 0;
+    uint32 anyHitMismatches = 0, anyHitOtherTriangle = 0;
+    uint32 loggedRays = 0;
+    TCompareHitVec rasterSorted, bvhSorted;
+    for (uint32 r = 0; r < gscCompareRayCount; ++r)
+    {
+        const uint32 cRasterBegin = rasterAllHitStarts[r];
+        const uint32 cRasterEnd = rasterAllHitStarts[r + 1];
+        const uint32 cBVHBegin = bvhAllHitStarts[r];
+        const uint32 cBVHEnd = bvhAllHitStarts[r + 1];
+
+        //hit sets, every difference here changes what the transfer sees
+        rasterSorted.assign(rasterAllHits.begin() + cRasterBegin, rasterAllHits.begin() + cRasterEnd);
+        bvhSorted.assign(bvhAllHits.begin() + cBVHBegin, bvhAllHits.begin() + cBVHEnd);
+        std::sort(rasterSorted.begin(), rasterSorted.end());
+        std::sort(bvhSorted.begin(), bvhSorted.end());
+        uint32 onlyRasterCube = 0, onlyBVH = 0;
+        TCompareHitVec::const_iterator rasterIter = rasterSorted.begin();
+        TCompareHitVec::const_iterator bvhIter = bvhSorted.begin();
+        while (rasterIter != rasterSorted.end() || bvhIter != bvhSorted.end())
+        {
+            if (bvhIter == bvhSorted.end() || (rasterIter != rasterSorted.end() && *rasterIter < *bvhIter))
+            {
+                ++onlyRasterCube;
+                ++rasterIter;
+            }
+            else
+            if (rasterIter == rasterSorted.end() || *bvhIter < *rasterIter)
+            {
+                ++onlyBVH;
+                ++bvhIter;
+            }
+            else
+            {
+                ++rasterIter;
+                ++bvhIter;
+            }
+        }
+
+        //transparency chains, the hits ProcessRayCastingResult walks: ascending distance up to and including the first opaque one
+        //CAllHits lowers the ray max with every hit, both only cull whole cells or leaves with it, but cells and leaves hold different triangles so this is where they can part
+        uint32 rasterChainEnd = cRasterBegin;
+        while (rasterChainEnd < cRasterEnd && !rasterAllHits[rasterChainEnd++].opaque)
+        {
+        }
+        uint32 bvhChainEnd = cBVHBegin;
+        while (bvhChainEnd < cBVHEnd && !bvhAllHits[bvhChainEnd++].opaque)
+        {
+        }
+        const uint32 cRasterChainLength = rasterChainEnd - cRasterBegin;
+        const uint32 cBVHChainLength = bvhChainEnd - cBVHBegin;
+        bool chainsDiffer = (cRasterChainLength != cBVHChainLength);
+        for (uint32 i = 0; !chainsDiffer && i < cRasterChainLength; ++i)
+        {
+            chainsDiffer = !(rasterAllHits[cRasterBegin + i] == bvhAllHits[cBVHBegin + i]);
+        }
+
+        //any hit only decides visibility, which triangle blocks may differ since both stop at the first opaque hit they find
+        const SCompareHit& crRasterAnyHit = rasterAnyHits[r];
+        const SCompareHit& crBVHAnyHit = bvhAnyHits[r];
+        const bool cAnyHitDiffers = ((crRasterAnyHit.pMesh == NULL) != (crBVHAnyHit.pMesh == NULL));
+        if (!cAnyHitDiffers && crRasterAnyHit.pMesh && !(crRasterAnyHit == crBVHAnyHit))
+        {
+            ++anyHitOtherTriangle;
+        }
+
+        rasterChainHits += cRasterChainLength;
+        bvhChainHits += cBVHChainLength;
+        onlyRasterCubeHits += onlyRasterCube;
+        onlyBVHHits += onlyBVH;
+        if (onlyRasterCube > 0 || onlyBVH > 0)
+        {
+            ++allHitsMismatches;
+        }
+        if (chainsDiffer)
+        {
+            ++chainMismatches;
+        }
+        if (cAnyHitDiffers)
+        {
+            ++anyHitMismatches;
+        }
+        if ((onlyRasterCube > 0 || onlyBVH > 0 || chainsDiffer || cAnyHitDiffers) && loggedRays < gscCompareLoggedRays)
+        {
+            ++loggedRays;
+            const SCompareRay& crRay = rays[r];
+            GetSHLog().LogWarning("ray %d from (%.3f %.3f %.3f) dir (%.3f %.3f %.3f): raster cube %d hits %d chained %s, BVH %d hits %d chained %s\n",
+                r, crRay.origin.x, crRay.origin.y, crRay.origin.z, crRay.dir.x, crRay.dir.y, crRay.dir.z,
+                cRasterEnd - cRasterBegin, cRasterChainLength, crRasterAnyHit.pMesh ? "blocked" : "visible",
+                cBVHEnd - cBVHBegin, cBVHChainLength, crBVHAnyHit.pMesh ? "blocked" : "visible");
+        }
+    }
+
+    uint32 rasterSize[3];
+    const uint32 cRasterMemory = rasterCube.CalcMemoryConsumption(rasterSize);
+    GetSHLog().Log("	ray casting structure comparison: %d triangles, %d rays\n", cTriangleCount, gscCompareRayCount);
+    GetSHLog().Log("	raster cube: %dx%dx%d cells, %.2f MB, %.0f rays/s all hits, %.0f rays/s any hit\n",
+        rasterSize[0], rasterSize[1], rasterSize[2], (float)cRasterMemory / (1024.f * 1024.f), rasterAllHitsRate, rasterAnyHitRate);
+    GetSHLog().Log("	BVH: %d nodes, %.2f MB, %.0f rays/s all hits, %.0f rays/s any hit\n",
+        bvh.GetNodeCount(), (float)bvh.CalcMemoryConsumption() / (1024.f * 1024.f), bvhAllHitsRate, bvhAnyHitRate);
+    GetSHLog().Log("	all hits: %d rays differ, %d hits only in raster cube, %d only in BVH\n", allHitsMismatches, onlyRasterCubeHits, onlyBVHHits);
+    GetSHLog().Log("	transparency chains: %d rays differ, %d hits chained in raster cube, %d in BVH\n", chainMismatches, rasterChainHits, bvhChainHits);
+    GetSHLog().Log("	any hit: %d rays differ in visibility, %d blocked by another triangle\n", anyHitMismatches, anyHitOtherTriangle);
+}
+
+#endif
+
 #endif
\ No newline at end of file
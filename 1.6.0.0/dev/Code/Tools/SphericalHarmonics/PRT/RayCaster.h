@@ -182,11 +182,12 @@ namespace NSH
         //special functions used for multi threaded ray casting
         const uint32 GetFullVisQueries() const;     //!< retrieves the number of full visibility queries
         const uint32 GetFullVisSuccesses() const;   //!< retrieves the number of full visibility successes
+        const uint32 GetCastRays() const;                   //!< retrieves the number of rays cast since the mesh stats were reset
 
         NSH::CSmartPtr<NSH::CRayCaster, CSHAllocator<> > CreateClone() const;                   //!< creates a ray caster clone
 
     protected:
-        TRasterCubeImpl*    m_pRasterCube;              //!< ref counted raster cube for this cluster, pointer therefore
+        TRayCastAccelImpl*  m_pRayCastAccel;            //!< ref counted acceleration structure for this cluster, read only after SetupGeometry and shared with all clones
         mutable uint32      m_CloneRefCount;            //!< reference count for clones
         mutable CRayCache   m_RayCache;                     //!< ray cache
         CFullVisCache           m_FullVisCache;             //!< full vis cache, used to discard any occlusion queries for objects being almost fully visible
@@ -204,6 +205,7 @@ namespace NSH
 
         mutable uint32  m_FullVisQueries;               //!< counts the number of full vis queries
         mutable uint32  m_FullVisSuccesses;         //!< counts the number of full vis queries which succeeded
+        mutable uint32  m_CastRays;                         //!< counts the number of rays cast
 
         TVec                        m_Source;                               //!< source pos to use for cache queries
         TVec                        m_Normal;                               //!< source direction to use for cache queries
@@ -215,6 +217,51 @@ namespace NSH
         void DecrementCloneRefCount() const;        //!< clone ref counting decrement for destructor
         void IncrementCloneRefCount() const;        //!< clone ref counting increment for destructor
 
+#if defined(PRT_COMPARE_RAYCAST_ACCEL)
+        //!< ray of the acceleration structure comparison
+        struct SCompareRay
+        {
+            Vec3 origin;
+            Vec3 dir;
+            Vec3 normal;    //!< source plane normal
+        };
+
+        //!< hit of the acceleration structure comparison, both structures hold their own element copies so hits are identified by mesh and face
+        struct SCompareHit
+        {
+            const CSimpleIndexedMesh* pMesh;    //!< NULL for no hit
+            uint32 faceID;
+            float dist;
+            bool opaque;                        //!< ends the transparency chain
+
+            const bool operator==(const SCompareHit& crComp) const{return pMesh == crComp.pMesh && faceID == crComp.faceID; }
+            const bool operator<(const SCompareHit& crComp) const{return (pMesh == crComp.pMesh) ? (faceID < crComp.faceID) : ((size_t)pMesh < (size_t)crComp.pMesh); }//orders by triangle, not by distance
+        };
+
+        typedef std::vector<SCompareRay, CSHAllocator<SCompareRay> > TCompareRayVec;
+        typedef std::vector<SCompareHit, CSHAllocator<SCompareHit> > TCompareHitVec;
+        typedef std::vector<uint32, CSHAllocator<uint32> > TCompareHitStartVec;
+
+        //!< casts all rays through one structure, once with the all hits sink and once with the any hit sink
+        //!< hits of ray r are rAllHits[rAllHitStarts[r]..rAllHitStarts[r+1]-1] sorted by distance, rAnyHits has one entry per ray
+        template <class TAccel>
+        static void CastCompareRays
+        (
+            const TAccel& crAccel,
+            const TCompareRayVec& crRays,
+            const float cRayLen,
+            const float cBias,
+            TCompareHitVec& rAllHits,
+            TCompareHitStartVec& rAllHitStarts,
+            TCompareHitVec& rAnyHits,
+            float& rAllHitsRaysPerSecond,
+            float& rAnyHitRaysPerSecond
+        );
+
+        //!< builds raster cube and BVH from the same triangles, casts the same rays through both and logs hit differences, rays/s and memory
+        void CompareRayCastAccel(const RasterCubeUserT* cpTriangles, const uint32 cTriangleCount, const Vec3& crMinExt, const Vec3& crMaxExt) const;
+#endif
+
         CRayCaster(const CRayCaster&);                  //!< disallow copy constructor
     };
 }
@@ -28,6 +28,7 @@
 #include <limits>
 
 static const double gs_cSampleCosThreshold = 0.000001;
+static const LONG gs_cRayCastingQueryChunk = 4;    //!< vertices a ray casting thread takes at once from the shared queries
 const float NSH::NTransfer::CInterreflectionTransfer::scLowerHSPercentage = (float)(30. / 90.) /*30 degree*/;
 
 //!< helper function which retrieves a mesh index from a vector of mesh pointers
@@ -46,6 +47,13 @@ static const size_t GetIndexFromMesh(const NSH::TGeomVec& crMeshes, const CSimpl
     return (size_t)-1;
 }
 
+//!< logs how many rays the direct pass of a mesh has cast and how fast
+static void LogRayCastingSpeed(const uint32 cCastRays, const DWORD cStartTime)
+{
+    const float cSeconds = (float)(GetTickCount() - cStartTime) / 1000.f;
+    GetSHLog().Log("	%d rays cast in %.1f s: %.0f rays/s\n", cCastRays, cSeconds, (cSeconds > 0.f) ? (float)cCastRays / cSeconds : 0.f);
+}
+
 /**********************************************************************************************************************************************/
 
 void NSH::NTransfer::CInterreflectionTransfer::PrepareVectors
@@ -215,10 +223,9 @@ void NSH::NTransfer::CInterreflectionTransfer::AdjustDirectCoefficients
     const ITransferConfigurator& crConfigurator,
     const bool cHasTransparentMats,
     const bool cOnlyHemisphere
-)
+) const
 {
     const double cDirectScale = crParameters.bumpGranularity ? NSH::g_cPi * cBaseSampleScale : cBaseSampleScale;//used as lookup -> no convolution and divide by PI
-    static NSH::SCoeffList_tpl<TScalarCoeff> dest(crSHDescriptor); //save allocations
 
     if (!crParameters.bumpGranularity || !cOnlyHemisphere)
     {
@@ -258,7 +265,7 @@ void NSH::NTransfer::CInterreflectionTransfer::AdjustDirectCoefficients
         rRayCaster.ResetCache();
         for (uint32 i = 0; i < scBorderColours; ++i)
         {
-            SVISCache& cVISCache = m_VISCache[i];
+            const SVISCache& cVISCache = m_VISCache[i];
             //rotate back to world space and look up visibility
             SCartesianCoord_tpl<float> worldSpaceDir(cVISCache.tangentSpaceCartCoord);
             worldSpaceDir = fromTSMat * worldSpaceDir;
@@ -453,6 +460,7 @@ void NSH::NTransfer::CInterreflectionTransfer::ComputeDirectPass
         TVertexIndexSet vertexIndexSet;
 
         rRayCaster.ResetMeshStats();
+        const DWORD cStartTime = GetTickCount();
 
         uint32 visQueries = 0;  //mesh queries for visibility (for log statistics)
         float vis = 0.f;                //counts the resulted visibility (for log statistics)
@@ -581,6 +589,7 @@ void NSH::NTransfer::CInterreflectionTransfer::ComputeDirectPass
         m_State.meshIndex++;//next mesh
 
         rRayCaster.LogMeshStats();
+        LogRayCastingSpeed(rRayCaster.GetCastRays(), cStartTime);
         GetSHLog().Log("	average visibility per vertex: %.2f percent\n", (visQueries > 0) ? (vis / (float)visQueries) * 100.f : 0);
 
         assert(rCoeffsDirect.size() == (size_t)crMesh.GetVertexCount());
@@ -631,10 +640,11 @@ void NSH::NTransfer::CInterreflectionTransfer::ComputeDirectPassMultipleThreadin
         *iter = rRayCaster.CreateClone();
     }
 
-    //works as follows: split each mesh into crParameters.rayCastingThreads vertices
-    //built ray casting queries and process within each thread by trying to send to the other processor
-    //let main thread go to sleep and check from time to time if some thread has been finished, then process with low priority
-    std::vector<TThreadRayVertexQueryVec, CSHAllocator<TThreadRayVertexQueryVec> > threadQueries(crParameters.rayCastingThreads);   //for each thread build a vector of queries
+    //works as follows: build one ray casting query per vertex of a mesh, all threads (the main thread included) take chunks of
+    //queries from it until none is left, so no thread idles while another one still works through a large fixed slice
+    //the ray casters share their acceleration structure, each thread only owns its caches, ray results and configurator
+    //a thread adjusts the coefficients of a vertex right after casting its rays, the main thread only gathers statistics at the end
+    //each thread adds its finished chunks to the processing state, the main thread notifies the observers after each of its own
     std::vector<TRayResultVec, CSHAllocator<TRayResultVec> > threadRayResults(crParameters.rayCastingThreads);
     const std::vector<TRayResultVec, CSHAllocator<TRayResultVec> >::iterator cThreadEnd = threadRayResults.end();
     for (std::vector<TRayResultVec, CSHAllocator<TRayResultVec> >::iterator rayIter = threadRayResults.begin(); rayIter != cThreadEnd; ++rayIter)
@@ -664,30 +674,24 @@ void NSH::NTransfer::CInterreflectionTransfer::ComputeDirectPassMultipleThreadin
 
         TVertexIndexSet vertexIndexSet;
         rRayCaster.ResetMeshStats();
+        for (TRayCasterVec::iterator iter = clonedRayCasters.begin(); iter != cEnd; ++iter)
+        {
+            (*iter)->ResetMeshStats();
+        }
+        const DWORD cStartTime = GetTickCount();
 
         uint32 visQueries = 0;  //mesh queries for visibility (for log statistics)
         float vis = 0.f;                //counts the resulted visibility (for log statistics)
 
         //build ray cast threading queries
-        //vertices to process per thread, pay attention that last one gets the rest(may be more, may be less)
-        //main thread gets less since it is started as last one and processed as first one (save one thread)
-        const uint32 cVerticesPerThread = (uint32)((float)m_VerticesToSHProcessPerMesh[mesh] / (float)(crParameters.rayCastingThreads - 1 + 0.8f /*constant should better be estimated due to number of threads*/));
-        uint32 currentThreadIndex = 0;
-        std::vector<std::pair<HANDLE, uint32>, CSHAllocator<std::pair<HANDLE, uint32> > > threadIDs(crParameters.rayCastingThreads - 1);//pair of handle and thread ids (-1 because main thread is processing too)
-        TBoolVec threadStates(crParameters.rayCastingThreads - 1);//states of the threads
-        //initialize them
-        const TBoolVec::iterator cEnd = threadStates.end();
-        for (TBoolVec::iterator iter = threadStates.begin(); iter != cEnd; ++iter)
-        {
-            *iter = true; //indicate as running
-        }
+        TThreadRayVertexQueryVec queries;
+        queries.reserve(m_VerticesToSHProcessPerMesh[mesh]);//save memory alloc calls
         Notify();
         //iterate all faces and unique vertices
         for (uint32 i = 0; i < crMesh.GetFaceCount(); ++i)
         {
             const bool cCalcSHCoeffs = crMesh.ComputeSHCoeffs(i);   //compute sh coeffs for this material?
             const NSH::NMaterial::ISHMaterial& crMat = crMesh.GetMaterialByFaceID(i);   //cache material reference
-            threadQueries[currentThreadIndex].reserve(cVerticesPerThread);//save memory alloc calls
             const CObjFace& rObjFace = crMesh.GetObjFace(i);
             for (int v = 0; v < 3; ++v)//for each face index
             {
@@ -719,130 +723,73 @@ void NSH::NTransfer::CInterreflectionTransfer::ComputeDirectPassMultipleThreadin
                 query.cpMat = &crMat;
                 query.vertexIndex = cVertexIndex;
                 query.normalIndex = cNormalIndex;
-                threadQueries[currentThreadIndex].push_back(query); //add query for this vertex
-
-                if (currentThreadIndex != crParameters.rayCastingThreads - 1) //if not last thread
-                {
-                    if (threadQueries[currentThreadIndex].size() == cVerticesPerThread)
-                    {
-                        //start thread whilst building the other
-                        SThreadParams param((currentThreadIndex == 0) ? rRayCaster : *clonedRayCasters[currentThreadIndex - 1], samples, crParameters, threadQueries[currentThreadIndex], rIntersectionInfo, crMeshes, cRayLen, cHasTransparentMats, threadRayResults[currentThreadIndex], *threadConfigurators[currentThreadIndex]);
-                        threadIDs[currentThreadIndex].first = CreateThread(NULL, 1024000, RayCastingThread, &param, 0, (LPDWORD)&(threadIDs[currentThreadIndex].second));
-                        SetThreadPriority(threadIDs[currentThreadIndex].first, THREAD_PRIORITY_HIGHEST);
-                        m_State.rcThreadsRunning++;
-                        currentThreadIndex++;//go to next thread
-                        Notify();
-                    }
-                }
+                queries.push_back(query); //add query for this vertex
             }//face vertex
         }//face
 
-        //process one ray casting in the main thread
-        SThreadParams param(*clonedRayCasters[currentThreadIndex - 1], samples, crParameters, threadQueries[currentThreadIndex], rIntersectionInfo, crMeshes, cRayLen, cHasTransparentMats, threadRayResults[currentThreadIndex], *threadConfigurators[currentThreadIndex]);
+        //thread i casts with ray caster i, the main thread takes the last one
+        volatile LONG nextQuery = 0;
+        std::vector<SThreadParams, CSHAllocator<SThreadParams> > threadParams;
+        threadParams.reserve(crParameters.rayCastingThreads);//the threads keep pointers to their params
+        for (uint32 i = 0; i < crParameters.rayCastingThreads; ++i)
+        {
+            threadParams.push_back(SThreadParams((i == 0) ? rRayCaster : *clonedRayCasters[i - 1], samples, crParameters, queries, nextQuery, rIntersectionInfo, crMeshes, cRayLen, cHasTransparentMats, threadRayResults[i], *threadConfigurators[i],
+                    *this, (i == crParameters.rayCastingThreads - 1), crMesh, sampleCount, crSHDescriptor));
+        }
+        std::vector<HANDLE, CSHAllocator<HANDLE> > threadHandles(crParameters.rayCastingThreads - 1);//-1 because main thread is processing too
+        for (uint32 i = 0; i < crParameters.rayCastingThreads - 1; ++i)
+        {
+            DWORD threadID;
+            threadHandles[i] = CreateThread(NULL, 1024000, RayCastingThread, &threadParams[i], 0, &threadID);
+            SetThreadPriority(threadHandles[i], THREAD_PRIORITY_HIGHEST);
+            m_State.rcThreadsRunning++;
+        }
+
+        //process ray casting in the main thread too
         m_State.rcThreadsRunning++;
         Notify();
-        RayCastingThread(&param);
+        RayCastingThread(&threadParams[crParameters.rayCastingThreads - 1]);
         m_State.rcThreadsRunning--;
+        Notify();
 
-        //ray cast query struct is now built
-        //loop til all threads are done (check and put asleep)
-        uint32 threadsProcessed = 0;
-        bool wasProcessing = false;
-        bool processMainThread = true;
-        while (true)
+        //all queries are taken, wait for the threads still working on their last chunk
+        for (uint32 i = 0; i < crParameters.rayCastingThreads - 1; ++i)
         {
-            int32 mostRecentThreadFinished = -1;
-            if (!processMainThread)
-            {
-                if (m_State.rcThreadsRunning == 0 && threadsProcessed == crParameters.rayCastingThreads - 1)
-                {
-                    break;//all threads have been finished and have been processed
-                }
-                //now check that one thread has been finished, if not, go asleep
-                for (uint32 i = 0; i < crParameters.rayCastingThreads - 1; ++i)
-                {
-                    if (threadStates[i])//still running
-                    {
-                        if (WaitForSingleObject(threadIDs[i].first, 1) != WAIT_TIMEOUT)
-                        {
-                            //has just been finished
-                            threadStates[i] = false;
-                            m_State.rcThreadsRunning--;
-                            Notify();
-                            mostRecentThreadFinished = i;
-                            break;//even if another thread has finished too, process this one first before continue checking
-                        }
-                    }
-                }
-                if (mostRecentThreadFinished == -1)
-                {
-                    if (wasProcessing)
-                    {
-                        wasProcessing = false;
-                        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST); //reset main thread priority
-                    }
-                    SleepEx(1000, false);//put main thread asleep for some time
-                    continue;
-                }
-                if (!wasProcessing)
-                {
-                    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST); //reset main thread priority
-                    wasProcessing = true;
-                }
-                threadsProcessed++;
-            }
-            const uint32 cThreadIndex = processMainThread ? (crParameters.rayCastingThreads - 1) : mostRecentThreadFinished;
-            TThreadRayVertexQueryVec& rRayQueries = threadQueries[cThreadIndex];
-            processMainThread = false;
-            //iterate all vertices using the ray query results
-            const TThreadRayVertexQueryVec::iterator cEnd = rRayQueries.end();
-            for (TThreadRayVertexQueryVec::iterator vertexIter = rRayQueries.begin(); vertexIter != cEnd; ++vertexIter)
-            {
-                SThreadRayVertexQuery& rQuery = *vertexIter;
-                const Vec2& cTexCoord = rQuery.texCoord;
-                const uint32 cNormalIndex = rQuery.normalIndex;
-
-                Notify();//update observers
-
-                SCoeffList_tpl<TScalarCoeff>& rCoeffListDirect          = *rQuery.pCoeffListDirect;
-                //remember that hemispherical retrieval only covers 2 g_cPi of the sphere
-                const int cHemisphereSampleCount = rQuery.hemisphereSampleCount;
-                const bool cOnlyHemisphere = threadConfigurators[cThreadIndex]->ProcessOnlyUpperHemisphere(rQuery.cpMat->Type());
-                const double cBaseSampleScale = (cHemisphereSampleCount == 0) ? 0. : 2. / (double)cHemisphereSampleCount; //divide by PI because we need exitance radiance here
-                const double cDirectScale = cOnlyHemisphere ? cBaseSampleScale : 4. / (double)sampleCount; //full sphere if required
-                const uint32 cVertexIndex = rQuery.vertexIndex;
-                const NSH::NMaterial::ISHMaterial& crMat = *rQuery.cpMat;   //cache material reference
-                visQueries += rQuery.visQueries;
-                vis += rQuery.vis;
-
-                assert(cHemisphereSampleCount < ((2 << (sizeof(short) * 8 - 1))) - 1);
-                rMeshVertexCounter[cVertexIndex] = (uint16)cHemisphereSampleCount;
+            WaitForSingleObject(threadHandles[i], INFINITE);
+            CloseHandle(threadHandles[i]);
+            m_State.rcThreadsRunning--;
+            Notify();
+        }
 
-                AdjustDirectCoefficients
-                (
-                    samples, sampleCount, crMesh, cTexCoord, ((cThreadIndex == 0) ? rRayCaster : *clonedRayCasters[cThreadIndex - 1]), cRayLen, crParameters, cNormalIndex, rCoeffListDirect,
-                    cDirectScale, crMat, threadRayResults[cThreadIndex], crSHDescriptor, *threadConfigurators[cThreadIndex], cHasTransparentMats, cOnlyHemisphere
-                );
-                //post-scale by inverse sample count
-                m_State.vertexIndex++;
-                m_State.overallVertexIndex++;
-            }//vertices
-             //free some memory
-            rRayQueries.swap(TThreadRayVertexQueryVec());
-        }//threads
+        //the threads have adjusted the coefficients already, only gather the counters and statistics
+        const TThreadRayVertexQueryVec::iterator cQueriesEnd = queries.end();
+        for (TThreadRayVertexQueryVec::iterator vertexIter = queries.begin(); vertexIter != cQueriesEnd; ++vertexIter)
+        {
+            const SThreadRayVertexQuery& crQuery = *vertexIter;
+            //remember that hemispherical retrieval only covers 2 g_cPi of the sphere
+            const int cHemisphereSampleCount = crQuery.hemisphereSampleCount;
+            visQueries += crQuery.visQueries;
+            vis += crQuery.vis;
+
+            assert(cHemisphereSampleCount < ((2 << (sizeof(short) * 8 - 1))) - 1);
+            rMeshVertexCounter[crQuery.vertexIndex] = (uint16)cHemisphereSampleCount;
+        }//vertices
         Notify();//update observers
         m_State.meshIndex++;//next mesh
 
         uint32 fullVisQueries = rRayCaster.GetFullVisQueries();
         uint32 fullVisSuccesses = rRayCaster.GetFullVisSuccesses();
+        uint32 castRays = rRayCaster.GetCastRays();
         const TRayCasterVec::const_iterator cClonedEnd = clonedRayCasters.end();
         for (TRayCasterVec::const_iterator rayCasterIter = clonedRayCasters.begin(); rayCasterIter != cClonedEnd; ++rayCasterIter)
         {
             fullVisQueries += (*rayCasterIter)->GetFullVisQueries();
             fullVisSuccesses += (*rayCasterIter)->GetFullVisSuccesses();
+            castRays += (*rayCasterIter)->GetCastRays();
         }
         GetSHLog().Log("	average full visibility: %.2f percent\n", (fullVisQueries > 0) ? ((float)fullVisSuccesses / (float)fullVisQueries) * 100.f : 0);
         GetSHLog().Log("	average visibility per vertex: %.2f percent\n", (visQueries > 0) ? (vis / (float)visQueries) * 100.f : 0);
+        LogRayCastingSpeed(castRays, cStartTime);
 
         assert(rCoeffsDirect.size() == (size_t)crMesh.GetVertexCount());
     }
@@ -870,124 +817,153 @@ DWORD WINAPI NSH::NTransfer::CInterreflectionTransfer::RayCastingThread(LPVOID p
     TRayCacheVec tempRayCacheVec(pThreadParam->crSamples.size());//temp vector to not allocate memory too often, count inserted entries itself
 
     const bool cAddGroundPlaneBehaviour = (crParameters.groundPlaneBlockValue != 1.0f);
-    //iterate each vertex and query
-    const TThreadRayVertexQueryVec::iterator cEnd = rQueries.end();
-    for (TThreadRayVertexQueryVec::iterator vertexIter = rQueries.begin(); vertexIter != cEnd; ++vertexIter)
+    //take chunks of queries until all are taken, the other threads do the same
+    const LONG cQueryCount = (LONG)rQueries.size();
+    for (;; )
     {
-        SThreadRayVertexQuery& rQuery = *vertexIter;
-        TRayCacheVec& rRayInterreflectionCache = rIntersectionInfo[rQuery.vertexIndex];
-        const bool cOnlyHemisphere = crConfigurator.ProcessOnlyUpperHemisphere(rQuery.cpMat->Type());
-        rRayCaster.ResetCache(rQuery.pos, cRayLen, rQuery.normal, crParameters.rayTracingBias, cOnlyHemisphere, true /*use full vis cache*/);
-
-        const TVec& crPos                   = rQuery.pos;
-        const TVec& crNormal            = rQuery.normal;
-        const Vec2& crTexCoord      = rQuery.texCoord;
-        SCoeffList_tpl<TScalarCoeff>& rCoeffListDirect              = *rQuery.pCoeffListDirect;
-        const NSH::NMaterial::ISHMaterial& crMat = *rQuery.cpMat;   //cache material reference
-        int& hemisphereSampleCount  = rQuery.hemisphereSampleCount;
-        uint32& visQueries                  = rQuery.visQueries;
-        float& vis                                  = rQuery.vis;
-
-        uint32 insertedRayCacheEntries = 0;//accessor for rRayInterreflectionCache
-        //iterate samples
-        const TSampleVec::const_iterator cEnd = pThreadParam->crSamples.end();
-        for (TSampleVec::const_iterator sampleIter = pThreadParam->crSamples.begin(); sampleIter != cEnd; ++sampleIter)
+        const LONG cFirstQuery = InterlockedExchangeAdd(&pThreadParam->rNextQuery, gs_cRayCastingQueryChunk);
+        if (cFirstQuery >= cQueryCount)
         {
-            SThreadRayResult result;
+            break;
+        }
+        const LONG cLastQuery = std::min(cFirstQuery + gs_cRayCastingQueryChunk, cQueryCount);
+        //iterate each vertex and query
+        for (LONG queryIndex = cFirstQuery; queryIndex < cLastQuery; ++queryIndex)
+        {
+            SThreadRayVertexQuery& rQuery = rQueries[queryIndex];
+            TRayCacheVec& rRayInterreflectionCache = rIntersectionInfo[rQuery.vertexIndex];
+            const bool cOnlyHemisphere = crConfigurator.ProcessOnlyUpperHemisphere(rQuery.cpMat->Type());
+            rRayCaster.ResetCache(rQuery.pos, cRayLen, rQuery.normal, crParameters.rayTracingBias, cOnlyHemisphere, true /*use full vis cache*/);
+
+            const TVec& crPos                   = rQuery.pos;
+            const TVec& crNormal            = rQuery.normal;
+            const Vec2& crTexCoord      = rQuery.texCoord;
+            SCoeffList_tpl<TScalarCoeff>& rCoeffListDirect              = *rQuery.pCoeffListDirect;
+            const NSH::NMaterial::ISHMaterial& crMat = *rQuery.cpMat;   //cache material reference
+            int& hemisphereSampleCount  = rQuery.hemisphereSampleCount;
+            uint32& visQueries                  = rQuery.visQueries;
+            float& vis                                  = rQuery.vis;
+
+            uint32 insertedRayCacheEntries = 0;//accessor for rRayInterreflectionCache
+            //iterate samples
+            const TSampleVec::const_iterator cEnd = pThreadParam->crSamples.end();
+            for (TSampleVec::const_iterator sampleIter = pThreadParam->crSamples.begin(); sampleIter != cEnd; ++sampleIter)
+            {
+                SThreadRayResult result;
 
-            const CSample_tpl<SCoeffList_tpl<TScalarCoeff> >& crSample = *sampleIter;
-            const TCartesianCoord& rSampleCartCoord = crSample.GetCartesianPos();
+                const CSample_tpl<SCoeffList_tpl<TScalarCoeff> >& crSample = *sampleIter;
+                const TCartesianCoord& rSampleCartCoord = crSample.GetCartesianPos();
 
-            bool isOnUpperHemisphere = true;//indicates where sample lies
-            if (rSampleCartCoord * rQuery.normal < gs_cSampleCosThreshold)
-            {
-                if (cOnlyHemisphere)
+                bool isOnUpperHemisphere = true;//indicates where sample lies
+                if (rSampleCartCoord * rQuery.normal < gs_cSampleCosThreshold)
                 {
-                    continue;//consider only hemisphere
+                    if (cOnlyHemisphere)
+                    {
+                        continue;//consider only hemisphere
+                    }
+                    isOnUpperHemisphere = false;
                 }
-                isOnUpperHemisphere = false;
-            }
 
-            //cache result values
-            TRGBCoeffType& rIncidentIntensity = result.incidentIntensity;
-            bool& rContinueLoop = result.continueLoop;
-            bool& rApplyTransparency = result.applyTransparency;
+                //cache result values
+                TRGBCoeffType& rIncidentIntensity = result.incidentIntensity;
+                bool& rContinueLoop = result.continueLoop;
+                bool& rApplyTransparency = result.applyTransparency;
 
-            //reset intensity, loop indicator and transparency indicator
-            rIncidentIntensity = TRGBCoeffType(1., 1., 1.);
-            rContinueLoop = true;
-            rApplyTransparency = false;
+                //reset intensity, loop indicator and transparency indicator
+                rIncidentIntensity = TRGBCoeffType(1., 1., 1.);
+                rContinueLoop = true;
+                rApplyTransparency = false;
 
-            bool firstElement = true;
-            if (cHasTransparentMats && crParameters.supportTransparency)
-            {
-                const TCartesianCoord& crSampleDir = crSample.GetCartesianPos();
-                if (rRayCaster.CastRay(rRayResultVec, rQuery.pos, crSampleDir, cRayLen, rQuery.normal, crParameters.rayTracingBias))
+                bool firstElement = true;
+                if (cHasTransparentMats && crParameters.supportTransparency)
                 {
-                    SRayResultData rayResultData(cHasTransparentMats, crSampleDir, isOnUpperHemisphere, rRayResultVec,  rIncidentIntensity, rContinueLoop, rApplyTransparency);
-                    crConfigurator.ProcessRayCastingResult(rayResultData);
-                    if (rayResultData.pRayRes)
-                    { //record hit for interreflection and cache
-                        const SRayResult& rRayRes = *rayResultData.pRayRes;
-                        SRayCache& rRayCache        = tempRayCacheVec[insertedRayCacheEntries++];
-                        rRayCache.hSampleHandle = crSample.GetHandle();
-                        assert(rRayRes.faceID < (2 << (sizeof(rRayCache.faceIndex) * 8 - 1)));
-                        rRayCache.faceIndex         = (uint16)rRayRes.faceID;
-                        rRayCache.meshIndex         = (uint16)GetIndexFromMesh(crMeshes, rRayRes.pMesh);
-                        assert((uint32)crMeshes.size() < (uint32)(2 << (sizeof(rRayCache.faceIndex) * 8 - 1)));
+                    const TCartesianCoord& crSampleDir = crSample.GetCartesianPos();
+                    if (rRayCaster.CastRay(rRayResultVec, rQuery.pos, crSampleDir, cRayLen, rQuery.normal, crParameters.rayTracingBias))
+                    {
+                        SRayResultData rayResultData(cHasTransparentMats, crSampleDir, isOnUpperHemisphere, rRayResultVec,  rIncidentIntensity, rContinueLoop, rApplyTransparency);
+                        crConfigurator.ProcessRayCastingResult(rayResultData);
+                        if (rayResultData.pRayRes)
+                        { //record hit for interreflection and cache
+                            const SRayResult& rRayRes = *rayResultData.pRayRes;
+                            SRayCache& rRayCache        = tempRayCacheVec[insertedRayCacheEntries++];
+                            rRayCache.hSampleHandle = crSample.GetHandle();
+                            assert(rRayRes.faceID < (2 << (sizeof(rRayCache.faceIndex) * 8 - 1)));
+                            rRayCache.faceIndex         = (uint16)rRayRes.faceID;
+                            rRayCache.meshIndex         = (uint16)GetIndexFromMesh(crMeshes, rRayRes.pMesh);
+                            assert((uint32)crMeshes.size() < (uint32)(2 << (sizeof(rRayCache.faceIndex) * 8 - 1)));
+                        }
+                        result.returnValue = true;
+                    }
+                    else
+                    {
+                        result.returnValue = false;
                     }
-                    result.returnValue = true;
                 }
                 else
                 {
-                    result.returnValue = false;
-                }
-            }
-            else
-            {
-                SRayResult rayRes;
-                if (rRayCaster.CastRay(rayRes, rQuery.pos, crSample.GetCartesianPos(), cRayLen, rQuery.normal, crParameters.rayTracingBias))
-                {
-                    //record hit, used for subsequent interreflection passes
-                    result.returnValue = true;
+                    SRayResult rayRes;
+                    if (rRayCaster.CastRay(rayRes, rQuery.pos, crSample.GetCartesianPos(), cRayLen, rQuery.normal, crParameters.rayTracingBias))
+                    {
+                        //record hit, used for subsequent interreflection passes
+                        result.returnValue = true;
+                    }
+                    else
+                    {
+                        result.returnValue = false;
+                    }
                 }
-                else
+                //now process result
+                TRGBCoeffType incidentIntensity = result.incidentIntensity;
+                if (isOnUpperHemisphere)
                 {
-                    result.returnValue = false;
+                    hemisphereSampleCount++;//count for sample weighting(also important for indirect passes)
                 }
-            }
-            //now process result
-            TRGBCoeffType incidentIntensity = result.incidentIntensity;
-            if (isOnUpperHemisphere)
-            {
-                hemisphereSampleCount++;//count for sample weighting(also important for indirect passes)
-            }
-            visQueries++;
-            if (result.returnValue)
-            {
-                if (result.continueLoop)
+                visQueries++;
+                if (result.returnValue)
                 {
-                    if (cUseMinVisibility)
+                    if (result.continueLoop)
                     {
-                        crConfigurator.AddDirectScalarCoefficientValue(rCoeffListDirect, crParameters.minDirectBumpCoeffVisibility, crSample);
+                        if (cUseMinVisibility)
+                        {
+                            crConfigurator.AddDirectScalarCoefficientValue(rCoeffListDirect, crParameters.minDirectBumpCoeffVisibility, crSample);
+                        }
+                        continue;
                     }
-                    continue;
                 }
+                //ray fired toward ground, treat partly as blocked
+                SRayProcessedData rayProcessData
+                (
+                    crMat, crSample, crParameters, crPos, crNormal, crTexCoord, result.applyTransparency, isOnUpperHemisphere, false /*no interrefl*/,
+                    incidentIntensity, rCoeffListDirect, vis
+                );
+                crConfigurator.TransformRayCastingResult(rayProcessData);
+            }//sample loop for vertex query
+            rRayInterreflectionCache.resize(insertedRayCacheEntries);
+            for (uint32 i = 0; i < insertedRayCacheEntries; ++i)
+            {
+                rRayInterreflectionCache[i] = tempRayCacheVec[i];
             }
-            //ray fired toward ground, treat partly as blocked
-            SRayProcessedData rayProcessData
+
+            //scale and rotate the coefficients, for bump granularity this casts the lower hemisphere border rays too
+            const double cBaseSampleScale = (hemisphereSampleCount == 0) ? 0. : 2. / (double)hemisphereSampleCount; //divide by PI because we need exitance radiance here
+            const double cDirectScale = cOnlyHemisphere ? cBaseSampleScale : 4. / (double)pThreadParam->cSampleCount; //full sphere if required
+            pThreadParam->rTransfer.AdjustDirectCoefficients
             (
-                crMat, crSample, crParameters, crPos, crNormal, crTexCoord, result.applyTransparency, isOnUpperHemisphere, false /*no interrefl*/,
-                incidentIntensity, rCoeffListDirect, vis
+                pThreadParam->crSamples, pThreadParam->cSampleCount, pThreadParam->crMesh, crTexCoord, rRayCaster, cRayLen, crParameters, rQuery.normalIndex, rCoeffListDirect,
+                cDirectScale, crMat, rRayResultVec, pThreadParam->crSHDescriptor, crConfigurator, cHasTransparentMats, cOnlyHemisphere
             );
-            crConfigurator.TransformRayCastingResult(rayProcessData);
-        }//sample loop for vertex query
-        rRayInterreflectionCache.resize(insertedRayCacheEntries);
-        for (uint32 i = 0; i < insertedRayCacheEntries; ++i)
+        }//vertex query
+
+        //publish progress for the chunk, the state is shared with the other threads
+        const LONG cChunkSize = cLastQuery - cFirstQuery;
+        STransferStatus& rState = pThreadParam->rTransfer.m_State;
+        InterlockedExchangeAdd((volatile LONG*)&rState.vertexIndex, cChunkSize);
+        InterlockedExchangeAdd((volatile LONG*)&rState.overallVertexIndex, cChunkSize);
+        if (pThreadParam->cNotifyObservers)
         {
-            rRayInterreflectionCache[i] = tempRayCacheVec[i];
+            pThreadParam->rTransfer.Notify();//update observers
         }
-    }//vertex query
+    }//chunk
     return 0;
 }
 
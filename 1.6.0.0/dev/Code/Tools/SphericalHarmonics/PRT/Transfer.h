@@ -111,7 +111,7 @@ namespace NSH
                 const ITransferConfigurator& crConfigurator,
                 const bool cHasTransparentMats = false,
                 const bool cApplyValuesToLowerHS = true
-            );
+            ) const;
 
         public:
             CInterreflectionTransfer()      //!< standard constructor
@@ -195,13 +195,19 @@ namespace NSH
                 CRayCaster& rRayCaster;                                             //!< individual copy of ray casting interface
                 const TSampleVec& crSamples;                                    //!< samples to iterate(the same for each vertex)
                 const STransferParameters& crParameters;            //!< transfer params
-                TThreadRayVertexQueryVec& rQueries;                     //!< ray casting queries(result is stored in there too)
+                TThreadRayVertexQueryVec& rQueries;                     //!< ray casting queries shared by all threads(result is stored in there too)
+                volatile LONG& rNextQuery;                                      //!< index of the first query no thread has taken yet
                 TRayCacheVecVec& rIntersectionInfo;                     //!< intersection info to fill
                 const TGeomVec& crMeshes;                                           //!< vector of meshes to work on
                 const float cRayLen;                                                    //!< length of ray
                 const bool cHasTransparentMats;                             //!< determines whether there are any transparent materials or not(in that case ray casting needs to be handled in another way)
                 TRayResultVec& rRayResultVec;                                   //!< results for ray casting (save mem allocs)
                 const ITransferConfigurator& crConfigurator;    //!< configurator to use
+                CInterreflectionTransfer& rTransfer;                //!< transfer to adjust the direct coefficients with and to report progress to
+                const bool cNotifyObservers;                                //!< only the main thread notifies the observers
+                const CSimpleIndexedMesh& crMesh;                       //!< mesh the queries belong to
+                const uint32 cSampleCount;                                      //!< number of samples per vertex
+                const SDescriptor& crSHDescriptor;                      //!< SH descriptor of the coefficients
 
                 SThreadParams
                 (
@@ -209,28 +215,41 @@ namespace NSH
                     const TSampleVec& crSamplesParam,
                     const STransferParameters& crParametersParam,
                     TThreadRayVertexQueryVec& rQueriesParam,
+                    volatile LONG& rNextQueryParam,
                     TRayCacheVecVec& rIntersectionInfoParam,
                     const TGeomVec& crMeshesParam,
                     const float cRayLenParam,
                     const bool cHasTransparentMatsParam,
                     TRayResultVec& rRayResultVecParam,
-                    const ITransferConfigurator& crConfiguratorParam
+                    const ITransferConfigurator& crConfiguratorParam,
+                    CInterreflectionTransfer& rTransferParam,
+                    const bool cNotifyObserversParam,
+                    const CSimpleIndexedMesh& crMeshParam,
+                    const uint32 cSampleCountParam,
+                    const SDescriptor& crSHDescriptorParam
                 )
                     : rRayCaster(rRayCasterParam)
                     , crSamples(crSamplesParam)
                     , crParameters(crParametersParam)
                     , rQueries(rQueriesParam)
+                    , rNextQuery(rNextQueryParam)
                     , rIntersectionInfo(rIntersectionInfoParam)
                     , crMeshes(crMeshesParam)
                     , cRayLen(cRayLenParam)
                     , cHasTransparentMats(cHasTransparentMatsParam)
                     , rRayResultVec(rRayResultVecParam)
                     , crConfigurator(crConfiguratorParam)
+                    , rTransfer(rTransferParam)
+                    , cNotifyObservers(cNotifyObserversParam)
+                    , crMesh(crMeshParam)
+                    , cSampleCount(cSampleCountParam)
+                    , crSHDescriptor(crSHDescriptorParam)
                 {}
             }SThreadParams;
 #pragma warning (default : 4512)
 
             //!< core ray casting thread, casts ray and does everything else what PerformRayCasting does (but for threads)
+            //!< takes chunks of the shared queries until all are taken and adjusts the direct coefficients of each vertex
             static DWORD WINAPI RayCastingThread(LPVOID pThreadParam);
 
             //!< determine ray length from bounding box extensions of all participating meshes
@@ -0,0 +1,136 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#ifndef CRYINCLUDE_TOOLS_SPHERICALHARMONICS_PRT_TRIANGLEBVH_H
+#define CRYINCLUDE_TOOLS_SPHERICALHARMONICS_PRT_TRIANGLEBVH_H
+#pragma once
+
+#if defined(OFFLINE_COMPUTATION)
+
+
+#include <PRT/PRTTypes.h>
+#include "RasterCube.h"
+#include <xmmintrin.h>
+#include <limits>
+
+
+namespace NSH
+{
+    static const uint32 gscBVHQuadWidth = 4;                //!< triangles tested at once, one SSE lane each
+    static const uint32 gscBVHLeafTriangles = 4;        //!< nodes with no more triangles are always leaves
+    static const uint32 gscBVHMaxLeafTriangles = 8; //!< largest leaf the SAH may prefer over a split
+    static const uint32 gscBVHMaxDepth = 64;                //!< deeper nodes become leaves whatever their size, bounds the traversal stack
+    static const uint32 gscBVHBinCount = 16;                //!< SAH bins per axis
+
+    //!< bounding volume hierarchy over triangles, same interface as CRasterCube
+    //!< it is only read after PreProcess, so one instance serves all ray caster clones
+    //!< leaf triangles are stored in groups of 4 laid out for SSE, the group test is a conservative filter only,
+    //!< the sink still does its own exact intersection test for every triangle passing it
+    template <class T>
+    class CTriangleBVH
+    {
+        typedef CTriangleBVH<T> TTriangleBVHTempl;
+    public:
+        INSTALL_CLASS_NEW(TTriangleBVHTempl)
+
+        CTriangleBVH();     //!< default constructor
+
+        //! starts a new hierarchy, after that triangles can be put in
+        //! /param cElementCount element count to reserve memory for
+        //! /return true=success, false otherwise
+        const bool Init(const TVector3D cMinExt, const TVector3D cMaxExt, const uint32 cElementCount);
+
+        //! free data
+        void DeInit();
+
+        //! call this once per triangle after Init and before PreProcess
+        void PutInTriangle(const Vec3 cVertices[3], const T& crElement);
+
+        //! builds the hierarchy from all triangles put in
+        //! /return true=success, false otherwise
+        const bool PreProcess(const bool cDebug);
+
+        //! /return memory consumption in bytes
+        const uint32 CalcMemoryConsumption() const;
+        const uint32 GetNodeCount() const;
+        const uint32 GetElementCount() const;
+
+        //! returns every triangle possibly hit by the ray to the sink, near nodes first
+        //! if bBreakAfterFirstHit=true it returns as soon as the sink reports any hit, otherwise only on RETURN_SINK_HIT_AND_EARLY_OUT
+        template <class Sink, bool bBreakAfterFirstHit>
+        void GatherRayHitsDirection(const TVector3D cStart, const TVector3D cDir, Sink& rSink, const float cRayMax = std::numeric_limits<float>::max()) const;
+
+    private:
+        //!< inner nodes have count 0 and their children at offset and offset+1, leaves have count quads starting at offset
+        struct SNode
+        {
+            float minExt[3];
+            uint32 offset;
+            float maxExt[3];
+            uint32 count;
+        };
+
+        //!< 4 triangles as vertex 0 and the two edges leaving it, structure of arrays
+        struct SQuad
+        {
+            float v0[3][gscBVHQuadWidth];
+            float edge1[3][gscBVHQuadWidth];
+            float edge2[3][gscBVHQuadWidth];
+            uint32 element[gscBVHQuadWidth];    //!< index into m_Elements, lanes without triangle are degenerate and never pass the test
+        };
+
+        //!< per triangle data only needed during PreProcess
+        struct SBuildTriangle
+        {
+            float minExt[3];
+            float maxExt[3];
+            float centroid[3];
+        };
+
+        struct SBuildTask
+        {
+            uint32 nodeIndex;
+            uint32 first;       //!< first index into the build index vector
+            uint32 count;
+            uint32 depth;
+        };
+
+        typedef std::vector<SBuildTriangle, CSHAllocator<SBuildTriangle> > TBuildTriangleVec;
+        typedef std::vector<uint32, CSHAllocator<uint32> > TIndexVec;
+
+        std::vector<T, CSHAllocator<T> > m_Elements;           //!< triangles in the order they were put in
+        std::vector<SNode, CSHAllocator<SNode> > m_Nodes;   //!< depth first, root at 0
+        std::vector<SQuad, CSHAllocator<SQuad> > m_Quads;   //!< leaf triangles
+
+        //! finds the binned SAH split and partitions the indices of the task accordingly
+        //! /return false if the task is better kept as a leaf
+        const bool Split(const TBuildTriangleVec& crBuildTriangles, TIndexVec& rIndices, const SBuildTask& crTask, const float cNodeArea, const float cCentroidMin[3], const float cCentroidMax[3], uint32& rLeftCount) const;
+        void MakeLeaf(SNode& rNode, const TIndexVec& crIndices, const SBuildTask& crTask);
+
+        //! slab test, rEnter is the distance the ray enters the node at
+        static const bool IntersectNode(const SNode& crNode, const float cOrigin[3], const float cInvDir[3], const float cRayMax, float& rEnter);
+
+        //! /return true if the sink asked to stop
+        template <class Sink, bool bBreakAfterFirstHit>
+        const bool GatherElementsAt(const SNode& crNode, const __m128 cOrigin[3], const __m128 cDir[3], Sink& rSink, float& rRayMax) const;
+
+        static void GetVertices(const T& crElement, float rVertices[3][3]);
+        static const float HalfArea(const float cMinExt[3], const float cMaxExt[3]);
+
+        CTriangleBVH(const CTriangleBVH& crCopyFrom);//!< copy constructor, not supported
+    };
+}
+
+#include "TriangleBVH.inl"
+
+#endif
+#endif // CRYINCLUDE_TOOLS_SPHERICALHARMONICS_PRT_TRIANGLEBVH_H
@@ -0,0 +1,531 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+
+#if defined(OFFLINE_COMPUTATION)
+
+#include <algorithm>
+
+
+namespace NSH
+{
+    static const float gscBVHBoxPadding = 0.0001f;         //!< relative padding of triangle boxes so rays grazing a node are not lost to rounding
+    static const float gscBVHMinDeterminant = 0.0000005f;   //!< half the epsilon of RayTriangleIntersectTest, anything it accepts passes
+    static const float gscBVHBarySlack = 0.0001f;           //!< barycentric slack of the SSE filter
+    static const float gscBVHDistanceSlack = 0.001f;        //!< distance slack of the SSE filter
+}
+
+template <class T>
+NSH::CTriangleBVH<T>::CTriangleBVH()
+{
+    DeInit();
+}
+
+template <class T>
+const bool NSH::CTriangleBVH<T>::Init(const TVector3D, const TVector3D, const uint32 cElementCount)
+{
+    DeInit();
+    m_Elements.reserve(cElementCount);
+    return true;
+}
+
+template <class T>
+void NSH::CTriangleBVH<T>::DeInit()
+{
+    std::vector<T, CSHAllocator<T> >().swap(m_Elements);
+    std::vector<SNode, CSHAllocator<SNode> >().swap(m_Nodes);
+    std::vector<SQuad, CSHAllocator<SQuad> >().swap(m_Quads);
+}
+
+template <class T>
+void NSH::CTriangleBVH<T>::PutInTriangle(const Vec3[3], const T& crElement)
+{
+    //the vertices are taken from the element itself, the parameter is kept for the CRasterCube interface
+    assert(m_Nodes.empty());
+    m_Elements.push_back(crElement);
+}
+
+template <class T>
+const uint32 NSH::CTriangleBVH<T>::CalcMemoryConsumption() const
+{
+    return (uint32)(m_Elements.capacity() * sizeof(T) + m_Nodes.capacity() * sizeof(SNode) + m_Quads.capacity() * sizeof(SQuad) + sizeof(*this));
+}
+
+template <class T>
+const uint32 NSH::CTriangleBVH<T>::GetNodeCount() const
+{
+    return (uint32)m_Nodes.size();
+}
+
+template <class T>
+const uint32 NSH::CTriangleBVH<T>::GetElementCount() const
+{
+    return (uint32)m_Elements.size();
+}
+
+template <class T>
+inline void NSH::CTriangleBVH<T>::GetVertices(const T& crElement, float rVertices[3][3])
+{
+    for (int v = 0; v < 3; ++v)
+    {
+        rVertices[v][0] = crElement.vertices[v].x;
+        rVertices[v][1] = crElement.vertices[v].y;
+        rVertices[v][2] = crElement.vertices[v].z;
+    }
+}
+
+template <class T>
+const float NSH::CTriangleBVH<T>::HalfArea(const float cMinExt[3], const float cMaxExt[3])
+{
+    const float cX = cMaxExt[0] - cMinExt[0];
+    const float cY = cMaxExt[1] - cMinExt[1];
+    const float cZ = cMaxExt[2] - cMinExt[2];
+    return cX * cY + cY * cZ + cZ * cX;
+}
+
+template <class T>
+const bool NSH::CTriangleBVH<T>::PreProcess(const bool)
+{
+    m_Nodes.resize(0);
+    m_Quads.resize(0);
+    const uint32 cElementCount = (uint32)m_Elements.size();
+    if (cElementCount == 0)
+    {
+        return true;//nothing to hit, GatherRayHitsDirection returns right away
+    }
+
+    //cache triangle boxes and centroids
+    TBuildTriangleVec buildTriangles(cElementCount);
+    TIndexVec indices(cElementCount);
+    for (uint32 i = 0; i < cElementCount; ++i)
+    {
+        float vertices[3][3];
+        GetVertices(m_Elements[i], vertices);
+        SBuildTriangle& rBuildTriangle = buildTriangles[i];
+        for (int a = 0; a < 3; ++a)
+        {
+            const float cMin = std::min(vertices[0][a], std::min(vertices[1][a], vertices[2][a]));
+            const float cMax = std::max(vertices[0][a], std::max(vertices[1][a], vertices[2][a]));
+            const float cPadding = (cMax - cMin + fabs(cMin) + fabs(cMax)) * gscBVHBoxPadding + gscBVHBoxPadding;
+            rBuildTriangle.minExt[a] = cMin - cPadding;
+            rBuildTriangle.maxExt[a] = cMax + cPadding;
+            rBuildTriangle.centroid[a] = (cMin + cMax) * 0.5f;
+        }
+        indices[i] = i;
+    }
+
+    //a binary tree with at least one triangle per leaf has less than 2 nodes per triangle
+    m_Nodes.reserve(2 * cElementCount);
+    m_Quads.reserve(cElementCount / gscBVHQuadWidth + 1);
+    m_Nodes.push_back(SNode());
+
+    std::vector<SBuildTask, CSHAllocator<SBuildTask> > tasks;
+    SBuildTask rootTask;
+    rootTask.nodeIndex = 0;
+    rootTask.first = 0;
+    rootTask.count = cElementCount;
+    rootTask.depth = 0;
+    tasks.push_back(rootTask);
+    while (!tasks.empty())
+    {
+        const SBuildTask cTask = tasks.back();
+        tasks.pop_back();
+
+        //node box and centroid box
+        float minExt[3], maxExt[3], centroidMin[3], centroidMax[3];
+        for (int a = 0; a < 3; ++a)
+        {
+            minExt[a] = centroidMin[a] = std::numeric_limits<float>::max();
+            maxExt[a] = centroidMax[a] = -std::numeric_limits<float>::max();
+        }
+        for (uint32 i = cTask.first; i < cTask.first + cTask.count; ++i)
+        {
+            const SBuildTriangle& crBuildTriangle = buildTriangles[indices[i]];
+            for (int a = 0; a < 3; ++a)
+            {
+                minExt[a] = std::min(minExt[a], crBuildTriangle.minExt[a]);
+                maxExt[a] = std::max(maxExt[a], crBuildTriangle.maxExt[a]);
+                centroidMin[a] = std::min(centroidMin[a], crBuildTriangle.centroid[a]);
+                centroidMax[a] = std::max(centroidMax[a], crBuildTriangle.centroid[a]);
+            }
+        }
+        {
+            SNode& rNode = m_Nodes[cTask.nodeIndex];
+            for (int a = 0; a < 3; ++a)
+            {
+                rNode.minExt[a] = minExt[a];
+                rNode.maxExt[a] = maxExt[a];
+            }
+        }
+
+        uint32 leftCount = 0;
+        if (cTask.count <= gscBVHLeafTriangles || cTask.depth >= gscBVHMaxDepth ||
+            !Split(buildTriangles, indices, cTask, HalfArea(minExt, maxExt), centroidMin, centroidMax, leftCount))
+        {
+            MakeLeaf(m_Nodes[cTask.nodeIndex], indices, cTask);
+            continue;
+        }
+
+        const uint32 cChildIndex = (uint32)m_Nodes.size();
+        m_Nodes[cTask.nodeIndex].offset = cChildIndex;
+        m_Nodes[cTask.nodeIndex].count = 0;
+        m_Nodes.push_back(SNode());
+        m_Nodes.push_back(SNode());
+
+        SBuildTask childTask;
+        childTask.depth = cTask.depth + 1;
+        childTask.nodeIndex = cChildIndex;
+        childTask.first = cTask.first;
+        childTask.count = leftCount;
+        tasks.push_back(childTask);
+        childTask.nodeIndex = cChildIndex + 1;
+        childTask.first = cTask.first + leftCount;
+        childTask.count = cTask.count - leftCount;
+        tasks.push_back(childTask);
+    }
+    return true;
+}
+
+template <class T>
+const bool NSH::CTriangleBVH<T>::Split
+(
+    const TBuildTriangleVec& crBuildTriangles,
+    TIndexVec& rIndices,
+    const SBuildTask& crTask,
+    const float cNodeArea,
+    const float cCentroidMin[3],
+    const float cCentroidMax[3],
+    uint32& rLeftCount
+) const
+{
+    //evaluate the surface area heuristic at the bin borders of all 3 axes
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    uint32 bestBin = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+        const float cExtent = cCentroidMax[a] - cCentroidMin[a];
+        if (cExtent <= 0.f)
+        {
+            continue;
+        }
+        const float cBinScale = (float)gscBVHBinCount / cExtent;
+
+        uint32 binCount[gscBVHBinCount];
+        float binMin[gscBVHBinCount][3], binMax[gscBVHBinCount][3];
+        for (uint32 b = 0; b < gscBVHBinCount; ++b)
+        {
+            binCount[b] = 0;
+            for (int c = 0; c < 3; ++c)
+            {
+                binMin[b][c] = std::numeric_limits<float>::max();
+                binMax[b][c] = -std::numeric_limits<float>::max();
+            }
+        }
+        for (uint32 i = crTask.first; i < crTask.first + crTask.count; ++i)
+        {
+            const SBuildTriangle& crBuildTriangle = crBuildTriangles[rIndices[i]];
+            const uint32 cBin = std::min(gscBVHBinCount - 1, (uint32)((crBuildTriangle.centroid[a] - cCentroidMin[a]) * cBinScale));
+            binCount[cBin]++;
+            for (int c = 0; c < 3; ++c)
+            {
+                binMin[cBin][c] = std::min(binMin[cBin][c], crBuildTriangle.minExt[c]);
+                binMax[cBin][c] = std::max(binMax[cBin][c], crBuildTriangle.maxExt[c]);
+            }
+        }
+
+        //sweep from the right to get the cost of everything right of each border
+        float rightCost[gscBVHBinCount];
+        float sweepMin[3], sweepMax[3];
+        uint32 sweepCount = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+            sweepMin[c] = std::numeric_limits<float>::max();
+            sweepMax[c] = -std::numeric_limits<float>::max();
+        }
+        for (uint32 b = gscBVHBinCount - 1; b > 0; --b)
+        {
+            sweepCount += binCount[b];
+            for (int c = 0; c < 3; ++c)
+            {
+                sweepMin[c] = std::min(sweepMin[c], binMin[b][c]);
+                sweepMax[c] = std::max(sweepMax[c], binMax[b][c]);
+            }
+            rightCost[b] = (sweepCount > 0) ? HalfArea(sweepMin, sweepMax) * (float)sweepCount : 0.f;
+        }
+        //sweep from the left, border b lies between bin b-1 and bin b
+        sweepCount = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+            sweepMin[c] = std::numeric_limits<float>::max();
+            sweepMax[c] = -std::numeric_limits<float>::max();
+        }
+        for (uint32 b = 1; b < gscBVHBinCount; ++b)
+        {
+            sweepCount += binCount[b - 1];
+            for (int c = 0; c < 3; ++c)
+            {
+                sweepMin[c] = std::min(sweepMin[c], binMin[b - 1][c]);
+                sweepMax[c] = std::max(sweepMax[c], binMax[b - 1][c]);
+            }
+            if (sweepCount == 0 || sweepCount == crTask.count)
+            {
+                continue;
+            }
+            const float cCost = HalfArea(sweepMin, sweepMax) * (float)sweepCount + rightCost[b];
+            if (cCost < bestCost)
+            {
+                bestCost = cCost;
+                bestAxis = a;
+                bestBin = b;
+            }
+        }
+    }
+
+    if (bestAxis == -1)
+    {
+        //all centroids coincide, nothing to gain from a split unless the leaf would get too large
+        if (crTask.count <= gscBVHMaxLeafTriangles)
+        {
+            return false;
+        }
+        rLeftCount = crTask.count / 2;
+        return true;
+    }
+    if (crTask.count <= gscBVHMaxLeafTriangles && bestCost >= cNodeArea * (float)crTask.count)
+    {
+        return false;//testing all triangles is cheaper than descending
+    }
+
+    //partition in place, same bin computation as above so the counts match
+    const float cBinScale = (float)gscBVHBinCount / (cCentroidMax[bestAxis] - cCentroidMin[bestAxis]);
+    uint32 left = crTask.first;
+    uint32 right = crTask.first + crTask.count;
+    while (left < right)
+    {
+        const float cCentroid = crBuildTriangles[rIndices[left]].centroid[bestAxis];
+        const uint32 cBin = std::min(gscBVHBinCount - 1, (uint32)((cCentroid - cCentroidMin[bestAxis]) * cBinScale));
+        if (cBin < bestBin)
+        {
+            ++left;
+        }
+        else
+        {
+            std::swap(rIndices[left], rIndices[--right]);
+        }
+    }
+    rLeftCount = left - crTask.first;
+    assert(rLeftCount > 0 && rLeftCount < crTask.count);
+    return true;
+}
+
+template <class T>
+void NSH::CTriangleBVH<T>::MakeLeaf(SNode& rNode, const TIndexVec& crIndices, const SBuildTask& crTask)
+{
+    rNode.offset = (uint32)m_Quads.size();
+    rNode.count = (crTask.count + gscBVHQuadWidth - 1) / gscBVHQuadWidth;
+    for (uint32 q = 0; q < rNode.count; ++q)
+    {
+        SQuad quad;
+        memset(&quad, 0, sizeof(quad));
+        for (uint32 lane = 0; lane < gscBVHQuadWidth; ++lane)
+        {
+            const uint32 cIndex = q * gscBVHQuadWidth + lane;
+            if (cIndex >= crTask.count)
+            {
+                quad.element[lane] = (uint32)-1;//zero edges, the determinant test rejects it
+                continue;
+            }
+            const uint32 cElement = crIndices[crTask.first + cIndex];
+            float vertices[3][3];
+            GetVertices(m_Elements[cElement], vertices);
+            for (int a = 0; a < 3; ++a)
+            {
+                quad.v0[a][lane] = vertices[0][a];
+                quad.edge1[a][lane] = vertices[1][a] - vertices[0][a];
+                quad.edge2[a][lane] = vertices[2][a] - vertices[0][a];
+            }
+            quad.element[lane] = cElement;
+        }
+        m_Quads.push_back(quad);
+    }
+}
+
+template <class T>
+inline const bool NSH::CTriangleBVH<T>::IntersectNode(const SNode& crNode, const float cOrigin[3], const float cInvDir[3], const float cRayMax, float& rEnter)
+{
+    float enter = 0.f;
+    float exit = cRayMax;
+    for (int a = 0; a < 3; ++a)
+    {
+        const float cT0 = (crNode.minExt[a] - cOrigin[a]) * cInvDir[a];
+        const float cT1 = (crNode.maxExt[a] - cOrigin[a]) * cInvDir[a];
+        enter = std::max(enter, std::min(cT0, cT1));
+        exit = std::min(exit, std::max(cT0, cT1));
+    }
+    rEnter = enter;
+    return enter <= exit;
+}
+
+template <class T>
+template <class Sink, bool bBreakAfterFirstHit>
+void NSH::CTriangleBVH<T>::GatherRayHitsDirection(const TVector3D cStart, const TVector3D cDir, Sink& rSink, const float cRayMax) const
+{
+    if (m_Nodes.empty())
+    {
+        return;
+    }
+    float origin[3], invDir[3];
+    __m128 originSSE[3], dirSSE[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        const float cDirComponent = (float)cDir.p[a];
+        origin[a] = (float)cStart.p[a];
+        //avoid 0 * infinity in the slab test for rays starting on a node border
+        invDir[a] = (fabs(cDirComponent) > 1e-20f) ? 1.f / cDirComponent : ((cDirComponent < 0.f) ? -1e20f : 1e20f);
+        originSSE[a] = _mm_set1_ps(origin[a]);
+        dirSSE[a] = _mm_set1_ps(cDirComponent);
+    }
+
+    float rayMax = cRayMax;
+    float enter;
+    if (!IntersectNode(m_Nodes[0], origin, invDir, rayMax, enter))
+    {
+        return;
+    }
+
+    //far children waiting to be visited, with the distance the ray enters them
+    uint32 stackNodes[gscBVHMaxDepth + 2];
+    float stackEnter[gscBVHMaxDepth + 2];
+    uint32 stackSize = 0;
+    uint32 nodeIndex = 0;
+    for (;; )
+    {
+        const SNode& crNode = m_Nodes[nodeIndex];
+        if (crNode.count > 0)
+        {
+            if (GatherElementsAt<Sink, bBreakAfterFirstHit>(crNode, originSSE, dirSSE, rSink, rayMax))
+            {
+                return;//one valid hit found, stop here
+            }
+        }
+        else
+        {
+            float enter0, enter1;
+            const bool cHit0 = IntersectNode(m_Nodes[crNode.offset], origin, invDir, rayMax, enter0);
+            const bool cHit1 = IntersectNode(m_Nodes[crNode.offset + 1], origin, invDir, rayMax, enter1);
+            if (cHit0 && cHit1)
+            {
+                //visit the nearer child first, hits in there may cull the other one
+                const bool cFirstIsNear = (enter0 <= enter1);
+                assert(stackSize < gscBVHMaxDepth + 2);
+                stackNodes[stackSize] = cFirstIsNear ? crNode.offset + 1 : crNode.offset;
+                stackEnter[stackSize++] = cFirstIsNear ? enter1 : enter0;
+                nodeIndex = cFirstIsNear ? crNode.offset : crNode.offset + 1;
+                continue;
+            }
+            if (cHit0 || cHit1)
+            {
+                nodeIndex = cHit0 ? crNode.offset : crNode.offset + 1;
+                continue;
+            }
+        }
+        //pop the next node the ray still reaches
+        bool found = false;
+        while (stackSize > 0)
+        {
+            --stackSize;
+            if (stackEnter[stackSize] <= rayMax)
+            {
+                nodeIndex = stackNodes[stackSize];
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+        {
+            return;
+        }
+    }
+}
+
+template <class T>
+template <class Sink, bool bBreakAfterFirstHit>
+const bool NSH::CTriangleBVH<T>::GatherElementsAt(const SNode& crNode, const __m128 cOrigin[3], const __m128 cDir[3], Sink& rSink, float& rRayMax) const
+{
+    const __m128 cZero = _mm_setzero_ps();
+    const __m128 cOne = _mm_set1_ps(1.f);
+    const __m128 cMinDeterminant = _mm_set1_ps(gscBVHMinDeterminant);
+    const __m128 cMinBary = _mm_set1_ps(-gscBVHBarySlack);
+    const __m128 cMaxBary = _mm_set1_ps(1.f + gscBVHBarySlack);
+    const __m128 cMinDistance = _mm_set1_ps(-gscBVHDistanceSlack);
+    //like a raster cube cell, the whole leaf is culled with the ray max it was entered with and returned before that is lowered,
+    //the sink gets its own max for the leaf, starting unlimited as it does for a cell
+    const __m128 cMaxDistance = _mm_set1_ps(rRayMax + (rRayMax + 1.f) * gscBVHDistanceSlack);
+    float leafRayMax = std::numeric_limits<float>::max();
+
+    for (uint32 q = 0; q < crNode.count; ++q)
+    {
+        const SQuad& crQuad = m_Quads[crNode.offset + q];
+        //Moeller-Trumbore for 4 triangles, same operations as NRayTriangleIntersect::RayTriangleIntersectTest without culling
+        const __m128 cE1X = _mm_loadu_ps(crQuad.edge1[0]);
+        const __m128 cE1Y = _mm_loadu_ps(crQuad.edge1[1]);
+        const __m128 cE1Z = _mm_loadu_ps(crQuad.edge1[2]);
+        const __m128 cE2X = _mm_loadu_ps(crQuad.edge2[0]);
+        const __m128 cE2Y = _mm_loadu_ps(crQuad.edge2[1]);
+        const __m128 cE2Z = _mm_loadu_ps(crQuad.edge2[2]);
+        //pvec = dir x edge2
+        const __m128 cPX = _mm_sub_ps(_mm_mul_ps(cDir[1], cE2Z), _mm_mul_ps(cDir[2], cE2Y));
+        const __m128 cPY = _mm_sub_ps(_mm_mul_ps(cDir[2], cE2X), _mm_mul_ps(cDir[0], cE2Z));
+        const __m128 cPZ = _mm_sub_ps(_mm_mul_ps(cDir[0], cE2Y), _mm_mul_ps(cDir[1], cE2X));
+        const __m128 cDet = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cE1X, cPX), _mm_mul_ps(cE1Y, cPY)), _mm_mul_ps(cE1Z, cPZ));
+        const __m128 cAbsDet = _mm_max_ps(cDet, _mm_sub_ps(cZero, cDet));
+        //tvec = origin - v0
+        const __m128 cTX = _mm_sub_ps(cOrigin[0], _mm_loadu_ps(crQuad.v0[0]));
+        const __m128 cTY = _mm_sub_ps(cOrigin[1], _mm_loadu_ps(crQuad.v0[1]));
+        const __m128 cTZ = _mm_sub_ps(cOrigin[2], _mm_loadu_ps(crQuad.v0[2]));
+        //qvec = tvec x edge1
+        const __m128 cQX = _mm_sub_ps(_mm_mul_ps(cTY, cE1Z), _mm_mul_ps(cTZ, cE1Y));
+        const __m128 cQY = _mm_sub_ps(_mm_mul_ps(cTZ, cE1X), _mm_mul_ps(cTX, cE1Z));
+        const __m128 cQZ = _mm_sub_ps(_mm_mul_ps(cTX, cE1Y), _mm_mul_ps(cTY, cE1X));
+        const __m128 cInvDet = _mm_div_ps(cOne, cDet);
+        const __m128 cU = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cTX, cPX), _mm_mul_ps(cTY, cPY)), _mm_mul_ps(cTZ, cPZ)), cInvDet);
+        const __m128 cV = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cDir[0], cQX), _mm_mul_ps(cDir[1], cQY)), _mm_mul_ps(cDir[2], cQZ)), cInvDet);
+        const __m128 cT = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cE2X, cQX), _mm_mul_ps(cE2Y, cQY)), _mm_mul_ps(cE2Z, cQZ)), cInvDet);
+        //degenerate lanes produce NaN or infinity here, the ordered compares reject those
+        __m128 mask = _mm_cmpge_ps(cAbsDet, cMinDeterminant);
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(cU, cMinBary));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(cV, cMinBary));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(cU, cV), cMaxBary));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(cT, cMinDistance));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(cT, cMaxDistance));
+
+        int lanes = _mm_movemask_ps(mask);
+        while (lanes)
+        {
+            const uint32 cLane = (lanes & 1) ? 0 : ((lanes & 2) ? 1 : ((lanes & 4) ? 2 : 3));
+            lanes &= lanes - 1;
+            assert(crQuad.element[cLane] < (uint32)m_Elements.size());
+            const NSH::EReturnSinkValue cResult = rSink.ReturnElement(m_Elements[crQuad.element[cLane]], leafRayMax);
+            if (bBreakAfterFirstHit ? (NSH::RETURN_SINK_FAIL != cResult) : (NSH::RETURN_SINK_HIT_AND_EARLY_OUT == cResult))
+            {
+                rSink.EndReturningBucket();
+                return true;
+            }
+        }
+    }
+    rSink.EndReturningBucket();
+    //the traversal culls the remaining nodes with it
+    rRayMax = std::min(rRayMax, leafRayMax);
+    return false;
+}
+
+#endif
@@ -0,0 +1,361 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#include "StdAfx.h"
+#include "BoidGrid.h"
+#include "BoidObject.h"
+
+#if defined(_CPU_SSE)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Keeps neighbors which are just inside MaxAttractDistance from falling two cells away due to rounding.
+    const float kCellSizeScale = 1.001f;
+    const float kMinCellSize = 0.01f;
+    const int kPadding = 3;
+}
+
+CBoidGrid::CBoidGrid()
+    : m_bValid(false)
+    , m_count(0)
+    , m_invCellSize(1.0f)
+    , m_bucketMask(0)
+{
+    memset(&m_params, 0, sizeof(m_params));
+}
+
+CBoidGrid::SQueryParams CBoidGrid::GetQueryParams(const SBoidContext& bc)
+{
+    SQueryParams params;
+    params.maxAttractDistance2 = bc.MaxAttractDistance * bc.MaxAttractDistance;
+    params.minAttractDistance2 = bc.MinAttractDistance * bc.MinAttractDistance;
+    params.cosFovAngle = bc.cosFovAngle;
+    params.factorSeparation = bc.factorSeparation;
+    return params;
+}
+
+bool CBoidGrid::SameQueryParams(const SQueryParams& a, const SQueryParams& b)
+{
+    return a.maxAttractDistance2 == b.maxAttractDistance2 && a.minAttractDistance2 == b.minAttractDistance2 &&
+           a.cosFovAngle == b.cosFovAngle && a.factorSeparation == b.factorSeparation;
+}
+
+uint32 CBoidGrid::GetBucket(int x, int y, int z) const
+{
+    return ((uint32)x * 73856093u ^ (uint32)y * 19349663u ^ (uint32)z * 83492791u) & m_bucketMask;
+}
+
+void CBoidGrid::Build(const std::vector<CBoidObject*>& boids, const SBoidContext& bc)
+{
+    m_params = GetQueryParams(bc);
+    m_invCellSize = 1.0f / (max(bc.MaxAttractDistance, kMinCellSize) * kCellSizeScale);
+
+    m_count = 0;
+    for (size_t i = 0; i < boids.size(); ++i)
+    {
+        if (boids[i])
+        {
+            ++m_count;
+        }
+    }
+
+    uint32 bucketCount = 16;
+    while (bucketCount < (uint32)m_count * 2)
+    {
+        bucketCount <<= 1;
+    }
+    m_bucketMask = bucketCount - 1;
+
+    // Counting sort of the boids by bucket.
+    std::vector<uint32> boidBuckets(boids.size());
+    m_bucketStart.assign(bucketCount + 1, 0);
+    for (size_t i = 0; i < boids.size(); ++i)
+    {
+        if (const CBoidObject* boid = boids[i])
+        {
+            const Vec3& pos = boid->m_pos;
+            boidBuckets[i] = GetBucket((int)floorf(pos.x * m_invCellSize), (int)floorf(pos.y * m_invCellSize), (int)floorf(pos.z * m_invCellSize));
+            ++m_bucketStart[boidBuckets[i] + 1];
+        }
+    }
+    for (uint32 bucket = 0; bucket < bucketCount; ++bucket)
+    {
+        m_bucketStart[bucket + 1] += m_bucketStart[bucket];
+    }
+
+    const size_t paddedCount = m_count + kPadding;
+    m_posX.assign(paddedCount, 0.0f);
+    m_posY.assign(paddedCount, 0.0f);
+    m_posZ.assign(paddedCount, 0.0f);
+    m_velX.assign(paddedCount, 0.0f);
+    m_velY.assign(paddedCount, 0.0f);
+    m_velZ.assign(paddedCount, 0.0f);
+    m_heading.resize(m_count);
+
+    std::vector<int> bucketFill(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    for (size_t i = 0; i < boids.size(); ++i)
+    {
+        if (CBoidObject* boid = boids[i])
+        {
+            const int index = bucketFill[boidBuckets[i]]++;
+            const Vec3 velocity = boid->m_heading * boid->m_speed;
+            m_posX[index] = boid->m_pos.x;
+            m_posY[index] = boid->m_pos.y;
+            m_posZ[index] = boid->m_pos.z;
+            m_velX[index] = velocity.x;
+            m_velY[index] = velocity.y;
+            m_velZ[index] = velocity.z;
+            m_heading[index] = boid->m_heading;
+            boid->m_gridIndex = index;
+        }
+    }
+
+    SFlockBehavior invalidBehavior;
+    invalidBehavior.bValid = false;
+    m_behaviors.assign(m_count, invalidBehavior);
+
+    m_bValid = true;
+}
+
+void CBoidGrid::Invalidate()
+{
+    m_bValid = false;
+}
+
+void CBoidGrid::PrecomputeFlockBehavior(int firstBoid, int lastBoid)
+{
+    for (int i = firstBoid; i < lastBoid; ++i)
+    {
+        SFlockBehavior& behavior = m_behaviors[i];
+        const Vec3 pos(m_posX[i], m_posY[i], m_posZ[i]);
+        Query(i, pos, m_heading[i], m_params, behavior.alignment, behavior.cohesion, behavior.separation);
+        behavior.bValid = true;
+    }
+}
+
+bool CBoidGrid::CalcFlockBehavior(int boidIndex, const Vec3& pos, const Vec3& heading, const SBoidContext& bc, Vec3& vAlignment, Vec3& vCohesion, Vec3& vSeparation) const
+{
+    if (!m_bValid || boidIndex < 0 || boidIndex >= m_count)
+    {
+        return false;
+    }
+
+    const SQueryParams params = GetQueryParams(bc);
+    if (params.maxAttractDistance2 > m_params.maxAttractDistance2)
+    {
+        return false;
+    }
+
+    const SFlockBehavior& behavior = m_behaviors[boidIndex];
+    if (behavior.bValid && SameQueryParams(params, m_params) &&
+        pos.x == m_posX[boidIndex] && pos.y == m_posY[boidIndex] && pos.z == m_posZ[boidIndex] && heading == m_heading[boidIndex])
+    {
+        vAlignment = behavior.alignment;
+        vCohesion = behavior.cohesion;
+        vSeparation = behavior.separation;
+        return true;
+    }
+
+    Query(boidIndex, pos, heading, params, vAlignment, vCohesion, vSeparation);
+    return true;
+}
+
+void CBoidGrid::Query(int boidIndex, const Vec3& pos, const Vec3& heading, const SQueryParams& params, Vec3& vAlignment, Vec3& vCohesion, Vec3& vSeparation) const
+{
+    vSeparation.zero();
+    vAlignment.zero();
+    vCohesion.zero();
+
+    // Neighbor cells can share a bucket, every bucket must only be visited once.
+    uint32 buckets[27];
+    int numBuckets = 0;
+    const int cellX = (int)floorf(pos.x * m_invCellSize);
+    const int cellY = (int)floorf(pos.y * m_invCellSize);
+    const int cellZ = (int)floorf(pos.z * m_invCellSize);
+    for (int z = cellZ - 1; z <= cellZ + 1; ++z)
+    {
+        for (int y = cellY - 1; y <= cellY + 1; ++y)
+        {
+            for (int x = cellX - 1; x <= cellX + 1; ++x)
+            {
+                buckets[numBuckets++] = GetBucket(x, y, z);
+            }
+        }
+    }
+    std::sort(buckets, buckets + numBuckets);
+    numBuckets = (int)(std::unique(buckets, buckets + numBuckets) - buckets);
+
+    Vec3 avgAlignment(0, 0, 0);
+    Vec3 avgNeighborsCenter(0, 0, 0);
+    int numMates = 0;
+
+#if defined(_CPU_SSE)
+    const __m128 posX = _mm_set1_ps(pos.x);
+    const __m128 posY = _mm_set1_ps(pos.y);
+    const __m128 posZ = _mm_set1_ps(pos.z);
+    const __m128 headingX = _mm_set1_ps(heading.x);
+    const __m128 headingY = _mm_set1_ps(heading.y);
+    const __m128 headingZ = _mm_set1_ps(heading.z);
+    const __m128 maxAttractDistance2 = _mm_set1_ps(params.maxAttractDistance2);
+    const __m128 minAttractDistance2 = _mm_set1_ps(params.minAttractDistance2);
+    const __m128 cosFovAngle = _mm_set1_ps(params.cosFovAngle);
+    const __m128 factorSeparation = _mm_set1_ps(params.factorSeparation);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threeHalves = _mm_set1_ps(1.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i magic = _mm_set1_epi32(0x5f3759df);
+    const __m128i self = _mm_set1_epi32(boidIndex);
+    const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+    __m128 alignmentX = _mm_setzero_ps();
+    __m128 alignmentY = _mm_setzero_ps();
+    __m128 alignmentZ = _mm_setzero_ps();
+    __m128 centerX = _mm_setzero_ps();
+    __m128 centerY = _mm_setzero_ps();
+    __m128 centerZ = _mm_setzero_ps();
+    __m128 separationX = _mm_setzero_ps();
+    __m128 separationY = _mm_setzero_ps();
+    __m128 separationZ = _mm_setzero_ps();
+    __m128i mates = _mm_setzero_si128();
+
+    for (int b = 0; b < numBuckets; ++b)
+    {
+        const int end = m_bucketStart[buckets[b] + 1];
+        const __m128i endIndex = _mm_set1_epi32(end);
+        for (int i = m_bucketStart[buckets[b]]; i < end; i += 4)
+        {
+            const __m128 neighborX = _mm_loadu_ps(&m_posX[i]);
+            const __m128 neighborY = _mm_loadu_ps(&m_posY[i]);
+            const __m128 neighborZ = _mm_loadu_ps(&m_posZ[i]);
+
+            __m128 sightX = _mm_sub_ps(neighborX, posX);
+            __m128 sightY = _mm_sub_ps(neighborY, posY);
+            __m128 sightZ = _mm_sub_ps(neighborZ, posZ);
+
+            // Boid::Normalize_fast, lane by lane
+            const __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sightX, sightX), _mm_mul_ps(sightY, sightY)), _mm_mul_ps(sightZ, sightZ));
+            const __m128 n = _mm_castsi128_ps(_mm_sub_epi32(magic, _mm_srli_epi32(_mm_castps_si128(dist2), 1)));
+            const __m128 d = _mm_mul_ps(_mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(dist2, half), n), n)), n);
+            sightX = _mm_mul_ps(sightX, d);
+            sightY = _mm_mul_ps(sightY, d);
+            sightZ = _mm_mul_ps(sightZ, d);
+
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(headingX, sightX), _mm_mul_ps(headingY, sightY)), _mm_mul_ps(headingZ, sightZ));
+
+            const __m128i index = _mm_add_epi32(_mm_set1_epi32(i), laneOffsets);
+            const __m128i validLanes = _mm_andnot_si128(_mm_cmpeq_epi32(index, self), _mm_cmplt_epi32(index, endIndex));
+
+            const __m128 mateMask = _mm_and_ps(_mm_castsi128_ps(validLanes), _mm_and_ps(_mm_cmplt_ps(dist2, maxAttractDistance2), _mm_cmpgt_ps(dot, cosFovAngle)));
+            if (_mm_movemask_ps(mateMask) == 0)
+            {
+                continue;
+            }
+
+            // Boid too close, distract from him.
+            const __m128 separationMask = _mm_and_ps(mateMask, _mm_cmplt_ps(dist2, minAttractDistance2));
+            const __m128 w = _mm_sub_ps(one, _mm_div_ps(dist2, minAttractDistance2));
+            separationX = _mm_sub_ps(separationX, _mm_and_ps(separationMask, _mm_mul_ps(_mm_mul_ps(sightX, w), factorSeparation)));
+            separationY = _mm_sub_ps(separationY, _mm_and_ps(separationMask, _mm_mul_ps(_mm_mul_ps(sightY, w), factorSeparation)));
+            separationZ = _mm_sub_ps(separationZ, _mm_and_ps(separationMask, _mm_mul_ps(_mm_mul_ps(sightZ, w), factorSeparation)));
+
+            mates = _mm_sub_epi32(mates, _mm_castps_si128(mateMask));
+
+            alignmentX = _mm_add_ps(alignmentX, _mm_and_ps(mateMask, _mm_loadu_ps(&m_velX[i])));
+            alignmentY = _mm_add_ps(alignmentY, _mm_and_ps(mateMask, _mm_loadu_ps(&m_velY[i])));
+            alignmentZ = _mm_add_ps(alignmentZ, _mm_and_ps(mateMask, _mm_loadu_ps(&m_velZ[i])));
+
+            centerX = _mm_add_ps(centerX, _mm_and_ps(mateMask, neighborX));
+            centerY = _mm_add_ps(centerY, _mm_and_ps(mateMask, neighborY));
+            centerZ = _mm_add_ps(centerZ, _mm_and_ps(mateMask, neighborZ));
+        }
+    }
+
+    float sums[10][4];
+    _mm_storeu_ps(sums[0], alignmentX);
+    _mm_storeu_ps(sums[1], alignmentY);
+    _mm_storeu_ps(sums[2], alignmentZ);
+    _mm_storeu_ps(sums[3], centerX);
+    _mm_storeu_ps(sums[4], centerY);
+    _mm_storeu_ps(sums[5], centerZ);
+    _mm_storeu_ps(sums[6], separationX);
+    _mm_storeu_ps(sums[7], separationY);
+    _mm_storeu_ps(sums[8], separationZ);
+    _mm_storeu_ps(sums[9], _mm_castsi128_ps(mates));
+
+    avgAlignment.Set(sums[0][0] + sums[0][1] + sums[0][2] + sums[0][3], sums[1][0] + sums[1][1] + sums[1][2] + sums[1][3], sums[2][0] + sums[2][1] + sums[2][2] + sums[2][3]);
+    avgNeighborsCenter.Set(sums[3][0] + sums[3][1] + sums[3][2] + sums[3][3], sums[4][0] + sums[4][1] + sums[4][2] + sums[4][3], sums[5][0] + sums[5][1] + sums[5][2] + sums[5][3]);
+    vSeparation.Set(sums[6][0] + sums[6][1] + sums[6][2] + sums[6][3], sums[7][0] + sums[7][1] + sums[7][2] + sums[7][3], sums[8][0] + sums[8][1] + sums[8][2] + sums[8][3]);
+
+    int mateCounts[4];
+    memcpy(mateCounts, sums[9], sizeof(mateCounts));
+    numMates = mateCounts[0] + mateCounts[1] + mateCounts[2] + mateCounts[3];
+#else
+    for (int b = 0; b < numBuckets; ++b)
+    {
+        const int end = m_bucketStart[buckets[b] + 1];
+        for (int i = m_bucketStart[buckets[b]]; i < end; ++i)
+        {
+            if (i == boidIndex) // skip myself.
+            {
+                continue;
+            }
+
+            Vec3 sight(m_posX[i] - pos.x, m_posY[i] - pos.y, m_posZ[i] - pos.z);
+            const float dist2 = Boid::Normalize_fast(sight);
+
+            if (dist2 < params.maxAttractDistance2 && heading.Dot(sight) > params.cosFovAngle)
+            {
+                if (dist2 < params.minAttractDistance2)
+                {
+                    // Boid too close, distract from him.
+                    float w = (1.0f - dist2 / params.minAttractDistance2);
+                    vSeparation -= sight * (w) * params.factorSeparation;
+                }
+
+                numMates++;
+                avgAlignment += Vec3(m_velX[i], m_velY[i], m_velZ[i]);
+                avgNeighborsCenter += Vec3(m_posX[i], m_posY[i], m_posZ[i]);
+            }
+        }
+    }
+#endif
+
+    if (numMates > 0)
+    {
+        avgAlignment = avgAlignment * (1.0f / numMates);
+        vAlignment = avgAlignment;
+
+        // Attraction to mates.
+        avgNeighborsCenter = avgNeighborsCenter * (1.0f / numMates);
+        Vec3 cohesionDir = avgNeighborsCenter - pos;
+
+        float sqrDist = cohesionDir.IsZeroFast() ? 0 : Boid::Normalize_fast(cohesionDir);
+        float w = params.maxAttractDistance2 != params.minAttractDistance2
+            ? (sqrDist - params.minAttractDistance2) / (params.maxAttractDistance2 - params.minAttractDistance2)
+            : 0;
+        vCohesion = cohesionDir * w;
+    }
+}
+
+void CBoidGrid::GetMemoryUsage(ICrySizer* pSizer) const
+{
+    pSizer->AddContainer(m_bucketStart);
+    pSizer->AddContainer(m_posX);
+    pSizer->AddContainer(m_posY);
+    pSizer->AddContainer(m_posZ);
+    pSizer->AddContainer(m_velX);
+    pSizer->AddContainer(m_velY);
+    pSizer->AddContainer(m_velZ);
+    pSizer->AddContainer(m_heading);
+    pSizer->AddContainer(m_behaviors);
+}
@@ -0,0 +1,92 @@
+/*
+* All or portions of this file Copyright (c) Amazon.com, Inc. or its affiliates or
+* its licensors.
+*
+* For complete copyright and license terms please see the LICENSE at the root of this
+* distribution (the "License"). All use of this software is governed by the License,
+* or, if provided, by the license below or the license accompanying this file. Do not
+* remove or modify any license notices. This file is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*
+*/
+#ifndef CRYINCLUDE_GAMEDLL_BOIDS_BOIDGRID_H
+#define CRYINCLUDE_GAMEDLL_BOIDS_BOIDGRID_H
+#pragma once
+
+class CBoidObject;
+struct SBoidContext;
+
+/*!
+ *  Snapshot of a flock's boids taken at the start of a flock update, hashed into a uniform grid
+ *  with cells of MaxAttractDistance so that neighbor queries only visit the 27 cells around a boid.
+ *  Positions and velocities are kept as structure of arrays, sorted by cell, so the flock behavior
+ *  sums can be computed four boids at a time.
+ */
+class CBoidGrid
+{
+public:
+    CBoidGrid();
+
+    //! Take a snapshot of boids and assign every boid its grid index.
+    void Build(const std::vector<CBoidObject*>& boids, const SBoidContext& bc);
+    //! Forget the snapshot, boids fall back to checking the whole flock.
+    void Invalidate();
+    bool IsValid() const { return m_bValid; }
+
+    //! Computes the flock behavior of every boid in [firstBoid, lastBoid) from the snapshot.
+    //! Boids which haven't moved by the time they ask for their flock behavior get it from this cache.
+    //! Different ranges may be computed on different threads.
+    void PrecomputeFlockBehavior(int firstBoid, int lastBoid);
+    int GetBoidCount() const { return m_count; }
+
+    //! Same as CBoidObject::CalcFlockBehavior, with neighbors taken from the snapshot.
+    //! Returns false if the grid can't answer, e.g. when bc asks for a larger attract distance than it was built for.
+    bool CalcFlockBehavior(int boidIndex, const Vec3& pos, const Vec3& heading, const SBoidContext& bc, Vec3& vAlignment, Vec3& vCohesion, Vec3& vSeparation) const;
+
+    void GetMemoryUsage(ICrySizer* pSizer) const;
+
+private:
+    struct SFlockBehavior
+    {
+        Vec3 alignment;
+        Vec3 cohesion;
+        Vec3 separation;
+        bool bValid;
+    };
+
+    struct SQueryParams
+    {
+        float maxAttractDistance2;
+        float minAttractDistance2;
+        float cosFovAngle;
+        float factorSeparation;
+    };
+
+    static SQueryParams GetQueryParams(const SBoidContext& bc);
+    static bool SameQueryParams(const SQueryParams& a, const SQueryParams& b);
+
+    uint32 GetBucket(int x, int y, int z) const;
+    void Query(int boidIndex, const Vec3& pos, const Vec3& heading, const SQueryParams& params, Vec3& vAlignment, Vec3& vCohesion, Vec3& vSeparation) const;
+
+    bool m_bValid;
+    int m_count;
+    float m_invCellSize;
+    uint32 m_bucketMask;
+    SQueryParams m_params;
+
+    // First boid of every bucket, m_bucketStart[bucket + 1] is one past its last boid.
+    std::vector<int> m_bucketStart;
+
+    // Boids sorted by bucket. Padded by 3 elements so that 4-wide loads never read past the end.
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    std::vector<float> m_posZ;
+    std::vector<float> m_velX;
+    std::vector<float> m_velY;
+    std::vector<float> m_velZ;
+    std::vector<Vec3> m_heading;
+
+    std::vector<SFlockBehavior> m_behaviors;
+};
+
+#endif // CRYINCLUDE_GAMEDLL_BOIDS_BOIDGRID_H
@@ -53,6 +53,7 @@ CBoidObject::CBoidObject(SBoidContext& bc)
 {
     m_flock = 0;
     m_entity = 0;
+    m_gridIndex = -1;
 
     m_heading.Set(1, 0, 0);
     m_accel.Set(0, 0, 0);
@@ -376,6 +377,12 @@ void CBoidObject::CalcFlockBehavior(SBoidContext& bc, Vec3& vAlignment, Vec3& vC
     float MaxAttractDistance2 = bc.MaxAttractDistance * bc.MaxAttractDistance;
     float MinAttractDistance2 = bc.MinAttractDistance * bc.MinAttractDistance;
 
+    // Only neighbors within MaxAttractDistance count, the flock's grid finds them without visiting every boid.
+    if (m_flock->GetBoidGrid().CalcFlockBehavior(m_gridIndex, m_pos, m_heading, bc, vAlignment, vCohesion, vSeparation))
+    {
+        return;
+    }
+
     vSeparation.zero();
     vAlignment.zero();
     vCohesion.zero();
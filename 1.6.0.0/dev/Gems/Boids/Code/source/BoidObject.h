@@ -251,6 +251,7 @@ public:
     friend class CFlock;
 
     CFlock* m_flock;     //!< Flock of this boid.
+    int m_gridIndex;     //!< Index of this boid in the flock's CBoidGrid, assigned when the grid is built.
     Vec3 m_pos;          //!< Boid position.
     Vec3 m_heading;      //!< Current heading direction.
     Vec3 m_accel;        //!< Desired acceleration vector.
@@ -26,6 +26,10 @@
 #include <CryPath.h>
 #include "Components/IComponentRender.h"
 
+#include <AzCore/Jobs/JobCompletion.h>
+#include <AzCore/Jobs/JobContext.h>
+#include <AzCore/Jobs/JobFunction.h>
+
 #define PHYS_FOREIGN_ID_BOID PHYS_FOREIGN_ID_USER - 1
 
 #define MAX_SPEED 15
@@ -433,6 +437,9 @@ void CFlock::Update(CCamera* pCamera)
 
     UpdateBoidCollisions();
 
+    m_boidGrid.Build(m_boids, m_bc);
+    PrecomputeFlockBehavior();
+
     Vec3 entityPos = m_pEntity->GetWorldPos();
     Matrix34 boidTM;
     int num = 0;
@@ -461,10 +468,41 @@ void CFlock::Update(CCamera* pCamera)
         }
     }
 
+    m_boidGrid.Invalidate();
+
     m_updateFrameID = gEnv->pRenderer->GetFrameID(false);
     // gEnv->pLog->Log( "Birds Update" );
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CFlock::PrecomputeFlockBehavior()
+{
+    // Small flocks query the grid on demand, splitting them into jobs costs more than it saves.
+    const int kMinBoidsForJobs = 512;
+    const int kBoidsPerJob = 256;
+
+    const int numBoids = m_boidGrid.GetBoidCount();
+    if (m_bc.factorAlignment == 0 || numBoids < kMinBoidsForJobs || !AZ::JobContext::GetGlobalContext())
+    {
+        return;
+    }
+
+    FUNCTION_PROFILER(GetISystem(), PROFILE_ENTITY);
+
+    AZ::JobCompletion completion;
+    for (int firstBoid = 0; firstBoid < numBoids; firstBoid += kBoidsPerJob)
+    {
+        const int lastBoid = min(firstBoid + kBoidsPerJob, numBoids);
+        AZ::Job* job = AZ::CreateJobFunction([this, firstBoid, lastBoid]()
+                {
+                    m_boidGrid.PrecomputeFlockBehavior(firstBoid, lastBoid);
+                }, true);
+        job->SetDependent(&completion);
+        job->Start();
+    }
+    completion.StartAndWaitForCompletion();
+}
+
 //////////////////////////////////////////////////////////////////////////
 void CFlock::Render(const SRendParams& EntDrawParams)
 {
@@ -815,6 +853,7 @@ void CFlock::GetMemoryUsage(ICrySizer* pSizer) const
     pSizer->AddObject(m_model);
     pSizer->AddObject(m_boidEntityName);
     pSizer->AddObject(m_boidDefaultAnimName);
+    m_boidGrid.GetMemoryUsage(pSizer);
 }
 
 //////////////////////////////////////////////////////////////////////////
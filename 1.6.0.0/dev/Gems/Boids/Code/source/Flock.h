@@ -16,6 +16,7 @@
 #include <IScriptSystem.h>
 #include <IAISystem.h>
 #include "BoidObject.h"
+#include "BoidGrid.h"
 
 #define MAX_ATTRACT_DISTANCE 20
 #define MIN_ATTRACT_DISTANCE 5
@@ -148,8 +149,12 @@ public:
 
     inline const Vec3& GetAvgBoidPos() const { return m_avgBoidPos; }
 
+    //! Neighbor lookup for the boids, only valid while the flock is updating them.
+    const CBoidGrid& GetBoidGrid() const { return m_boidGrid; }
+
 protected:
     void UpdateAvgBoidPos(float dt);
+    void PrecomputeFlockBehavior();
     virtual void UpdateBoidCollisions();
 
 public:
@@ -227,6 +232,8 @@ protected:
     float m_lastUpdatePosTimePassed;
 
     TTimeBoidMap m_BoidCollisionMap;
+
+    CBoidGrid m_boidGrid;
 };
 
 #endif // CRYINCLUDE_GAMEDLL_BOIDS_FLOCK_H
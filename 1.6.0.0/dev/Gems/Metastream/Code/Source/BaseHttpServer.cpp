@@ -17,109 +17,170 @@
 
 using namespace Metastream;
 
-HttpResponse BaseHttpServer::GetDataTables() const
+namespace
 {
-    std::ostringstream os;
-    os << "{ \"tables\": [";
-    const Database cache = m_cache->GetDatabase();
-    for (auto key = cache.begin(); key != cache.end(); key++)
+    void AppendKeyValue(std::string& body, const std::string& key, const std::string& value)
     {
-        if (key != cache.begin())
-        {
-            os << ",";
-        }
-        os << "\"" << key->first << "\"";
+        body += "\"";
+        body += key;
+        body += "\": ";
+        body += value;
     }
-    os << "] }";
+}
 
+HttpResponse BaseHttpServer::GetDataTables() const
+{
     HttpResponse response;
     response.code = 200;
-    response.body = os.str();
+    response.body = m_cache->GetSnapshot()->tablesJson;
     return response;
 }
 
 HttpResponse BaseHttpServer::GetDataKeys(const std::string& tableName) const
 {
-    std::ostringstream body;
-    int code = 404;
-    const Table table = m_cache->GetTable(tableName);
+    HttpResponse response;
+    response.code = 404;
 
-    if (!table.empty())
+    const DatabaseSnapshotPtr snapshot = m_cache->GetSnapshot();
+    const TableSnapshot* table = snapshot->FindTable(tableName);
+    if (table)
     {
-        body << "{ \"keys\": [";
-        for (auto key = table.begin(); key != table.end(); key++)
-        {
-            if (key != table.begin())
-            {
-                body << ",";
-            }
-            body << "\"" << key->first << "\"";
-        }
-        body << "] }";
-        int code = 200;
+        response.code = 200;
+        response.body = table->keysJson;
     }
-
-    HttpResponse response;
-    response.code = code;
-    response.body = body.str();
     return response;
 }
 
 HttpResponse BaseHttpServer::GetDataValue(const std::string& tableName, const std::string& key) const
 {
-    std::ostringstream body;
-    int code = 404;
-    const Table table = m_cache->GetTable(tableName);
+    HttpResponse response;
+    response.code = 404;
 
-    if (!table.empty())
+    const DatabaseSnapshotPtr snapshot = m_cache->GetSnapshot();
+    const TableSnapshot* table = snapshot->FindTable(tableName);
+    if (table)
     {
-        if (table.find(key) != table.end())
+        auto it = table->entries.find(key);
+        if (it != table->entries.end())
         {
-            std::string value = table.at(key);
-            body << "{\"" << key << "\": " << value << "}";
-            code = 200;
+            response.body.reserve(key.length() + it->second.value.length() + 8);
+            response.body += "{";
+            AppendKeyValue(response.body, key, it->second.value);
+            response.body += "}";
+            response.code = 200;
         }
     }
-
-    HttpResponse response;
-    response.code = code;
-    response.body = body.str();
     return response;
 }
 
 Metastream::HttpResponse Metastream::BaseHttpServer::GetDataValues(const std::string& tableName, const std::vector<std::string>& keys) const
 {
-    std::ostringstream body;
-    int code = 404;
-    const Table table = m_cache->GetTable(tableName);
-    
-    if (!table.empty())
-    {
-        std::ostringstream keyValues;
+    HttpResponse response;
+    response.code = 404;
 
+    const DatabaseSnapshotPtr snapshot = m_cache->GetSnapshot();
+    const TableSnapshot* table = snapshot->FindTable(tableName);
+    if (table)
+    {
+        std::vector<const TableEntries::value_type*> found;
+        found.reserve(keys.size());
+        size_t length = 2;
         for (auto it = keys.begin(); it != keys.end(); it++)
         {
-            const std::string& key = *it;
-            if (table.find(key) != table.end())
+            auto entry = table->entries.find(*it);
+            if (entry != table->entries.end())
             {
-                std::string value = table.at(key);
-                keyValues << "\"" << key << "\": " << value << ",";
-                code = 200;
+                found.push_back(&*entry);
+                length += entry->first.length() + entry->second.value.length() + 5;
             }
         }
 
-        if (code != 404)
+        if (!found.empty())
         {
-            body << "{" << std::string(keyValues.str().c_str(), keyValues.str().length() - 1) << "}";
+            response.body.reserve(length);
+            response.body += "{";
+            for (size_t i = 0; i < found.size(); ++i)
+            {
+                if (i)
+                {
+                    response.body += ",";
+                }
+                AppendKeyValue(response.body, found[i]->first, found[i]->second.value);
+            }
+            response.body += "}";
+            response.code = 200;
         }
     }
+    return response;
+}
 
+HttpResponse BaseHttpServer::GetDataChanges(const std::string& tableName, AZ::u64 sinceVersion) const
+{
     HttpResponse response;
-    response.code = code;
-    response.body = body.str();
+    response.code = 404;
+
+    const DatabaseSnapshotPtr snapshot = m_cache->GetSnapshot();
+    const TableSnapshot* table = snapshot->FindTable(tableName);
+    if (table)
+    {
+        char header[64];
+        azsnprintf(header, sizeof(header), "{ \"version\": %llu, \"reset\": %s, \"values\": {",
+            static_cast<unsigned long long>(snapshot->version), sinceVersion < snapshot->clearVersion ? "true" : "false");
+        response.body = header;
+
+        // Every entry is newer, the whole table is already serialized
+        if (sinceVersion < table->firstVersion)
+        {
+            response.body.reserve(response.body.length() + table->valuesJson.length() + 3);
+            response.body += table->valuesJson;
+        }
+        // Nothing in the table changed, skip walking it
+        else if (table->version > sinceVersion)
+        {
+            bool first = true;
+            for (auto& entry : table->entries)
+            {
+                if (entry.second.version > sinceVersion)
+                {
+                    if (!first)
+                    {
+                        response.body += ",";
+                    }
+                    AppendKeyValue(response.body, entry.first, entry.second.value);
+                    first = false;
+                }
+            }
+        }
+        response.body += "} }";
+        response.code = 200;
+    }
     return response;
 }
 
+HttpResponse BaseHttpServer::HandleQuery(const std::map<std::string, std::string>& query) const
+{
+    auto table = query.find("table");
+    if (table == query.end())
+    {
+        return GetDataTables();
+    }
+
+    auto key = query.find("key");
+    if (key != query.end())
+    {
+        std::vector<std::string> keyList = SplitValueList(key->second, ',');
+        return GetDataValues(table->second, keyList);
+    }
+
+    auto since = query.find("since");
+    if (since != query.end())
+    {
+        return GetDataChanges(table->second, strtoull(since->second.c_str(), nullptr, 10));
+    }
+
+    return GetDataKeys(table->second);
+}
+
 std::map<std::string, std::string> BaseHttpServer::TokenizeQuery(const char* queryString)
 {
     std::map<std::string, std::string> queryMap;
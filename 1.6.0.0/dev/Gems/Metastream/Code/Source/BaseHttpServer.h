@@ -64,6 +64,14 @@ namespace Metastream
         // Return a JSON object containing a set of values.
         HttpResponse GetDataValues(const std::string& tableName, const std::vector<std::string>& keys) const;
 
+        // Return a JSON object with the cache version and every value in a table written after sinceVersion.
+        // "reset" is true when the cache was cleared after sinceVersion, clients should then drop what they hold.
+        // Since 0 returns the whole table from the serialized values of the snapshot.
+        HttpResponse GetDataChanges(const std::string& tableName, AZ::u64 sinceVersion) const;
+
+        // Dispatch a tokenized query (table, key and since) to the matching request above
+        HttpResponse HandleQuery(const std::map<std::string, std::string>& query) const;
+
         //---------------------------------------------------------------------
         // Helper functions
 
@@ -35,30 +35,12 @@ public:
             filters = BaseHttpServer::TokenizeQuery(request->query_string);
         }
                 
-        HttpResponse response;
-
-        auto table = filters.find("table");
-        if (table != filters.end())
-        {
-            auto key = filters.find("key");
-            if (key != filters.end())
-            {
-                std::vector<std::string> keyList = BaseHttpServer::SplitValueList(key->second, ',');
-                response = m_parent->GetDataValues(table->second, keyList);
-            }
-            else
-            {
-                response = m_parent->GetDataKeys(table->second);
-            }
-        }
-        else
-        {
-            response = m_parent->GetDataTables();
-        }
+        HttpResponse response = m_parent->HandleQuery(filters);
 
         mg_printf(conn, BaseHttpServer::HttpStatus(response.code).c_str());
         mg_printf(conn, BaseHttpServer::SerializeHeaders(response.headers).c_str());
-        mg_printf(conn, response.body.c_str());
+        // Bodies can be large and hold '%', write them out as is rather than through the format buffer
+        mg_write(conn, response.body.data(), response.body.size());
         return true;
     }
 
@@ -102,28 +84,8 @@ public:
                     filters = BaseHttpServer::TokenizeQuery(std::string(data, data_len).c_str());
                 }
 
-                HttpResponse response;
-
-                auto table = filters.find("table");
-                if (table != filters.end())
-                {
-                    auto key = filters.find("key");
-                    if (key != filters.end())
-                    {
-                        std::vector<std::string> keyList = BaseHttpServer::SplitValueList(key->second, ',');
-                        response = m_parent->GetDataValues(table->second, keyList);
-                    }
-                    else
-                    {
-                        response = m_parent->GetDataKeys(table->second);
-                    }
-                }
-                else
-                {
-                    response = m_parent->GetDataTables();
-                }
-                std::string payload(response.body);
-                mg_websocket_write(conn, WEBSOCKET_OPCODE_TEXT, payload.c_str(), payload.size() + 1);
+                HttpResponse response = m_parent->HandleQuery(filters);
+                mg_websocket_write(conn, WEBSOCKET_OPCODE_TEXT, response.body.c_str(), response.body.size() + 1);
                 break;
             }
             case WEBSOCKET_OPCODE_BINARY:
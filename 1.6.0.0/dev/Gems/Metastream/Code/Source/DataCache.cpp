@@ -14,43 +14,172 @@
 
 using namespace Metastream;
 
-void DataCache::AddToCache(const std::string& tableName, const std::string& key, const std::string& value)
+namespace
 {
-    AZStd::lock_guard<AZStd::mutex> lock(m_mutexDatabase);
+    void AppendJsonStringList(std::string& json, const char* listName, const std::vector<const std::string*>& names)
+    {
+        size_t length = 16 + strlen(listName);
+        for (const std::string* name : names)
+        {
+            length += name->length() + 3;
+        }
+        json.reserve(length);
+
+        json += "{ \"";
+        json += listName;
+        json += "\": [";
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            if (i)
+            {
+                json += ",";
+            }
+            json += "\"";
+            json += *names[i];
+            json += "\"";
+        }
+        json += "] }";
+    }
 
-    if (m_database.find(tableName) == m_database.end())
+    void AppendJsonValues(std::string& json, const TableEntries& entries)
     {
-        m_database[tableName] = Table();
+        size_t length = 0;
+        for (auto& entry : entries)
+        {
+            length += entry.first.length() + entry.second.value.length() + 5;
+        }
+        json.reserve(length);
+
+        for (auto& entry : entries)
+        {
+            if (!json.empty())
+            {
+                json += ",";
+            }
+            json += "\"";
+            json += entry.first;
+            json += "\": ";
+            json += entry.second.value;
+        }
     }
+}
 
-    m_database[tableName][key] = value;
+const TableSnapshot* DatabaseSnapshot::FindTable(const std::string& tableName) const
+{
+    auto it = tables.find(tableName);
+    return it != tables.end() ? it->second.get() : nullptr;
 }
 
+DataCache::DataCache()
+    : m_clearVersion(0)
+    , m_version(0)
+{
+}
 
-Database DataCache::GetDatabase() const
+void DataCache::AddToCache(const std::string& tableName, const std::string& key, const std::string& value)
 {
     AZStd::lock_guard<AZStd::mutex> lock(m_mutexDatabase);
 
-    return m_database;
+    CachedTable& table = m_database[tableName];
+
+    auto it = table.entries.find(key);
+    if (it == table.entries.end())
+    {
+        it = table.entries.insert(std::make_pair(key, TableEntry())).first;
+    }
+    else if (it->second.value == value)
+    {
+        // Rewriting the same value every frame shouldn't invalidate the snapshot
+        return;
+    }
+
+    it->second.value = value;
+    it->second.version = ++m_version;
+    table.dirty = true;
 }
 
-Table DataCache::GetTable(const std::string& tableName) const
+DatabaseSnapshotPtr DataCache::GetSnapshot() const
 {
-    AZStd::lock_guard<AZStd::mutex> lock(m_mutexDatabase);
+    AZStd::lock_guard<AZStd::mutex> snapshotLock(m_mutexSnapshot);
+
+    if (m_snapshot && m_snapshot->version == m_version.load())
+    {
+        return m_snapshot;
+    }
+
+    std::shared_ptr<DatabaseSnapshot> snapshot = std::make_shared<DatabaseSnapshot>();
+    std::vector<std::shared_ptr<TableSnapshot> > rebuiltTables;
+
+    {
+        // Only the copy of the written tables happens under the lock the game thread writes through
+        AZStd::lock_guard<AZStd::mutex> lock(m_mutexDatabase);
+
+        snapshot->version = m_version.load();
+        snapshot->clearVersion = m_clearVersion;
 
-    auto it = m_database.find(tableName);
+        for (auto& table : m_database)
+        {
+            if (!table.second.dirty && m_snapshot)
+            {
+                auto previous = m_snapshot->tables.find(table.first);
+                if (previous != m_snapshot->tables.end())
+                {
+                    snapshot->tables.insert(*previous);
+                    continue;
+                }
+            }
 
-    if (it != m_database.end())
+            std::shared_ptr<TableSnapshot> tableSnapshot = std::make_shared<TableSnapshot>();
+            tableSnapshot->entries = table.second.entries;
+            table.second.dirty = false;
+
+            snapshot->tables.insert(std::make_pair(table.first, tableSnapshot));
+            rebuiltTables.push_back(tableSnapshot);
+        }
+    }
+
+    std::vector<const std::string*> names;
+    for (const std::shared_ptr<TableSnapshot>& tableSnapshot : rebuiltTables)
+    {
+        names.clear();
+        tableSnapshot->version = 0;
+        tableSnapshot->firstVersion = 0;
+        for (auto& entry : tableSnapshot->entries)
+        {
+            names.push_back(&entry.first);
+            if (entry.second.version > tableSnapshot->version)
+            {
+                tableSnapshot->version = entry.second.version;
+            }
+            if (tableSnapshot->firstVersion == 0 || entry.second.version < tableSnapshot->firstVersion)
+            {
+                tableSnapshot->firstVersion = entry.second.version;
+            }
+        }
+        AppendJsonStringList(tableSnapshot->keysJson, "keys", names);
+        AppendJsonValues(tableSnapshot->valuesJson, tableSnapshot->entries);
+    }
+
+    names.clear();
+    for (auto& table : snapshot->tables)
     {
-        return it->second;
+        names.push_back(&table.first);
     }
+    AppendJsonStringList(snapshot->tablesJson, "tables", names);
 
-    return Table();
+    m_snapshot = snapshot;
+    return m_snapshot;
 }
 
 void DataCache::ClearCache()
 {
     AZStd::lock_guard<AZStd::mutex> lock(m_mutexDatabase);
 
-    m_database.clear();
+    // Clients polling a table should see it empty rather than gone
+    for (auto& table : m_database)
+    {
+        table.second.entries.clear();
+        table.second.dirty = true;
+    }
+    m_clearVersion = ++m_version;
 }
@@ -11,22 +11,76 @@
 */
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 namespace Metastream
 {
-    typedef std::map<std::string, std::string> Table;
-    typedef std::map<std::string, Table> Database;
+    // A cached value and the cache version at which it was last written
+    struct TableEntry
+    {
+        std::string value;
+        AZ::u64 version;
+    };
+    typedef std::map<std::string, TableEntry> TableEntries;
+
+    // Immutable copy of one table.  The key list and all values are serialized once when the snapshot is built, so
+    // polling them costs nothing until the table is written again.
+    struct TableSnapshot
+    {
+        AZ::u64         version;
+        // Oldest write among the entries, a diff since anything before it is the whole table
+        AZ::u64         firstVersion;
+        TableEntries    entries;
+        std::string     keysJson;
+        // Comma separated "key": value pairs of every entry, without the enclosing braces
+        std::string     valuesJson;
+    };
+    typedef std::shared_ptr<const TableSnapshot> TableSnapshotPtr;
+
+    // Immutable copy of the whole cache.  Tables which have not been written since the previous snapshot are shared
+    // with it rather than copied.
+    struct DatabaseSnapshot
+    {
+        AZ::u64                                 version;
+        // Version of the last ClearCache, changes from before it can't be expressed as a diff
+        AZ::u64                                 clearVersion;
+        std::map<std::string, TableSnapshotPtr> tables;
+        std::string                             tablesJson;
+
+        const TableSnapshot* FindTable(const std::string& tableName) const;
+    };
+    typedef std::shared_ptr<const DatabaseSnapshot> DatabaseSnapshotPtr;
 
     class DataCache
     {
     public:
+        DataCache();
+
         void AddToCache(const std::string& tableName, const std::string& key, const std::string& value);
-        Database GetDatabase() const;
-        Table GetTable(const std::string& tableName) const;
+        // Empties every table, the tables themselves stay listed
         void ClearCache();
 
+        // Returns the current state of the cache.  Writes only mark their table dirty, the first read after a write
+        // copies the dirty tables and publishes a new snapshot, so the writing thread never pays for the copy.
+        DatabaseSnapshotPtr GetSnapshot() const;
+
     private:
-        mutable AZStd::mutex    m_mutexDatabase;
-        Database                m_database;
+        struct CachedTable
+        {
+            TableEntries    entries;
+            // Written since the last snapshot, cleared by GetSnapshot
+            mutable bool    dirty = true;
+        };
+
+        mutable AZStd::mutex                m_mutexDatabase;
+        std::map<std::string, CachedTable>  m_database;
+        AZ::u64                             m_clearVersion;
+        std::atomic<AZ::u64>                m_version;
+
+        // Serializes snapshot rebuilds, held only to read m_snapshot when it is up to date
+        mutable AZStd::mutex                m_mutexSnapshot;
+        mutable DatabaseSnapshotPtr         m_snapshot;
     };
 
-} // namespace Metastream
\ No newline at end of file
+} // namespace Metastream
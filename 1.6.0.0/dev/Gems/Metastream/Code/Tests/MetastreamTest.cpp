@@ -13,6 +13,9 @@
 
 #include <gtest/gtest.h>
 
+#include "DataCache.h"
+#include "BaseHttpServer.h"
+
 class MetastreamTest : public ::testing::Test
 {
 protected:
@@ -27,7 +30,56 @@ protected:
     }
 };
 
+// Serves queries straight from the cache, without a network layer
+class QueryOnlyHttpServer
+    : public Metastream::BaseHttpServer
+{
+public:
+    QueryOnlyHttpServer(const Metastream::DataCache* cache)
+        : BaseHttpServer(cache)
+    {
+    }
+
+    bool Start(int port, const std::string& path) override { return false; }
+    void Stop() override {}
+};
+
 TEST_F(MetastreamTest, ExampleTest)
 {
     ASSERT_TRUE(true);
-}
\ No newline at end of file
+}
+
+TEST_F(MetastreamTest, ChangesSinceZeroReturnWholeTable)
+{
+    Metastream::DataCache cache;
+    cache.AddToCache("table", "a", "1");
+    cache.AddToCache("table", "b", "\"two\"");
+
+    QueryOnlyHttpServer server(&cache);
+    Metastream::HttpResponse response = server.GetDataChanges("table", 0);
+    ASSERT_EQ(200, response.code);
+    ASSERT_EQ("{ \"version\": 2, \"reset\": false, \"values\": {\"a\": 1,\"b\": \"two\"} }", response.body);
+
+    response = server.GetDataChanges("table", 1);
+    ASSERT_EQ("{ \"version\": 2, \"reset\": false, \"values\": {\"b\": \"two\"} }", response.body);
+}
+
+TEST_F(MetastreamTest, ClearedTableIsEmptyNotMissing)
+{
+    Metastream::DataCache cache;
+    cache.AddToCache("table", "a", "1");
+    cache.ClearCache();
+
+    const Metastream::DatabaseSnapshotPtr snapshot = cache.GetSnapshot();
+    const Metastream::TableSnapshot* table = snapshot->FindTable("table");
+    ASSERT_TRUE(table != nullptr);
+    ASSERT_TRUE(table->entries.empty());
+    ASSERT_EQ("{ \"keys\": [] }", table->keysJson);
+
+    QueryOnlyHttpServer server(&cache);
+    ASSERT_EQ(200, server.GetDataKeys("table").code);
+
+    const Metastream::HttpResponse response = server.GetDataChanges("table", 1);
+    ASSERT_EQ(200, response.code);
+    ASSERT_EQ("{ \"version\": 2, \"reset\": true, \"values\": {} }", response.body);
+}
@@ -12,157 +12,460 @@
 #include "StdAfx.h"
 #include <CSVStaticData.h>
 
-#include <AzCore/std/smart_ptr/make_shared.h>
-
-#include <sstream>
+#include <cctype>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 
 namespace CloudCanvas
 {
     namespace StaticData
     {
+        namespace
+        {
+            AZ::u32 HashText(const char* text, size_t length)
+            {
+                // FNV-1a
+                AZ::u32 hash = 2166136261u;
+                for (size_t i = 0; i < length; ++i)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(text[i])) * 16777619u;
+                }
+                return hash;
+            }
+
+            const char* SkipSpace(const char* text)
+            {
+                while (*text && isspace(static_cast<unsigned char>(*text)))
+                {
+                    ++text;
+                }
+                return text;
+            }
+
+            // Reads an int the way std::istream >> int did: leading whitespace and an optional sign, then as many
+            // digits as follow.  No digits gives 0 and out of range values clamp.  Returns the end of the digits read.
+            const char* ParseIntPrefix(const char* text, int& value, bool& overflow)
+            {
+                const char* readPos = SkipSpace(text);
+                bool negative = false;
+                if (*readPos == '+' || *readPos == '-')
+                {
+                    negative = *readPos == '-';
+                    ++readPos;
+                }
+
+                const char* digitStart = readPos;
+                AZ::s64 accumulated = 0;
+                overflow = false;
+                while (*readPos >= '0' && *readPos <= '9')
+                {
+                    if (!overflow)
+                    {
+                        accumulated = accumulated * 10 + (*readPos - '0');
+                        overflow = accumulated > static_cast<AZ::s64>(INT_MAX) + 1;
+                    }
+                    ++readPos;
+                }
+
+                if (readPos == digitStart)
+                {
+                    value = 0;
+                    return text;
+                }
+
+                if (negative)
+                {
+                    accumulated = -accumulated;
+                }
+                if (overflow || accumulated > INT_MAX || accumulated < INT_MIN)
+                {
+                    overflow = true;
+                    value = negative ? INT_MIN : INT_MAX;
+                }
+                else
+                {
+                    value = static_cast<int>(accumulated);
+                }
+                return readPos;
+            }
+
+            int ParseInt(const char* text)
+            {
+                int value;
+                bool overflow;
+                ParseIntPrefix(text, value, overflow);
+                return value;
+            }
+
+            // True if the whole text is a plain decimal number: optional sign, digits with an optional fraction and an
+            // optional exponent.  strtod reads such text exactly as std::istream >> double did.
+            bool IsDecimal(const char* text)
+            {
+                const char* readPos = SkipSpace(text);
+                if (*readPos == '+' || *readPos == '-')
+                {
+                    ++readPos;
+                }
+
+                size_t mantissaDigits = 0;
+                while (*readPos >= '0' && *readPos <= '9')
+                {
+                    ++readPos;
+                    ++mantissaDigits;
+                }
+                if (*readPos == '.')
+                {
+                    ++readPos;
+                    while (*readPos >= '0' && *readPos <= '9')
+                    {
+                        ++readPos;
+                        ++mantissaDigits;
+                    }
+                }
+                if (!mantissaDigits)
+                {
+                    return false;
+                }
+
+                if (*readPos == 'e' || *readPos == 'E')
+                {
+                    ++readPos;
+                    if (*readPos == '+' || *readPos == '-')
+                    {
+                        ++readPos;
+                    }
+                    if (!(*readPos >= '0' && *readPos <= '9'))
+                    {
+                        return false;
+                    }
+                    while (*readPos >= '0' && *readPos <= '9')
+                    {
+                        ++readPos;
+                    }
+                }
+                return *readPos == 0;
+            }
+
+            double ParseDouble(const char* text)
+            {
+                const char* readPos = SkipSpace(text);
+                // Only hand strtod text which starts like a decimal number so "inf", "nan" and hex floats stay 0
+                // as they did when read through a stream
+                const char* digitPos = (*readPos == '+' || *readPos == '-') ? readPos + 1 : readPos;
+                if (*digitPos == '.')
+                {
+                    ++digitPos;
+                }
+                if (!(*digitPos >= '0' && *digitPos <= '9'))
+                {
+                    return 0.0;
+                }
+                // strtod gives infinity for out of range values where the stream clamped to the largest double
+                double value = strtod(readPos, nullptr);
+                if (value == HUGE_VAL || value == -HUGE_VAL)
+                {
+                    value = value > 0.0 ? DBL_MAX : -DBL_MAX;
+                }
+                return value;
+            }
+        }
 
         CSVStaticData::CSVStaticData()
+            : m_rowCount(0)
         {
 
         }
 
-        bool CSVStaticData::LoadData(const char* initBuffer)
+        char CSVStaticData::ReadCell(char*& cursor, char* end, CellSpan& cell)
         {
-            m_dataVec.clear();
-            m_attributes.clear();
+            char* cellStart = cursor;
+            char* writePos = cursor;
+            char* readPos = cursor;
+
+            if (readPos < end && *readPos == '"')
+            {
+                // Quoted cell, may hold delimiters and newlines.  Doubled quotes collapse to one in place, the text
+                // only ever shrinks so it never overtakes the read position
+                ++readPos;
+                while (readPos < end)
+                {
+                    if (*readPos == '"')
+                    {
+                        if (readPos + 1 < end && readPos[1] == '"')
+                        {
+                            *writePos++ = '"';
+                            readPos += 2;
+                            continue;
+                        }
+                        ++readPos;
+                        break;
+                    }
+                    *writePos++ = *readPos++;
+                }
+            }
 
-            std::stringstream readStream(initBuffer);
-   
-            // The first row should be all of our attribute names
-            std::string attributeStr;
-            std::getline(readStream, attributeStr);
+            // Unquoted text, or anything trailing a closing quote, is taken as is up to the delimiter
+            while (readPos < end && *readPos != ',' && *readPos != '\n')
+            {
+                *writePos++ = *readPos++;
+            }
 
-            // Strip off the trailing \r if it is present
-            if (attributeStr.length() && attributeStr[attributeStr.length() - 1] == '\r')
+            char delimiter = readPos < end ? *readPos : '\0';
+            if (delimiter != ',' && writePos > cellStart && writePos[-1] == '\r')
             {
-                attributeStr.erase(attributeStr.length() - 1);
+                --writePos;
             }
 
-            std::stringstream attributeStream(attributeStr);
-            AttributeValueType thisAttribute;
-            do 
+            // Terminate the cell in place, writePos never passes the delimiter which has already been read
+            *writePos = '\0';
+
+            cell.m_offset = static_cast<AZ::u32>(cellStart - m_buffer.data());
+            cell.m_length = static_cast<AZ::u32>(writePos - cellStart);
+            cursor = readPos < end ? readPos + 1 : end;
+            return delimiter;
+        }
+
+        bool CSVStaticData::LoadData(const char* initBuffer)
+        {
+            m_columns.clear();
+            m_keyIndex.clear();
+            m_keyHashes.clear();
+            m_rowCount = 0;
+
+            m_buffer = initBuffer ? initBuffer : "";
+            char* cursor = m_buffer.data();
+            char* end = cursor + m_buffer.size();
+
+            // The first row should be all of our attribute names, we'll just assume that our first column is our key
+            // column
+            char delimiter;
+            do
             {
-                thisAttribute = ParseFromStream(attributeStream);
-                // We'll just assume that our first column is our key column
-                if (!m_attributes.size())
-                {
-                    m_keyName = thisAttribute.c_str();
-                }
-                m_attributes.push_back(thisAttribute.c_str());
-            } while (thisAttribute.length());
+                CellSpan nameCell;
+                delimiter = ReadCell(cursor, end, nameCell);
+
+                m_columns.emplace_back();
+                Column& newColumn = m_columns.back();
+                newColumn.m_name.assign(GetCellText(nameCell), nameCell.m_length);
+                newColumn.m_nameHash = HashText(GetCellText(nameCell), nameCell.m_length);
+                newColumn.m_type = ColumnType::String;
+            } while (delimiter == ',');
 
             // Attributes set, now real reading
-            while (std::getline(readStream, attributeStr))
+            while (cursor < end)
             {
-                if (attributeStr.length() && attributeStr[attributeStr.length() - 1] == '\r')
+                CellSpan thisCell;
+                delimiter = ReadCell(cursor, end, thisCell);
+
+                // Skip blank lines rather than adding an entry with an empty key
+                if (delimiter != ',' && !thisCell.m_length)
                 {
-                    attributeStr.erase(attributeStr.length() - 1);
+                    continue;
                 }
 
-                std::stringstream entryStream(attributeStr);
-
-                AttributeMapPtr newMap = AZStd::make_shared<AttributeMap>();
-
                 size_t thisAttrSlot = 0;
-                do
+                for (;;)
                 {
-                    thisAttribute = ParseFromStream(entryStream);
-
-                    if (thisAttrSlot < m_attributes.size())
+                    if (thisAttrSlot < m_columns.size())
                     {
-                        newMap->insert({ m_attributes[thisAttrSlot], thisAttribute.c_str() });
+                        // Short rows leave the columns they skipped missing
+                        AZStd::vector<CellSpan>& cells = m_columns[thisAttrSlot].m_cells;
+                        cells.resize(m_rowCount, CellSpan{ s_missingCell, 0 });
+                        cells.push_back(thisCell);
                     }
                     ++thisAttrSlot;
-                } while (thisAttribute.length());
 
-                m_dataVec.push_back(newMap);
+                    if (delimiter != ',')
+                    {
+                        break;
+                    }
+                    delimiter = ReadCell(cursor, end, thisCell);
+                }
+                ++m_rowCount;
             }
+
+            for (Column& thisColumn : m_columns)
+            {
+                thisColumn.m_cells.resize(m_rowCount, CellSpan{ s_missingCell, 0 });
+                BuildColumnValues(thisColumn);
+            }
+
+            BuildKeyIndex();
             return true;
         }
 
-        AttributeValueType CSVStaticData::ParseFromStream(std::stringstream& inStream)
+        void CSVStaticData::BuildColumnValues(Column& column)
         {
-            std::string returnString;
-            size_t quoteCount = 0;
-            bool trimQuotes = false;
-
-            for (std::string readString; std::getline(inStream, readString, ','); returnString += ',')
+            // Pick the narrowest type every cell in the column parses as in full, empty and missing cells fit any type
+            bool allInt = true;
+            bool allDecimal = true;
+            for (const CellSpan& thisCell : column.m_cells)
             {
-                returnString += readString;
-                quoteCount += std::count(readString.begin(), readString.end(), '"');
-
-                // If there are any quotes there will be a leading/trailing quote pair that we want to trim
-                if (quoteCount)
+                if (thisCell.m_offset == s_missingCell || !thisCell.m_length)
                 {
-                    trimQuotes = true;
+                    continue;
                 }
 
-                //In this case we've read through everything (There are no more embedded commas)
-                if ((quoteCount % 2)==0)
+                const char* cellText = GetCellText(thisCell);
+                if (allInt)
+                {
+                    int value;
+                    bool overflow;
+                    const char* parseEnd = ParseIntPrefix(cellText, value, overflow);
+                    allInt = parseEnd != cellText && !*parseEnd && !overflow;
+                }
+                if (!allInt && !IsDecimal(cellText))
                 {
+                    allDecimal = false;
                     break;
                 }
             }
 
-            if (trimQuotes)
+            column.m_type = allInt ? ColumnType::Int : (allDecimal ? ColumnType::Double : ColumnType::String);
+            if (column.m_type == ColumnType::String)
             {
-                returnString.erase(0, 1);
-                returnString.erase(returnString.length() - 1, 1);
+                return;
             }
 
-            // Now find if we've got any double quotes that need to be turned back into single quotes
-            const std::string doubleQuotes = "\"\"";
-            std::string::size_type findPos = 0;
-            while ((findPos = returnString.find(doubleQuotes, findPos)) != std::string::npos)
+            column.m_intValues.reserve(column.m_cells.size());
+            if (column.m_type == ColumnType::Double)
             {
-                returnString.erase(findPos, 1);
-                findPos += doubleQuotes.length() - 1;
+                column.m_doubleValues.reserve(column.m_cells.size());
+            }
+
+            for (const CellSpan& thisCell : column.m_cells)
+            {
+                const char* cellText = thisCell.m_offset == s_missingCell ? "" : GetCellText(thisCell);
+                column.m_intValues.push_back(ParseInt(cellText));
+                if (column.m_type == ColumnType::Double)
+                {
+                    column.m_doubleValues.push_back(ParseDouble(cellText));
+                }
             }
-            return returnString.c_str();
         }
-        AttributeMapPtr CSVStaticData::GetAttributeMap(const char* keyName) const
+
+        void CSVStaticData::BuildKeyIndex()
         {
-            for (auto thisMap : m_dataVec)
+            if (m_columns.empty() || !m_rowCount)
+            {
+                return;
+            }
+
+            size_t slotCount = 16;
+            while (slotCount < m_rowCount * 2)
             {
-                auto thisElement = thisMap->find(m_keyName);
-                if (thisElement != thisMap->end())
+                slotCount <<= 1;
+            }
+            m_keyIndex.resize(slotCount, 0);
+            m_keyHashes.resize(m_rowCount);
+
+            const size_t slotMask = slotCount - 1;
+            const Column& keyColumn = m_columns[0];
+            for (AZ::u32 rowIndex = 0; rowIndex < m_rowCount; ++rowIndex)
+            {
+                const CellSpan& keyCell = keyColumn.m_cells[rowIndex];
+                const char* keyText = GetCellText(keyCell);
+                AZ::u32 keyHash = HashText(keyText, keyCell.m_length);
+                m_keyHashes[rowIndex] = keyHash;
+
+                for (size_t slot = keyHash & slotMask;; slot = (slot + 1) & slotMask)
                 {
-                    if (thisElement->second == keyName)
+                    AZ::u32 existing = m_keyIndex[slot];
+                    if (!existing)
+                    {
+                        m_keyIndex[slot] = rowIndex + 1;
+                        break;
+                    }
+
+                    // Lookups used to return the first matching row, so later duplicates stay unindexed
+                    const CellSpan& existingCell = keyColumn.m_cells[existing - 1];
+                    if (m_keyHashes[existing - 1] == keyHash && existingCell.m_length == keyCell.m_length &&
+                        !memcmp(GetCellText(existingCell), keyText, keyCell.m_length))
                     {
-                        return thisMap;
+                        break;
                     }
                 }
             }
-            return AttributeMapPtr{};
         }
 
-        // Find the attribute value for the given key and attribute combination
-        AttributeReturnType CSVStaticData::GetAttributeValue(const char* keyName, const char* attributeName) const
+        AZ::u32 CSVStaticData::FindRow(const char* keyName) const
         {
-            AttributeMapPtr mapPtr = GetAttributeMap(keyName);
-            if (mapPtr)
+            if (m_keyIndex.empty() || !keyName)
             {
-                auto thisField = mapPtr->find(attributeName);
-                if (thisField != mapPtr->end())
+                return s_missingCell;
+            }
+
+            size_t keyLength = strlen(keyName);
+            AZ::u32 keyHash = HashText(keyName, keyLength);
+
+            const size_t slotMask = m_keyIndex.size() - 1;
+            const Column& keyColumn = m_columns[0];
+            for (size_t slot = keyHash & slotMask;; slot = (slot + 1) & slotMask)
+            {
+                AZ::u32 entry = m_keyIndex[slot];
+                if (!entry)
                 {
-                    return AZStd::make_pair(true, thisField->second);
+                    return s_missingCell;
+                }
+
+                AZ::u32 rowIndex = entry - 1;
+                const CellSpan& keyCell = keyColumn.m_cells[rowIndex];
+                if (m_keyHashes[rowIndex] == keyHash && keyCell.m_length == keyLength &&
+                    !memcmp(GetCellText(keyCell), keyName, keyLength))
+                {
+                    return rowIndex;
                 }
             }
-            return AZStd::make_pair(false, "");
+        }
+
+        const CSVStaticData::Column* CSVStaticData::FindColumn(const char* fieldName) const
+        {
+            if (!fieldName)
+            {
+                return nullptr;
+            }
+
+            size_t fieldLength = strlen(fieldName);
+            AZ::u32 fieldHash = HashText(fieldName, fieldLength);
+            for (const Column& thisColumn : m_columns)
+            {
+                if (thisColumn.m_nameHash == fieldHash && thisColumn.m_name.length() == fieldLength &&
+                    !memcmp(thisColumn.m_name.data(), fieldName, fieldLength))
+                {
+                    return &thisColumn;
+                }
+            }
+            return nullptr;
+        }
+
+        // Find the cell for the given key and attribute combination
+        const CSVStaticData::Column* CSVStaticData::FindCell(const char* keyName, const char* attributeName, AZ::u32& rowIndex) const
+        {
+            const Column* thisColumn = FindColumn(attributeName);
+            if (!thisColumn)
+            {
+                return nullptr;
+            }
+
+            rowIndex = FindRow(keyName);
+            if (rowIndex == s_missingCell || thisColumn->m_cells[rowIndex].m_offset == s_missingCell)
+            {
+                return nullptr;
+            }
+            return thisColumn;
         }
 
         bool CSVStaticData::GetIntValue(const char* structName, const char* fieldName, int& returnValue) const
         {
-            AttributeReturnType searchValue = GetAttributeValue(structName, fieldName);
-            if (searchValue.first)
+            AZ::u32 rowIndex;
+            const Column* thisColumn = FindCell(structName, fieldName, rowIndex);
+            if (thisColumn)
             {
-                std::stringstream numStream(searchValue.second.c_str());
-                numStream >> returnValue;
+                returnValue = thisColumn->m_type == ColumnType::String ?
+                    ParseInt(GetCellText(thisColumn->m_cells[rowIndex])) : thisColumn->m_intValues[rowIndex];
                 return true;
             }
             return false;
@@ -170,11 +473,22 @@ namespace CloudCanvas
 
         bool CSVStaticData::GetDoubleValue(const char* structName, const char* fieldName, double& returnValue) const
         {
-            AttributeReturnType searchValue = GetAttributeValue(structName, fieldName);
-            if (searchValue.first)
+            AZ::u32 rowIndex;
+            const Column* thisColumn = FindCell(structName, fieldName, rowIndex);
+            if (thisColumn)
             {
-                std::stringstream numStream(searchValue.second.c_str());
-                numStream >> returnValue;
+                switch (thisColumn->m_type)
+                {
+                case ColumnType::Int:
+                    returnValue = static_cast<double>(thisColumn->m_intValues[rowIndex]);
+                    break;
+                case ColumnType::Double:
+                    returnValue = thisColumn->m_doubleValues[rowIndex];
+                    break;
+                default:
+                    returnValue = ParseDouble(GetCellText(thisColumn->m_cells[rowIndex]));
+                    break;
+                }
                 return true;
             }
             return false;
@@ -182,13 +496,15 @@ namespace CloudCanvas
 
         bool CSVStaticData::GetStrValue(const char* structName, const char* fieldName, StringReturnType& returnStr) const
         {
-            AttributeReturnType searchValue = GetAttributeValue(structName, fieldName);
-            if (searchValue.first)
+            AZ::u32 rowIndex;
+            const Column* thisColumn = FindCell(structName, fieldName, rowIndex);
+            if (thisColumn)
             {
-                returnStr = searchValue.second;
+                const CellSpan& thisCell = thisColumn->m_cells[rowIndex];
+                returnStr.assign(GetCellText(thisCell), thisCell.m_length);
                 return true;
             }
             return false;
         }
     }
-}
\ No newline at end of file
+}
@@ -13,21 +13,17 @@
 #include <StaticDataInterface.h>
 #include <AzCore/std/string/string.h>
 #include <AzCore/std/containers/vector.h>
-#include <AzCore/std/containers/unordered_map.h>
-#include <AzCore/std/smart_ptr/shared_ptr.h>
 
 namespace CloudCanvas
 {
     namespace StaticData
     {
         using AttributeKeyType = AZStd::string;
-        using AttributeValueType = AZStd::string;
-        using AttributeMap = AZStd::unordered_map<AttributeKeyType, AttributeValueType>;
-        using AttributeMapPtr = AZStd::shared_ptr<AttributeMap>;
-        using DataVec = AZStd::vector<AttributeMapPtr>;
-        using AttributeReturnType = AZStd::pair<bool, AttributeValueType>;
-        using AttributeVec = AZStd::vector<AttributeValueType>;
 
+        // A CSV table is loaded once and is immutable afterwards, so lookups need no locking.  The file buffer is kept
+        // and tokenized in place, cells reference it by offset rather than being copied into strings.  The first column
+        // is the key column and is hashed for lookup, every other column is typed at load time so numeric fields are
+        // converted exactly once.
         class CSVStaticData : public StaticDataInterface
         {
         public:
@@ -37,22 +33,65 @@ namespace CloudCanvas
             virtual bool GetStrValue(const char* structName, const char* fieldName, StringReturnType& returnStr) const override;
             virtual bool GetDoubleValue(const char* structName, const char* fieldName, double& returnValue) const override;
 
-            static AttributeValueType ParseFromStream(std::stringstream& inStream);
+            size_t GetRowCount() const { return m_rowCount; }
+            size_t GetColumnCount() const { return m_columns.size(); }
+
         protected:
             bool LoadData(const char* initBuffer) override;
         private:
-            // Helpers to get attribute value data
+            static const AZ::u32 s_missingCell = 0xffffffff;
+
+            // Location of a cell's text within m_buffer, the text is null terminated in place
+            struct CellSpan
+            {
+                AZ::u32 m_offset;
+                AZ::u32 m_length;
+            };
+
+            enum class ColumnType
+            {
+                Int,
+                Double,
+                String,
+            };
+
+            struct Column
+            {
+                AttributeKeyType m_name;
+                AZ::u32 m_nameHash;
+                ColumnType m_type;
+                AZStd::vector<CellSpan> m_cells;
+                // Filled for Int and Double columns.  Double columns keep both since reading an int from "2.5e3"
+                // gives 2, not the truncated double
+                AZStd::vector<int> m_intValues;
+                // Filled for Double columns only, Int columns widen m_intValues
+                AZStd::vector<double> m_doubleValues;
+            };
+
+            // Tokenize one cell starting at cursor, returns the delimiter which ended it (',', '\n' or '\0')
+            char ReadCell(char*& cursor, char* end, CellSpan& cell);
+
+            void BuildColumnValues(Column& column);
+            void BuildKeyIndex();
+
+            // Row index for the given key, or s_missingCell
+            AZ::u32 FindRow(const char* keyName) const;
+            const Column* FindColumn(const char* fieldName) const;
+
+            // Finds the cell for the key and attribute combination, returns null if either is unknown or the row has
+            // no such cell
+            const Column* FindCell(const char* keyName, const char* attributeName, AZ::u32& rowIndex) const;
 
-            // Find the attribute map for the given key
-            AttributeMapPtr GetAttributeMap(const char* keyName) const;
+            const char* GetCellText(const CellSpan& cell) const { return m_buffer.data() + cell.m_offset; }
 
-            // Find the attribute value for the given key and attribute combination
-            AttributeReturnType GetAttributeValue(const char* keyName, const char* attributeName) const;
+            AZStd::string m_buffer;
+            AZStd::vector<Column> m_columns;
+            size_t m_rowCount;
 
-            AttributeKeyType m_keyName;
-            AttributeVec m_attributes;
-            DataVec m_dataVec;
+            // Open addressed hash of the key column, each slot holds row index + 1, zero is empty
+            AZStd::vector<AZ::u32> m_keyIndex;
+            AZStd::vector<AZ::u32> m_keyHashes;
         };
 
     }
-}
\ No newline at end of file
+}
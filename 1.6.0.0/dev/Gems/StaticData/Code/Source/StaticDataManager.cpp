@@ -54,13 +54,25 @@ namespace CloudCanvas
                 m_monitor->RemoveAll();
             }
 
+            // Build every table before publishing any of them so readers see either the old set or the new one,
+            // never a partially loaded map
+            AZStd::lock_guard<AZStd::mutex> updateLock(m_updateMutex);
+
+            StaticDataMapType newData;
+            LoadDirectoryDataType(csvDir, CSV_TAG, StaticDataType::CSV, newData);
+
+            StaticDataTypeList reloadedTypes;
+            for (auto& thisType : newData)
             {
-                AZStd::lock_guard<AZStd::mutex> thisLock(GetDataMutex());
-                m_data.clear();
+                reloadedTypes.push_back(thisType.first);
             }
 
-            LoadDirectoryDataType(csvDir, CSV_TAG, StaticDataType::CSV);
- 
+            PublishData(AZStd::make_shared<const StaticDataMapType>(AZStd::move(newData)));
+
+            for (auto& thisType : reloadedTypes)
+            {
+                EBUS_EVENT(DataUpdateBus, TypeReloaded, thisType);
+            }
             return true;
         }
 
@@ -123,12 +135,29 @@ namespace CloudCanvas
             return true;
         }
 
-        StaticDataInterfacePtr StaticDataManager::GetDataType(const char* tagName) const
+        StaticDataManager::StaticDataMapPtr StaticDataManager::GetDataSnapshot() const
         {
+            // The lock only covers copying the pointer, lookups run against the snapshot without it
             AZStd::lock_guard<AZStd::mutex> thisLock(GetDataMutex());
+            return m_data;
+        }
+
+        void StaticDataManager::PublishData(StaticDataMapPtr newData)
+        {
+            AZStd::lock_guard<AZStd::mutex> thisLock(GetDataMutex());
+            m_data.swap(newData);
+        }
+
+        StaticDataInterfacePtr StaticDataManager::GetDataType(const char* tagName) const
+        {
+            StaticDataMapPtr dataSnapshot = GetDataSnapshot();
+            if (!dataSnapshot)
+            {
+                return StaticDataInterfacePtr{};
+            }
 
-            auto dataIter = m_data.find(tagName);
-            if (dataIter != m_data.end())
+            auto dataIter = dataSnapshot->find(tagName);
+            if (dataIter != dataSnapshot->end())
             {
                 return dataIter->second;
             }
@@ -137,13 +166,15 @@ namespace CloudCanvas
 
         StaticDataTypeList StaticDataManager::GetDataTypeList() const
         {
-            AZStd::lock_guard<AZStd::mutex> thisLock(GetDataMutex());
-
             StaticDataTypeList returnList;
 
-            for (auto thisType : m_data)
+            StaticDataMapPtr dataSnapshot = GetDataSnapshot();
+            if (dataSnapshot)
             {
-                returnList.push_back(thisType.first);
+                for (auto& thisType : *dataSnapshot)
+                {
+                    returnList.push_back(thisType.first);
+                }
             }
             return returnList;
         }
@@ -193,7 +224,7 @@ namespace CloudCanvas
             return false;
         }
 
-        StaticDataManager::StaticDataInterfacePtrInternal StaticDataManager::CreateInterface(StaticDataType dataType, const char* initData, const char* tagName)
+        StaticDataManager::StaticDataInterfacePtrInternal StaticDataManager::CreateInterface(StaticDataType dataType, const char* initData)
         {
             switch (dataType)
             {
@@ -201,7 +232,6 @@ namespace CloudCanvas
             {
                 StaticDataInterfacePtrInternal thisInterface = AZStd::make_shared<CSVStaticData>();
                 thisInterface->LoadData(initData);
-                SetInterface(tagName, thisInterface);
                 return thisInterface;
             }
             break;
@@ -212,8 +242,16 @@ namespace CloudCanvas
         void StaticDataManager::SetInterface(const char* tagName, StaticDataInterfacePtrInternal someInterface)
         {
             {
-                AZStd::lock_guard<AZStd::mutex> thisLock(GetDataMutex());
-                m_data[tagName] = someInterface;
+                // The new table is fully built by now, swapping in a copy of the map with it replaced means readers
+                // holding the previous snapshot finish their lookups against the old table undisturbed
+                AZStd::lock_guard<AZStd::mutex> updateLock(m_updateMutex);
+
+                StaticDataMapPtr dataSnapshot = GetDataSnapshot();
+                AZStd::shared_ptr<StaticDataMapType> newData = dataSnapshot ?
+                    AZStd::make_shared<StaticDataMapType>(*dataSnapshot) : AZStd::make_shared<StaticDataMapType>();
+                (*newData)[tagName] = someInterface;
+
+                PublishData(newData);
             }
             EBUS_EVENT(DataUpdateBus, TypeReloaded, AZStd::string{ tagName });
         }
@@ -250,39 +288,54 @@ namespace CloudCanvas
 
         void StaticDataManager::LoadRelativeFile(const char* relativeFile)
         {
-            AZStd::string sanitizedString = ResolveAndSanitize(relativeFile);
             // Currently our file names act as our data types, but are stripped of their extensions
+            StaticDataTagType tagStr;
+            StaticDataInterfacePtrInternal newInterface;
+            if (LoadFileInterface(relativeFile, tagStr, newInterface))
+            {
+                if (newInterface)
+                {
+                    SetInterface(tagStr.c_str(), newInterface);
+                }
+            }
+            else
+            {
+                RemoveInterface(tagStr.c_str());
+            }
+        }
+
+        bool StaticDataManager::LoadFileInterface(const char* relativeFile, StaticDataTagType& tagStr, StaticDataInterfacePtrInternal& newInterface)
+        {
+            AZStd::string sanitizedString = ResolveAndSanitize(relativeFile);
 
-            AZStd::string tagStr(GetTagFromFile(sanitizedString.c_str()));
+            tagStr = GetTagFromFile(sanitizedString.c_str());
 
             AZ::IO::HandleType readHandle = gEnv->pCryPak->FOpen(sanitizedString.c_str(), "rt");
+            if (readHandle == AZ::IO::InvalidHandle)
+            {
+                return false;
+            }
 
-            if (readHandle != AZ::IO::InvalidHandle)
+            size_t fileSize = gEnv->pCryPak->FGetSize(readHandle);
+            if (fileSize > 0)
             {
-                size_t fileSize = gEnv->pCryPak->FGetSize(readHandle);
-                if (fileSize > 0)
+                if (sanitizedString.length() && m_monitor)
                 {
-                    if (sanitizedString.length() && m_monitor)
-                    {
-                        m_monitor->AddPath(sanitizedString, true);
-                    }
+                    m_monitor->AddPath(sanitizedString, true);
+                }
 
-                    AZStd::string fileBuf;
-                    fileBuf.resize(fileSize);
+                AZStd::string fileBuf;
+                fileBuf.resize(fileSize);
 
-                    size_t read = gEnv->pCryPak->FRead(fileBuf.data(), fileSize, readHandle);
+                size_t read = gEnv->pCryPak->FRead(fileBuf.data(), fileSize, readHandle);
 
-                    CreateInterface(GetTypeFromFile(relativeFile), fileBuf.data(), tagStr.c_str());
-                }
-                gEnv->pCryPak->FClose(readHandle);
-            }
-            else
-            {
-                RemoveInterface(tagStr.c_str());
+                newInterface = CreateInterface(GetTypeFromFile(relativeFile), fileBuf.data());
             }
+            gEnv->pCryPak->FClose(readHandle);
+            return true;
         }
 
-        void StaticDataManager::LoadDirectoryDataType(const char* dirName, const char* extensionType, StaticDataType dataType)
+        void StaticDataManager::LoadDirectoryDataType(const char* dirName, const char* extensionType, StaticDataType dataType, StaticDataMapType& loadInto)
         {
             AZStd::string sanitizedString = ResolveAndSanitize(dirName);
 
@@ -304,7 +357,12 @@ namespace CloudCanvas
 
             for (auto thisFile : dataSet)
             {
-                LoadRelativeFile(thisFile.c_str());
+                StaticDataTagType tagStr;
+                StaticDataInterfacePtrInternal newInterface;
+                if (LoadFileInterface(thisFile.c_str(), tagStr, newInterface) && newInterface)
+                {
+                    loadInto[tagStr] = newInterface;
+                }
             }
         }
 
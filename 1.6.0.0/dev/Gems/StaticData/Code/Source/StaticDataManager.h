@@ -30,6 +30,7 @@ namespace CloudCanvas
 
         using StaticDataInterfacePtr = AZStd::shared_ptr<const StaticDataInterface>;
         using StaticDataMapType = AZStd::unordered_map<StaticDataTagType, StaticDataInterfacePtr>;
+        using StaticDataMapPtr = AZStd::shared_ptr<const StaticDataMapType>;
         using StaticDataExtensionList = AZStd::vector<StaticDataExtension>;
 
         static const char* csvDir = "@assets@\\staticdata\\csv\\";
@@ -89,13 +90,15 @@ namespace CloudCanvas
 
             bool ReloadType(const char* tagName);
 
-            void LoadDirectoryDataType(const char* dirName, const char* fileExtension, StaticDataType dataType);
+            void LoadDirectoryDataType(const char* dirName, const char* fileExtension, StaticDataType dataType, StaticDataMapType& loadInto);
+            // Reads and parses a file without publishing it, returns false if the file could not be opened
+            bool LoadFileInterface(const char* relativeFile, StaticDataTagType& tagStr, StaticDataInterfacePtrInternal& newInterface);
 
             bool LoadAll();
 
             void AddExtensionType(const char* extensionStr, StaticDataType dataType);
 
-            StaticDataInterfacePtrInternal CreateInterface(StaticDataType dataType, const char* initData, const char* tagName);
+            StaticDataInterfacePtrInternal CreateInterface(StaticDataType dataType, const char* initData);
             void RemoveInterface(const char* tagName);
             void SetInterface(const char* tagName, StaticDataInterfacePtrInternal someInterface);
 
@@ -109,13 +112,19 @@ namespace CloudCanvas
 
             void SetEditorGameDir(const char* dirName) override { m_editorGameDir = dirName; }
 
-            StaticDataMapType m_data;
+            // Published maps are never modified, updates build a new map and swap the pointer under m_dataMutex
+            StaticDataMapPtr GetDataSnapshot() const;
+            void PublishData(StaticDataMapPtr newData);
+
+            StaticDataMapPtr m_data;
 
             AZStd::unordered_map<StaticDataTagType, StaticDataType> m_extensionToTypeMap;
             AZStd::unordered_map<AZStd::string, StaticDataExtensionList> m_directoryToExtensionMap;
 
             AZStd::shared_ptr<StaticDataTransferManager> m_transferManager;
             mutable AZStd::mutex m_dataMutex;
+            // Serializes writers so concurrent reloads can't drop each other's copy of the map
+            AZStd::mutex m_updateMutex;
 
             IStaticDataMonitor* m_monitor{ nullptr };
 
@@ -13,6 +13,23 @@
 
 #include <AzTest/AzTest.h>
 
+#include <CSVStaticData.h>
+
+#include <cfloat>
+#include <climits>
+
+using namespace CloudCanvas::StaticData;
+
+namespace
+{
+    // LoadData is only meant to be called by the StaticDataManager
+    class TestCSVStaticData : public CSVStaticData
+    {
+    public:
+        using CSVStaticData::LoadData;
+    };
+}
+
 class StaticDataTest : public ::testing::Test
 {
 protected:
@@ -25,6 +42,15 @@ protected:
     {
 
     }
+
+    AZStd::string GetStr(const char* key, const char* field)
+    {
+        AZStd::string value = "<missing>";
+        m_data.GetStrValue(key, field, value);
+        return value;
+    }
+
+    TestCSVStaticData m_data;
 };
 
 TEST_F(StaticDataTest, ExampleTest)
@@ -32,4 +58,191 @@ TEST_F(StaticDataTest, ExampleTest)
     ASSERT_TRUE(true);
 }
 
+TEST_F(StaticDataTest, QuotedCells_HoldDelimitersQuotesAndNewlines)
+{
+    ASSERT_TRUE(m_data.LoadData(
+        "key,text,after\n"
+        "comma,\"a,b\",1\n"
+        "quotes,\"say \"\"hi\"\"\",2\n"
+        "multiline,\"first\nsecond\r\nthird\",3\n"
+        "\"quoted key\",plain,4\n"));
+
+    EXPECT_EQ(4u, m_data.GetRowCount());
+    EXPECT_EQ("a,b", GetStr("comma", "text"));
+    EXPECT_EQ("say \"hi\"", GetStr("quotes", "text"));
+    // only the line end which ends a cell loses its carriage return
+    EXPECT_EQ("first\nsecond\r\nthird", GetStr("multiline", "text"));
+    EXPECT_EQ("plain", GetStr("quoted key", "text"));
+
+    // the cell after a multiline cell still belongs to the same row
+    int value = 0;
+    EXPECT_TRUE(m_data.GetIntValue("multiline", "after", value));
+    EXPECT_EQ(3, value);
+    EXPECT_TRUE(m_data.GetIntValue("quoted key", "after", value));
+    EXPECT_EQ(4, value);
+}
+
+TEST_F(StaticDataTest, EmptyCells_DoNotEndRows)
+{
+    ASSERT_TRUE(m_data.LoadData(
+        "key,a,b,c\n"
+        "row1,,2,3\n"
+        "row2,1,,\n"
+        "row3,5\n"));
+
+    EXPECT_EQ(3u, m_data.GetRowCount());
+
+    // cells after an empty cell are still read
+    int value = 0;
+    EXPECT_TRUE(m_data.GetIntValue("row1", "c", value));
+    EXPECT_EQ(3, value);
+
+    // an empty cell exists and reads as empty or zero
+    EXPECT_EQ("", GetStr("row1", "a"));
+    EXPECT_TRUE(m_data.GetIntValue("row1", "a", value));
+    EXPECT_EQ(0, value);
+    double doubleValue = 1.0;
+    EXPECT_TRUE(m_data.GetDoubleValue("row2", "c", doubleValue));
+    EXPECT_EQ(0.0, doubleValue);
+
+    // a short row leaves the rest of its cells missing
+    EXPECT_TRUE(m_data.GetIntValue("row3", "a", value));
+    EXPECT_EQ(5, value);
+    EXPECT_FALSE(m_data.GetIntValue("row3", "b", value));
+    EXPECT_EQ("<missing>", GetStr("row3", "c"));
+}
+
+TEST_F(StaticDataTest, BlankLines_AreSkipped)
+{
+    ASSERT_TRUE(m_data.LoadData(
+        "key,value\r\n"
+        "\r\n"
+        "first,1\r\n"
+        "\n"
+        "\n"
+        "second,2\r\n"
+        "\r\n"));
+
+    EXPECT_EQ(2u, m_data.GetRowCount());
+    EXPECT_EQ("<missing>", GetStr("", "value"));
+
+    int value = 0;
+    EXPECT_TRUE(m_data.GetIntValue("second", "value", value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ("1", GetStr("first", "value"));
+}
+
+TEST_F(StaticDataTest, TypedLookups_ReadLikeStreams)
+{
+    ASSERT_TRUE(m_data.LoadData(
+        "key,int,double,string,big\n"
+        "a,5,1.5,hello,99999999999\n"
+        "b,-7,2.5e3,12abc,1e999\n"
+        "c,+3,.25,-.5x,-1e999\n"));
+
+    int intValue = 0;
+    double doubleValue = 0.0;
+
+    // int column
+    EXPECT_TRUE(m_data.GetIntValue("b", "int", intValue));
+    EXPECT_EQ(-7, intValue);
+    EXPECT_TRUE(m_data.GetIntValue("c", "int", intValue));
+    EXPECT_EQ(3, intValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("a", "int", doubleValue));
+    EXPECT_EQ(5.0, doubleValue);
+    EXPECT_EQ("-7", GetStr("b", "int"));
+
+    // double column, an int read stops at the first character which isn't a digit
+    EXPECT_TRUE(m_data.GetDoubleValue("b", "double", doubleValue));
+    EXPECT_EQ(2500.0, doubleValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("c", "double", doubleValue));
+    EXPECT_EQ(0.25, doubleValue);
+    EXPECT_TRUE(m_data.GetIntValue("b", "double", intValue));
+    EXPECT_EQ(2, intValue);
+    EXPECT_TRUE(m_data.GetIntValue("a", "double", intValue));
+    EXPECT_EQ(1, intValue);
+
+    // string column, numbers are read from the leading part of the text
+    EXPECT_TRUE(m_data.GetIntValue("b", "string", intValue));
+    EXPECT_EQ(12, intValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("c", "string", doubleValue));
+    EXPECT_EQ(-0.5, doubleValue);
+    EXPECT_TRUE(m_data.GetIntValue("a", "string", intValue));
+    EXPECT_EQ(0, intValue);
+    EXPECT_EQ("12abc", GetStr("b", "string"));
+
+    // out of range values clamp instead of overflowing
+    EXPECT_TRUE(m_data.GetIntValue("a", "big", intValue));
+    EXPECT_EQ(INT_MAX, intValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("a", "big", doubleValue));
+    EXPECT_EQ(99999999999.0, doubleValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("b", "big", doubleValue));
+    EXPECT_EQ(DBL_MAX, doubleValue);
+    EXPECT_TRUE(m_data.GetDoubleValue("c", "big", doubleValue));
+    EXPECT_EQ(-DBL_MAX, doubleValue);
+    EXPECT_TRUE(m_data.GetIntValue("c", "big", intValue));
+    EXPECT_EQ(-1, intValue);
+}
+
+TEST_F(StaticDataTest, Lookups_UnknownAndDuplicateKeys)
+{
+    ASSERT_TRUE(m_data.LoadData(
+        "key,value\n"
+        "dup,1\n"
+        "other,2\n"
+        "dup,3\n"));
+
+    int value = 0;
+    EXPECT_FALSE(m_data.GetIntValue("missing", "value", value));
+    EXPECT_FALSE(m_data.GetIntValue("other", "missing", value));
+    EXPECT_FALSE(m_data.GetIntValue(nullptr, "value", value));
+    EXPECT_FALSE(m_data.GetIntValue("other", nullptr, value));
+
+    // the first row with a key wins
+    EXPECT_TRUE(m_data.GetIntValue("dup", "value", value));
+    EXPECT_EQ(1, value);
+
+    // the key column can be read like any other
+    EXPECT_EQ("other", GetStr("other", "key"));
+}
+
+TEST_F(StaticDataTest, MalformedInput_DoesNotBreakLoading)
+{
+    // no data at all
+    EXPECT_TRUE(m_data.LoadData(nullptr));
+    EXPECT_EQ(0u, m_data.GetRowCount());
+    EXPECT_TRUE(m_data.LoadData(""));
+    EXPECT_EQ(0u, m_data.GetRowCount());
+    EXPECT_EQ("<missing>", GetStr("", ""));
+
+    // header only, without a line end
+    EXPECT_TRUE(m_data.LoadData("key,value"));
+    EXPECT_EQ(0u, m_data.GetRowCount());
+    EXPECT_EQ(2u, m_data.GetColumnCount());
+
+    // rows longer than the header drop their extra cells
+    EXPECT_TRUE(m_data.LoadData("key,value\nrow,1,2,3\n"));
+    EXPECT_EQ(1u, m_data.GetRowCount());
+    EXPECT_EQ("1", GetStr("row", "value"));
+
+    // text after a closing quote and quotes inside unquoted text are kept as is
+    EXPECT_TRUE(m_data.LoadData("key,a,b\nrow,\"quoted\"tail,in\"side\n"));
+    EXPECT_EQ("quotedtail", GetStr("row", "a"));
+    EXPECT_EQ("in\"side", GetStr("row", "b"));
+
+    // an unterminated quote takes the rest of the buffer
+    EXPECT_TRUE(m_data.LoadData("key,a\nfirst,1\nsecond,\"open\nrest,2\n"));
+    EXPECT_EQ(2u, m_data.GetRowCount());
+    EXPECT_EQ("open\nrest,2\n", GetStr("second", "a"));
+
+    // the last row does not need a line end
+    EXPECT_TRUE(m_data.LoadData("key,a\nlast,7"));
+    int value = 0;
+    EXPECT_TRUE(m_data.GetIntValue("last", "a", value));
+    EXPECT_EQ(7, value);
+
+    // loading again replaces everything which was loaded before
+    EXPECT_EQ("<missing>", GetStr("first", "a"));
+}
+
 AZ_UNIT_TEST_HOOK();